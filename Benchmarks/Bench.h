@@ -0,0 +1,255 @@
+/***************************************************************************************************
+ * @file Bench.h                                                                                   *
+ * @brief Defines the helpers shared by the benchmarks                                             *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see HashMapBench.c, TreeBench.c, ScannerBench.c                                                *
+ **************************************************************************************************/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <malloc.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Returns the time of a monotonic clock, in nanoseconds
+ */
+static inline long long BenchNow()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+
+/**
+ * @brief Returns the number of bytes of the heap in use, including the allocator's own overhead
+ */
+static inline size_t BenchHeapInUse()
+{
+    return mallinfo2().uordblks;
+}
+
+
+
+/*
+ * Counts the calls to the allocator when BENCH_COUNT_ALLOCATIONS is defined before this header,
+ * by wrapping the allocator of the C library (g_malloc goes through it too). Only one file of a
+ * benchmark may include the header with it defined.
+ */
+#ifdef BENCH_COUNT_ALLOCATIONS
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+static unsigned long benchAllocations;  ///< The number of allocations made so far
+
+void *malloc(size_t size)
+{
+    benchAllocations++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    benchAllocations++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    benchAllocations++;
+    return __libc_realloc(pointer, size);
+}
+
+/** @brief Returns the number of allocations made so far */
+static inline unsigned long BenchAllocations() { return benchAllocations; }
+#else
+static inline unsigned long BenchAllocations() { return 0; }
+#endif
+
+
+/**
+ * @brief Describes what one benchmark measures
+ * 
+ * setup and teardown run around each repetition without being timed, run is timed and performs
+ * the operations once. Any of setup and teardown may be NULL.
+ */
+typedef struct
+{
+    void (*setup)(void *context);       ///< Prepares a repetition (e.g., fills a map)
+    void (*run)(void *context);         ///< Performs the operations
+    void (*teardown)(void *context);    ///< Cleans up after a repetition
+    void *context;                      ///< Passed unchanged to the functions
+    long operations;                    ///< The number of operations performed by one run
+    size_t bytes;                       ///< The number of bytes processed by one run, to report a throughput (or 0)
+} BenchCase;
+
+
+/**
+ * @brief The summary of the repetitions of one benchmark
+ */
+typedef struct
+{
+    double nsPerOp;             ///< The median time of an operation
+    double minNsPerOp;          ///< The best time of an operation, or NAN if it was not measured
+    double deviation;           ///< The standard deviation of the time, relative to the mean, in %, or NAN if it was not measured
+    double allocationsPerOp;    ///< The allocations per operation, or -1 if they are not counted
+    double megabytesPerSecond;  ///< The median throughput, or 0 if the case has no bytes
+} BenchResult;
+
+
+/**
+ * @brief The options of the benchmarks, read from the command line by BenchInit
+ */
+static struct
+{
+    int json;           ///< Whether the results are printed as JSON lines (--json)
+    int repetitions;    ///< The number of timed repetitions (--repetitions=N)
+    int warmups;        ///< The number of repetitions run before (--warmups=N)
+    const char *filter; ///< Only the benchmarks whose name contains it are run (--filter=TEXT)
+    int printed;        ///< Set once the header of the text output is printed
+} benchOptions = { 0, 15, 3, NULL, 0 };
+
+
+/**
+ * @brief Reads the options of the benchmarks from the command line
+ * 
+ * --json prints one JSON object per benchmark and per line, so the results of two builds can
+ * be compared with diff or any JSON tool. The default output is a table.
+ */
+static inline void BenchInit(int argc, char **argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--json") == 0) benchOptions.json = 1;
+        else if(strncmp(argv[i], "--repetitions=", 14) == 0) benchOptions.repetitions = atoi(argv[i] + 14);
+        else if(strncmp(argv[i], "--warmups=", 10) == 0) benchOptions.warmups = atoi(argv[i] + 10);
+        else if(strncmp(argv[i], "--filter=", 9) == 0) benchOptions.filter = argv[i] + 9;
+        else fprintf(stderr, "Unknown option %s (--json, --repetitions=N, --warmups=N, --filter=TEXT)\n", argv[i]);
+    }
+    if(benchOptions.repetitions < 1) benchOptions.repetitions = 1;
+    if(benchOptions.warmups < 0) benchOptions.warmups = 0;
+}
+
+
+static int benchCompare(const void *first, const void *second)
+{
+    double a = *(const double *)first, b = *(const double *)second;
+    return (a > b) - (a < b);
+}
+
+
+/**
+ * @brief Prints the summary of a benchmark, as a row of the table or as a JSON line
+ * 
+ * BenchMeasure calls it; a benchmark calls it directly for the results it derives from measured
+ * ones (e.g., the difference of two phases). A derived result has no best time nor deviation of
+ * its own: they are set to NAN and printed as "-" (null in JSON).
+ * @param name The name of the benchmark
+ * @param summary Its results
+ * @param repetitions The number of repetitions they summarize
+ */
+static inline void BenchReport(const char *name, const BenchResult *summary, int repetitions)
+{
+    if(benchOptions.json)
+    {
+        printf("{\"name\":\"%s\",\"ns_per_op\":%.2f,", name, summary->nsPerOp);
+        if(isnan(summary->minNsPerOp)) printf("\"min_ns_per_op\":null,\"rsd_percent\":null,");
+        else printf("\"min_ns_per_op\":%.2f,\"rsd_percent\":%.1f,", summary->minNsPerOp, summary->deviation);
+        printf("\"allocs_per_op\":%.3f,\"mb_per_s\":%.1f,\"repetitions\":%d}\n", summary->allocationsPerOp,
+               summary->megabytesPerSecond, repetitions);
+    }
+    else
+    {
+        if(!benchOptions.printed)
+        {
+            printf("%-36s %12s %12s %8s %12s %10s\n", "benchmark", "ns/op", "min ns/op", "rsd %", "allocs/op", "MB/s");
+            benchOptions.printed = 1;
+        }
+        printf("%-36s %12.1f ", name, summary->nsPerOp);
+        if(isnan(summary->minNsPerOp)) printf("%12s %8s ", "-", "-");
+        else printf("%12.1f %8.1f ", summary->minNsPerOp, summary->deviation);
+        if(summary->allocationsPerOp < 0) printf("%12s ", "-");
+        else printf("%12.3f ", summary->allocationsPerOp);
+        if(summary->megabytesPerSecond) printf("%10.1f\n", summary->megabytesPerSecond);
+        else printf("%10s\n", "-");
+    }
+    fflush(stdout);
+}
+
+
+/**
+ * @brief Runs a benchmark: warm-up repetitions, then timed ones, and prints their summary
+ * @param name The name of the benchmark, e.g. "HashMapGet/1000"
+ * @param benchCase What is measured
+ * @param result Where the summary is written, or NULL
+ * @return 1 if the benchmark ran, 0 if the filter skipped it
+ */
+static inline int BenchMeasure(const char *name, const BenchCase *benchCase, BenchResult *result)
+{
+    if(benchOptions.filter && !strstr(name, benchOptions.filter)) return 0;
+
+    for(int i = 0; i < benchOptions.warmups; i++)
+    {
+        if(benchCase->setup) benchCase->setup(benchCase->context);
+        benchCase->run(benchCase->context);
+        if(benchCase->teardown) benchCase->teardown(benchCase->context);
+    }
+
+    int repetitions = benchOptions.repetitions;
+    double *times = malloc(repetitions * sizeof(double));
+    unsigned long allocations = 0;
+    double sum = 0, squares = 0;
+
+    for(int i = 0; i < repetitions; i++)
+    {
+        if(benchCase->setup) benchCase->setup(benchCase->context);
+
+        unsigned long before = BenchAllocations();
+        long long start = BenchNow();
+        benchCase->run(benchCase->context);
+        long long elapsed = BenchNow() - start;
+        allocations += BenchAllocations() - before;
+
+        if(benchCase->teardown) benchCase->teardown(benchCase->context);
+
+        times[i] = (double)elapsed / benchCase->operations;
+        sum += times[i];
+        squares += times[i] * times[i];
+    }
+
+    qsort(times, repetitions, sizeof(double), benchCompare);
+    double mean = sum / repetitions;
+    double variance = squares / repetitions - mean * mean;
+
+    BenchResult summary;
+    summary.nsPerOp = repetitions % 2 ? times[repetitions / 2] : (times[repetitions / 2 - 1] + times[repetitions / 2]) / 2;
+    summary.minNsPerOp = times[0];
+    summary.deviation = mean > 0 && variance > 0 ? 100.0 * sqrt(variance) / mean : 0;
+#ifdef BENCH_COUNT_ALLOCATIONS
+    summary.allocationsPerOp = (double)allocations / ((double)repetitions * benchCase->operations);
+#else
+    summary.allocationsPerOp = -1;
+#endif
+    summary.megabytesPerSecond = benchCase->bytes ?
+        benchCase->bytes / (summary.nsPerOp * benchCase->operations) * 1e9 / (1024 * 1024) : 0;
+    free(times);
+
+    BenchReport(name, &summary, repetitions);
+
+    if(result) *result = summary;
+    return 1;
+}
+
+#endif // BENCH_H
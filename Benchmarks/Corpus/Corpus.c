@@ -0,0 +1,458 @@
+/***************************************************************************************************
+ * @file Corpus.c                                                                                  *
+ * @brief The implementation of the generator of synthetic markup documents                        *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Corpus.h                                                                                   *
+ **************************************************************************************************/
+
+#include "Corpus.h"
+#include <string.h>
+
+/**
+ * @brief Receives the elements of a document in order, the markup writer and the tree builder implement it
+ */
+struct Sink
+{
+    int (*open)(struct Sink *sink, widgetType type, const char *id, int attributeCount, int depth, int isLeaf);
+    int (*attribute)(struct Sink *sink, const char *key, const char *value);
+    int (*endOpen)(struct Sink *sink, int isLeaf);
+    int (*close)(struct Sink *sink, widgetType type, int depth);
+};
+
+
+/** @brief Draws the next number of a splitmix64 sequence */
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+
+/** @brief Draws a number between low and high, both included */
+static long drawBetween(unsigned long long *state, long low, long high)
+{
+    if(high <= low) return low;
+    return low + (long)(nextRandom(state) % (unsigned long long)(high - low + 1));
+}
+
+
+/** @brief Draws a probability event */
+static int drawChance(unsigned long long *state, double probability)
+{
+    return (double)(nextRandom(state) >> 11) / (double)(1ull << 53) < probability;
+}
+
+
+/**
+ * @brief Draws a widget type from the mix, window excluded
+ * @param kind 0 for any type, 1 for leaves only, 2 for containers only
+ */
+static widgetType drawType(unsigned long long *state, const double *mix, int kind)
+{
+    static const int isLeafType[WIDGET_TYPE_COUNT] = { 0, 0, 0, 0, 1, 1 };
+
+    double total = 0;
+    for(int type = headerBar; type < WIDGET_TYPE_COUNT; type++)
+    {
+        if(kind == 0 || (kind == 1) == isLeafType[type]) total += mix[type];
+    }
+
+    double draw = (double)(nextRandom(state) >> 11) / (double)(1ull << 53) * total;
+    for(int type = headerBar; type < WIDGET_TYPE_COUNT; type++)
+    {
+        if(kind != 0 && (kind == 1) != isLeafType[type]) continue;
+        if(draw < mix[type]) return (widgetType)type;
+        draw -= mix[type];
+    }
+    return kind == 2 ? box : label;
+}
+
+
+/**
+ * @brief The kinds of attribute values, each drawn so that the Renderer and GtkBuilder accept it
+ */
+typedef enum
+{
+    valueText,          ///< Free text of about the mean value length
+    valueSize,          ///< A number of pixels, from 0 to 48
+    valueBool,
+    valueAlign,
+    valueOrientation,
+    valueOpacity,       ///< A number from 0.5 to 1
+    valueClass          ///< A style class of the default theme
+} valueKind;
+
+
+/**
+ * @brief The attributes an element may get, those of its type before the shared ones
+ */
+static const struct
+{
+    const char *name;
+    int type;           ///< The widget type it belongs to, or -1 if every type has it
+    valueKind kind;
+} attributeTable[] = {
+    { "title", window, valueText }, { "defaultWidth", window, valueSize }, { "defaultHeight", window, valueSize },
+    { "showTitleButtons", headerBar, valueBool },
+    { "orientation", box, valueOrientation }, { "spacing", box, valueSize }, { "homogeneous", box, valueBool },
+    { "rowSpacing", grid, valueSize }, { "columnSpacing", grid, valueSize },
+    { "text", label, valueText }, { "wrap", label, valueBool }, { "selectable", label, valueBool },
+    { "label", button, valueText },
+    { "tooltip", -1, valueText }, { "name", -1, valueText }, { "class", -1, valueClass },
+    { "hexpand", -1, valueBool }, { "vexpand", -1, valueBool }, { "halign", -1, valueAlign },
+    { "valign", -1, valueAlign }, { "marginStart", -1, valueSize }, { "marginEnd", -1, valueSize },
+    { "marginTop", -1, valueSize }, { "marginBottom", -1, valueSize }, { "opacity", -1, valueOpacity },
+};
+#define ATTRIBUTE_TABLE_SIZE (int)(sizeof(attributeTable) / sizeof(attributeTable[0]))
+
+static const char *const alignValues[] = { "fill", "start", "end", "center" };
+static const char *const classValues[] = { "title", "dim-label", "flat", "suggested-action", "card", "heading" };
+static const char valueAlphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 -_.,:;!?()";
+
+
+/**
+ * @brief Draws the value of an attribute into value, which holds twice the mean text length
+ */
+static void drawValue(unsigned long long *state, valueKind kind, int valueLength, char *value)
+{
+    switch(kind)
+    {
+        case valueSize:         sprintf(value, "%ld", drawBetween(state, 0, 48)); return;
+        case valueBool:         strcpy(value, drawChance(state, 0.5) ? "true" : "false"); return;
+        case valueAlign:        strcpy(value, alignValues[nextRandom(state) % 4]); return;
+        case valueOrientation:  strcpy(value, drawChance(state, 0.5) ? "horizontal" : "vertical"); return;
+        case valueOpacity:      sprintf(value, "%.2f", 0.5 + drawBetween(state, 0, 50) / 100.0); return;
+        case valueClass:        strcpy(value, classValues[nextRandom(state) % 6]); return;
+        default:                break;
+    }
+
+    int length = (int)drawBetween(state, 1, 2L * valueLength - 1);
+    for(int c = 0; c < length; c++) value[c] = valueAlphabet[nextRandom(state) % (sizeof(valueAlphabet) - 1)];
+    value[length] = '\0';
+}
+
+
+/**
+ * @brief Generates a document, sending its elements to a sink
+ * @return 1 on success, -1 if the sink failed or allocation fails
+ */
+static int generate(const CorpusOptions *options, struct Sink *sink)
+{
+    unsigned long long state = options->seed;
+    int maxDepth = options->maxDepth > 2 ? options->maxDepth : 2;
+    int valueLength = options->valueLength > 0 ? options->valueLength : 1;
+
+    double mix[WIDGET_TYPE_COUNT];
+    for(int type = 0; type < WIDGET_TYPE_COUNT; type++)
+    {
+        mix[type] = type == window || options->mix[type] < 0 ? 0 : options->mix[type];
+    }
+    if(mix[label] + mix[button] <= 0) mix[label] = 1;
+    if(mix[headerBar] + mix[box] + mix[grid] <= 0) mix[box] = 1;
+
+    // The number of children each open element still has to get, the content box's is unbounded
+    long *remaining = malloc((maxDepth + 1) * sizeof(long));
+    widgetType *types = malloc((maxDepth + 1) * sizeof(widgetType));
+    char *value = malloc(2 * valueLength + 32);
+    if(!remaining || !types || !value)
+    {
+        free(remaining);
+        free(types);
+        free(value);
+        return -1;
+    }
+
+    char id[32], key[32];
+    int order[ATTRIBUTE_TABLE_SIZE];
+    long generated = 0;
+    int depth = 0, result = 1;
+    long nodes = options->nodes > 0 ? options->nodes : 1;
+    int fanout = options->fanout > 1 ? options->fanout : 2;
+
+    // The levels of containers only below the content box, half the depth the document needs, so
+    // that no element gets a number of children growing with the document
+    int spine = 0;
+    for(double size = 1; size < nodes; size *= fanout) spine++;
+    spine = 1 + (spine / 2 < maxDepth / 2 ? spine / 2 : maxDepth / 2);
+
+    while(result == 1 && generated < nodes)
+    {
+        // Close the elements that got all their children, the content box never does
+        while(depth > 0 && remaining[depth] == 0)
+        {
+            if(sink->close(sink, types[depth], depth - 1) == -1) result = -1;
+            depth--;
+        }
+        if(result == -1) break;
+
+        // The window and its only child, the content box, then an element under the deepest open one
+        widgetType type = generated == 0 ? window : depth == 1 ? box :
+                          drawType(&state, mix, depth >= maxDepth ? 1 : depth <= spine ? 2 : 0);
+        int isLeaf = type == label || type == button || generated + 1 == nodes;
+        if(depth > 0) remaining[depth]--;
+
+        sprintf(id, "n%ld", generated++);
+        int attributeCount = (int)drawBetween(&state, 0, 2L * options->attributes);
+        if(sink->open(sink, type, id, attributeCount, depth, isLeaf) == -1) result = -1;
+
+        // The attributes of the type and the shared ones, in a random order
+        int available = 0;
+        for(int i = 0; i < ATTRIBUTE_TABLE_SIZE; i++)
+        {
+            if(attributeTable[i].type == -1 || attributeTable[i].type == (int)type) order[available++] = i;
+        }
+
+        size_t written = 0;
+        for(int i = 0; result == 1 && i < attributeCount; i++)
+        {
+            if(i < available)
+            {
+                int pick = (int)drawBetween(&state, i, available - 1), swap = order[i];
+                order[i] = order[pick];
+                order[pick] = swap;
+                strcpy(key, attributeTable[order[i]].name);
+                drawValue(&state, attributeTable[order[i]].kind, valueLength, value);
+            }
+            else
+            {
+                sprintf(key, "data%d", i);
+                drawValue(&state, valueText, valueLength, value);
+            }
+
+            // Leave the remaining attributes out rather than overflow the tag buffer of the Scanner
+            written += strlen(key) + strlen(value) + 8;
+            if(written > CORPUS_MAX_TAG_ATTRIBUTES) break;
+            if(sink->attribute(sink, key, value) == -1) result = -1;
+        }
+        if(result == 1 && sink->endOpen(sink, isLeaf) == -1) result = -1;
+
+        if(!isLeaf)
+        {
+            depth++;
+            types[depth] = type;
+            remaining[depth] = type == window ? 1 : depth == 2 ? -1 : drawBetween(&state, 1, 2L * fanout - 1);
+        }
+    }
+
+    // Close the elements still open
+    for(; result == 1 && depth > 0; depth--)
+    {
+        if(sink->close(sink, types[depth], depth - 1) == -1) result = -1;
+    }
+
+    free(remaining);
+    free(types);
+    free(value);
+    return result;
+}
+
+
+/**
+ * @brief Writes the elements as markup
+ */
+struct MarkupSink
+{
+    struct Sink sink;
+    FILE *output;
+    double whitespace;          ///< The probability of optional white space
+    unsigned long long state;   ///< The generator of the white space, separate from the document's
+    long written;               ///< The number of bytes written
+};
+
+
+static int writeString(struct MarkupSink *markup, const char *string)
+{
+    size_t length = strlen(string);
+    if(fwrite(string, 1, length, markup->output) != length) return -1;
+    markup->written += length;
+    return 1;
+}
+
+
+static int writeSpace(struct MarkupSink *markup, int required)
+{
+    if(!required && !drawChance(&markup->state, markup->whitespace)) return 1;
+    return writeString(markup, " ");
+}
+
+
+/** @brief Starts a line indented to a depth, when white space is drawn */
+static int writeIndent(struct MarkupSink *markup, int depth)
+{
+    if(!drawChance(&markup->state, markup->whitespace)) return 1;
+    if(writeString(markup, "\n") == -1) return -1;
+    for(int i = 0; i < depth; i++) if(writeString(markup, "  ") == -1) return -1;
+    return 1;
+}
+
+
+static int markupOpen(struct Sink *sink, widgetType type, const char *id, int attributeCount, int depth, int isLeaf)
+{
+    (void)attributeCount;
+    (void)isLeaf;
+    struct MarkupSink *markup = (struct MarkupSink *)sink;
+    if(markup->written && writeIndent(markup, depth) == -1) return -1;
+    if(writeString(markup, "<") == -1 || writeString(markup, WidgetTypeToName(type)) == -1) return -1;
+    return markup->sink.attribute(sink, "id", id);
+}
+
+
+static int markupAttribute(struct Sink *sink, const char *key, const char *value)
+{
+    struct MarkupSink *markup = (struct MarkupSink *)sink;
+    if(writeSpace(markup, 1) == -1 || writeString(markup, key) == -1 || writeSpace(markup, 0) == -1) return -1;
+    if(writeString(markup, "=") == -1 || writeSpace(markup, 0) == -1) return -1;
+    if(writeString(markup, "\"") == -1 || writeString(markup, value) == -1) return -1;
+    return writeString(markup, "\"");
+}
+
+
+static int markupEndOpen(struct Sink *sink, int isLeaf)
+{
+    struct MarkupSink *markup = (struct MarkupSink *)sink;
+    if(writeSpace(markup, 0) == -1) return -1;
+    return writeString(markup, isLeaf ? "/>" : ">");
+}
+
+
+static int markupClose(struct Sink *sink, widgetType type, int depth)
+{
+    struct MarkupSink *markup = (struct MarkupSink *)sink;
+    if(writeIndent(markup, depth) == -1) return -1;
+    if(writeString(markup, "</") == -1 || writeString(markup, WidgetTypeToName(type)) == -1) return -1;
+    if(writeSpace(markup, 0) == -1) return -1;
+    return writeString(markup, ">");
+}
+
+
+/**
+ * @brief Builds the tree of the elements, as the Scanner does: the id is taken out of the attributes
+ */
+struct TreeSink
+{
+    struct Sink sink;
+    Tree *root;
+    Tree **parents;     ///< The open elements, by depth
+    Tree *current;      ///< The element whose attributes are received
+    HashMap *attributes;///< Its attributes
+    int depth;          ///< Its depth
+};
+
+
+static int treeOpen(struct Sink *sink, widgetType type, const char *id, int attributeCount, int depth, int isLeaf)
+{
+    (void)attributeCount;
+    (void)isLeaf;
+    struct TreeSink *tree = (struct TreeSink *)sink;
+    tree->attributes = HashMapNew();
+    tree->current = tree->attributes ? TreeNewAdopt(type, g_strdup(id), NULL, tree->attributes) : NULL;
+    if(!tree->current) return -1;
+
+    if(depth == 0) tree->root = tree->current;
+    else if(TreeAddChild(tree->parents[depth - 1], tree->current) == -1)
+    {
+        TreeDestroy(tree->current);
+        return -1;
+    }
+    tree->depth = depth;
+    return 1;
+}
+
+
+static int treeAttribute(struct Sink *sink, const char *key, const char *value)
+{
+    struct TreeSink *tree = (struct TreeSink *)sink;
+    return HashMapPut(tree->attributes, key, value) == -1 ? -1 : 1;
+}
+
+
+static int treeEndOpen(struct Sink *sink, int isLeaf)
+{
+    struct TreeSink *tree = (struct TreeSink *)sink;
+    if(!isLeaf) tree->parents[tree->depth] = tree->current;
+    return 1;
+}
+
+
+static int treeClose(struct Sink *sink, widgetType type, int depth)
+{
+    (void)sink;
+    (void)type;
+    (void)depth;
+    return 1;
+}
+
+
+
+
+void CorpusDefaultOptions(CorpusOptions *options)
+{
+    // Check the input parameter
+    if(!options) return;
+
+    *options = (CorpusOptions){ 1, 1000, 8, 6, 3, 12, 0.5, { 0 } };
+    options->mix[headerBar] = 0.02;
+    options->mix[box] = 0.2;
+    options->mix[grid] = 0.05;
+    options->mix[label] = 0.43;
+    options->mix[button] = 0.3;
+}
+
+
+
+
+long CorpusNodesForSize(const CorpusOptions *options, size_t bytes)
+{
+    // Check the input parameter
+    if(!options) return 1;
+
+    // A tag name and id, its closing tag or "/>", the attributes (half of them text), and the white space
+    double perNode = 24 + options->attributes * (10 + options->valueLength / 2.0) + 6 * options->whitespace * (1 + options->maxDepth / 2.0);
+    long nodes = (long)(bytes / perNode);
+    return nodes > 0 ? nodes : 1;
+}
+
+
+
+
+long CorpusWriteMarkup(const CorpusOptions *options, FILE *output)
+{
+    // Check the input parameters
+    if(!options || !output) return -1;
+
+    struct MarkupSink markup = { { markupOpen, markupAttribute, markupEndOpen, markupClose }, output,
+                                 options->whitespace, options->seed ^ 0x5DEECE66Dull, 0 };
+    if(generate(options, &markup.sink) == -1 || writeString(&markup, "\n") == -1) return -1;
+
+    return markup.written;
+}
+
+
+
+
+Tree *CorpusBuildTree(const CorpusOptions *options)
+{
+    // Check the input parameter
+    if(!options) return NULL;
+
+    struct TreeSink tree = { { treeOpen, treeAttribute, treeEndOpen, treeClose }, NULL, NULL, NULL, NULL, 0 };
+    tree.parents = malloc(((options->maxDepth > 0 ? options->maxDepth : 1) + 1) * sizeof(Tree *));
+    if(!tree.parents) return NULL;
+
+    if(generate(options, &tree.sink) == -1)
+    {
+        TreeDestroyAll(tree.root);
+        tree.root = NULL;
+    }
+
+    free(tree.parents);
+    return tree.root;
+}
@@ -0,0 +1,83 @@
+/***************************************************************************************************
+ * @file Corpus.h                                                                                  *
+ * @brief Defines the generator of synthetic markup documents                                      *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Corpus.c                                                                                   *
+ **************************************************************************************************/
+
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <stdio.h>
+#include "../../DataStructure/Tree/Tree.h"
+
+#define CORPUS_MAX_TAG_ATTRIBUTES 8192  ///< The most bytes of attributes written in a tag, the Scanner reads up to MAX
+
+/**
+ * @brief The knobs of a generated document
+ * 
+ * The document is a valid interface for the Renderer and for GtkBuilder alike: a window whose
+ * only child is a content box, whose descendants are drawn from the type mix. Containers (box,
+ * grid, headerBar) get a number of children around the fan-out until the maximum depth, where
+ * only leaves (label, button) are drawn. The content box takes more children until the document
+ * has the requested number of elements; the first levels below it are containers only, so that
+ * the number of children of an element does not grow with the size of the document. Counts and
+ * lengths are drawn uniformly between 1 (0 for attributes) and twice their mean.
+ * 
+ * Every element has a unique "id". The other attributes are drawn among the known attributes of
+ * its type with values of their kind (sizes, booleans, alignments, classes...), only the text
+ * ones having the mean value length; past the known ones, "dataN" text attributes are added.
+ */
+typedef struct
+{
+    unsigned long seed;             ///< The seed of the generator, the same options give the same document
+    long nodes;                     ///< The number of elements
+    int maxDepth;                   ///< The deepest level of an element below the window, at least 2
+    int fanout;                     ///< The mean number of children of a container
+    int attributes;                 ///< The mean number of attributes of an element, the id not included
+    int valueLength;                ///< The mean length of an attribute value
+    double whitespace;              ///< The probability of optional white space (indentation, spaces in the tags), from 0 to 1
+    double mix[WIDGET_TYPE_COUNT];  ///< The relative weight of each widget type below the window (window itself is ignored)
+} CorpusOptions;
+
+
+/**
+ * @brief Fills options with the defaults: 1000 elements, depth 8, fan-out 6, 3 attributes of 12
+ * characters, some white space, and a mix of mostly labels and buttons
+ * @param options The options to fill
+ */
+void CorpusDefaultOptions(CorpusOptions *options);
+
+
+/**
+ * @brief Returns the number of elements giving a document of about a number of bytes
+ * @param options The options, whose node count is ignored
+ * @param bytes The size wanted
+ * @return The number of elements (at least 1)
+ */
+long CorpusNodesForSize(const CorpusOptions *options, size_t bytes);
+
+
+/**
+ * @brief Writes a document
+ * @param options The options of the document
+ * @param output The file the markup is written to
+ * @return The number of bytes written, or -1 if any error occurs
+ */
+long CorpusWriteMarkup(const CorpusOptions *options, FILE *output);
+
+
+/**
+ * @brief Builds the Tree of a document directly, as the Scanner would build it from its markup
+ * @param options The options of the document
+ * @return Tree* The root of the tree, or NULL if any error occurs
+ */
+Tree *CorpusBuildTree(const CorpusOptions *options);
+
+#endif // CORPUS_H
@@ -0,0 +1,150 @@
+/***************************************************************************************************
+ * @file ScalingBench.c                                                                            *
+ * @brief Benchmarks shared maps by number of threads and share of reads                           *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see ConcurrentHashMap.h                                                                        *
+ **************************************************************************************************/
+
+#include "../../../DataStructure/ConcurrentHashMap/ConcurrentHashMap.h"
+#include "../../../DataStructure/HashMap/HashMap.h"
+#include "../../Bench.h"
+#include <pthread.h>
+#include <unistd.h>
+
+#define KEYS 1024           // The number of keys in the map
+#define OPERATIONS 1000000  // The number of operations of each thread
+#define MAX_THREADS 64      // The most threads measured
+
+static const int readPercents[] = { 100, 99, 90, 50 };
+
+static char keys[KEYS][16];
+static char values[KEYS][16];
+
+/**
+ * @brief The map measured, either a ConcurrentHashMap or a HashMap behind one mutex (what
+ *        sharing a HashMap takes today)
+ */
+struct Run
+{
+    ConcurrentHashMap *concurrent;
+    HashMap *locked;
+    pthread_mutex_t lock;
+    int readPercent;
+    pthread_barrier_t start;
+};
+
+struct Worker
+{
+    struct Run *run;
+    unsigned int seed;
+};
+
+
+static void *work(void *data)
+{
+    struct Worker *worker = data;
+    struct Run *run = worker->run;
+    unsigned int seed = worker->seed;
+    volatile size_t sink = 0;
+
+    pthread_barrier_wait(&run->start);
+
+    for(int i = 0; i < OPERATIONS; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int key = (seed >> 8) % KEYS;
+        int read = (int)((seed >> 20) % 100) < run->readPercent;
+
+        if(run->concurrent)
+        {
+            if(read)
+            {
+                ConcurrentHashMapReadBegin();
+                const char *value = ConcurrentHashMapGet(run->concurrent, keys[key]);
+                sink += value ? (size_t)value[0] : 0;
+                ConcurrentHashMapReadEnd();
+            }
+            else ConcurrentHashMapPut(run->concurrent, keys[key], values[(key + i) % KEYS]);
+        }
+        else
+        {
+            pthread_mutex_lock(&run->lock);
+            if(read)
+            {
+                const char *value = HashMapGet(run->locked, keys[key]);
+                sink += value ? (size_t)value[0] : 0;
+            }
+            else HashMapPut(run->locked, keys[key], values[(key + i) % KEYS]);
+            pthread_mutex_unlock(&run->lock);
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * @brief Runs the threads on a map and returns the total throughput, in millions of operations per second
+ */
+static double measure(struct Run *run, int threads)
+{
+    pthread_t ids[MAX_THREADS];
+    struct Worker workers[MAX_THREADS];
+
+    pthread_barrier_init(&run->start, NULL, threads + 1);
+    for(int i = 0; i < threads; i++)
+    {
+        workers[i] = (struct Worker){ run, 2654435761u * (i + 1) };
+        pthread_create(&ids[i], NULL, work, &workers[i]);
+    }
+
+    pthread_barrier_wait(&run->start);
+    long long start = BenchNow();
+    for(int i = 0; i < threads; i++) pthread_join(ids[i], NULL);
+    long long elapsed = BenchNow() - start;
+
+    pthread_barrier_destroy(&run->start);
+    return (double)threads * OPERATIONS * 1000.0 / elapsed;
+}
+
+
+int main() {
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int maxThreads = cores * 2 < MAX_THREADS ? cores * 2 : MAX_THREADS;
+    if(maxThreads < 4) maxThreads = 4;
+
+    for (int i = 0; i < KEYS; i++) {
+        sprintf(keys[i], "key%d", i);
+        sprintf(values[i], "value%d", i);
+    }
+
+    printf("cores: %d, keys: %d, operations per thread: %d, throughput in Mops/s\n\n", cores, KEYS, OPERATIONS);
+    printf("%-8s %-8s %16s %16s\n", "reads", "threads", "concurrent", "mutex+HashMap");
+
+    for (size_t r = 0; r < sizeof(readPercents) / sizeof(readPercents[0]); r++) {
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            struct Run concurrent = { .concurrent = ConcurrentHashMapNew(), .readPercent = readPercents[r] };
+            struct Run locked = { .locked = HashMapNew(), .lock = PTHREAD_MUTEX_INITIALIZER, .readPercent = readPercents[r] };
+            for (int i = 0; i < KEYS; i++) {
+                ConcurrentHashMapPut(concurrent.concurrent, keys[i], values[i]);
+                HashMapPut(locked.locked, keys[i], values[i]);
+            }
+
+            double concurrentRate = measure(&concurrent, threads);
+            double lockedRate = measure(&locked, threads);
+            printf("%-8d %-8d %16.2f %16.2f\n", readPercents[r], threads, concurrentRate, lockedRate);
+
+            ConcurrentHashMapFree(concurrent.concurrent);
+            HashMapFree(locked.locked);
+        }
+    }
+
+    ConcurrentHashMapReclaim();
+    return 0;
+}
@@ -0,0 +1,71 @@
+/***************************************************************************************************
+ * @file AttributeCountBench.c                                                                     *
+ * @brief Benchmarks the memory and the lookup time of a HashMap by number of entries              *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see HashMap.h                                                                                  *
+ **************************************************************************************************/
+
+
+#include "../../../DataStructure/HashMap/HashMap.h"
+#include "../../Bench.h"
+
+#define MAPS 4096       // The number of maps measured per attribute count
+#define ROUNDS 64       // The number of times every key of every map is looked up
+
+static const int counts[] = { 0, 1, 2, 3, 4, 6, 8, 9, 12, 16, 24, 32, 48, 64 };
+
+int main() {
+    static HashMap *maps[MAPS];
+    char keys[64][16], misses[64][16], value[32];
+
+    for (int i = 0; i < 64; i++) {
+        sprintf(keys[i], "attribute%d", i);
+        sprintf(misses[i], "missing%d", i);
+    }
+
+    printf("%-10s %14s %14s %14s\n", "entries", "bytes/map", "ns/hit", "ns/miss");
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        int count = counts[c];
+
+        // Memory: the heap growth of MAPS maps of count entries
+        size_t before = BenchHeapInUse();
+        for (int m = 0; m < MAPS; m++) {
+            maps[m] = HashMapNew();
+            for (int i = 0; i < count; i++) {
+                sprintf(value, "value-%d-%d", m, i);
+                HashMapPut(maps[m], keys[i], value);
+            }
+        }
+        size_t bytes = BenchHeapInUse() - before;
+
+        // Lookup: every key of every map, then as many missing keys
+        long long found = 0;
+        long long start = BenchNow();
+        for (int r = 0; r < ROUNDS; r++)
+            for (int m = 0; m < MAPS; m++)
+                for (int i = 0; i < count; i++) found += HashMapGet(maps[m], keys[i]) != NULL;
+        long long hitTime = BenchNow() - start;
+
+        start = BenchNow();
+        for (int r = 0; r < ROUNDS; r++)
+            for (int m = 0; m < MAPS; m++)
+                for (int i = 0; i < count; i++) found += HashMapGet(maps[m], misses[i]) != NULL;
+        long long missTime = BenchNow() - start;
+
+        long long lookups = (long long)ROUNDS * MAPS * count;
+        printf("%-10d %14.1f %14.2f %14.2f\n", count, (double)bytes / MAPS,
+               lookups ? (double)hitTime / lookups : 0.0, lookups ? (double)missTime / lookups : 0.0);
+
+        if (found != lookups) { printf("Unexpected lookup result\n"); return 1; }
+        for (int m = 0; m < MAPS; m++) HashMapFree(maps[m]);
+    }
+
+    return 0;
+}
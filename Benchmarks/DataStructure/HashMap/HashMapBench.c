@@ -0,0 +1,127 @@
+/***************************************************************************************************
+ * @file HashMapBench.c                                                                            *
+ * @brief Measures the operations of the HashMap across sizes                                      *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see HashMap.h                                                                                  *
+ **************************************************************************************************/
+
+#include "../../../DataStructure/HashMap/HashMap.h"
+#define BENCH_COUNT_ALLOCATIONS
+#include "../../Bench.h"
+
+static const int sizes[] = { 8, 64, 1024, 65536 };  // The numbers of entries measured
+
+
+struct MapContext
+{
+    int size;           ///< The number of entries
+    char (*keys)[16];   ///< The keys of the entries
+    char (*misses)[16]; ///< As many keys that are not in the map
+    HashMap *map;       ///< The map measured
+    HashMap *copy;      ///< The copy made by HashMapGetCopy
+};
+
+
+static void fillMap(struct MapContext *context) {
+    context->map = HashMapNew();
+    for (int i = 0; i < context->size; i++) HashMapPut(context->map, context->keys[i], "a value of average length");
+}
+
+
+static void newMap(void *data) {
+    struct MapContext *context = data;
+    context->map = HashMapNew();
+}
+
+
+static void freeMap(void *data) {
+    struct MapContext *context = data;
+    HashMapFree(context->map);
+    context->map = NULL;
+}
+
+
+static void runPut(void *data) {
+    struct MapContext *context = data;
+    for (int i = 0; i < context->size; i++) HashMapPut(context->map, context->keys[i], "a value of average length");
+}
+
+
+static void runGet(void *data) {
+    struct MapContext *context = data;
+    for (int i = 0; i < context->size; i++) {
+        if (!HashMapGet(context->map, context->keys[i])) abort();
+    }
+}
+
+
+static void runGetMissing(void *data) {
+    struct MapContext *context = data;
+    for (int i = 0; i < context->size; i++) {
+        if (HashMapGet(context->map, context->misses[i])) abort();
+    }
+}
+
+
+static void setupRemove(void *data) {
+    fillMap(data);
+}
+
+
+static void runRemove(void *data) {
+    struct MapContext *context = data;
+    for (int i = 0; i < context->size; i++) HashMapRemove(context->map, context->keys[i]);
+}
+
+
+static void runGetCopy(void *data) {
+    struct MapContext *context = data;
+    context->copy = HashMapGetCopy(context->map);
+}
+
+
+static void freeCopy(void *data) {
+    struct MapContext *context = data;
+    HashMapFree(context->copy);
+}
+
+
+int main(int argc, char **argv) {
+    BenchInit(argc, argv);
+    char name[64];
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        struct MapContext context = { sizes[s], malloc(sizes[s] * 16), malloc(sizes[s] * 16), NULL, NULL };
+        for (int i = 0; i < context.size; i++) {
+            sprintf(context.keys[i], "key-%d", i);
+            sprintf(context.misses[i], "missing-%d", i);
+        }
+
+        sprintf(name, "HashMapPut/%d", context.size);
+        BenchMeasure(name, &(BenchCase){ newMap, runPut, freeMap, &context, context.size, 0 }, NULL);
+
+        // The lookups and the copies read the same map
+        fillMap(&context);
+        sprintf(name, "HashMapGet/%d", context.size);
+        BenchMeasure(name, &(BenchCase){ NULL, runGet, NULL, &context, context.size, 0 }, NULL);
+        sprintf(name, "HashMapGet/missing/%d", context.size);
+        BenchMeasure(name, &(BenchCase){ NULL, runGetMissing, NULL, &context, context.size, 0 }, NULL);
+        sprintf(name, "HashMapGetCopy/%d", context.size);
+        BenchMeasure(name, &(BenchCase){ NULL, runGetCopy, freeCopy, &context, 1, 0 }, NULL);
+        freeMap(&context);
+
+        sprintf(name, "HashMapRemove/%d", context.size);
+        BenchMeasure(name, &(BenchCase){ setupRemove, runRemove, freeMap, &context, context.size, 0 }, NULL);
+
+        free(context.keys);
+        free(context.misses);
+    }
+
+    return 0;
+}
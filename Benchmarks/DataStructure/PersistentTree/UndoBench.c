@@ -0,0 +1,156 @@
+/***************************************************************************************************
+ * @file UndoBench.c                                                                               *
+ * @brief Compares undo histories of persistent versions and of deep copies                        *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see PersistentTree.h                                                                           *
+ **************************************************************************************************/
+
+#include "../../../DataStructure/PersistentTree/PersistentTree.h"
+#include "../../Bench.h"
+
+#define FANOUT 10           // The number of children of each box, the tree has 111111 nodes
+#define LEVELS 6            // The number of levels of the tree
+#define EDITS 10000         // The number of edits
+#define COPIES 10           // The number of edits measured with deep copies, they are much slower
+#define MAX_DEPTH 64        // The longest path an edit follows
+
+static unsigned int seed = 12345;
+
+static unsigned int nextRandom()
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+
+/**
+ * @brief Picks a random node by walking down from the root, returns the length of its path
+ */
+static int randomPath(const PersistentTree *root, int *path)
+{
+    int depth = 0, target = nextRandom() % LEVELS;
+    const PersistentTree *node = root;
+    while (depth < target && PersistentTreeGetChildCount(node) > 0) {
+        path[depth] = nextRandom() % PersistentTreeGetChildCount(node);
+        node = PersistentTreeGetChild(node, path[depth++]);
+    }
+    return depth;
+}
+
+
+/**
+ * @brief Copies a tree with TreeNew, which copies each id and HashMap (a snapshot of the baseline)
+ */
+static void copyChild(Tree *child, void *userData)
+{
+    Tree *copy = TreeNew(TreeGetType(child), TreeGetId(child), NULL, (HashMap *)TreeGetAttributes(child));
+    TreeAddChild(userData, copy);
+    TreeForEachChild(child, copyChild, copy);
+}
+
+
+static Tree *deepCopy(Tree *root)
+{
+    Tree *copy = TreeNew(TreeGetType(root), TreeGetId(root), NULL, (HashMap *)TreeGetAttributes(root));
+    TreeForEachChild(root, copyChild, copy);
+    return copy;
+}
+
+
+/**
+ * @brief Builds a complete tree of boxes with buttons as leaves, each node with a few attributes
+ */
+static Tree *buildTree(int level, int *count)
+{
+    char id[32], text[48];
+    sprintf(id, "node-%d", (*count)++);
+    sprintf(text, "Text of %s", id);
+
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "text", text);
+    HashMapPut(attributes, "spacing", "4");
+    HashMapPut(attributes, "visible", "true");
+    Tree *node = TreeNewAdopt(level == LEVELS - 1 ? button : box, g_strdup(id), NULL, attributes);
+
+    for (int i = 0; level < LEVELS - 1 && i < FANOUT; i++) TreeAddChild(node, buildTree(level + 1, count));
+    return node;
+}
+
+
+int main() {
+    int nodes = 0;
+    Tree *tree = buildTree(0, &nodes);
+
+    // The baseline: a deep copy of the whole tree after each edit
+    static Tree *copies[COPIES];
+    size_t heap = BenchHeapInUse();
+    long long start = BenchNow();
+    for (int i = 0; i < COPIES; i++) copies[i] = deepCopy(tree);
+    double copyTime = (double)(BenchNow() - start) / COPIES;
+    double copyBytes = (double)(BenchHeapInUse() - heap) / COPIES;
+    for (int i = 0; i < COPIES; i++) TreeDestroyAll(copies[i]);
+
+    PersistentTree *initial = PersistentTreeFromTree(tree);
+    TreeDestroyAll(tree);
+    TreeHistory *history = TreeHistoryNew(initial);
+
+    // Random edits: attribute changes, new leaves and removed subtrees, each one a new version
+    int path[MAX_DEPTH], added = 0;
+    char text[32];
+    heap = BenchHeapInUse();
+    start = BenchNow();
+    for (int i = 0; i < EDITS; i++) {
+        const PersistentTree *current = TreeHistoryCurrent(history);
+        int depth = randomPath(current, path);
+        PersistentTree *version;
+
+        // The root cannot be removed, its attributes are changed instead
+        int edit = nextRandom() % 4;
+        if (edit == 1 && depth == 0) edit = 2;
+        switch (edit) {
+            case 0: {
+                sprintf(text, "added-%d", added++);
+                PersistentTree *leaf = PersistentTreeNew(label, text, NULL);
+                version = PersistentTreeAddChild(current, path, depth, leaf);
+                PersistentTreeRelease(leaf);
+                break;
+            }
+            case 1:
+                version = PersistentTreeRemoveChild(current, path, depth);
+                break;
+            default:
+                sprintf(text, "Edit %d", i);
+                version = PersistentTreeSetAttribute(current, path, depth, "text", text);
+                break;
+        }
+        TreeHistoryCommit(history, version);
+    }
+    double editTime = (double)(BenchNow() - start) / EDITS;
+    double editBytes = (double)(BenchHeapInUse() - heap) / EDITS;
+
+    start = BenchNow();
+    int undone = 0;
+    while (TreeHistoryUndo(history) == 1) undone++;
+    double undoTime = (double)(BenchNow() - start) / undone;
+    start = BenchNow();
+    while (TreeHistoryRedo(history) == 1);
+    double redoTime = (double)(BenchNow() - start) / undone;
+
+    printf("nodes: %d, edits: %d (deep copies measured on %d)\n\n", nodes, EDITS, COPIES);
+    printf("%-32s %14s %14s\n", "snapshot per edit", "ns/edit", "bytes/edit");
+    printf("%-32s %14.0f %14.0f\n", "deep copy of the Tree", copyTime, copyBytes);
+    printf("%-32s %14.0f %14.0f\n", "persistent version (path copy)", editTime, editBytes);
+    printf("\n%-32s %14.1f\n", "undo ns/op", undoTime);
+    printf("%-32s %14.1f\n", "redo ns/op", redoTime);
+
+    TreeHistoryFree(history);
+    return 0;
+}
@@ -0,0 +1,134 @@
+/***************************************************************************************************
+ * @file BuildBench.c                                                                              *
+ * @brief Compares TreeBuild with the incremental TreeNew and TreeAddChild calls                   *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Tree.h                                                                                     *
+ **************************************************************************************************/
+
+#include "../../../DataStructure/Tree/Tree.h"
+#define BENCH_COUNT_ALLOCATIONS
+#include "../../Bench.h"
+
+#define ATTRIBUTES 6    // The number of attributes of each node
+
+/*
+ * A producer of layouts holds its nodes as flat records. The incremental way fills a HashMap
+ * per node, which TreeNew copies, then appends the node with TreeAddChild (walking the
+ * children already added). TreeBuild takes the records as they are.
+ */
+
+/**
+ * @brief The shape of a generated tree: every node down to the last level has the same number of children
+ */
+struct Shape
+{
+    const char *name;   ///< The name used in the benchmark names
+    int fanout;         ///< The number of children of each inner node
+    int depth;          ///< The number of levels below the root
+};
+
+static const struct Shape shapes[] = {
+    { "wide", 4096, 1 },
+    { "deep", 1, 4096 },
+    { "balanced", 8, 4 },
+    { "balanced", 8, 5 },
+};
+
+static const char *const attributeKeys[ATTRIBUTES] = { "label", "tooltip", "class", "margin", "visible", "halign" };
+
+
+struct BuildContext
+{
+    int count;              ///< The number of records
+    TreeRecord *records;    ///< The nodes, parents before their children (breadth first)
+    char (*ids)[24];        ///< The ids of the records
+    const char **keys;      ///< The keys of all the attributes
+    const char **values;    ///< The values of all the attributes
+    char (*texts)[16];      ///< The values, one per attribute
+    Tree *root;             ///< The tree built
+};
+
+
+static void buildIncremental(void *data) {
+    struct BuildContext *context = data;
+    Tree **nodes = malloc(context->count * sizeof(Tree *));
+
+    for (int i = 0; i < context->count; i++) {
+        const TreeRecord *record = &context->records[i];
+        HashMap *attributes = HashMapNew();
+        for (int a = record->firstAttribute; a < record->firstAttribute + record->attributeCount; a++) {
+            HashMapPut(attributes, context->keys[a], context->values[a]);
+        }
+
+        nodes[i] = TreeNew(record->type, record->id, NULL, attributes);
+        HashMapFree(attributes);
+        if (i) TreeAddChild(nodes[record->parent], nodes[i]);
+    }
+
+    context->root = nodes[0];
+    free(nodes);
+}
+
+
+static void buildBulk(void *data) {
+    struct BuildContext *context = data;
+    context->root = TreeBuild(context->records, context->count, context->keys, context->values);
+    if (!context->root) abort();
+}
+
+
+static void destroyTree(void *data) {
+    struct BuildContext *context = data;
+    TreeDestroyAll(context->root);
+    context->root = NULL;
+}
+
+
+int main(int argc, char **argv) {
+    BenchInit(argc, argv);
+    char name[64];
+
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        const struct Shape *shape = &shapes[s];
+
+        int count = 1, level = 1;
+        for (int d = 0; d < shape->depth; d++) count += level *= shape->fanout;
+
+        // Give each record its parent, an id and its attributes
+        struct BuildContext context = { .count = count };
+        context.records = malloc(count * sizeof(TreeRecord));
+        context.ids = malloc(count * sizeof(*context.ids));
+        context.keys = malloc(count * ATTRIBUTES * sizeof(const char *));
+        context.values = malloc(count * ATTRIBUTES * sizeof(const char *));
+        context.texts = malloc(count * ATTRIBUTES * sizeof(*context.texts));
+        for (int i = 0; i < count; i++) {
+            sprintf(context.ids[i], "node-%d", i);
+            context.records[i] = (TreeRecord){ i ? (i - 1) / shape->fanout : -1, i ? button : box, context.ids[i],
+                                               i * ATTRIBUTES, ATTRIBUTES };
+            for (int a = 0; a < ATTRIBUTES; a++) {
+                sprintf(context.texts[i * ATTRIBUTES + a], "value-%d", (i + a) % 1000);
+                context.keys[i * ATTRIBUTES + a] = attributeKeys[a];
+                context.values[i * ATTRIBUTES + a] = context.texts[i * ATTRIBUTES + a];
+            }
+        }
+
+        sprintf(name, "Incremental/%s/%d", shape->name, count);
+        BenchMeasure(name, &(BenchCase){ NULL, buildIncremental, destroyTree, &context, count, 0 }, NULL);
+        sprintf(name, "TreeBuild/%s/%d", shape->name, count);
+        BenchMeasure(name, &(BenchCase){ NULL, buildBulk, destroyTree, &context, count, 0 }, NULL);
+
+        free(context.records);
+        free(context.ids);
+        free(context.keys);
+        free(context.values);
+        free(context.texts);
+    }
+
+    return 0;
+}
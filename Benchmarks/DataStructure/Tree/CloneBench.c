@@ -0,0 +1,145 @@
+/***************************************************************************************************
+ * @file CloneBench.c                                                                              *
+ * @brief Compares template instances with components built by deep copies                         *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Tree.h                                                                                     *
+ **************************************************************************************************/
+
+#include "../../../DataStructure/Tree/Tree.h"
+#include "../../Bench.h"
+
+#define INSTANCES 10000 // The number of instances of the component
+#define ROWS 5          // The number of rows of the component, each a box with a label and a button
+#define ATTRIBUTES 6    // The number of attributes of each node
+
+
+struct CopyContext
+{
+    Tree *parent;       ///< The copy the children are added to
+    const char *prefix; ///< The prefix of the ids
+    int bare;           ///< Whether the attributes are left out
+};
+
+
+/**
+ * @brief Copies a node with TreeNew, which copies its id and HashMap (the baseline), or only
+ * allocates the node and its id (the floor)
+ */
+static Tree *copyNode(Tree *node, const char *prefix, int bare)
+{
+    char *id = g_strdup_printf("%s-%s", prefix, TreeGetId(node));
+    Tree *copy;
+    if (bare) copy = TreeNewAdopt(TreeGetType(node), id, NULL, NULL);
+    else {
+        copy = TreeNew(TreeGetType(node), id, NULL, (HashMap *)TreeGetAttributes(node));
+        g_free(id);
+    }
+    return copy;
+}
+
+
+static void copyChild(Tree *child, void *userData)
+{
+    struct CopyContext *context = userData;
+    Tree *copy = copyNode(child, context->prefix, context->bare);
+    TreeAddChild(context->parent, copy);
+
+    struct CopyContext childContext = { copy, context->prefix, context->bare };
+    TreeForEachChild(child, copyChild, &childContext);
+}
+
+
+static Tree *copyTree(Tree *root, const char *prefix, int bare)
+{
+    struct CopyContext context = { copyNode(root, prefix, bare), prefix, bare };
+    TreeForEachChild(root, copyChild, &context);
+    return context.parent;
+}
+
+
+static Tree *deepCopy(Tree *root, const char *prefix)
+{
+    return copyTree(root, prefix, 0);
+}
+
+
+static Tree *bareCopy(Tree *root, const char *prefix)
+{
+    return copyTree(root, prefix, 1);
+}
+
+
+static Tree *newNode(widgetType type, const char *id)
+{
+    HashMap *attributes = HashMapNew();
+    char key[32], value[64];
+    for (int i = 0; i < ATTRIBUTES; i++) {
+        sprintf(key, "property-%d", i);
+        sprintf(value, "the value of the property %d of %s", i, id);
+        HashMapPut(attributes, key, value);
+    }
+    return TreeNewAdopt(type, g_strdup(id), NULL, attributes);
+}
+
+
+/**
+ * @brief Measures the instantiation of the component, returns the time in ns and the bytes per node
+ */
+static double measure(Tree *component, Tree *(*instantiate)(Tree *, const char *), double *bytesPerNode, int nodes)
+{
+    static Tree *instances[INSTANCES];
+    char prefix[32];
+
+    size_t heap = BenchHeapInUse();
+    long long start = BenchNow();
+    for (int i = 0; i < INSTANCES; i++) {
+        sprintf(prefix, "row-%d", i);
+        instances[i] = instantiate(component, prefix);
+    }
+    long long elapsed = BenchNow() - start;
+    *bytesPerNode = (double)(BenchHeapInUse() - heap) / ((double)INSTANCES * nodes);
+
+    for (int i = 0; i < INSTANCES; i++) TreeDestroyAll(instances[i]);
+    return (double)elapsed / ((double)INSTANCES * nodes);
+}
+
+
+int main() {
+    char id[32];
+
+    // A card: a box of rows, each a box with a label and a button
+    Tree *component = newNode(box, "card");
+    for (int i = 0; i < ROWS; i++) {
+        sprintf(id, "row%d", i);
+        Tree *row = newNode(box, id);
+        sprintf(id, "label%d", i);
+        TreeAddChild(row, newNode(label, id));
+        sprintf(id, "button%d", i);
+        TreeAddChild(row, newNode(button, id));
+        TreeAddChild(component, row);
+    }
+    int nodes = 1 + 3 * ROWS;
+
+    // Warm up the allocator, the first instance also marks the attributes of the component as shared
+    double bytes;
+    measure(component, deepCopy, &bytes, nodes);
+    measure(component, TreeInstantiate, &bytes, nodes);
+
+    printf("instances: %d, nodes per instance: %d, attributes per node: %d\n\n", INSTANCES, nodes, ATTRIBUTES);
+    printf("%-28s %12s %12s\n", "instantiation", "ns/node", "bytes/node");
+    double time = measure(component, deepCopy, &bytes, nodes);
+    printf("%-28s %12.1f %12.1f\n", "deep copy (TreeNew)", time, bytes);
+    time = measure(component, TreeInstantiate, &bytes, nodes);
+    printf("%-28s %12.1f %12.1f\n", "TreeInstantiate", time, bytes);
+    time = measure(component, bareCopy, &bytes, nodes);
+    printf("%-28s %12.1f %12.1f\n", "nodes and ids only", time, bytes);
+
+    TreeDestroyAll(component);
+    return 0;
+}
@@ -0,0 +1,138 @@
+/***************************************************************************************************
+ * @file TreeBench.c                                                                               *
+ * @brief Measures the operations of the Tree on trees of varying width and depth                  *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Tree.h                                                                                     *
+ **************************************************************************************************/
+
+#include "../../../DataStructure/Tree/Tree.h"
+#define BENCH_COUNT_ALLOCATIONS
+#include "../../Bench.h"
+
+#define LOOKUPS 64  // The number of nodes looked up by TreeGetNode and TreeGetParent
+
+
+/**
+ * @brief The shape of a generated tree: every node down to the last level has the same number of children
+ */
+struct Shape
+{
+    const char *name;   ///< The name used in the benchmark names
+    int fanout;         ///< The number of children of each inner node
+    int depth;          ///< The number of levels below the root
+};
+
+static const struct Shape shapes[] = {
+    { "wide", 4096, 1 },
+    { "deep", 1, 4096 },
+    { "balanced", 8, 4 },
+};
+
+
+struct TreeContext
+{
+    const struct Shape *shape;
+    int count;          ///< The number of nodes
+    Tree **nodes;       ///< The nodes, parents before their children (breadth first)
+    int *parents;       ///< The index of the parent of each node (-1 for the root)
+    Tree *root;         ///< The tree measured
+    Tree *targets[LOOKUPS];     ///< The nodes looked up, spread over the tree
+    char ids[LOOKUPS][24];      ///< Their ids
+};
+
+
+/** @brief Makes the nodes of a shape, without linking them */
+static void newNodes(void *data) {
+    struct TreeContext *context = data;
+    char id[24];
+    for (int i = 0; i < context->count; i++) {
+        sprintf(id, "node-%d", i);
+        context->nodes[i] = TreeNewAdopt(i ? button : box, g_strdup(id), NULL, NULL);
+    }
+    context->root = context->nodes[0];
+}
+
+
+static void linkNodes(void *data) {
+    struct TreeContext *context = data;
+    for (int i = 1; i < context->count; i++) TreeAddChild(context->nodes[context->parents[i]], context->nodes[i]);
+}
+
+
+static void buildTree(void *data) {
+    newNodes(data);
+    linkNodes(data);
+}
+
+
+static void destroyTree(void *data) {
+    struct TreeContext *context = data;
+    TreeDestroyAll(context->root);
+    context->root = NULL;
+}
+
+
+static void runGetNode(void *data) {
+    struct TreeContext *context = data;
+    for (int i = 0; i < LOOKUPS; i++) {
+        if (!TreeGetNode(context->root, context->ids[i])) abort();
+    }
+}
+
+
+static void runGetParent(void *data) {
+    struct TreeContext *context = data;
+    for (int i = 0; i < LOOKUPS; i++) {
+        if (!TreeGetParent(context->root, context->targets[i])) abort();
+    }
+}
+
+
+int main(int argc, char **argv) {
+    BenchInit(argc, argv);
+    char name[64];
+
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        const struct Shape *shape = &shapes[s];
+
+        // Count the nodes level by level, and give each one its parent
+        int count = 1, level = 1;
+        for (int d = 0; d < shape->depth; d++) count += level *= shape->fanout;
+
+        struct TreeContext context = { .shape = shape, .count = count };
+        context.nodes = malloc(count * sizeof(Tree *));
+        context.parents = malloc(count * sizeof(int));
+        context.parents[0] = -1;
+        for (int i = 1; i < count; i++) context.parents[i] = (i - 1) / shape->fanout;
+
+        sprintf(name, "TreeAddChild/%s/%d", shape->name, count);
+        BenchMeasure(name, &(BenchCase){ newNodes, linkNodes, destroyTree, &context, count - 1, 0 }, NULL);
+
+        // The lookups search the same tree, for nodes spread over it (the deepest last)
+        buildTree(&context);
+        for (int i = 0; i < LOOKUPS; i++) {
+            int index = 1 + (int)((long)(count - 2) * (i + 1) / LOOKUPS);
+            context.targets[i] = context.nodes[index];
+            sprintf(context.ids[i], "node-%d", index);
+        }
+        sprintf(name, "TreeGetNode/%s/%d", shape->name, count);
+        BenchMeasure(name, &(BenchCase){ NULL, runGetNode, NULL, &context, LOOKUPS, 0 }, NULL);
+        sprintf(name, "TreeGetParent/%s/%d", shape->name, count);
+        BenchMeasure(name, &(BenchCase){ NULL, runGetParent, NULL, &context, LOOKUPS, 0 }, NULL);
+        destroyTree(&context);
+
+        sprintf(name, "TreeDestroyAll/%s/%d", shape->name, count);
+        BenchMeasure(name, &(BenchCase){ buildTree, destroyTree, NULL, &context, count, 0 }, NULL);
+
+        free(context.nodes);
+        free(context.parents);
+    }
+
+    return 0;
+}
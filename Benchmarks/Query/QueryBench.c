@@ -0,0 +1,140 @@
+/***************************************************************************************************
+ * @file QueryBench.c                                                                              *
+ * @brief Compares indexed selector queries with walks of the whole tree                           *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Query.h                                                                                    *
+ **************************************************************************************************/
+
+#include "../../Query/Query.h"
+#include "../Bench.h"
+
+#define BOXES 1000      // The number of boxes under the window
+#define BUTTONS 100     // The number of buttons in each box
+
+static int matched;     // Keeps the walks from being optimized away
+
+
+/**
+ * @brief Counts the buttons labelled "Seven", the walk a query without index does
+ */
+static visitResult countSevens(Tree *node, int depth, void *userData)
+{
+    (void)depth;
+    (void)userData;
+    if (TreeGetType(node) == button) {
+        const char *value = HashMapGet(TreeGetAttributes(node), "label");
+        if (value && strcmp(value, "Seven") == 0) matched++;
+    }
+    return visitContinue;
+}
+
+
+/**
+ * @brief Counts the buttons under a box
+ */
+static visitResult countButtons(Tree *node, int depth, void *userData)
+{
+    (void)userData;
+    if (TreeGetType(node) == button && depth >= 2) matched++;
+    return visitContinue;
+}
+
+
+/**
+ * @brief Counts the buttons among the children of a box
+ */
+static void countChildButtons(Tree *child, void *userData)
+{
+    (void)userData;
+    if (TreeGetType(child) == button) matched++;
+}
+
+
+/**
+ * @brief Returns the time of one query, in nanoseconds, checking its number of results
+ */
+static double timeQuery(TreeIndex *index, const char *text, int repeat, int expected)
+{
+    Selector *selector = SelectorCompile(text);
+    long long start = BenchNow();
+    for (int i = 0; i < repeat; i++) {
+        Tree **results;
+        if (QuerySelectAll(index, NULL, selector, &results) != expected) {
+            printf("%s: wrong number of results\n", text);
+            exit(1);
+        }
+        free(results);
+    }
+    double elapsed = (double)(BenchNow() - start) / repeat;
+    SelectorFree(selector);
+    return elapsed;
+}
+
+
+int main() {
+    char id[32];
+
+    // A window of boxes of buttons, the 7th button of each box labelled "Seven"
+    Tree *root = TreeNew(window, "main", NULL, NULL);
+    for (int i = 0; i < BOXES; i++) {
+        sprintf(id, "box%d", i);
+        Tree *row = TreeNew(box, id, NULL, NULL);
+        for (int j = 0; j < BUTTONS; j++) {
+            HashMap *attributes = HashMapNew();
+            HashMapPut(attributes, "label", j == 7 ? "Seven" : "Other");
+            sprintf(id, "button%d_%d", i, j);
+            TreeAddChild(row, TreeNew(button, id, NULL, attributes));
+            HashMapFree(attributes);
+        }
+        TreeAddChild(root, row);
+    }
+    int nodes = 1 + BOXES + BOXES * BUTTONS;
+
+    // The index is built by the first query
+    TreeIndex *index = TreeIndexNew(root);
+    TreeIndexAddAttribute(index, "label");
+    long long start = BenchNow();
+    TreeIndexSize(index);
+    double buildTime = BenchNow() - start;
+
+    printf("nodes: %d, index built in %.2f ms (%.1f ns/node)\n\n", nodes, buildTime / 1e6, buildTime / nodes);
+    printf("%-28s %14s %14s %10s\n", "query", "walk ns/op", "index ns/op", "speedup");
+
+    // By id
+    start = BenchNow();
+    for (int i = 0; i < 10; i++) matched += TreeGetNode(root, "button500_7") != NULL;
+    double walk = (double)(BenchNow() - start) / 10;
+    double indexed = timeQuery(index, "#button500_7", 10000, 1);
+    printf("%-28s %14.0f %14.0f %9.0fx\n", "#button500_7", walk, indexed, walk / indexed);
+
+    // By the value of an indexed attribute
+    start = BenchNow();
+    for (int i = 0; i < 10; i++) TreeVisit(root, countSevens, NULL);
+    walk = (double)(BenchNow() - start) / 10;
+    indexed = timeQuery(index, "button[label=Seven]", 100, BOXES);
+    printf("%-28s %14.0f %14.0f %9.0fx\n", "button[label=Seven]", walk, indexed, walk / indexed);
+
+    // The children of a node found by id
+    start = BenchNow();
+    for (int i = 0; i < 10; i++) TreeForEachChild(TreeGetNode(root, "box500"), countChildButtons, NULL);
+    walk = (double)(BenchNow() - start) / 10;
+    indexed = timeQuery(index, "#box500 > button", 1000, BUTTONS);
+    printf("%-28s %14.0f %14.0f %9.0fx\n", "#box500 > button", walk, indexed, walk / indexed);
+
+    // Not selective, every button matches
+    start = BenchNow();
+    for (int i = 0; i < 10; i++) TreeVisit(root, countButtons, NULL);
+    walk = (double)(BenchNow() - start) / 10;
+    indexed = timeQuery(index, "box button", 10, BOXES * BUTTONS);
+    printf("%-28s %14.0f %14.0f %9.1fx\n", "box button", walk, indexed, walk / indexed);
+
+    TreeIndexFree(index);
+    TreeDestroyAll(root);
+    return matched == 0;
+}
@@ -0,0 +1,320 @@
+/***************************************************************************************************
+ * @file BuilderBench.c                                                                            *
+ * @brief Compares the load of an interface with GtkBuilder's, for the same documents              *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Corpus.h                                                                                   *
+ **************************************************************************************************/
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../../Renderer/Renderer.h"
+#include "../../Renderer/AttributeRegistry.h"
+#include "../../Scanner/Scanner.h"
+#include "../Corpus/Corpus.h"
+#include "../Bench.h"
+
+/*
+ * The same generated interface is loaded from its markup (Scanner, then Renderer) and from its
+ * GtkBuilder .ui equivalent. Each loader runs in a process of its own, forked before GTK starts,
+ * so that its peak RSS is its own; the first load of the process gives the peak, the following
+ * ones the times.
+ *
+ * GtkBuilder parses and constructs in one pass: its parse is the floor of a GMarkup pass with no
+ * callbacks over the .ui, and its construction the rest. The windows are never shown, so any
+ * display will do; on a machine without one, run it under Xvfb (xvfb-run -a ./BuilderBench) or
+ * the Broadway backend (GDK_BACKEND=broadway with gtk4-broadwayd running).
+ */
+
+/**
+ * @brief The sizes of the markup documents, the .ui files are about three times larger
+ */
+static const struct
+{
+    const char *name;   ///< The name used in the results
+    size_t bytes;       ///< The size wanted
+} sizes[] = {
+    { "32KB", 32UL << 10 },
+    { "1MB", 1UL << 20 },
+    { "8MB", 8UL << 20 },
+};
+
+
+static const char *const classNames[WIDGET_TYPE_COUNT] = { "GtkWindow", "GtkHeaderBar", "GtkBox", "GtkGrid", "GtkLabel", "GtkButton" };
+
+
+/**
+ * @brief What a load measured, sent back by the process that ran it
+ */
+struct LoadResult
+{
+    int ok;                 ///< Whether the loader succeeded
+    double parseMs;         ///< The median time of the parse
+    double constructMs;     ///< The median time of the construction of the widgets
+    long peakKilobytes;     ///< The growth of the peak RSS over the first load
+};
+
+
+struct UiContext
+{
+    GString *ui;        ///< The .ui written so far
+    int depth;          ///< The indentation of the element written
+    widgetType type;    ///< Its type
+    int row;            ///< Its row in its parent grid, or -1
+    int index;          ///< The index of its next child
+};
+
+
+static void writeIndent(GString *ui, int depth) {
+    for (int i = 0; i < depth; i++) g_string_append(ui, "  ");
+}
+
+
+static void writeProperty(const char *key, const char *value, void *data) {
+    struct UiContext *context = data;
+
+    // The attributes without an equivalent (the "dataN" ones) are left out, as the Renderer ignores them
+    const AttributeDescriptor *descriptor = AttributeRegistryLookup(context->type, AtomIntern(key));
+    if (!descriptor) return;
+
+    writeIndent(context->ui, context->depth + 1);
+    if (strcmp(key, "class") == 0) g_string_append_printf(context->ui, "<style><class name=\"%s\"/></style>\n", value);
+    else g_string_append_printf(context->ui, "<property name=\"%s\">%s</property>\n",
+                                descriptor->property ? descriptor->property : key, value);
+}
+
+
+static void writeChild(Tree *node, void *data);
+
+
+/**
+ * @brief Writes an element and its children as a GtkBuilder object
+ */
+static void writeObject(Tree *node, struct UiContext *context) {
+    GString *ui = context->ui;
+
+    writeIndent(ui, context->depth);
+    g_string_append_printf(ui, "<object class=\"%s\" id=\"%s\">\n", classNames[context->type], TreeGetId(node));
+
+    // The Renderer makes vertical boxes, GtkBox is horizontal by default
+    const HashMap *attributes = TreeGetAttributes(node);
+    if (context->type == box && !(attributes && HashMapContainsKey(attributes, "orientation") == 1)) {
+        writeIndent(ui, context->depth + 1);
+        g_string_append(ui, "<property name=\"orientation\">vertical</property>\n");
+    }
+    if (attributes) HashMapForEach(attributes, writeProperty, context);
+
+    TreeForEachChild(node, writeChild, context);
+
+    // The Renderer puts the children of a grid in column 0, one row each
+    if (context->row >= 0) {
+        writeIndent(ui, context->depth + 1);
+        g_string_append_printf(ui, "<layout><property name=\"column\">0</property><property name=\"row\">%d</property></layout>\n",
+                               context->row);
+    }
+
+    writeIndent(ui, context->depth);
+    g_string_append(ui, "</object>\n");
+}
+
+
+static void writeChild(Tree *node, void *data) {
+    struct UiContext *parent = data;
+
+    writeIndent(parent->ui, parent->depth + 1);
+    g_string_append(parent->ui, parent->type == headerBar ? "<child type=\"start\">\n" : "<child>\n");
+
+    struct UiContext context = { parent->ui, parent->depth + 2, TreeGetType(node), parent->type == grid ? parent->index : -1, 0 };
+    writeObject(node, &context);
+    parent->index++;
+
+    writeIndent(parent->ui, parent->depth + 1);
+    g_string_append(parent->ui, "</child>\n");
+}
+
+
+static char *writeUi(Tree *root, size_t *length) {
+    GString *ui = g_string_new("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<interface>\n");
+    struct UiContext context = { ui, 1, TreeGetType(root), -1, 0 };
+    writeObject(root, &context);
+    g_string_append(ui, "</interface>\n");
+    *length = ui->len;
+    return g_string_free(ui, FALSE);
+}
+
+
+static long peakKilobytes(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+
+static int compareDoubles(const void *first, const void *second) {
+    double a = *(const double *)first, b = *(const double *)second;
+    return (a > b) - (a < b);
+}
+
+
+/**
+ * @brief Loads the markup with the Scanner and the Renderer, once
+ */
+static int loadMarkup(const char *markup, size_t length, double *parseMs, double *constructMs, long *peak, long baseline) {
+    long long start = BenchNow();
+    FILE *file = fmemopen((void *)markup, length, "r");
+    Tree *tree = performLexicalAnalysis(file);
+    fclose(file);
+    long long parsed = BenchNow();
+    int ok = tree && RendererRealize(tree) == 1;
+    long long constructed = BenchNow();
+
+    *parseMs = (parsed - start) / 1e6;
+    *constructMs = (constructed - parsed) / 1e6;
+    if (peak) *peak = peakKilobytes() - baseline;
+
+    if (tree && TreeGetWidget(tree)) gtk_window_destroy(GTK_WINDOW(TreeGetWidget(tree)));
+    TreeDestroyAll(tree);
+    return ok;
+}
+
+
+/**
+ * @brief Loads the .ui with GtkBuilder, once, after a bare GMarkup pass over it
+ */
+static int loadUi(const char *ui, size_t length, double *parseMs, double *constructMs, long *peak, long baseline) {
+    static const GMarkupParser noCallbacks = { NULL, NULL, NULL, NULL, NULL };
+
+    long long start = BenchNow();
+    GMarkupParseContext *parser = g_markup_parse_context_new(&noCallbacks, 0, NULL, NULL);
+    int ok = g_markup_parse_context_parse(parser, ui, length, NULL) && g_markup_parse_context_end_parse(parser, NULL);
+    g_markup_parse_context_free(parser);
+    long long parsed = BenchNow();
+
+    GError *error = NULL;
+    GtkBuilder *builder = gtk_builder_new();
+    ok = ok && gtk_builder_add_from_string(builder, ui, length, &error);
+    long long loaded = BenchNow();
+
+    // GtkBuilder parses the .ui again while it builds the widgets
+    *parseMs = (parsed - start) / 1e6;
+    *constructMs = (loaded - parsed) / 1e6 - *parseMs;
+    if (peak) *peak = peakKilobytes() - baseline;
+
+    if (error) {
+        fprintf(stderr, "GtkBuilder: %s\n", error->message);
+        g_error_free(error);
+    }
+    GObject *root = gtk_builder_get_object(builder, "n0");
+    if (root) gtk_window_destroy(GTK_WINDOW(root));
+    g_object_unref(builder);
+    return ok;
+}
+
+
+/**
+ * @brief Runs the repetitions of a loader in a process of its own
+ */
+static struct LoadResult measure(int (*load)(const char *, size_t, double *, double *, long *, long),
+                                 const char *document, size_t length) {
+    struct LoadResult result = { 0, 0, 0, 0 };
+    int channel[2];
+    if (pipe(channel) == -1) return result;
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(channel[0]);
+        if (gtk_init_check()) {
+            int repetitions = benchOptions.repetitions;
+            double *parse = malloc(repetitions * sizeof(double)), *construct = malloc(repetitions * sizeof(double));
+
+            long baseline = peakKilobytes();
+            result.ok = load(document, length, &parse[0], &construct[0], &result.peakKilobytes, baseline);
+            for (int i = 1; result.ok && i < repetitions; i++) result.ok = load(document, length, &parse[i], &construct[i], NULL, 0);
+
+            qsort(parse, repetitions, sizeof(double), compareDoubles);
+            qsort(construct, repetitions, sizeof(double), compareDoubles);
+            result.parseMs = parse[repetitions / 2];
+            result.constructMs = construct[repetitions / 2];
+            free(parse);
+            free(construct);
+        }
+        else fprintf(stderr, "No display: run under xvfb-run -a, or with GDK_BACKEND=broadway\n");
+
+        if (write(channel[1], &result, sizeof(result)) != sizeof(result)) _exit(1);
+        _exit(0);
+    }
+
+    close(channel[1]);
+    if (child > 0) {
+        if (read(channel[0], &result, sizeof(result)) != sizeof(result)) result.ok = 0;
+        waitpid(child, NULL, 0);
+    }
+    close(channel[0]);
+    return result;
+}
+
+
+static void report(const char *size, const char *loader, long widgets, size_t length, const struct LoadResult *result) {
+    if (!result->ok) {
+        printf(benchOptions.json ? "{\"size\":\"%s\",\"loader\":\"%s\",\"failed\":true}\n" : "%-6s %-12s failed\n", size, loader);
+        return;
+    }
+
+    double total = result->parseMs + result->constructMs;
+    if (benchOptions.json) {
+        printf("{\"size\":\"%s\",\"loader\":\"%s\",\"widgets\":%ld,\"bytes\":%zu,\"parse_ms\":%.2f,\"construct_ms\":%.2f,"
+               "\"total_ms\":%.2f,\"us_per_widget\":%.3f,\"peak_rss_kb\":%ld}\n", size, loader, widgets, length,
+               result->parseMs, result->constructMs, total, total * 1000 / widgets, result->peakKilobytes);
+    }
+    else {
+        printf("%-6s %-12s %8ld %10zu %10.2f %13.2f %10.2f %10.3f %13.1f\n", size, loader, widgets, length, result->parseMs,
+               result->constructMs, total, total * 1000 / widgets, result->peakKilobytes / 1024.0);
+    }
+    fflush(stdout);
+}
+
+
+int main(int argc, char **argv) {
+    // Widgets are slow to build: fewer repetitions unless more are asked for
+    benchOptions.repetitions = 5;
+    BenchInit(argc, argv);
+
+    if (!benchOptions.json) {
+        printf("%-6s %-12s %8s %10s %10s %13s %10s %10s %13s\n", "size", "loader", "widgets", "bytes", "parse ms",
+               "construct ms", "total ms", "µs/widget", "peak RSS MB");
+    }
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        CorpusOptions options;
+        CorpusDefaultOptions(&options);
+        options.nodes = CorpusNodesForSize(&options, sizes[s].bytes);
+
+        // Both documents come from the same tree: the markup is what the generator writes
+        char *markup;
+        size_t markupLength;
+        FILE *file = open_memstream(&markup, &markupLength);
+        CorpusWriteMarkup(&options, file);
+        fclose(file);
+
+        Tree *tree = CorpusBuildTree(&options);
+        size_t uiLength;
+        char *ui = writeUi(tree, &uiLength);
+        TreeDestroyAll(tree);
+
+        struct LoadResult result = measure(loadMarkup, markup, markupLength);
+        report(sizes[s].name, "markup", options.nodes, markupLength, &result);
+        result = measure(loadUi, ui, uiLength);
+        report(sizes[s].name, "gtkbuilder", options.nodes, uiLength, &result);
+
+        free(markup);
+        g_free(ui);
+    }
+
+    return 0;
+}
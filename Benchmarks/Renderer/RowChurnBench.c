@@ -0,0 +1,141 @@
+/***************************************************************************************************
+ * @file RowChurnBench.c                                                                           *
+ * @brief Measures a list whose rows are constantly replaced, with and without widget pools        *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see WidgetPool.h                                                                               *
+ **************************************************************************************************/
+
+#include "../../Renderer/Renderer.h"
+#include "../../Renderer/Transaction.h"
+#include "../../Renderer/WidgetPool.h"
+#define BENCH_COUNT_ALLOCATIONS // GLib and GTK allocate through malloc too
+#include "../Bench.h"
+
+#define ROWS 200        // The number of rows of the list
+#define CHURN 20        // The number of rows replaced each frame
+#define FRAMES 500      // The number of frames measured
+
+/**
+ * @brief Builds a row: a box with a label and a button
+ */
+static Tree *newRow(int index) {
+    char id[32], text[64];
+
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "orientation", "horizontal");
+    HashMapPut(attributes, "spacing", "6");
+    sprintf(id, "row%d", index);
+    Tree *row = TreeNew(box, id, NULL, attributes);
+    HashMapFree(attributes);
+
+    attributes = HashMapNew();
+    sprintf(text, "Item number %d", index);
+    HashMapPut(attributes, "text", text);
+    HashMapPut(attributes, "hexpand", "true");
+    sprintf(id, "label%d", index);
+    TreeAddChild(row, TreeNew(label, id, NULL, attributes));
+    HashMapFree(attributes);
+
+    attributes = HashMapNew();
+    HashMapPut(attributes, "label", "Remove");
+    HashMapPut(attributes, "class", "destructive-action");
+    sprintf(id, "button%d", index);
+    TreeAddChild(row, TreeNew(button, id, NULL, attributes));
+    HashMapFree(attributes);
+
+    return row;
+}
+
+
+/**
+ * @brief Replaces the oldest rows of the list with new ones, frame after frame
+ *
+ * A removed row gives back its label and button first, then its box, as TransactionRemoveChild
+ * only removes leaves. Returns the mean time of a frame in µs, and the allocations per frame.
+ */
+static double churn(Tree *list, int *first, int *next, int frames, double *allocationsPerFrame) {
+    char id[32];
+    long long elapsed = 0;
+    unsigned long allocated = 0;
+
+    for (int frame = 0; frame < frames; frame++) {
+        unsigned long before = BenchAllocations();
+        long long start = BenchNow();
+
+        Transaction *transaction = TransactionBegin(list);
+        for (int i = 0; i < CHURN; i++, (*first)++) {
+            sprintf(id, "row%d", *first);
+            Tree *row = TreeGetNode(list, id);
+            sprintf(id, "label%d", *first);
+            TransactionRemoveChild(transaction, row, id);
+            sprintf(id, "button%d", *first);
+            TransactionRemoveChild(transaction, row, id);
+            sprintf(id, "row%d", *first);
+            TransactionRemoveChild(transaction, list, id);
+        }
+        for (int i = 0; i < CHURN; i++) TransactionAddChild(transaction, list, newRow((*next)++));
+        TransactionCommit(transaction);
+
+        elapsed += BenchNow() - start;
+        allocated += BenchAllocations() - before;
+    }
+
+    *allocationsPerFrame = (double)allocated / frames;
+    return (double)elapsed / frames / 1000.0;
+}
+
+
+static void printPools(void) {
+    const widgetType types[] = { box, label, button };
+    const char *names[] = { "box", "label", "button" };
+
+    for (int i = 0; i < 3; i++) {
+        WidgetPoolStats stats;
+        WidgetPoolGetStats(types[i], &stats);
+        printf("  %-8s hits %8lu  misses %8lu  recycled %8lu  dropped %8lu  size %4d/%d\n", names[i],
+               stats.hits, stats.misses, stats.recycled, stats.dropped, stats.size, stats.capacity);
+    }
+}
+
+
+static void run(const char *name, int capacity) {
+    const widgetType types[] = { box, label, button };
+    for (int i = 0; i < 3; i++) WidgetPoolSetCapacity(types[i], capacity);
+    WidgetPoolClear();
+
+    // The list is realized once, then only the transactions touch the widgets
+    Tree *list = TreeNew(box, "list", NULL, NULL);
+    for (int i = 0; i < ROWS; i++) TreeAddChild(list, newRow(i));
+    RendererRealize(list);
+    GtkWidget *widget = g_object_ref_sink(TreeGetWidget(list));
+
+    int first = 0, next = ROWS;
+    double allocationsPerFrame;
+    churn(list, &first, &next, FRAMES / 10, &allocationsPerFrame);
+    double frameTime = churn(list, &first, &next, FRAMES, &allocationsPerFrame);
+
+    printf("%-24s %14.1f %18.1f\n", name, frameTime, allocationsPerFrame);
+    printPools();
+
+    TreeDestroyAll(list);
+    g_object_unref(widget);
+}
+
+
+int main() {
+    gtk_init();
+
+    printf("rows: %d, rows replaced per frame: %d, frames: %d\n\n", ROWS, CHURN, FRAMES);
+    printf("%-24s %14s %18s\n", "widgets", "µs/frame", "allocations/frame");
+    run("created (no pool)", 0);
+    run("recycled (pool)", WIDGET_POOL_DEFAULT_CAPACITY);
+
+    WidgetPoolClear();
+    return 0;
+}
@@ -0,0 +1,106 @@
+/***************************************************************************************************
+ * @file VirtualGridBench.c                                                                        *
+ * @brief Measures the memory and the scroll frame time of virtualized grids                       *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see VirtualGrid.h                                                                              *
+ **************************************************************************************************/
+
+#include "../../Renderer/Renderer.h"
+#include "../../Renderer/VirtualGrid.h"
+#include "../Bench.h"
+
+#define VISIBLE 40      // The number of rows in the viewport
+#define ROW_HEIGHT 24   // The height of a row, in pixels
+#define FRAMES 1000     // The number of scroll frames measured
+#define STEP 3          // The number of rows scrolled each frame
+
+
+static RowModel *newModel(int rows) {
+    RowModel *model = RowModelNew();
+    RowModelAddColumn(model, label, NULL, "text");
+    RowModelAddColumn(model, label, NULL, "text");
+    RowModelAddColumn(model, button, NULL, "label");
+
+    char name[32], size[32];
+    for (int i = 0; i < rows; i++) {
+        sprintf(name, "file-%d.txt", i);
+        sprintf(size, "%d KB", (i * 37) % 4096);
+        const char *values[] = { name, size, "Open" };
+        RowModelAppendRow(model, values);
+    }
+    return model;
+}
+
+
+/**
+ * @brief Scrolls a virtualized grid of some rows, prints the heap it uses and the time of a frame
+ */
+static void measureVirtual(int rows) {
+    size_t heap = BenchHeapInUse();
+
+    Tree *table = TreeNew(grid, "table", NULL, NULL);
+    RendererRealize(table);
+    GtkWidget *widget = g_object_ref_sink(TreeGetWidget(table));
+    TreeSetRowModel(table, newModel(rows));
+
+    VirtualGrid *virtualGrid = VirtualGridNew(table, ROW_HEIGHT, VIRTUAL_GRID_DEFAULT_OVERSCAN);
+    VirtualGridSetViewport(virtualGrid, 0, VISIBLE);
+    size_t used = BenchHeapInUse() - heap;
+
+    long long start = BenchNow();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        VirtualGridSetViewport(virtualGrid, (frame * STEP) % (rows - VISIBLE), VISIBLE);
+    }
+    double frameTime = (double)(BenchNow() - start) / FRAMES / 1000.0;
+
+    printf("%-14s %8d %14.1f %12.1f\n", "virtualized", rows, used / 1024.0, frameTime);
+
+    VirtualGridFree(virtualGrid);
+    TreeDestroyAll(table);
+    g_object_unref(widget);
+}
+
+
+/**
+ * @brief Builds a grid with a node and a widget for every cell, prints the heap it uses and the build time
+ */
+static void measureMaterialized(int rows) {
+    size_t heap = BenchHeapInUse();
+    long long start = BenchNow();
+
+    Tree *table = TreeNew(grid, "table", NULL, NULL);
+    RowModel *model = newModel(rows);
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < 3; column++) TreeAddChild(table, RowModelNewCell(model, "table", row, column));
+    }
+    RowModelFree(model);
+    RendererRealize(table);
+    GtkWidget *widget = g_object_ref_sink(TreeGetWidget(table));
+
+    double buildTime = (double)(BenchNow() - start) / 1000.0;
+    printf("%-14s %8d %14.1f %12s (built in %.0f µs)\n", "materialized", rows, (BenchHeapInUse() - heap) / 1024.0, "-", buildTime);
+
+    TreeDestroyAll(table);
+    g_object_unref(widget);
+}
+
+
+int main() {
+    gtk_init();
+
+    printf("columns: 3, visible rows: %d, overscan: %d, frames: %d scrolling %d rows each\n\n",
+           VISIBLE, VIRTUAL_GRID_DEFAULT_OVERSCAN, FRAMES, STEP);
+    printf("%-14s %8s %14s %12s\n", "grid", "rows", "heap (KB)", "µs/frame");
+
+    const int sizes[] = { 1000, 10000, 100000 };
+    for (int i = 0; i < 3; i++) measureVirtual(sizes[i]);
+    for (int i = 0; i < 2; i++) measureMaterialized(sizes[i]);
+
+    return 0;
+}
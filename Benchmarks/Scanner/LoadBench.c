@@ -0,0 +1,240 @@
+/***************************************************************************************************
+ * @file LoadBench.c                                                                               *
+ * @brief Measures the phases of loading a generated document, from 1 KB to 1 GB                   *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Corpus.h                                                                                   *
+ **************************************************************************************************/
+
+#include "../../Scanner/Scanner.h"
+#include "../Corpus/Corpus.h"
+#include "../../Utils/Trace.h"
+#define BENCH_COUNT_ALLOCATIONS
+#include "../Bench.h"
+
+/*
+ * The Scanner builds the tree while it reads the markup, so the scan is not timed alone: the
+ * build is timed by replaying the calls the Scanner makes for each element (HashMapNew,
+ * HashMapPut, TreeNewAdopt, TreeAddChild) from records prepared beforehand, and the scan is the
+ * difference between the whole load and that build.
+ *
+ * The documents up to --max-size (32MB by default) are measured; --max-size=1G measures all of
+ * them and needs several GB of memory for the trees.
+ *
+ * Built with -DTRACE_ENABLED, --trace=FILE writes the spans of the last runs to FILE in the
+ * Chrome trace format (the ring buffer keeps the last TRACE_BUFFER_EVENTS spans only).
+ */
+
+/**
+ * @brief The sizes of the documents
+ */
+static const struct
+{
+    const char *name;   ///< The name used in the benchmark names
+    size_t bytes;       ///< The size wanted
+} sizes[] = {
+    { "1KB", 1UL << 10 },
+    { "32KB", 32UL << 10 },
+    { "1MB", 1UL << 20 },
+    { "32MB", 32UL << 20 },
+    { "1GB", 1UL << 30 },
+};
+
+
+/**
+ * @brief An element of the document, as the Scanner sees it when it opens the element
+ */
+struct Record
+{
+    widgetType type;
+    const char *id;
+    long parent;        ///< The index of the record of the parent, or -1 for the root
+    int count;          ///< The number of attributes
+    const char **keys;
+    const char **values;
+};
+
+
+struct LoadContext
+{
+    FILE *file;             ///< The markup of the document
+    char *buffer;           ///< Where read reads it
+    size_t length;          ///< Its length in bytes
+    Tree *source;           ///< The tree of the document, built by the generator
+    struct Record *records; ///< Its elements, in the order of the markup
+    long count;             ///< The number of elements
+    Tree **nodes;           ///< The nodes built by the replay, by record
+    Tree *tree;             ///< The tree built by the last run
+    long *lastAtDepth;      ///< Used while recording, the index of the last record at each depth
+};
+
+
+static void recordAttribute(const char *key, const char *value, void *data) {
+    struct Record *record = data;
+    record->keys[record->count] = key;
+    record->values[record->count++] = value;
+}
+
+
+static visitResult recordNode(Tree *node, int depth, void *data) {
+    struct LoadContext *context = data;
+    struct Record *record = &context->records[context->count];
+    const HashMap *attributes = TreeGetAttributes(node);
+    int size = attributes ? HashMapSize(attributes) : 0;
+
+    record->type = TreeGetType(node);
+    record->id = TreeGetId(node);
+    record->parent = depth ? context->lastAtDepth[depth - 1] : -1;
+    record->count = 0;
+    record->keys = malloc((size + 1) * sizeof(char *));
+    record->values = malloc((size + 1) * sizeof(char *));
+    if (attributes) HashMapForEach(attributes, recordAttribute, record);
+
+    context->lastAtDepth[depth] = context->count++;
+    return visitContinue;
+}
+
+
+static void runRead(void *data) {
+    struct LoadContext *context = data;
+    rewind(context->file);
+    if (fread(context->buffer, 1, context->length, context->file) != context->length) abort();
+}
+
+
+static void runLoad(void *data) {
+    struct LoadContext *context = data;
+    rewind(context->file);
+    context->tree = performLexicalAnalysis(context->file);
+    if (!context->tree) abort();
+}
+
+
+static void runBuild(void *data) {
+    struct LoadContext *context = data;
+
+    for (long i = 0; i < context->count; i++) {
+        const struct Record *record = &context->records[i];
+        HashMap *attributes = HashMapNew();
+        HashMapPut(attributes, "id", record->id);
+        for (int a = 0; a < record->count; a++) HashMapPut(attributes, record->keys[a], record->values[a]);
+
+        char *id = g_strdup(HashMapGet(attributes, "id"));
+        HashMapRemove(attributes, "id");
+        context->nodes[i] = TreeNewAdopt(record->type, id, NULL, attributes);
+        if (record->parent >= 0) TreeAddChild(context->nodes[record->parent], context->nodes[i]);
+    }
+    context->tree = context->nodes[0];
+}
+
+
+static void runDestroy(void *data) {
+    struct LoadContext *context = data;
+    TreeDestroyAll(context->tree);
+}
+
+
+/** @brief The scan alone: the whole load minus the build, only the medians can be subtracted */
+static BenchResult subtract(const BenchResult *load, const BenchResult *build, long operations, size_t bytes) {
+    BenchResult scan;
+    scan.nsPerOp = load->nsPerOp - build->nsPerOp;
+    scan.minNsPerOp = NAN;
+    scan.deviation = NAN;
+    scan.allocationsPerOp = load->allocationsPerOp - build->allocationsPerOp;
+    scan.megabytesPerSecond = scan.nsPerOp > 0 ? bytes / (scan.nsPerOp * operations) * 1e9 / (1024 * 1024) : 0;
+    return scan;
+}
+
+
+static void measure(const char *sizeName, size_t bytes) {
+    CorpusOptions options;
+    CorpusDefaultOptions(&options);
+    options.nodes = CorpusNodesForSize(&options, bytes);
+
+    struct LoadContext context = { tmpfile(), NULL, 0, NULL, NULL, 0, NULL, NULL, NULL };
+    long written = CorpusWriteMarkup(&options, context.file);
+    if (!context.file || written < 0) abort();
+    context.length = written;
+    context.buffer = malloc(context.length);
+
+    context.source = CorpusBuildTree(&options);
+    context.records = malloc(options.nodes * sizeof(struct Record));
+    context.nodes = malloc(options.nodes * sizeof(Tree *));
+    context.lastAtDepth = malloc((options.maxDepth + 1) * sizeof(long));
+    TreeVisit(context.source, recordNode, &context);
+
+    // The largest documents are too slow to repeat as often as the small ones
+    int repetitions = benchOptions.repetitions, warmups = benchOptions.warmups;
+    if (bytes >= 32UL << 20) {
+        benchOptions.repetitions = bytes >= 1UL << 30 ? 1 : 3;
+        benchOptions.warmups = 0;
+    }
+
+    // One operation is the load of an element, the throughput is given by the length of the document
+    char name[64];
+    BenchResult load, build;
+    sprintf(name, "Load/read/%s", sizeName);
+    BenchMeasure(name, &(BenchCase){ NULL, runRead, NULL, &context, context.count, context.length }, NULL);
+    sprintf(name, "Load/scan+build/%s", sizeName);
+    int loaded = BenchMeasure(name, &(BenchCase){ NULL, runLoad, runDestroy, &context, context.count, context.length }, &load);
+    sprintf(name, "Load/build/%s", sizeName);
+    int built = BenchMeasure(name, &(BenchCase){ NULL, runBuild, runDestroy, &context, context.count, context.length }, &build);
+    if (loaded && built) {
+        sprintf(name, "Load/scan/%s", sizeName);
+        BenchResult scan = subtract(&load, &build, context.count, context.length);
+        BenchReport(name, &scan, benchOptions.repetitions);
+    }
+    sprintf(name, "Load/destroy/%s", sizeName);
+    BenchMeasure(name, &(BenchCase){ runBuild, runDestroy, NULL, &context, context.count, 0 }, NULL);
+
+    benchOptions.repetitions = repetitions;
+    benchOptions.warmups = warmups;
+
+    for (long i = 0; i < context.count; i++) {
+        free(context.records[i].keys);
+        free(context.records[i].values);
+    }
+    free(context.records);
+    free(context.nodes);
+    free(context.lastAtDepth);
+    TreeDestroyAll(context.source);
+    free(context.buffer);
+    fclose(context.file);
+}
+
+
+int main(int argc, char **argv) {
+    // Take --max-size=N[K|M|G] out before the options of the harness are read
+    size_t maxSize = 32UL << 20;
+    const char *tracePath = NULL;
+    int count = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--max-size=", 11) == 0) {
+            char *unit;
+            maxSize = strtoul(argv[i] + 11, &unit, 10);
+            if (*unit == 'K') maxSize <<= 10;
+            else if (*unit == 'M') maxSize <<= 20;
+            else if (*unit == 'G') maxSize <<= 30;
+        }
+        else if (strncmp(argv[i], "--trace=", 8) == 0) tracePath = argv[i] + 8;
+        else argv[count++] = argv[i];
+    }
+    BenchInit(count, argv);
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        if (sizes[s].bytes <= maxSize) measure(sizes[s].name, sizes[s].bytes);
+    }
+
+    if (tracePath) {
+        FILE *trace = fopen(tracePath, "w");
+        if (!trace || TraceExport(trace) == -1) { fprintf(stderr, "Cannot write %s\n", tracePath); return 1; }
+        fclose(trace);
+    }
+
+    return 0;
+}
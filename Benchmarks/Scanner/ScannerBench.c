@@ -0,0 +1,147 @@
+/***************************************************************************************************
+ * @file ScannerBench.c                                                                            *
+ * @brief Measures the throughput of the Scanner                                                   *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Scanner.h                                                                                  *
+ **************************************************************************************************/
+
+#include "../../Scanner/Scanner.h"
+#include "../../Serializer/Serializer.h"
+#define BENCH_COUNT_ALLOCATIONS
+#include "../Bench.h"
+
+#define GROUP 100   // The number of rows of each group, so that no node has too many children
+
+/**
+ * @brief The documents scanned: a number of rows, each a box with a label and a button, in groups of GROUP rows
+ */
+struct Document
+{
+    const char *name;   ///< The name used in the benchmark names
+    int rows;           ///< The number of rows
+    int indent;         ///< Whether the markup is indented
+    int commented;      ///< Whether a comment follows each line, to compare with the same document without them
+};
+
+static const struct Document documents[] = {
+    { "small", 10, 1, 0 },
+    { "medium", 1000, 1, 0 },
+    { "large", 50000, 1, 0 },
+    { "large-compact", 50000, 0, 0 },
+    { "large-commented", 50000, 1, 1 },
+};
+
+#define COMMENT "<!-- A comment as long as the line it follows, skipped without reading it character by character -->"
+
+
+struct ScanContext
+{
+    char *markup;       ///< The document
+    size_t length;      ///< Its length in bytes
+    Tree *tree;         ///< The tree built by the last scan
+};
+
+
+static Tree *buildDocument(int rows) {
+    char id[32], text[64];
+
+    Tree *root = TreeNew(window, "main", NULL, NULL);
+    TreeSetAttribute(root, "title", "Scanner benchmark");
+    Tree *list = TreeNew(box, "list", NULL, NULL);
+    TreeSetAttribute(list, "orientation", "vertical");
+    TreeAddChild(root, list);
+
+    Tree *group = NULL;
+    for (int i = 0; i < rows; i++) {
+        if (i % GROUP == 0) {
+            sprintf(id, "group%d", i / GROUP);
+            group = TreeNew(box, id, NULL, NULL);
+            TreeSetAttribute(group, "orientation", "vertical");
+            TreeAddChild(list, group);
+        }
+
+        sprintf(id, "row%d", i);
+        Tree *row = TreeNew(box, id, NULL, NULL);
+        TreeSetAttribute(row, "spacing", "6");
+
+        sprintf(id, "label%d", i);
+        sprintf(text, "Item number %d & more", i);
+        Tree *item = TreeNew(label, id, NULL, NULL);
+        TreeSetAttribute(item, "text", text);
+        TreeSetAttribute(item, "hexpand", "true");
+        TreeAddChild(row, item);
+
+        sprintf(id, "button%d", i);
+        Tree *action = TreeNew(button, id, NULL, NULL);
+        TreeSetAttribute(action, "label", "Open");
+        TreeAddChild(row, action);
+
+        TreeAddChild(group, row);
+    }
+    return root;
+}
+
+
+/**
+ * @brief Adds a comment at the end of each line of a document
+ */
+static char *addComments(char *markup, size_t *length) {
+    size_t lines = 0;
+    for (size_t i = 0; i < *length; i++) lines += markup[i] == '\n';
+
+    char *commented = malloc(*length + lines * strlen(COMMENT) + 1);
+    char *end = commented;
+    for (size_t i = 0; i < *length; i++) {
+        if (markup[i] == '\n') end = stpcpy(end, COMMENT);
+        *end++ = markup[i];
+    }
+    *end = '\0';
+
+    free(markup);
+    *length = (size_t)(end - commented);
+    return commented;
+}
+
+
+static void runScan(void *data) {
+    struct ScanContext *context = data;
+    FILE *file = fmemopen(context->markup, context->length, "r");
+    context->tree = performLexicalAnalysis(file);
+    fclose(file);
+    if (!context->tree) abort();
+}
+
+
+static void freeTree(void *data) {
+    struct ScanContext *context = data;
+    TreeDestroyAll(context->tree);
+}
+
+
+int main(int argc, char **argv) {
+    BenchInit(argc, argv);
+    char name[64];
+
+    for (size_t d = 0; d < sizeof(documents) / sizeof(documents[0]); d++) {
+        Tree *document = buildDocument(documents[d].rows);
+        struct ScanContext context = { NULL, 0, NULL };
+        context.markup = SerializerToMarkup(document, documents[d].indent, &context.length);
+        TreeDestroyAll(document);
+        if (documents[d].commented) context.markup = addComments(context.markup, &context.length);
+
+        // One operation is the scan of a node, the throughput is given by the length of the document
+        int nodes = 2 + (documents[d].rows + GROUP - 1) / GROUP + 3 * documents[d].rows;
+        sprintf(name, "Scanner/%s/%zuKB", documents[d].name, context.length / 1024);
+        BenchMeasure(name, &(BenchCase){ NULL, runScan, freeTree, &context, nodes, context.length }, NULL);
+
+        free(context.markup);
+    }
+
+    return 0;
+}
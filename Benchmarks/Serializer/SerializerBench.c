@@ -0,0 +1,128 @@
+/***************************************************************************************************
+ * @file SerializerBench.c                                                                         *
+ * @brief Benchmarks the serializers against TreePrint on a large tree                             *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Serializer.h                                                                               *
+ **************************************************************************************************/
+
+#include "../../Serializer/Serializer.h"
+#include "../Bench.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+#define NODES 200000    // The number of nodes of the tree
+#define FANOUT 8        // The number of children of each box
+#define ROUNDS 5        // The number of times each output is measured
+
+/**
+ * @brief Writes an attribute with fprintf, as the serializer would without its buffer
+ */
+static void printAttribute(const char *key, const char *value, void *userData)
+{
+    fprintf(userData, " %s=\"%s\"", key, value);
+}
+
+
+struct PrintContext
+{
+    FILE *output;
+    int depth;
+};
+
+
+/**
+ * @brief Writes the markup of a tree with one fprintf per tag and per attribute (the baseline)
+ */
+static void printMarkup(Tree *node, void *userData)
+{
+    struct PrintContext *context = userData;
+    const char *type = WidgetTypeToName(TreeGetType(node));
+
+    fprintf(context->output, "%*s<%s id=\"%s\"", context->depth * 2, "", type, TreeGetId(node));
+    HashMapForEach(TreeGetAttributes(node), printAttribute, context->output);
+    if (TreeIsLeaf(node)) {
+        fprintf(context->output, " />\n");
+        return;
+    }
+
+    fprintf(context->output, ">\n");
+    context->depth++;
+    TreeForEachChild(node, printMarkup, context);
+    context->depth--;
+    fprintf(context->output, "%*s</%s>\n", context->depth * 2, "", type);
+}
+
+
+int main() {
+    static Tree *nodes[NODES];
+    char id[32], text[32];
+
+    // A balanced tree of boxes and labels, each with a few attributes
+    for (int i = 0; i < NODES; i++) {
+        HashMap *attributes = HashMapNew();
+        sprintf(text, "Item \"%d\" & co", i);
+        HashMapPut(attributes, "text", text);
+        HashMapPut(attributes, "spacing", "4");
+        HashMapPut(attributes, "halign", "center");
+        sprintf(id, "node-%d", i);
+        nodes[i] = TreeNew(i % 3 ? label : box, id, NULL, attributes);
+        HashMapFree(attributes);
+        if (i) TreeAddChild(nodes[(i - 1) / FANOUT], nodes[i]);
+    }
+
+    int null = open("/dev/null", O_WRONLY);
+    int savedStdout = dup(STDOUT_FILENO);
+    long long printTime = -1, fprintfTime = -1, markupTime = -1, jsonTime = -1;
+    long markupBytes = 0, jsonBytes = 0;
+
+    // Keep the best of a few rounds, the first ones also warm up the caches and the allocator
+    for (int round = 0; round < ROUNDS; round++) {
+        // TreePrint, printf per node, to /dev/null
+        fflush(stdout);
+        dup2(null, STDOUT_FILENO);
+        long long start = BenchNow();
+        TreePrint(nodes[0], "", 1);
+        fflush(stdout);
+        long long elapsed = BenchNow() - start;
+        dup2(savedStdout, STDOUT_FILENO);
+        if (printTime < 0 || elapsed < printTime) printTime = elapsed;
+
+        // The same markup as the serializer writes, with fprintf through a stdio buffer
+        FILE *output = fdopen(dup(null), "w");
+        struct PrintContext context = { output, 0 };
+        start = BenchNow();
+        printMarkup(nodes[0], &context);
+        fflush(output);
+        elapsed = BenchNow() - start;
+        fclose(output);
+        if (fprintfTime < 0 || elapsed < fprintfTime) fprintfTime = elapsed;
+
+        start = BenchNow();
+        markupBytes = SerializerWriteMarkup(nodes[0], 2, null);
+        elapsed = BenchNow() - start;
+        if (markupTime < 0 || elapsed < markupTime) markupTime = elapsed;
+
+        start = BenchNow();
+        jsonBytes = SerializerWriteJson(nodes[0], 0, null);
+        elapsed = BenchNow() - start;
+        if (jsonTime < 0 || elapsed < jsonTime) jsonTime = elapsed;
+    }
+
+    printf("nodes: %d, 3 attributes per node, best of %d rounds\n\n", NODES, ROUNDS);
+    printf("%-24s %12s %12s %12s\n", "output", "ms", "ns/node", "MB/s");
+    printf("%-24s %12.2f %12.1f %12s\n", "TreePrint (ids only)", printTime / 1e6, (double)printTime / NODES, "-");
+    printf("%-24s %12.2f %12.1f %12s\n", "fprintf markup", fprintfTime / 1e6, (double)fprintfTime / NODES, "-");
+    printf("%-24s %12.2f %12.1f %12.1f\n", "SerializerWriteMarkup", markupTime / 1e6, (double)markupTime / NODES, markupBytes * 1e3 / markupTime);
+    printf("%-24s %12.2f %12.1f %12.1f\n", "SerializerWriteJson", jsonTime / 1e6, (double)jsonTime / NODES, jsonBytes * 1e3 / jsonTime);
+
+    close(null);
+    close(savedStdout);
+    TreeDestroyAll(nodes[0]);
+    return 0;
+}
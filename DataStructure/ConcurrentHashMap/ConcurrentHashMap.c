@@ -0,0 +1,575 @@
+/***************************************************************************************************
+ * @file ConcurrentHashMap.c                                                                       *
+ * @brief The implementation of the ConcurrentHashMap data structure                               *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see ConcurrentHashMap.h                                                                        *
+ **************************************************************************************************/
+
+#include "ConcurrentHashMap.h"
+#include "../../Utils/Hash.h"
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/**
+ * @brief Represents a key-value pair of a ConcurrentHashMap
+ * 
+ * A node is never modified once it is reachable, except for its next pointer: replacing a
+ * value publishes a new node, so a reader always sees a consistent pair. The key and the
+ * value are stored after the node, in the same allocation.
+ */
+struct Node
+{
+    _Atomic(struct Node *) next;    ///< The next node of the bucket
+    unsigned int hash;              ///< The hash of the key
+    char *value;                    ///< The value, right after the key
+    char key[];                     ///< The key
+};
+
+
+/**
+ * @brief Represents the buckets of a ConcurrentHashMap
+ * 
+ * Growing the map publishes a new table with copies of the nodes, the old one is left
+ * untouched for the readers still walking it.
+ */
+struct Table
+{
+    unsigned int mask;                  ///< The number of buckets minus one (a power of two minus one)
+    _Atomic(struct Node *) buckets[];   ///< The first node of each bucket
+};
+
+
+/**
+ * @brief Represents a HashMap that can be shared between threads
+ * 
+ * There are at least as many buckets as stripes, so a key always maps to the same stripe,
+ * whatever the size of the table.
+ */
+struct ConcurrentHashMap
+{
+    _Atomic(struct Table *) table;                          ///< The current buckets
+    atomic_int size;                                        ///< The number of key-value pairs
+    pthread_mutex_t stripes[CONCURRENT_HASHMAP_STRIPES];    ///< The writer locks, by hash of the key
+};
+
+
+/**
+ * @brief Represents a thread that reads ConcurrentHashMaps
+ * 
+ * Records are never freed, a thread that exits leaves its record for the next new thread.
+ */
+struct Reader
+{
+    atomic_uint epoch;      ///< The epoch at the start of the current read section, or EPOCH_QUIESCENT
+    atomic_int inUse;       ///< Whether a thread owns the record
+    int nesting;            ///< The number of nested read sections of the owner
+    struct Reader *next;    ///< The next record
+};
+
+
+/**
+ * @brief Represents a block that was unlinked by a writer and waits for the readers
+ */
+struct Retired
+{
+    void *block;            ///< The block to free
+    unsigned int epoch;     ///< The epoch when it was unlinked
+    struct Retired *next;   ///< The next retired block, the newest first
+};
+
+#define EPOCH_QUIESCENT UINT_MAX    ///< The epoch of a reader outside of any read section
+#define RECLAIM_INTERVAL 64         ///< The number of blocks retired between two reclamations
+#define INITIAL_BUCKETS 64          ///< The number of buckets of a new ConcurrentHashMap
+
+static atomic_uint globalEpoch = 1;                     ///< The current epoch
+static _Atomic(struct Reader *) readers = NULL;         ///< The records of the reading threads
+static _Thread_local struct Reader *threadReader;       ///< The record of the calling thread
+static pthread_once_t readerKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t readerKey;                         ///< Releases the record of an exiting thread
+
+static pthread_mutex_t retiredLock = PTHREAD_MUTEX_INITIALIZER;
+static struct Retired *retired = NULL;                  ///< The blocks waiting for the readers
+static int retiredCount = 0;                            ///< The number of blocks in retired
+static int retiredSinceReclaim = 0;                     ///< The number of blocks retired since the last reclamation
+
+
+
+
+/**
+ * @brief Gives the record of an exiting thread back
+ */
+static void releaseReader(void *record)
+{
+    struct Reader *reader = record;
+    reader->nesting = 0;
+    atomic_store_explicit(&reader->epoch, EPOCH_QUIESCENT, memory_order_release);
+    atomic_store_explicit(&reader->inUse, 0, memory_order_release);
+}
+
+
+static void createReaderKey()
+{
+    pthread_key_create(&readerKey, releaseReader);
+}
+
+
+/**
+ * @brief Returns the record of the calling thread, taking one on its first read
+ */
+static struct Reader *currentReader()
+{
+    if(threadReader) return threadReader;
+
+    pthread_once(&readerKeyOnce, createReaderKey);
+
+    // Reuse the record of a thread that exited
+    struct Reader *reader;
+    for(reader = atomic_load(&readers); reader; reader = reader->next)
+    {
+        int free = 0;
+        if(atomic_compare_exchange_strong(&reader->inUse, &free, 1)) break;
+    }
+
+    // Otherwise push a new one, records are never removed so the list only grows at its head
+    if(!reader)
+    {
+        reader = (struct Reader *)malloc(sizeof(struct Reader));
+        if(!reader) abort();
+        atomic_init(&reader->epoch, EPOCH_QUIESCENT);
+        atomic_init(&reader->inUse, 1);
+        reader->nesting = 0;
+        reader->next = atomic_load(&readers);
+        while(!atomic_compare_exchange_weak(&readers, &reader->next, reader));
+    }
+
+    pthread_setspecific(readerKey, reader);
+    threadReader = reader;
+    return reader;
+}
+
+
+/**
+ * @brief Moves to the next epoch if every reader saw the current one, then frees the blocks
+ *        retired two epochs ago (called with retiredLock held)
+ */
+static void reclaim()
+{
+    unsigned int epoch = atomic_load(&globalEpoch);
+
+    int advance = 1;
+    for(struct Reader *reader = atomic_load(&readers); reader; reader = reader->next)
+    {
+        unsigned int seen = atomic_load(&reader->epoch);
+        if(seen != EPOCH_QUIESCENT && seen != epoch) advance = 0;
+    }
+    if(advance && atomic_compare_exchange_strong(&globalEpoch, &epoch, epoch + 1)) epoch++;
+
+    // A reader can only hold a block retired in its own epoch or the one before
+    struct Retired **link = &retired;
+    while(*link)
+    {
+        struct Retired *block = *link;
+        if(epoch - block->epoch >= 2)
+        {
+            *link = block->next;
+            free(block->block);
+            free(block);
+            retiredCount--;
+        }
+        else link = &block->next;
+    }
+    retiredSinceReclaim = 0;
+}
+
+
+/**
+ * @brief Frees a block once no reader can see it anymore (the block must already be unreachable)
+ */
+static void retire(void *block)
+{
+    struct Retired *entry = (struct Retired *)malloc(sizeof(struct Retired));
+
+    pthread_mutex_lock(&retiredLock);
+
+    // Without memory to remember the block, wait until the readers are all done with it
+    if(!entry)
+    {
+        unsigned int epoch = atomic_load(&globalEpoch);
+        while(atomic_load(&globalEpoch) - epoch < 2) reclaim();
+        free(block);
+        pthread_mutex_unlock(&retiredLock);
+        return;
+    }
+
+    entry->block = block;
+    entry->epoch = atomic_load(&globalEpoch);
+    entry->next = retired;
+    retired = entry;
+    retiredCount++;
+
+    if(++retiredSinceReclaim >= RECLAIM_INTERVAL) reclaim();
+    pthread_mutex_unlock(&retiredLock);
+}
+
+
+/**
+ * @brief Creates a node holding a key-value pair
+ */
+static struct Node *newNode(unsigned int hash, const char *key, const char *value)
+{
+    size_t keyLength = strlen(key) + 1;
+    size_t valueLength = strlen(value) + 1;
+
+    struct Node *node = (struct Node *)malloc(sizeof(struct Node) + keyLength + valueLength);
+    if(!node) return NULL;
+
+    atomic_init(&node->next, NULL);
+    node->hash = hash;
+    memcpy(node->key, key, keyLength);
+    node->value = memcpy(node->key + keyLength, value, valueLength);
+
+    return node;
+}
+
+
+/**
+ * @brief Creates a table with empty buckets
+ */
+static struct Table *newTable(unsigned int buckets)
+{
+    struct Table *table = (struct Table *)malloc(sizeof(struct Table) + buckets * sizeof(struct Node *));
+    if(!table) return NULL;
+
+    table->mask = buckets - 1;
+    for(unsigned int i = 0; i < buckets; i++) atomic_init(&table->buckets[i], NULL);
+
+    return table;
+}
+
+
+/**
+ * @brief Returns the node holding a key, or NULL if the key is not in the table
+ */
+static struct Node *findNode(const struct Table *table, const char *key, unsigned int hash)
+{
+    struct Node *node = atomic_load_explicit(&table->buckets[hash & table->mask], memory_order_acquire);
+    while(node)
+    {
+        if(node->hash == hash && strcmp(node->key, key) == 0) return node;
+        node = atomic_load_explicit(&node->next, memory_order_acquire);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * @brief Returns the link pointing to the node holding a key, or to the end of its bucket
+ *        (called with the stripe of the key locked)
+ */
+static _Atomic(struct Node *) *findLink(struct Table *table, const char *key, unsigned int hash)
+{
+    _Atomic(struct Node *) *link = &table->buckets[hash & table->mask];
+    struct Node *node;
+    while((node = atomic_load_explicit(link, memory_order_relaxed)))
+    {
+        if(node->hash == hash && strcmp(node->key, key) == 0) break;
+        link = &node->next;
+    }
+
+    return link;
+}
+
+
+/**
+ * @brief Doubles the number of buckets if the map holds more pairs than buckets
+ */
+static void grow(ConcurrentHashMap *map)
+{
+    // Stop every writer, in the same order to avoid deadlocks
+    for(int i = 0; i < CONCURRENT_HASHMAP_STRIPES; i++) pthread_mutex_lock(&map->stripes[i]);
+
+    struct Table *old = atomic_load_explicit(&map->table, memory_order_relaxed);
+    struct Table *table = NULL;
+    if((unsigned int)atomic_load(&map->size) > old->mask + 1) table = newTable((old->mask + 1) * 2);
+
+    // Copy the nodes, the readers may still be walking the old ones
+    int copied = 1;
+    for(unsigned int i = 0; table && i <= old->mask && copied; i++)
+    {
+        for(struct Node *node = atomic_load_explicit(&old->buckets[i], memory_order_relaxed); node;
+            node = atomic_load_explicit(&node->next, memory_order_relaxed))
+        {
+            struct Node *copy = newNode(node->hash, node->key, node->value);
+            if(!copy)
+            {
+                copied = 0;
+                break;
+            }
+            _Atomic(struct Node *) *bucket = &table->buckets[node->hash & table->mask];
+            atomic_init(&copy->next, atomic_load_explicit(bucket, memory_order_relaxed));
+            atomic_init(bucket, copy);
+        }
+    }
+
+    if(table && copied)
+    {
+        // Publish the new table, then retire the old one with its nodes
+        atomic_store_explicit(&map->table, table, memory_order_release);
+        for(unsigned int i = 0; i <= old->mask; i++)
+        {
+            struct Node *node = atomic_load_explicit(&old->buckets[i], memory_order_relaxed);
+            while(node)
+            {
+                struct Node *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+                retire(node);
+                node = next;
+            }
+        }
+        retire(old);
+    }
+    else if(table)
+    {
+        // Out of memory, keep the current table (lookups are only slower)
+        for(unsigned int i = 0; i <= table->mask; i++)
+        {
+            struct Node *node = atomic_load_explicit(&table->buckets[i], memory_order_relaxed);
+            while(node)
+            {
+                struct Node *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+                free(node);
+                node = next;
+            }
+        }
+        free(table);
+    }
+
+    for(int i = CONCURRENT_HASHMAP_STRIPES - 1; i >= 0; i--) pthread_mutex_unlock(&map->stripes[i]);
+}
+
+
+
+
+ConcurrentHashMap *ConcurrentHashMapNew()
+{
+    // Allocate memory for the ConcurrentHashMap
+    ConcurrentHashMap *map = (ConcurrentHashMap *)malloc(sizeof(ConcurrentHashMap));
+    if(!map) return NULL;
+
+    struct Table *table = newTable(INITIAL_BUCKETS);
+    if(!table)
+    {
+        free(map);
+        return NULL;
+    }
+
+    // Initialize the ConcurrentHashMap
+    atomic_init(&map->table, table);
+    atomic_init(&map->size, 0);
+    for(int i = 0; i < CONCURRENT_HASHMAP_STRIPES; i++) pthread_mutex_init(&map->stripes[i], NULL);
+
+    return map;
+}
+
+
+
+
+int ConcurrentHashMapPut(ConcurrentHashMap *map, const char *key, const char *value)
+{
+    // Check the input parameters
+    if(!map || !key || !value) return -1;
+
+    unsigned int hash = HashString(key);
+    struct Node *node = newNode(hash, key, value);
+    if(!node) return -1;
+
+    pthread_mutex_lock(&map->stripes[hash % CONCURRENT_HASHMAP_STRIPES]);
+
+    // The table cannot be replaced while a stripe is locked
+    struct Table *table = atomic_load_explicit(&map->table, memory_order_relaxed);
+    _Atomic(struct Node *) *link = findLink(table, key, hash);
+    struct Node *old = atomic_load_explicit(link, memory_order_relaxed);
+
+    if(old)
+    {
+        // Replace the node of the key, readers see either the old or the new value
+        atomic_init(&node->next, atomic_load_explicit(&old->next, memory_order_relaxed));
+        atomic_store_explicit(link, node, memory_order_release);
+        pthread_mutex_unlock(&map->stripes[hash % CONCURRENT_HASHMAP_STRIPES]);
+        retire(old);
+        return 0;
+    }
+
+    // Append the new node to its bucket
+    atomic_store_explicit(link, node, memory_order_release);
+    unsigned int size = atomic_fetch_add(&map->size, 1) + 1;
+    unsigned int buckets = table->mask + 1;
+    pthread_mutex_unlock(&map->stripes[hash % CONCURRENT_HASHMAP_STRIPES]);
+
+    // Keep at most one pair per bucket on average
+    if(size > buckets) grow(map);
+
+    return 1;
+}
+
+
+
+
+const char *ConcurrentHashMapGet(const ConcurrentHashMap *map, const char *key)
+{
+    // Check the input parameters
+    if(!map || !key) return NULL;
+
+    struct Table *table = atomic_load_explicit(&((ConcurrentHashMap *)map)->table, memory_order_acquire);
+    struct Node *node = findNode(table, key, HashString(key));
+
+    return node ? node->value : NULL;
+}
+
+
+
+
+char *ConcurrentHashMapGetCopy(const ConcurrentHashMap *map, const char *key)
+{
+    // Check the input parameters
+    if(!map || !key) return NULL;
+
+    ConcurrentHashMapReadBegin();
+    const char *value = ConcurrentHashMapGet(map, key);
+    char *copy = value ? strdup(value) : NULL;
+    ConcurrentHashMapReadEnd();
+
+    return copy;
+}
+
+
+
+
+int ConcurrentHashMapRemove(ConcurrentHashMap *map, const char *key)
+{
+    // Check the input parameters
+    if(!map || !key) return -1;
+
+    unsigned int hash = HashString(key);
+    pthread_mutex_lock(&map->stripes[hash % CONCURRENT_HASHMAP_STRIPES]);
+
+    struct Table *table = atomic_load_explicit(&map->table, memory_order_relaxed);
+    _Atomic(struct Node *) *link = findLink(table, key, hash);
+    struct Node *node = atomic_load_explicit(link, memory_order_relaxed);
+
+    // Unlink the node, its next pointer stays valid for the readers standing on it
+    if(node)
+    {
+        atomic_store_explicit(link, atomic_load_explicit(&node->next, memory_order_relaxed), memory_order_release);
+        atomic_fetch_sub(&map->size, 1);
+    }
+
+    pthread_mutex_unlock(&map->stripes[hash % CONCURRENT_HASHMAP_STRIPES]);
+
+    if(!node) return 0;
+
+    retire(node);
+    return 1;
+}
+
+
+
+
+int ConcurrentHashMapContainsKey(const ConcurrentHashMap *map, const char *key)
+{
+    // Check the input parameters
+    if(!map || !key) return -1;
+
+    ConcurrentHashMapReadBegin();
+    int found = ConcurrentHashMapGet(map, key) != NULL;
+    ConcurrentHashMapReadEnd();
+
+    return found;
+}
+
+
+
+
+int ConcurrentHashMapSize(const ConcurrentHashMap *map)
+{
+    // Check the input parameters
+    if(!map) return -1;
+
+    return atomic_load(&((ConcurrentHashMap *)map)->size);
+}
+
+
+
+
+void ConcurrentHashMapReadBegin()
+{
+    struct Reader *reader = currentReader();
+
+    // Announce the epoch before reading any pointer, writers will keep what it can see
+    if(reader->nesting++ == 0)
+    {
+        atomic_store(&reader->epoch, atomic_load(&globalEpoch));
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+}
+
+
+
+
+void ConcurrentHashMapReadEnd()
+{
+    struct Reader *reader = currentReader();
+
+    if(reader->nesting > 0 && --reader->nesting == 0)
+    {
+        atomic_store_explicit(&reader->epoch, EPOCH_QUIESCENT, memory_order_release);
+    }
+}
+
+
+
+
+int ConcurrentHashMapReclaim()
+{
+    pthread_mutex_lock(&retiredLock);
+
+    // Two epochs are needed for the blocks retired in the current one
+    for(int i = 0; i < 3 && retired; i++) reclaim();
+    int count = retiredCount;
+
+    pthread_mutex_unlock(&retiredLock);
+    return count;
+}
+
+
+
+
+void ConcurrentHashMapFree(ConcurrentHashMap *map)
+{
+    // Check the input parameters
+    if(!map) return;
+
+    // Free the nodes and the table, no other thread may be using them
+    struct Table *table = atomic_load(&map->table);
+    for(unsigned int i = 0; i <= table->mask; i++)
+    {
+        struct Node *node = atomic_load_explicit(&table->buckets[i], memory_order_relaxed);
+        while(node)
+        {
+            struct Node *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+            free(node);
+            node = next;
+        }
+    }
+    free(table);
+
+    for(int i = 0; i < CONCURRENT_HASHMAP_STRIPES; i++) pthread_mutex_destroy(&map->stripes[i]);
+    free(map);
+}
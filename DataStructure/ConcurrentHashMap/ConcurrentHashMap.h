@@ -0,0 +1,143 @@
+/***************************************************************************************************
+ * @file ConcurrentHashMap.h                                                                       *
+ * @brief Defines a HashMap that can be shared between threads                                     *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see ConcurrentHashMap.c                                                                        *
+ **************************************************************************************************/
+
+#ifndef CONCURRENT_HASHMAP_H
+#define CONCURRENT_HASHMAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CONCURRENT_HASHMAP_STRIPES 16   ///< The number of locks shared by the writers of a ConcurrentHashMap
+
+typedef struct ConcurrentHashMap ConcurrentHashMap;
+
+/**
+ * @brief Creates a new, empty ConcurrentHashMap
+ * 
+ * Readers never lock: they follow the buckets through atomic pointers, and the memory that
+ * writers replace or remove is only freed once no reader can still see it (epoch based
+ * reclamation). Writers lock one of CONCURRENT_HASHMAP_STRIPES locks, chosen by the hash of
+ * the key, so writers of different keys rarely wait for each other.
+ * 
+ * @return A pointer to the newly created ConcurrentHashMap, or NULL if memory allocation fails
+ */
+ConcurrentHashMap *ConcurrentHashMapNew();
+
+
+/**
+ * @brief Adds a key-value pair to the ConcurrentHashMap (safe from any thread)
+ * 
+ * If the key already exists, the value is replaced; readers see either the old or the new
+ * value, never a mix of both.
+ * 
+ * @param map Pointer to the ConcurrentHashMap
+ * @param key Key to be inserted or updated
+ * @param value Value associated with the key
+ * @return 1 if successful, 0 if key already exists (value updated), -1 if an error occurs
+ */
+int ConcurrentHashMapPut(ConcurrentHashMap *map, const char *key, const char *value);
+
+
+/**
+ * @brief Retrieves the value associated with a given key (safe from any thread, wait-free)
+ * 
+ * The returned string may be replaced by another thread at any time, so it is only valid
+ * until the end of the calling thread's read section: call this function between
+ * ConcurrentHashMapReadBegin and ConcurrentHashMapReadEnd, or use ConcurrentHashMapGetCopy.
+ * 
+ * @param map Pointer to the ConcurrentHashMap to search
+ * @param key Key to look up
+ * @return The value associated with the key, or NULL if the key is not found
+ */
+const char *ConcurrentHashMapGet(const ConcurrentHashMap *map, const char *key);
+
+
+/**
+ * @brief Retrieves a copy of the value associated with a given key (safe from any thread)
+ * 
+ * @param map Pointer to the ConcurrentHashMap to search
+ * @param key Key to look up
+ * @return A copy of the value to be freed by the caller, or NULL if the key is not found or
+ *         memory allocation fails
+ */
+char *ConcurrentHashMapGetCopy(const ConcurrentHashMap *map, const char *key);
+
+
+/**
+ * @brief Removes a key-value pair from the ConcurrentHashMap (safe from any thread)
+ * 
+ * @param map Pointer to the ConcurrentHashMap
+ * @param key Key to be removed
+ * @return 1 if the key was found and removed, 0 if the key was not found or -1 if an error occurs
+ */
+int ConcurrentHashMapRemove(ConcurrentHashMap *map, const char *key);
+
+
+/**
+ * @brief Checks if a key exists in the ConcurrentHashMap (safe from any thread, wait-free)
+ * 
+ * @param map Pointer to the ConcurrentHashMap to search
+ * @param key Key to check for existence
+ * @return 1 if the key is found, 0 if the key is not found, -1 if an error occurs
+ */
+int ConcurrentHashMapContainsKey(const ConcurrentHashMap *map, const char *key);
+
+
+/**
+ * @brief Returns the number of key-value pairs in the ConcurrentHashMap
+ * 
+ * @param map Pointer to the ConcurrentHashMap
+ * @return The number of key-value pairs, or -1 if an error occurs
+ */
+int ConcurrentHashMapSize(const ConcurrentHashMap *map);
+
+
+/**
+ * @brief Starts a read section on the calling thread
+ * 
+ * The values returned by ConcurrentHashMapGet stay valid until the matching
+ * ConcurrentHashMapReadEnd. Read sections can be nested, and should be short: the memory
+ * released by writers is not freed while a read section that started before is running.
+ */
+void ConcurrentHashMapReadBegin();
+
+
+/**
+ * @brief Ends the read section started by the matching ConcurrentHashMapReadBegin
+ */
+void ConcurrentHashMapReadEnd();
+
+
+/**
+ * @brief Frees the memory released by writers that no reader can see anymore
+ * 
+ * Writers already do this from time to time, this is only needed to release everything at
+ * a quiet point (e.g., before exiting).
+ * 
+ * @return The number of released blocks that are still waiting for readers
+ */
+int ConcurrentHashMapReclaim();
+
+
+/**
+ * @brief Frees all memory associated with the ConcurrentHashMap
+ * 
+ * No other thread may use the ConcurrentHashMap anymore when it is freed.
+ * 
+ * @param map Pointer to the ConcurrentHashMap to be freed
+ */
+void ConcurrentHashMapFree(ConcurrentHashMap *map);
+
+
+#endif // CONCURRENT_HASHMAP_H
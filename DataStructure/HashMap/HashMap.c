@@ -12,291 +12,1511 @@
  **************************************************************************************************/
 
 #include "HashMap.h"
+#include "../../Utils/Hash.h"
+#include "../../Utils/Entities.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Represents a key-value pair stored in the HashMap
+ * 
+ * The key and the value are stored in one allocation, the value right after the key's
+ * terminating NUL (at an offset multiple of four, so the two lowest bits of its pointer are
+ * free for the tags of VALUE_TAGS), so an entry costs a single allocation.
+ * The allocation starts with the atom of the key, interned the first time it is asked for.
+ * Reads only ever change the value pointer (with a compare and swap) and the atom, never the
+ * allocation, so the key stays where it is until the entry is put again or removed.
+ */
+struct HashMapEntry
+{
+    char *key;              ///< The key, right after its atom at the start of the allocation
+    _Atomic(char *) value;  ///< The value inside the key allocation, or a tagged pointer (see VALUE_TAGS)
+};
+
 
 /**
  * @brief Represents a HashMap data structure
  * 
- * This structure defines a HashMap with a size and a pointer to the first node
+ * A small HashMap keeps up to HASHMAP_INLINE_CAPACITY entries inline, in insertion order,
+ * with a cheap fingerprint of their keys packed apart, so a lookup scans the fingerprints
+ * linearly (with SSE2 when available) and only compares the keys that match.
+ * The first put beyond that moves the entries to an open addressing table (linear probing,
+ * at most three quarters full), which still costs no allocation per entry.
  */
 struct HashMap {
     int size;           ///< The current number of elements in the HashMap
-    struct Node *head;  ///< Pointer to the first node in the HashMap's linked list
+    int capacity;       ///< The number of slots of the table (a power of two), 0 while the entries are inline
+    union
+    {
+        struct
+        {
+            unsigned int fingerprints[HASHMAP_INLINE_CAPACITY];     ///< The fingerprints of the inline keys
+            struct HashMapEntry entries[HASHMAP_INLINE_CAPACITY];   ///< The inline entries, oldest first
+        } inlined;
+        struct
+        {
+            unsigned int *hashes;           ///< The hashes of the keys, in the same allocation as entries
+            struct HashMapEntry *entries;   ///< The slots, a NULL key marks an empty slot
+        } table;
+    };
+};
+
+
+/**
+ * @brief The kinds a value can be parsed to
+ */
+typedef enum
+{
+    valueInt,
+    valueDouble,
+    valueBool,
+    valueAtom
+} valueKind;
+
+
+/**
+ * @brief Represents a value that was parsed once and whose result is kept
+ * 
+ * Plain strings are stored directly in HashMapEntry.value, so they do not pay for this
+ * structure. Once a value is read (or put) as a typed value, HashMapEntry.value points to a
+ * TypedValue instead, tagged with TYPED_VALUE_TAG. The string is kept as it was, so pointers
+ * returned by HashMapGet stay valid. A TypedValue attached by a reader is never changed nor
+ * replaced by another reader, only by the writers of the map.
+ */
+struct TypedValue
+{
+    valueKind kind;     ///< The kind of the parsed value
+    union
+    {
+        long asInt;
+        double asDouble;
+        int asBool;
+        Atom asAtom;
+    } as;               ///< The parsed value
+    char *text;         ///< The HashMapEntry.value it replaced, the string or its decoded copy (tagged)
+};
+
+#define VALUE_TAGS ((uintptr_t)3)          ///< The bits of HashMapEntry.value telling what it points to
+#define TYPED_VALUE_TAG ((uintptr_t)1)     ///< HashMapEntry.value points to a TypedValue
+#define ESCAPED_VALUE_TAG ((uintptr_t)2)   ///< HashMapEntry.value is in the block, its entities are not decoded yet
+#define DECODED_VALUE_TAG ((uintptr_t)3)   ///< HashMapEntry.value is the decoded copy of the escaped value of the block
+#define HASHMAP_INITIAL_SLOTS 16        ///< The number of slots when the inline entries are outgrown
+
+
+/**
+ * @brief Iterates over the entries of a HashMap, newest first while they are inline
+ */
+struct EntryIterator
+{
+    const HashMap *map; ///< The HashMap being visited
+    int index;          ///< The next inline entry, or the next slot of the table
+};
+
+
+/**
+ * @brief Represents a key-value pair of a frozen HashMap
+ */
+struct FrozenEntry
+{
+    unsigned int hash;  ///< The hash of the key
+    const char *key;    ///< The key, inside the FrozenHashMap allocation
+    const char *value;  ///< The value, inside the FrozenHashMap allocation
+};
+
+
+/**
+ * @brief Represents an immutable snapshot of a HashMap
+ * 
+ * The entries are sorted by the hash of their keys (then by key), so a lookup is a binary
+ * search and two equal snapshots have their entries in the same order. The keys and values
+ * follow the entries in the same allocation. Nothing but the reference count is written
+ * after the snapshot is built.
+ */
+struct FrozenHashMap
+{
+    atomic_int references;          ///< The number of owners of the snapshot
+    int size;                       ///< The number of entries
+    unsigned int hash;              ///< The hash of all the pairs, see FrozenHashMapHash
+    unsigned int bytes;             ///< The size of the allocation, in the padding before the entries
+    struct FrozenEntry entries[];   ///< The entries, sorted by hash then key
 };
 
+#define FROZEN_LINEAR_SEARCH 8  ///< Frozen HashMaps up to this size are searched linearly
+
+
+
+
+/**
+ * @brief Returns the current value of an entry, tagged
+ */
+static char *loadValue(const struct HashMapEntry *entry)
+{
+    return atomic_load_explicit(&((struct HashMapEntry *)entry)->value, memory_order_acquire);
+}
+
+
+/**
+ * @brief Returns the tag of a value, see TYPED_VALUE_TAG
+ */
+static uintptr_t valueTag(const char *value)
+{
+    return (uintptr_t)value & VALUE_TAGS;
+}
+
+
+/**
+ * @brief Returns a value without its tag
+ */
+static char *untagged(const char *value)
+{
+    return (char *)((uintptr_t)value & ~VALUE_TAGS);
+}
+
+
+/**
+ * @brief Returns the TypedValue of an entry, or NULL if its value is a string
+ */
+static struct TypedValue *typedValue(const struct HashMapEntry *entry)
+{
+    char *value = loadValue(entry);
+    return valueTag(value) == TYPED_VALUE_TAG ? (struct TypedValue *)untagged(value) : NULL;
+}
+
+
+/**
+ * @brief Returns the string of a tagged value, as it was stored (see readValue)
+ */
+static char *valueString(const char *value)
+{
+    if(valueTag(value) == TYPED_VALUE_TAG) value = ((struct TypedValue *)untagged(value))->text;
+    return untagged(value);
+}
+
+
+/**
+ * @brief Returns the value of an entry as a string, as it was stored (see readValue)
+ */
+static char *valueText(const struct HashMapEntry *entry)
+{
+    return valueString(loadValue(entry));
+}
+
+
+/**
+ * @brief Frees the decoded copy of a value, if the value is one
+ */
+static void releaseDecoded(const char *value)
+{
+    if(valueTag(value) == DECODED_VALUE_TAG) AllocatorFree(allocatorHashMap, untagged(value), strlen(untagged(value)) + 1);
+}
+
+
+/**
+ * @brief Attaches a parsed value to an entry, keeping its string (for the writers of the map)
+ */
+static int attachTyped(struct HashMapEntry *entry, const struct TypedValue *parsed)
+{
+    struct TypedValue *typed = typedValue(entry);
+    if(!typed)
+    {
+        typed = (struct TypedValue *)AllocatorAlloc(allocatorHashMap, sizeof(struct TypedValue));
+        if(!typed) return -1;
+        typed->text = loadValue(entry);
+        atomic_store_explicit(&entry->value, (char *)((uintptr_t)typed | TYPED_VALUE_TAG), memory_order_release);
+    }
+
+    typed->kind = parsed->kind;
+    typed->as = parsed->as;
+    return 1;
+}
+
+
+/**
+ * @brief Drops the parsed value of an entry, if any
+ */
+static void detachTyped(struct HashMapEntry *entry)
+{
+    struct TypedValue *typed = typedValue(entry);
+    if(!typed) return;
+
+    atomic_store_explicit(&entry->value, typed->text, memory_order_relaxed);
+    AllocatorFree(allocatorHashMap, typed, sizeof(struct TypedValue));
+}
+
+
+/**
+ * @brief Returns the offset of the value in the block of an entry, the first multiple of four after the key
+ */
+static size_t valueOffset(size_t keyLength)
+{
+    return (keyLength + 4) & ~(size_t)3;
+}
+
+
+/**
+ * @brief Returns the block of an entry, which starts with the atom of its key
+ */
+static atomic_uint *entryBlock(const struct HashMapEntry *entry)
+{
+    return (atomic_uint *)entry->key - 1;
+}
+
+
+/**
+ * @brief Returns the value stored in the block of an entry, undecoded if it was put escaped
+ */
+static char *storedValue(const struct HashMapEntry *entry)
+{
+    return entry->key + valueOffset(strlen(entry->key));
+}
+
+
+/**
+ * @brief Returns the size of the block of an entry
+ */
+static size_t entrySize(const struct HashMapEntry *entry)
+{
+    const char *value = storedValue(entry);
+    return sizeof(Atom) + (size_t)(value - entry->key) + strlen(value) + 1;
+}
+
+
+/**
+ * @brief Allocates the key and the value of a new entry in one block, its key atom not resolved yet
+ */
+static int initEntry(struct HashMapEntry *entry, const char *key, const char *value)
+{
+    size_t keyLength = strlen(key);
+    size_t valueLength = strlen(value);
+
+    atomic_uint *block = (atomic_uint *)AllocatorAlloc(allocatorHashMap, sizeof(Atom) + valueOffset(keyLength) + valueLength + 1);
+    if(!block) return -1;
+
+    atomic_init(block, 0);
+    entry->key = (char *)(block + 1);
+    memcpy(entry->key, key, keyLength + 1);
+    memcpy(storedValue(entry), value, valueLength + 1);
+    atomic_init(&entry->value, storedValue(entry));
+
+    return 1;
+}
+
+
+/**
+ * @brief Replaces the value of an entry, resizing its block
+ */
+static int updateEntry(struct HashMapEntry *entry, const char *value)
+{
+    detachTyped(entry);
+    releaseDecoded(loadValue(entry));
+    atomic_store_explicit(&entry->value, storedValue(entry), memory_order_relaxed);
+
+    size_t keyLength = strlen(entry->key);
+    size_t valueLength = strlen(value);
+
+    atomic_uint *block = (atomic_uint *)AllocatorRealloc(allocatorHashMap, entryBlock(entry), entrySize(entry), sizeof(Atom) + valueOffset(keyLength) + valueLength + 1);
+    if(!block) return -1;
+
+    entry->key = (char *)(block + 1);
+    memcpy(storedValue(entry), value, valueLength + 1);
+    atomic_store_explicit(&entry->value, storedValue(entry), memory_order_relaxed);
+
+    return 1;
+}
+
+
+/**
+ * @brief Copies an entry, its parsed value included
+ */
+static int copyEntry(struct HashMapEntry *copy, const struct HashMapEntry *entry)
+{
+    // Read the value once, another reader may decode it meanwhile
+    char *value = loadValue(entry);
+    if(initEntry(copy, entry->key, valueString(value)) == -1) return -1;
+    atomic_init(entryBlock(copy), atomic_load_explicit(entryBlock(entry), memory_order_relaxed));
+
+    if(valueTag(value) == TYPED_VALUE_TAG && attachTyped(copy, (struct TypedValue *)untagged(value)) == -1)
+    {
+        AllocatorFree(allocatorHashMap, entryBlock(copy), entrySize(copy));
+        return -1;
+    }
+
+    // A value not decoded yet is copied as it is, and decoded when the copy is read
+    if(valueTag(value) == ESCAPED_VALUE_TAG) atomic_init(&copy->value, (char *)((uintptr_t)storedValue(copy) | ESCAPED_VALUE_TAG));
+    return 1;
+}
+
+
+/**
+ * @brief Frees the block, the decoded copy and the parsed value of an entry
+ */
+static void freeEntry(struct HashMapEntry *entry)
+{
+    detachTyped(entry);
+    releaseDecoded(loadValue(entry));
+    AllocatorFree(allocatorHashMap, entryBlock(entry), entrySize(entry));
+}
+
+
+/**
+ * @brief Returns the value of an entry as a string, decoding its entities on the first read
+ * 
+ * The decoded value is allocated apart and published with a single compare and swap, the
+ * block is left as it is: the key and the pointers returned before stay valid, and readers
+ * of the same entry on other threads either decode it too (the copies of all but one are
+ * freed at once) or find it decoded.
+ * 
+ * @return The value, or NULL if it could not be decoded
+ */
+static char *readValue(const struct HashMapEntry *entry)
+{
+    char *value = loadValue(entry);
+    if(valueTag(value) != ESCAPED_VALUE_TAG) return valueString(value);
+
+    const char *raw = untagged(value);
+    size_t length = EntitiesDecode(raw, NULL);
+    char *decoded = (char *)AllocatorAlloc(allocatorHashMap, length + 1);
+    if(!decoded) return NULL;
+    EntitiesDecode(raw, decoded);
+
+    char *tagged = (char *)((uintptr_t)decoded | DECODED_VALUE_TAG);
+    if(atomic_compare_exchange_strong_explicit(&((struct HashMapEntry *)entry)->value, &value, tagged, memory_order_acq_rel, memory_order_acquire))
+    {
+        return decoded;
+    }
+
+    // Another reader decoded it first
+    AllocatorFree(allocatorHashMap, decoded, length + 1);
+    return valueString(value);
+}
+
+
+/**
+ * @brief Returns the fingerprint of a key: its length, its first, middle and last characters
+ * 
+ * Much cheaper than a hash for the few entries of a small HashMap, and attribute names rarely
+ * share all four.
+ */
+static unsigned int fingerprint(const char *key)
+{
+    size_t length = strlen(key);
+    if(!length) return 0;
+
+    return (unsigned int)length << 24 ^ (unsigned int)(unsigned char)key[0] << 16
+         ^ (unsigned int)(unsigned char)key[length / 2] << 8 ^ (unsigned char)key[length - 1];
+}
+
+
+/**
+ * @brief Returns the index of an inline entry, or -1 if the key is not inline
+ */
+static int findInline(const HashMap *map, const char *key)
+{
+    // With a couple of entries comparing the keys is cheaper than computing the fingerprint
+    if(map->size <= 2)
+    {
+        for(int index = 0; index < map->size; index++)
+        {
+            if(strcmp(map->inlined.entries[index].key, key) == 0) return index;
+        }
+        return -1;
+    }
+
+    unsigned int print = fingerprint(key);
+
+#if defined(__SSE2__) && HASHMAP_INLINE_CAPACITY == 8
+    // Compare the eight fingerprints at once, then only the keys whose fingerprint matches
+    __m128i needle = _mm_set1_epi32((int)print);
+    __m128i low = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)map->inlined.fingerprints), needle);
+    __m128i high = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(map->inlined.fingerprints + 4)), needle);
+    unsigned int candidates = (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(low))
+                            | (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(high)) << 4;
+    candidates &= (1u << map->size) - 1;
+
+    while(candidates)
+    {
+        int index = __builtin_ctz(candidates);
+        if(strcmp(map->inlined.entries[index].key, key) == 0) return index;
+        candidates &= candidates - 1;
+    }
+#else
+    for(int index = 0; index < map->size; index++)
+    {
+        if(map->inlined.fingerprints[index] == print && strcmp(map->inlined.entries[index].key, key) == 0) return index;
+    }
+#endif
+
+    return -1;
+}
+
+
+/**
+ * @brief Returns the slot holding a key in the table, or the empty slot where it belongs
+ */
+static int findSlot(const HashMap *map, const char *key, unsigned int hash)
+{
+    int mask = map->capacity - 1;
+    int slot = hash & mask;
+
+    while(map->table.entries[slot].key)
+    {
+        if(map->table.hashes[slot] == hash && strcmp(map->table.entries[slot].key, key) == 0) break;
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+
+/**
+ * @brief Returns the entry holding a key, or NULL if the key is not in the HashMap
+ */
+static struct HashMapEntry *findEntry(const HashMap *map, const char *key)
+{
+    if(!map->capacity)
+    {
+        int index = findInline(map, key);
+        return index == -1 ? NULL : (struct HashMapEntry *)&map->inlined.entries[index];
+    }
+
+    struct HashMapEntry *entry = &map->table.entries[findSlot(map, key, HashString(key))];
+    return entry->key ? entry : NULL;
+}
+
+
+/**
+ * @brief Returns the next entry of an iteration, or NULL once every entry was visited
+ */
+static struct HashMapEntry *nextEntry(struct EntryIterator *iterator)
+{
+    const HashMap *map = iterator->map;
+
+    // The inline entries are visited from the newest
+    if(!map->capacity)
+    {
+        if(iterator->index >= map->size) return NULL;
+        return (struct HashMapEntry *)&map->inlined.entries[map->size - 1 - iterator->index++];
+    }
+
+    // The slots of the table are visited in order, skipping the empty ones
+    while(iterator->index < map->capacity)
+    {
+        struct HashMapEntry *entry = &map->table.entries[iterator->index++];
+        if(entry->key) return entry;
+    }
+
+    return NULL;
+}
+
+
+/**
+ * @brief Returns the size of the block of a table of the given capacity
+ */
+static size_t tableSize(int capacity)
+{
+    return (size_t)capacity * (sizeof(struct HashMapEntry) + sizeof(unsigned int));
+}
+
+
+/**
+ * @brief Allocates an empty table, the entries and their hashes in one block
+ */
+static int allocateTable(HashMap *map, int capacity)
+{
+    struct HashMapEntry *entries = (struct HashMapEntry *)AllocatorCalloc(allocatorHashMap, capacity, sizeof(struct HashMapEntry) + sizeof(unsigned int));
+    if(!entries) return -1;
+
+    map->table.entries = entries;
+    map->table.hashes = (unsigned int *)(entries + capacity);
+    map->capacity = capacity;
+
+    return 1;
+}
+
+
+/**
+ * @brief Places an entry whose key is not in the table yet
+ */
+static struct HashMapEntry *placeEntry(HashMap *map, const struct HashMapEntry *entry, unsigned int hash)
+{
+    int slot = findSlot(map, entry->key, hash);
+    map->table.entries[slot] = *entry;
+    map->table.hashes[slot] = hash;
+    return &map->table.entries[slot];
+}
+
+
+/**
+ * @brief Moves the entries to a table of the given capacity, inline entries included
+ */
+static int resizeTable(HashMap *map, int capacity)
+{
+    HashMap old = *map;
+    if(allocateTable(map, capacity) == -1) return -1;
+
+    // The entries keep their block, only the slot changes (the inline keys are hashed once here)
+    if(!old.capacity)
+    {
+        for(int i = 0; i < old.size; i++) placeEntry(map, &old.inlined.entries[i], HashString(old.inlined.entries[i].key));
+        return 1;
+    }
+
+    for(int i = 0; i < old.capacity; i++)
+    {
+        if(old.table.entries[i].key) placeEntry(map, &old.table.entries[i], old.table.hashes[i]);
+    }
+    AllocatorFree(allocatorHashMap, old.table.entries, tableSize(old.capacity));
+
+    return 1;
+}
+
+
+/**
+ * @brief Adds a new key-value pair, the key must not be in the HashMap
+ * 
+ * @return The new entry, or NULL if an allocation fails
+ */
+static struct HashMapEntry *insertEntry(HashMap *map, const char *key, const char *value)
+{
+    if(!map->capacity && map->size < HASHMAP_INLINE_CAPACITY)
+    {
+        struct HashMapEntry *entry = &map->inlined.entries[map->size];
+        if(initEntry(entry, key, value) == -1) return NULL;
+        map->inlined.fingerprints[map->size] = fingerprint(key);
+        map->size++;
+        return entry;
+    }
+
+    // Leave the inline entries once they are all used, then keep the table at most three quarters full
+    if(!map->capacity && resizeTable(map, HASHMAP_INITIAL_SLOTS) == -1) return NULL;
+    if((map->size + 1) * 4 > map->capacity * 3 && resizeTable(map, map->capacity * 2) == -1) return NULL;
+
+    struct HashMapEntry entry;
+    if(initEntry(&entry, key, value) == -1) return NULL;
+    map->size++;
+
+    return placeEntry(map, &entry, HashString(key));
+}
+
+
+/**
+ * @brief Parses a string to a value of the given kind
+ * 
+ * @return 1 if the whole string was converted, 0 otherwise
+ */
+static int parseValue(const char *text, valueKind kind, struct TypedValue *result)
+{
+    char *end;
+    result->kind = kind;
+
+    switch(kind)
+    {
+        case valueInt:
+            errno = 0;
+            result->as.asInt = strtol(text, &end, 10);
+            return end != text && *end == '\0' && !errno;
+
+        case valueDouble:
+            errno = 0;
+            result->as.asDouble = strtod(text, &end);
+            return end != text && *end == '\0' && !errno;
+
+        case valueBool:
+            if(strcmp(text, "true") == 0 || strcmp(text, "1") == 0) result->as.asBool = 1;
+            else if(strcmp(text, "false") == 0 || strcmp(text, "0") == 0) result->as.asBool = 0;
+            else return 0;
+            return 1;
+
+        case valueAtom:
+            result->as.asAtom = AtomIntern(text);
+            return result->as.asAtom != 0;
+
+        default:
+            return 0;
+    }
+}
+
+
+/**
+ * @brief Keeps the parsed value of an entry read through a const map
+ * 
+ * The TypedValue is filled before it is published with a single compare and swap, so readers
+ * on other threads see it whole or not at all. When the value changed meanwhile (another reader
+ * decoded it or attached its own TypedValue) the copy is dropped and nothing is kept.
+ */
+static void cacheTyped(const struct HashMapEntry *entry, char *value, const struct TypedValue *parsed)
+{
+    struct TypedValue *typed = (struct TypedValue *)AllocatorAlloc(allocatorHashMap, sizeof(struct TypedValue));
+    if(!typed) return;
+    *typed = *parsed;
+    typed->text = value;
+
+    char *tagged = (char *)((uintptr_t)typed | TYPED_VALUE_TAG);
+    if(!atomic_compare_exchange_strong_explicit(&((struct HashMapEntry *)entry)->value, &value, tagged, memory_order_acq_rel, memory_order_acquire))
+    {
+        AllocatorFree(allocatorHashMap, typed, sizeof(struct TypedValue));
+    }
+}
+
+
+/**
+ * @brief Parses the value of an entry, caching the result on the first access
+ * 
+ * Only one kind is cached per value: a value read as another kind is parsed again at each
+ * access, as it is when the cache could not be allocated.
+ *
+ * @return 1 if the value was parsed to the kind, 0 otherwise
+ */
+static int entryTyped(const struct HashMapEntry *entry, valueKind kind, struct TypedValue *result)
+{
+    // Decode the string first, the value then only changes once more when it is cached
+    const char *text = readValue(entry);
+    if(!text) return 0;
+
+    // The value was already parsed to this kind
+    char *value = loadValue(entry);
+    if(valueTag(value) == TYPED_VALUE_TAG)
+    {
+        const struct TypedValue *typed = (const struct TypedValue *)untagged(value);
+        if(typed->kind != kind) return parseValue(text, kind, result);
+        *result = *typed;
+        return 1;
+    }
+
+    // Parse the string once and keep the result, the string stays where it is
+    if(!parseValue(text, kind, result)) return 0;
+    cacheTyped(entry, value, result);
+    return 1;
+}
+
+
+/**
+ * @brief Parses the value of a key, see entryTyped
+ *
+ * @return 1 if the value was parsed to the kind, 0 if the key is missing or its value
+ *         cannot be parsed to the kind
+ */
+static int getTyped(const HashMap *map, const char *key, valueKind kind, struct TypedValue *result)
+{
+    struct HashMapEntry *entry = findEntry(map, key);
+    return entry ? entryTyped(entry, kind, result) : 0;
+}
+
+
+/**
+ * @brief Stores an already parsed value and its string for a key, as HashMapPut does for strings
+ * 
+ * When the parsed value cannot be attached the string alone is kept, and the typed getters
+ * parse it on their first access as for any string: the put still succeeds.
+ */
+static int putTyped(HashMap *map, const char *key, const char *text, const struct TypedValue *parsed)
+{
+    // Store the string first, then attach the parsed value to it
+    int result = HashMapPut(map, key, text);
+    if(result == -1) return -1;
+
+    attachTyped(findEntry(map, key), parsed);
+    return result;
+}
+
+
+/**
+ * @brief Orders the entries of a frozen HashMap by hash, then by key
+ */
+static int compareFrozen(const void *first, const void *second)
+{
+    const struct FrozenEntry *a = first, *b = second;
+    if(a->hash != b->hash) return a->hash < b->hash ? -1 : 1;
+    return strcmp(a->key, b->key);
+}
+
+
+/**
+ * @brief Returns the entry of a frozen HashMap holding a key, or NULL if the key is not in it
+ */
+static const struct FrozenEntry *findFrozen(const FrozenHashMap *frozen, const char *key)
+{
+    unsigned int hash = HashString(key);
+    int low = 0, high = frozen->size;
+
+    // Find the first entry with the hash, linearly while there are only a few
+    if(frozen->size <= FROZEN_LINEAR_SEARCH)
+    {
+        while(low < high && frozen->entries[low].hash < hash) low++;
+    }
+    else
+    {
+        while(low < high)
+        {
+            int middle = low + (high - low) / 2;
+            if(frozen->entries[middle].hash < hash) low = middle + 1;
+            else high = middle;
+        }
+    }
+
+    // Compare the keys of the entries sharing the hash
+    for(int i = low; i < frozen->size && frozen->entries[i].hash == hash; i++)
+    {
+        if(strcmp(frozen->entries[i].key, key) == 0) return &frozen->entries[i];
+    }
+
+    return NULL;
+}
+
+
+
+
+HashMap *HashMapNew()
+{
+    // Allocate memory for the HashMap
+    HashMap *map = (HashMap *)AllocatorAlloc(allocatorHashMap, sizeof(HashMap));
+    if(!map) return NULL;
+
+    // Initialize the HashMap's size, its entries start inline
+    map->size = 0;
+    map->capacity = 0;
+
+    return map;
+}
+
+
+
+
+HashMap *HashMapNewWithCapacity(int capacity)
+{
+    // Check the input parameter
+    if(capacity < 0 || capacity > INT_MAX / 8) return NULL;
+
+    HashMap *map = HashMapNew();
+    if(!map || capacity <= HASHMAP_INLINE_CAPACITY) return map;
+
+    // The smallest table that stays at most three quarters full with every entry
+    int slots = HASHMAP_INITIAL_SLOTS;
+    while(capacity * 4 > slots * 3) slots *= 2;
+
+    if(allocateTable(map, slots) == -1)
+    {
+        AllocatorFree(allocatorHashMap, map, sizeof(HashMap));
+        return NULL;
+    }
+
+    return map;
+}
+
+
+
+
+int HashMapPut(HashMap *map, const char *key, const char *value)
+{
+    // Check the input parameters
+    if(!map || !key || !value) return -1;
+
+    // If the key exists, update the value and return 0
+    struct HashMapEntry *entry = findEntry(map, key);
+    if(entry) return updateEntry(entry, value) == -1 ? -1 : 0;
+
+    // Otherwise add a new key-value pair
+    return insertEntry(map, key, value) ? 1 : -1;
+}
+
+
+
+
+int HashMapPutEscaped(HashMap *map, const char *key, const char *value, int escaped)
+{
+    // Check the input parameters
+    if(!map || !key || !value) return -1;
+
+    int result = 0;
+    struct HashMapEntry *entry = findEntry(map, key);
+    if(entry && updateEntry(entry, value) == -1) return -1;
+    if(!entry)
+    {
+        if(!(entry = insertEntry(map, key, value))) return -1;
+        result = 1;
+    }
+
+    // The value is stored as it is, its entities are decoded when it is first read
+    if(escaped) atomic_store_explicit(&entry->value, (char *)((uintptr_t)storedValue(entry) | ESCAPED_VALUE_TAG), memory_order_relaxed);
+    return result;
+}
+
+
+
+
+char *HashMapGet(const HashMap *map, const char *key)
+{
+    // Check the input parameters
+    if(!map || !key) return NULL;
+    if(!map->size) return NULL;
+
+    struct HashMapEntry *entry = findEntry(map, key);
+    return entry ? readValue(entry) : NULL;
+}
+
+
+
+
+int HashMapRemove(HashMap *map, char *key)
+{
+    // Check the input parameters
+    if(!map || !key) return -1;
+
+    // Remove an inline entry, keeping the others in insertion order
+    if(!map->capacity)
+    {
+        int index = findInline(map, key);
+        if(index == -1) return 0;
+
+        freeEntry(&map->inlined.entries[index]);
+        int after = map->size - index - 1;
+        memmove(&map->inlined.entries[index], &map->inlined.entries[index + 1], after * sizeof(struct HashMapEntry));
+        memmove(&map->inlined.fingerprints[index], &map->inlined.fingerprints[index + 1], after * sizeof(unsigned int));
+        map->size--;
+        return 1;
+    }
+
+    // Empty the slot of the key
+    int mask = map->capacity - 1;
+    int hole = findSlot(map, key, HashString(key));
+    if(!map->table.entries[hole].key) return 0;
+
+    freeEntry(&map->table.entries[hole]);
+    map->size--;
+
+    // Shift back the following entries of the probe sequence that may fill the hole
+    for(int slot = (hole + 1) & mask; map->table.entries[slot].key; slot = (slot + 1) & mask)
+    {
+        int home = map->table.hashes[slot] & mask;
+        if(((slot - home) & mask) < ((slot - hole) & mask)) continue;
+
+        map->table.entries[hole] = map->table.entries[slot];
+        map->table.hashes[hole] = map->table.hashes[slot];
+        hole = slot;
+    }
+    map->table.entries[hole].key = NULL;
+
+    return 1;
+}
+
+
+
+
+int HashMapContainsKey(const HashMap *map, const char *key)
+{
+    // Check the input parameters
+    if(!map || !key) return -1;
+
+    return findEntry(map, key) ? 1 : 0;
+}
+
+
+
+
+int HashMapContainsValue(const HashMap *map, const char *value)
+{
+    // Check the input parameters
+    if(!map || !value) return -1;
+
+    // Visit every entry to find the specified value
+    struct EntryIterator iterator = { map, 0 };
+    for(struct HashMapEntry *entry = nextEntry(&iterator); entry; entry = nextEntry(&iterator))
+    {
+        const char *text = readValue(entry);
+        if(!text) return -1;
+        if(strcmp(text, value) == 0) return 1;
+    }
+
+    return 0;
+}
+
+
+
+
+int HashMapSize(const HashMap *map)
+{
+    // Check the input parameters
+    if(!map) return -1;
+
+    return map->size;
+}
+
+
+
+
+int HashMapForEach(const HashMap *map, void (*callback)(const char *key, const char *value, void *userData), void *userData)
+{
+    // Check the input parameters
+    if(!map || !callback) return -1;
+
+    // Visit each key-value pair
+    int count = 0;
+    struct EntryIterator iterator = { map, 0 };
+    for(struct HashMapEntry *entry = nextEntry(&iterator); entry; entry = nextEntry(&iterator))
+    {
+        const char *value = readValue(entry);
+        if(!value) return -1;
+        callback(entry->key, value, userData);
+        count++;
+    }
+
+    return count;
+}
+
+
+
+
+void HashMapFree(HashMap *map)
+{
+    // Check the input parameters
+    if(!map) return;
+
+    // Free the entries, then the table if the HashMap outgrew its inline entries
+    struct EntryIterator iterator = { map, 0 };
+    for(struct HashMapEntry *entry = nextEntry(&iterator); entry; entry = nextEntry(&iterator)) freeEntry(entry);
+    if(map->capacity) AllocatorFree(allocatorHashMap, map->table.entries, tableSize(map->capacity));
+
+    // Free the memory for the HashMap
+    AllocatorFree(allocatorHashMap, map, sizeof(HashMap));
+}
+
+
+
+
+void HashMapPrint(const HashMap *map)
+{
+    // Check the input parameters
+    if(!map) return;
+
+    // Print the HashMap
+    printf("\n-------------------------------------\n");
+    printf("The current state of the HashMap is :\n");
+    printf("-------------------------------------\n");
+
+    // if the HashMap is empty
+    if(map->size == 0){
+        printf("The HashMap is empty\n");
+        printf("-------------------------------------\n");
+        return;
+    } 
+
+    // Visit the entries and print the key-value pairs
+    struct EntryIterator iterator = { map, 0 };
+    for(struct HashMapEntry *entry = nextEntry(&iterator); entry; entry = nextEntry(&iterator))
+    {
+        const char *value = readValue(entry);
+        printf("Key: %s, Value: %s\n", entry->key, value ? value : valueText(entry));
+    }
+    printf("-------------------------------------\n");
+}
+
+
+
+
+HashMap *HashMapGetCopy(const HashMap *hashMap)
+{
+    // Check the input parameters
+    if(!hashMap) return NULL;
+
+    // Create a new HashMap
+    HashMap *newHashMap = HashMapNew();
+    if(!newHashMap) return NULL;
+
+    // Copy the inline entries in place, keeping their order and the values already parsed
+    if(!hashMap->capacity)
+    {
+        for(int i = 0; i < hashMap->size; i++)
+        {
+            if(copyEntry(&newHashMap->inlined.entries[i], &hashMap->inlined.entries[i]) == -1)
+            {
+                HashMapFree(newHashMap);
+                return NULL;
+            }
+            newHashMap->inlined.fingerprints[i] = hashMap->inlined.fingerprints[i];
+            newHashMap->size++;
+        }
+        return newHashMap;
+    }
+
+    // Otherwise copy the table slot by slot, the entries keep their slot and hash
+    if(allocateTable(newHashMap, hashMap->capacity) == -1)
+    {
+        AllocatorFree(allocatorHashMap, newHashMap, sizeof(HashMap));
+        return NULL;
+    }
+
+    for(int i = 0; i < hashMap->capacity; i++)
+    {
+        if(!hashMap->table.entries[i].key) continue;
+        if(copyEntry(&newHashMap->table.entries[i], &hashMap->table.entries[i]) == -1)
+        {
+            HashMapFree(newHashMap);
+            return NULL;
+        }
+        newHashMap->table.hashes[i] = hashMap->table.hashes[i];
+        newHashMap->size++;
+    }
 
-/**
- * @brief Represents a node in the HashMap's linked list
- * 
- * This structure defines a single node containing a key-value pair
- * and a pointer to the next node in the list
- */
-struct Node
+    return newHashMap;
+}
+
+
+
+
+size_t HashMapMemoryUsage(const HashMap *map, MemoryUsage *usage)
 {
-    char *key;          ///< A dynamically allocated string representing the node's key
-    char *value;        ///< A dynamically allocated string representing the node's value
-    struct Node *next;  ///< Pointer to the next node in the linked list
-};
+    // Check the input parameters
+    if(!map) return 0;
+
+    size_t maps = sizeof(HashMap) + (map->capacity ? tableSize(map->capacity) : 0), keys = 0, values = 0;
 
+    // The key of an entry takes its block up to the value, the value the rest
+    struct EntryIterator iterator = { map, 0 };
+    for(struct HashMapEntry *entry = nextEntry(&iterator); entry; entry = nextEntry(&iterator))
+    {
+        keys += sizeof(Atom) + valueOffset(strlen(entry->key));
+        const char *value = loadValue(entry);
+        values += strlen(storedValue(entry)) + 1 + (valueTag(value) == TYPED_VALUE_TAG ? sizeof(struct TypedValue) : 0);
+
+        // A decoded copy is counted next to the escaped value it was decoded from
+        if(valueString(value) != storedValue(entry)) values += strlen(valueString(value)) + 1;
+    }
+
+    if(usage)
+    {
+        usage->maps += maps;
+        usage->keys += keys;
+        usage->values += values;
+    }
+    return maps + keys + values;
+}
 
 
 
-HashMap *HashMapNew()
+
+int HashMapPutInt(HashMap *map, const char *key, long value)
 {
-    // Allocate memory for the HashMap
-    HashMap *map = (HashMap *)malloc(sizeof(HashMap));
-    if(!map) return NULL;
+    // Check the input parameters
+    if(!map || !key) return -1;
 
-    // Initialize the HashMap's size and head pointer
-    map->size = 0;
-    map->head = NULL;
+    char text[32];
+    snprintf(text, sizeof(text), "%ld", value);
 
-    return map;
+    struct TypedValue parsed = { valueInt, { .asInt = value }, NULL };
+    return putTyped(map, key, text, &parsed);
 }
 
 
 
 
-int HashMapPut(HashMap *map, const char *key, const char *value)
+int HashMapPutDouble(HashMap *map, const char *key, double value)
+{
+    // Check the input parameters
+    if(!map || !key) return -1;
+
+    // Enough digits to read the same double back
+    char text[32];
+    snprintf(text, sizeof(text), "%.17g", value);
+
+    struct TypedValue parsed = { valueDouble, { .asDouble = value }, NULL };
+    return putTyped(map, key, text, &parsed);
+}
+
+
+
+
+int HashMapPutBool(HashMap *map, const char *key, int value)
+{
+    // Check the input parameters
+    if(!map || !key) return -1;
+
+    struct TypedValue parsed = { valueBool, { .asBool = value ? 1 : 0 }, NULL };
+    return putTyped(map, key, value ? "true" : "false", &parsed);
+}
+
+
+
+
+int HashMapGetInt(const HashMap *map, const char *key, long *value)
 {
     // Check the input parameters
     if(!map || !key || !value) return -1;
 
-    // Check if the key already exists in the HashMap
-    if(HashMapContainsKey(map, key))
-    {
-        // If the key exists, update the value and return 0
-        struct Node *current = map->head;
-        while(current)
-        {
-            if(strcmp(current->key, key) == 0)
-            {
-                free(current->value);
-                current->value = (char *)malloc(strlen(value) + 1);
-                if(!current->value) return -1;
-                strcpy(current->value, value);
-                return 0;
-            }
-            current = current->next;
-        }
-    }
+    struct TypedValue typed;
+    if(!getTyped(map, key, valueInt, &typed)) return 0;
 
-    // Allocate memory for the new node
-    struct Node *newNode = (struct Node *)malloc(sizeof(struct Node));
-    if(!newNode) return -1;
+    *value = typed.as.asInt;
+    return 1;
+}
 
-    // Allocate memory for the key and value strings
-    newNode->key = (char *)malloc(strlen(key) + 1);
-    if(!newNode->key){
-        free(newNode);
-        return -1;
-    }
 
-    newNode->value = (char *)malloc(strlen(value) + 1);
-    if(!newNode->value) 
-    {
-        free(newNode->key);
-        free(newNode);
-        return -1;
-    }
 
-    // Copy the key and value strings into the new node
-    strcpy(newNode->key, key);
-    strcpy(newNode->value, value);
-    
-    // Insert the new node at the beginning of the linked list
-    newNode->next = map->head;
-    map->head = newNode;
-    map->size++;
 
+int HashMapGetDouble(const HashMap *map, const char *key, double *value)
+{
+    // Check the input parameters
+    if(!map || !key || !value) return -1;
+
+    struct TypedValue typed;
+    if(!getTyped(map, key, valueDouble, &typed)) return 0;
+
+    *value = typed.as.asDouble;
     return 1;
 }
 
 
 
 
-char *HashMapGet(const HashMap *map, const char *key)
+int HashMapGetBool(const HashMap *map, const char *key, int *value)
+{
+    // Check the input parameters
+    if(!map || !key || !value) return -1;
+
+    struct TypedValue typed;
+    if(!getTyped(map, key, valueBool, &typed)) return 0;
+
+    *value = typed.as.asBool;
+    return 1;
+}
+
+
+
+
+int HashMapGetAtom(const HashMap *map, const char *key, Atom *value)
+{
+    // Check the input parameters
+    if(!map || !key || !value) return -1;
+
+    struct TypedValue typed;
+    if(!getTyped(map, key, valueAtom, &typed)) return 0;
+
+    *value = typed.as.asAtom;
+    return 1;
+}
+
+
+
+
+const HashMapEntry *HashMapGetEntry(const HashMap *map, const char *key)
 {
     // Check the input parameters
     if(!map || !key) return NULL;
 
-    // Traverse the linked list to find the node with the specified key
-    struct Node *current = map->head;
-    while(current)
+    return findEntry(map, key);
+}
+
+
+
+
+int HashMapForEachEntry(const HashMap *map, void (*callback)(const HashMapEntry *entry, void *userData), void *userData)
+{
+    // Check the input parameters
+    if(!map || !callback) return -1;
+
+    // Visit each entry, in the same order as HashMapForEach
+    int count = 0;
+    struct EntryIterator iterator = { map, 0 };
+    for(struct HashMapEntry *entry = nextEntry(&iterator); entry; entry = nextEntry(&iterator))
     {
-        if(strcmp(current->key, key) == 0)
-        {
-            return current->value;
-        }
-        current = current->next;
+        callback(entry, userData);
+        count++;
     }
 
-    return NULL;
+    return count;
 }
 
 
 
 
-int HashMapRemove(HashMap *map, char *key)
+const char *HashMapEntryGetKey(const HashMapEntry *entry)
+{
+    // Check the input parameter
+    if(!entry) return NULL;
+
+    return entry->key;
+}
+
+
+
+
+Atom HashMapEntryGetKeyAtom(const HashMapEntry *entry)
+{
+    // Check the input parameter
+    if(!entry) return 0;
+
+    // Interned on the first call only, the atom is kept in the block of the entry (readers racing store the same atom)
+    Atom atom = atomic_load_explicit(entryBlock(entry), memory_order_relaxed);
+    if(atom) return atom;
+
+    atom = AtomIntern(entry->key);
+    atomic_store_explicit(entryBlock(entry), atom, memory_order_relaxed);
+    return atom;
+}
+
+
+
+
+const char *HashMapEntryGetValue(const HashMapEntry *entry)
+{
+    // Check the input parameter
+    if(!entry) return NULL;
+
+    return readValue(entry);
+}
+
+
+
+
+int HashMapEntryGetInt(const HashMapEntry *entry, long *value)
 {
     // Check the input parameters
-    if(!map || !key) return -1;
+    if(!entry || !value) return -1;
 
-    // Traverse the linked list to find the node with the specified key
-    struct Node *current = map->head;
-    
-    // Check if the key is in the first node
-    if(strcmp(current->key, key) == 0)
-    {
-        // Remove the first node
-        map->head = current->next;
-        free(current->key);
-        free(current->value);
-        free(current);
-        map->size--;
-        return 1;
-    }
+    struct TypedValue typed;
+    if(!entryTyped(entry, valueInt, &typed)) return 0;
 
-    // Traverse the linked list to find the node with the specified key
-    while(current->next)
-    {
-        if(strcmp(current->next->key, key) == 0)
-        {
-            // Remove the node
-            struct Node *temp = current->next;
-            current->next = temp->next;
-            free(temp->key);
-            free(temp->value);
-            free(temp);
-            map->size--;
-            return 1;
-        }
-        current = current->next;
-    }
+    *value = typed.as.asInt;
+    return 1;
+}
 
-    return 0;
+
+
+
+int HashMapEntryGetDouble(const HashMapEntry *entry, double *value)
+{
+    // Check the input parameters
+    if(!entry || !value) return -1;
+
+    struct TypedValue typed;
+    if(!entryTyped(entry, valueDouble, &typed)) return 0;
+
+    *value = typed.as.asDouble;
+    return 1;
 }
 
 
 
 
-int HashMapContainsKey(const HashMap *map, const char *key)
+int HashMapEntryGetBool(const HashMapEntry *entry, int *value)
 {
     // Check the input parameters
-    if(!map || !key) return -1;
+    if(!entry || !value) return -1;
 
-    // Traverse the linked list to find the node with the specified key
-    struct Node *current = map->head;
-    while(current)
-    {
-        if(strcmp(current->key, key) == 0) return 1;
-        current = current->next;
-    }
+    struct TypedValue typed;
+    if(!entryTyped(entry, valueBool, &typed)) return 0;
 
-    return 0;
+    *value = typed.as.asBool;
+    return 1;
 }
 
 
 
 
-int HashMapContainsValue(const HashMap *map, const char *value)
+int HashMapEntryGetAtom(const HashMapEntry *entry, Atom *value)
 {
     // Check the input parameters
-    if(!map || !value) return -1;
+    if(!entry || !value) return -1;
+
+    struct TypedValue typed;
+    if(!entryTyped(entry, valueAtom, &typed)) return 0;
+
+    *value = typed.as.asAtom;
+    return 1;
+}
+
 
-    // Traverse the linked list to find the node with the specified value
-    struct Node *current = map->head;
-    while(current)
+
+
+FrozenHashMap *HashMapFreeze(const HashMap *map)
+{
+    // Check the input parameters
+    if(!map) return NULL;
+
+    // Measure the strings, they are stored right after the entries
+    size_t bytes = sizeof(FrozenHashMap) + map->size * sizeof(struct FrozenEntry);
+    struct EntryIterator iterator = { map, 0 };
+    for(struct HashMapEntry *entry = nextEntry(&iterator); entry; entry = nextEntry(&iterator))
     {
-        if(strcmp(current->value, value) == 0) return 1;
-        current = current->next;
+        const char *value = readValue(entry);
+        if(!value) return NULL;
+        bytes += strlen(entry->key) + strlen(value) + 2;
     }
 
-    return 0;
+    FrozenHashMap *frozen = (FrozenHashMap *)AllocatorAlloc(allocatorHashMap, bytes);
+    if(!frozen) return NULL;
+
+    atomic_init(&frozen->references, 1);
+    frozen->size = map->size;
+    frozen->bytes = (unsigned int)bytes;
+
+    // Copy the pairs
+    char *strings = (char *)&frozen->entries[map->size];
+    struct FrozenEntry *frozenEntry = frozen->entries;
+    iterator = (struct EntryIterator){ map, 0 };
+    for(struct HashMapEntry *entry = nextEntry(&iterator); entry; entry = nextEntry(&iterator), frozenEntry++)
+    {
+        size_t keyLength = strlen(entry->key) + 1;
+        const char *value = valueText(entry);
+        size_t valueLength = strlen(value) + 1;
+
+        frozenEntry->hash = HashString(entry->key);
+        frozenEntry->key = memcpy(strings, entry->key, keyLength);
+        frozenEntry->value = memcpy(strings + keyLength, value, valueLength);
+        strings += keyLength + valueLength;
+    }
+
+    // Sort them, then hash them in that order so equal snapshots hash the same
+    qsort(frozen->entries, frozen->size, sizeof(struct FrozenEntry), compareFrozen);
+
+    unsigned int hash = 2166136261u;
+    for(int i = 0; i < frozen->size; i++)
+    {
+        hash = (hash ^ frozen->entries[i].hash) * 16777619u;
+        hash = (hash ^ HashString(frozen->entries[i].value)) * 16777619u;
+    }
+    frozen->hash = hash;
+
+    return frozen;
 }
 
 
 
 
-int HashMapSize(const HashMap *map)
+FrozenHashMap *FrozenHashMapRetain(FrozenHashMap *frozen)
 {
     // Check the input parameters
-    if(!map) return -1;
+    if(!frozen) return NULL;
 
-    return map->size;
+    atomic_fetch_add_explicit(&frozen->references, 1, memory_order_relaxed);
+    return frozen;
 }
 
 
 
 
-void HashMapFree(HashMap *map)
+void FrozenHashMapRelease(FrozenHashMap *frozen)
 {
     // Check the input parameters
-    if(!map) return;
+    if(!frozen) return;
 
-    // Traverse the linked list and free the memory for each node
-    struct Node *current = map->head;
-    while(current)
-    {
-        struct Node *temp = current;
-        current = current->next;
-        free(temp->key);
-        free(temp->value);
-        free(temp);
-    }
+    // The last owner frees the snapshot, after every other owner is done with it
+    if(atomic_fetch_sub_explicit(&frozen->references, 1, memory_order_acq_rel) == 1) AllocatorFree(allocatorHashMap, frozen, frozen->bytes);
+}
 
-    // Free the memory for the HashMap
-    free(map);
+
+
+
+const char *FrozenHashMapGet(const FrozenHashMap *frozen, const char *key)
+{
+    // Check the input parameters
+    if(!frozen || !key) return NULL;
+
+    const struct FrozenEntry *entry = findFrozen(frozen, key);
+    return entry ? entry->value : NULL;
 }
 
 
 
 
-void HashMapPrint(const HashMap *map)
+int FrozenHashMapContainsKey(const FrozenHashMap *frozen, const char *key)
 {
     // Check the input parameters
-    if(!map) return;
+    if(!frozen || !key) return -1;
 
-    // Print the HashMap
-    printf("\n-------------------------------------\n");
-    printf("The current state of the HashMap is :\n");
-    printf("-------------------------------------\n");
+    return findFrozen(frozen, key) ? 1 : 0;
+}
 
-    // if the HashMap is empty
-    if(map->size == 0){
-        printf("The HashMap is empty\n");
-        printf("-------------------------------------\n");
-        return;
-    } 
 
-    // Traverse the linked list and print the key-value pairs
-    struct Node *current = map->head;
-    while(current)
+
+
+int FrozenHashMapSize(const FrozenHashMap *frozen)
+{
+    // Check the input parameters
+    if(!frozen) return -1;
+
+    return frozen->size;
+}
+
+
+
+
+int FrozenHashMapForEach(const FrozenHashMap *frozen, void (*callback)(const char *key, const char *value, void *userData), void *userData)
+{
+    // Check the input parameters
+    if(!frozen || !callback) return -1;
+
+    for(int i = 0; i < frozen->size; i++) callback(frozen->entries[i].key, frozen->entries[i].value, userData);
+
+    return frozen->size;
+}
+
+
+
+
+int FrozenHashMapEquals(const FrozenHashMap *first, const FrozenHashMap *second)
+{
+    // Check the input parameters
+    if(!first || !second) return -1;
+
+    if(first == second) return 1;
+    if(first->size != second->size || first->hash != second->hash) return 0;
+
+    // Equal snapshots have their entries in the same order
+    for(int i = 0; i < first->size; i++)
     {
-        printf("Key: %s, Value: %s\n", current->key, current->value);
-        current = current->next;
+        const struct FrozenEntry *a = &first->entries[i], *b = &second->entries[i];
+        if(a->hash != b->hash || strcmp(a->key, b->key) != 0 || strcmp(a->value, b->value) != 0) return 0;
     }
-    printf("-------------------------------------\n");
+
+    return 1;
 }
 
 
 
 
-HashMap *HashMapGetCopy(const HashMap *hashMap)
+unsigned int FrozenHashMapHash(const FrozenHashMap *frozen)
 {
     // Check the input parameters
-    if(!hashMap) return NULL;
+    if(!frozen) return 0;
 
-    // Create a new HashMap
-    HashMap *newHashMap = HashMapNew();
-    if(!newHashMap) return NULL;
+    return frozen->hash;
+}
+
+
+
+
+HashMap *FrozenHashMapThaw(const FrozenHashMap *frozen)
+{
+    // Check the input parameters
+    if(!frozen) return NULL;
+
+    HashMap *map = HashMapNew();
+    if(!map) return NULL;
 
-    // Traverse the linked list and copy the key-value pairs
-    struct Node *current = hashMap->head;
-    while(current)
+    for(int i = 0; i < frozen->size; i++)
     {
-        HashMapPut(newHashMap, current->key, current->value);
-        current = current->next;
+        if(insertEntry(map, frozen->entries[i].key, frozen->entries[i].value) == NULL)
+        {
+            HashMapFree(map);
+            return NULL;
+        }
     }
 
-    return newHashMap;
+    return map;
+}
+
+
+
+
+size_t FrozenHashMapMemoryUsage(const FrozenHashMap *frozen)
+{
+    // Check the input parameters
+    if(!frozen) return 0;
+
+    return frozen->bytes / atomic_load_explicit(&frozen->references, memory_order_relaxed);
 }
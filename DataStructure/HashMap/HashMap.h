@@ -17,19 +17,41 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "../../Utils/Allocator.h"
+#include "../../Utils/Atom.h"
+
+#ifndef HASHMAP_INLINE_CAPACITY
+#define HASHMAP_INLINE_CAPACITY 8   ///< The number of entries stored inside the HashMap before it allocates a table
+#endif
 
 typedef struct HashMap HashMap;
+typedef struct FrozenHashMap FrozenHashMap;
+typedef struct HashMapEntry HashMapEntry;
 
 /**
  * @brief Creates a new, empty HashMap
  * 
- * Allocates memory for a new HashMap and initializes its size to 0 and head to NULL
+ * Allocates memory for a new HashMap and initializes its size to 0. The first
+ * HASHMAP_INLINE_CAPACITY entries are stored inside the HashMap, a table of buckets is
+ * only allocated once it grows beyond that.
  * 
  * @return A pointer to the newly created HashMap, or NULL if memory allocation fails
  */
 HashMap *HashMapNew();
 
 
+/**
+ * @brief Creates a new, empty HashMap sized for a number of entries
+ * 
+ * The table is allocated at once, at its final size, if the entries do not fit inline, so
+ * putting that many keys never grows it.
+ * 
+ * @param capacity The number of entries the HashMap will hold
+ * @return A pointer to the newly created HashMap, or NULL if the capacity is negative or memory allocation fails
+ */
+HashMap *HashMapNewWithCapacity(int capacity);
+
+
 /**
  * @brief Adds a key-value pair to the HashMap
  * 
@@ -44,14 +66,33 @@ HashMap *HashMapNew();
 int HashMapPut(HashMap *map, const char *key, const char *value);
 
 
+/**
+ * @brief Adds a key-value pair whose value may still contain markup entities
+ * 
+ * Behaves like HashMapPut, but when escaped is set the value is kept as it is and its entities
+ * (the five named ones of the markup and the numeric ones) are decoded when it is first read.
+ * The decoded copy is allocated apart and kept with the entry, whose key and raw value stay in place,
+ * so that first read writes to the map even through a const pointer: concurrent readers are safe,
+ * a read concurrent with a write is not. Values without entities are never decoded nor copied twice.
+ * 
+ * @param map Pointer to the HashMap
+ * @param key Key to be inserted or updated
+ * @param value Value associated with the key, possibly with entities
+ * @param escaped Non zero if the value contains an '&' to decode
+ * @return 1 if successful, 0 if key already exists (value updated), -1 if an error occurs
+ */
+int HashMapPutEscaped(HashMap *map, const char *key, const char *value, int escaped);
+
+
 /**
  * @brief Retrieves the value associated with a given key in the HashMap
  * 
- * Searches the HashMap for the specified key and returns its corresponding value.
+ * Searches the HashMap for the specified key and returns its corresponding value. The first read
+ * of a value put by HashMapPutEscaped caches its decoded copy in the map (see HashMapPutEscaped).
  * 
  * @param map Pointer to the HashMap to search
  * @param key Key to look up in the HashMap
- * @return The value associated with the key, or NULL if the key is not found
+ * @return The value associated with the key, or NULL if the key is not found (or if its entities could not be decoded)
  */
 char *HashMapGet(const HashMap *map, const char *key);
 
@@ -104,6 +145,20 @@ int HashMapContainsValue(const HashMap *map, const char *value);
 int HashMapSize(const HashMap *map);
 
 
+/**
+ * @brief Calls a function on every key-value pair of the HashMap
+ * 
+ * While the entries are inline they are visited from the newest, otherwise in no particular
+ * order. The callback must not modify the HashMap.
+ * 
+ * @param map Pointer to the HashMap to visit
+ * @param callback The function to call with each key and value
+ * @param userData Pointer passed unchanged to the callback
+ * @return The number of pairs visited, or -1 if an error occurs
+ */
+int HashMapForEach(const HashMap *map, void (*callback)(const char *key, const char *value, void *userData), void *userData);
+
+
 /**
  * @brief Frees all memory associated with the HashMap
  * 
@@ -139,4 +194,326 @@ void HashMapPrint(const HashMap *map);
 HashMap *HashMapGetCopy(const HashMap *hashMap);
 
 
+/**
+ * @brief Measures the memory used by the HashMap
+ * 
+ * The structure and its table count as maps, the rest of the blocks of the entries as keys and
+ * values, the parsed values as values.
+ * 
+ * @param map Pointer to the HashMap to measure
+ * @param usage The footprint the HashMap is added to, or NULL
+ * @return The number of bytes used by the HashMap
+ */
+size_t HashMapMemoryUsage(const HashMap *map, MemoryUsage *usage);
+
+
+/**
+ * @brief Adds an integer value to the HashMap
+ * 
+ * The value is stored as its decimal string (returned by HashMapGet) and as an integer,
+ * so HashMapGetInt does not need to parse it. When the integer cannot be kept, the string
+ * alone is stored and parsed on the first typed access, as for HashMapPut.
+ * 
+ * @param map Pointer to the HashMap
+ * @param key Key to be inserted or updated
+ * @param value Value associated with the key
+ * @return 1 if successful, 0 if key already exists (value updated), -1 if an error occurs
+ */
+int HashMapPutInt(HashMap *map, const char *key, long value);
+
+
+/**
+ * @brief Adds a floating point value to the HashMap
+ * 
+ * @param map Pointer to the HashMap
+ * @param key Key to be inserted or updated
+ * @param value Value associated with the key
+ * @return 1 if successful, 0 if key already exists (value updated), -1 if an error occurs
+ */
+int HashMapPutDouble(HashMap *map, const char *key, double value);
+
+
+/**
+ * @brief Adds a boolean value to the HashMap, stored as "true" or "false"
+ * 
+ * @param map Pointer to the HashMap
+ * @param key Key to be inserted or updated
+ * @param value Value associated with the key (any non-zero value is true)
+ * @return 1 if successful, 0 if key already exists (value updated), -1 if an error occurs
+ */
+int HashMapPutBool(HashMap *map, const char *key, int value);
+
+
+/**
+ * @brief Retrieves the value associated with a key as an integer
+ * 
+ * The string is parsed on the first typed access and the result is kept with the value,
+ * so the next calls do not parse it again. The whole string must be a decimal integer.
+ * That first access writes to the map even through a const pointer: concurrent readers are
+ * safe, a read concurrent with a write is not. Only the first kind read is kept, a value read
+ * as another kind (or whose result could not be allocated) is parsed again at each access.
+ * The other typed getters, of the map and of its entries, behave the same.
+ * 
+ * @param map Pointer to the HashMap to search
+ * @param key Key to look up in the HashMap
+ * @param value Receives the integer value
+ * @return 1 if found and converted, 0 if the key is not found or the value is not an integer,
+ *         -1 if an error occurs
+ */
+int HashMapGetInt(const HashMap *map, const char *key, long *value);
+
+
+/**
+ * @brief Retrieves the value associated with a key as a floating point number
+ * 
+ * @param map Pointer to the HashMap to search
+ * @param key Key to look up in the HashMap
+ * @param value Receives the floating point value
+ * @return 1 if found and converted, 0 if the key is not found or the value is not a number,
+ *         -1 if an error occurs
+ */
+int HashMapGetDouble(const HashMap *map, const char *key, double *value);
+
+
+/**
+ * @brief Retrieves the value associated with a key as a boolean ("true", "false", "1" or "0")
+ * 
+ * @param map Pointer to the HashMap to search
+ * @param key Key to look up in the HashMap
+ * @param value Receives 1 for true or 0 for false
+ * @return 1 if found and converted, 0 if the key is not found or the value is not a boolean,
+ *         -1 if an error occurs
+ */
+int HashMapGetBool(const HashMap *map, const char *key, int *value);
+
+
+/**
+ * @brief Retrieves the value associated with a key as an atom
+ * 
+ * Useful for enumerated values (e.g., orientation="vertical"), which can then be compared
+ * as integers.
+ * 
+ * @param map Pointer to the HashMap to search
+ * @param key Key to look up in the HashMap
+ * @param value Receives the atom of the value
+ * @return 1 if found, 0 if the key is not found, -1 if an error occurs
+ */
+int HashMapGetAtom(const HashMap *map, const char *key, Atom *value);
+
+
+/**
+ * @brief Returns the entry of a key, to read its key atom and value without looking it up again
+ * 
+ * The entry stays valid until the key is put again, removed, or the HashMap grows or is freed.
+ * 
+ * @param map Pointer to the HashMap to search
+ * @param key Key to look up in the HashMap
+ * @return The entry, or NULL if the key is not found or an error occurs
+ */
+const HashMapEntry *HashMapGetEntry(const HashMap *map, const char *key);
+
+
+/**
+ * @brief Calls a function on every entry of the HashMap
+ * 
+ * The entries are visited in the same order as by HashMapForEach. The callback must not
+ * modify the HashMap, but can read the entry with the HashMapEntry functions.
+ * 
+ * @param map Pointer to the HashMap to visit
+ * @param callback The function to call with each entry
+ * @param userData Pointer passed unchanged to the callback
+ * @return The number of entries visited, or -1 if an error occurs
+ */
+int HashMapForEachEntry(const HashMap *map, void (*callback)(const HashMapEntry *entry, void *userData), void *userData);
+
+
+/**
+ * @brief Returns the key of an entry
+ * 
+ * @param entry The entry
+ * @return The key, or NULL if the entry is NULL
+ */
+const char *HashMapEntryGetKey(const HashMapEntry *entry);
+
+
+/**
+ * @brief Returns the atom of the key of an entry
+ * 
+ * The key is interned on the first call and its atom kept with the entry (and its copies),
+ * so later calls neither hash the key nor lock the atom table.
+ * 
+ * @param entry The entry
+ * @return The atom of the key, or 0 if the entry is NULL or an error occurs
+ */
+Atom HashMapEntryGetKeyAtom(const HashMapEntry *entry);
+
+
+/**
+ * @brief Returns the value of an entry, as HashMapGet does
+ * 
+ * Like HashMapGet, the first read of an escaped value caches its decoded copy with the entry;
+ * the key returned by HashMapEntryGetKey stays valid.
+ * 
+ * @param entry The entry
+ * @return The value, or NULL if the entry is NULL or its value cannot be decoded
+ */
+const char *HashMapEntryGetValue(const HashMapEntry *entry);
+
+
+/**
+ * @brief Retrieves the value of an entry as an integer, as HashMapGetInt does
+ * 
+ * @param entry The entry
+ * @param value Receives the integer value
+ * @return 1 if converted, 0 if the value is not an integer, -1 if an error occurs
+ */
+int HashMapEntryGetInt(const HashMapEntry *entry, long *value);
+
+
+/**
+ * @brief Retrieves the value of an entry as a floating point number, as HashMapGetDouble does
+ * 
+ * @param entry The entry
+ * @param value Receives the floating point value
+ * @return 1 if converted, 0 if the value is not a number, -1 if an error occurs
+ */
+int HashMapEntryGetDouble(const HashMapEntry *entry, double *value);
+
+
+/**
+ * @brief Retrieves the value of an entry as a boolean, as HashMapGetBool does
+ * 
+ * @param entry The entry
+ * @param value Receives 1 for true or 0 for false
+ * @return 1 if converted, 0 if the value is not a boolean, -1 if an error occurs
+ */
+int HashMapEntryGetBool(const HashMapEntry *entry, int *value);
+
+
+/**
+ * @brief Retrieves the value of an entry as an atom, as HashMapGetAtom does
+ * 
+ * @param entry The entry
+ * @param value Receives the atom of the value
+ * @return 1 if converted, 0 if the value cannot be interned, -1 if an error occurs
+ */
+int HashMapEntryGetAtom(const HashMapEntry *entry, Atom *value);
+
+
+/**
+ * @brief Creates an immutable snapshot of the HashMap
+ * 
+ * The snapshot is laid out in a single allocation: an array of entries sorted by the hash
+ * of their keys, followed by the keys and values. It is never modified once created, so any
+ * number of threads can query it without locking, and later changes to the HashMap do not
+ * affect it. It is reference counted and starts with one reference.
+ * 
+ * @param map Pointer to the HashMap to freeze
+ * @return A pointer to the snapshot, or NULL if memory allocation fails
+ */
+FrozenHashMap *HashMapFreeze(const HashMap *map);
+
+
+/**
+ * @brief Adds a reference to a frozen HashMap (safe from any thread)
+ * 
+ * @param frozen Pointer to the frozen HashMap
+ * @return The frozen HashMap, or NULL if it is NULL
+ */
+FrozenHashMap *FrozenHashMapRetain(FrozenHashMap *frozen);
+
+
+/**
+ * @brief Drops a reference to a frozen HashMap, freeing it when it was the last one
+ * 
+ * @param frozen Pointer to the frozen HashMap
+ */
+void FrozenHashMapRelease(FrozenHashMap *frozen);
+
+
+/**
+ * @brief Retrieves the value associated with a given key in a frozen HashMap
+ * 
+ * @param frozen Pointer to the frozen HashMap to search
+ * @param key Key to look up
+ * @return The value associated with the key, or NULL if the key is not found
+ */
+const char *FrozenHashMapGet(const FrozenHashMap *frozen, const char *key);
+
+
+/**
+ * @brief Checks if a key exists in a frozen HashMap
+ * 
+ * @param frozen Pointer to the frozen HashMap to search
+ * @param key Key to check for existence
+ * @return 1 if the key is found, 0 if the key is not found, -1 if an error occurs
+ */
+int FrozenHashMapContainsKey(const FrozenHashMap *frozen, const char *key);
+
+
+/**
+ * @brief Returns the number of key-value pairs in a frozen HashMap
+ * 
+ * @param frozen Pointer to the frozen HashMap
+ * @return The number of key-value pairs, or -1 if an error occurs
+ */
+int FrozenHashMapSize(const FrozenHashMap *frozen);
+
+
+/**
+ * @brief Calls a function on every key-value pair of a frozen HashMap
+ * 
+ * The pairs are visited in the order of the hashes of their keys.
+ * 
+ * @param frozen Pointer to the frozen HashMap to visit
+ * @param callback The function to call with each key and value
+ * @param userData Pointer passed unchanged to the callback
+ * @return The number of pairs visited, or -1 if an error occurs
+ */
+int FrozenHashMapForEach(const FrozenHashMap *frozen, void (*callback)(const char *key, const char *value, void *userData), void *userData);
+
+
+/**
+ * @brief Checks if two frozen HashMaps hold the same key-value pairs
+ * 
+ * @param first Pointer to the first frozen HashMap
+ * @param second Pointer to the second frozen HashMap
+ * @return 1 if they are equal, 0 if they are not, -1 if an error occurs
+ */
+int FrozenHashMapEquals(const FrozenHashMap *first, const FrozenHashMap *second);
+
+
+/**
+ * @brief Returns a hash of the key-value pairs of a frozen HashMap
+ * 
+ * Equal frozen HashMaps have the same hash, whatever the order their pairs were put in, so
+ * it can be used with FrozenHashMapEquals to share one snapshot between identical maps.
+ * 
+ * @param frozen Pointer to the frozen HashMap
+ * @return The hash of the frozen HashMap (0 if it is NULL)
+ */
+unsigned int FrozenHashMapHash(const FrozenHashMap *frozen);
+
+
+/**
+ * @brief Creates a mutable HashMap holding the pairs of a frozen HashMap
+ * 
+ * @param frozen Pointer to the frozen HashMap
+ * @return A new HashMap, or NULL if memory allocation fails
+ */
+HashMap *FrozenHashMapThaw(const FrozenHashMap *frozen);
+
+
+/**
+ * @brief Returns the share of one owner of the memory used by a frozen HashMap
+ * 
+ * The snapshot (its structure, pairs and strings) is divided evenly between its owners, so the
+ * shares of all of them add up to the whole snapshot.
+ * 
+ * @param frozen Pointer to the frozen HashMap
+ * @return The number of bytes of the snapshot divided by its number of owners, or 0 if it is NULL
+ */
+size_t FrozenHashMapMemoryUsage(const FrozenHashMap *frozen);
+
+
 #endif // HASHMAP_H
\ No newline at end of file
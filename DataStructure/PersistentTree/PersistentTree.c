@@ -0,0 +1,668 @@
+/***************************************************************************************************
+ * @file PersistentTree.c                                                                          *
+ * @brief The implementation of the persistent trees and their history                             *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see PersistentTree.h                                                                           *
+ **************************************************************************************************/
+
+#include "PersistentTree.h"
+#include <stdatomic.h>
+
+/**
+ * @brief Represents an immutable node, shared by every version that contains it
+ * 
+ * The node, its children array, its id and its text are a single allocation.
+ */
+struct PersistentTree
+{
+    atomic_int references;              ///< The number of versions and parents holding the node
+    widgetType type;                    ///< The type of the node
+    union
+    {
+        FrozenHashMap *attributes;      ///< The attributes, or NULL if the node has none
+        PersistentTree *nextDead;       ///< Once released, the next node waiting to be freed
+    };
+    char *id;                           ///< The identifier, stored after the children
+    char *text;                         ///< The text content, stored after the identifier, or NULL if the node has none
+    size_t textLength;                  ///< The length of the text
+    int childCount;                     ///< The number of children
+    PersistentTree *children[];         ///< The children
+};
+
+
+/**
+ * @brief Represents the versions of a tree an editor can move between
+ */
+struct TreeHistory
+{
+    PersistentTree **versions;  ///< The versions, from the oldest, the ones after current were undone
+    int count;                  ///< The number of versions
+    int capacity;               ///< The number of versions the array can hold
+    int current;                ///< The index of the current version
+};
+
+#define PERSISTENT_TREE_INLINE_PATH 64  ///< The path length an edit handles without allocating
+
+
+/** @brief Allocates a node, taking the reference to its attributes, the children are left to the caller */
+static PersistentTree *allocateNode(widgetType type, const char *id, const char *text, size_t textLength, FrozenHashMap *attributes, int childCount)
+{
+    size_t idLength = strlen(id);
+    PersistentTree *node = malloc(sizeof(PersistentTree) + childCount * sizeof(PersistentTree *) + idLength + 1 + (text ? textLength + 1 : 0));
+    if(!node) return NULL;
+
+    atomic_init(&node->references, 1);
+    node->type = type;
+    node->attributes = attributes;
+    node->childCount = childCount;
+    node->id = (char *)&node->children[childCount];
+    memcpy(node->id, id, idLength + 1);
+
+    node->text = text ? node->id + idLength + 1 : NULL;
+    node->textLength = text ? textLength : 0;
+    if(text)
+    {
+        memcpy(node->text, text, textLength);
+        node->text[textLength] = '\0';
+    }
+    return node;
+}
+
+
+/** @brief Copies a node with room for a number of children, the children are left to the caller */
+static PersistentTree *copyNode(const PersistentTree *node, FrozenHashMap *attributes, int childCount)
+{
+    PersistentTree *copy = allocateNode(node->type, node->id, node->text, node->textLength, attributes, childCount);
+    if(!copy) FrozenHashMapRelease(attributes);
+    return copy;
+}
+
+
+
+
+PersistentTree *PersistentTreeNew(widgetType type, const char *id, const HashMap *attributes)
+{
+    // Check the input parameters
+    if(!id) return NULL;
+
+    FrozenHashMap *frozen = attributes ? HashMapFreeze(attributes) : NULL;
+    if(attributes && !frozen) return NULL;
+
+    PersistentTree *node = allocateNode(type, id, NULL, 0, frozen, 0);
+    if(!node) FrozenHashMapRelease(frozen);
+    return node;
+}
+
+
+
+
+/** @brief Counts the children of a Tree node */
+static void countChild(Tree *child, void *userData)
+{
+    (void)child;
+    (*(int *)userData)++;
+}
+
+
+
+
+PersistentTree *PersistentTreeFromTree(Tree *tree)
+{
+    // Check the input parameter
+    if(!tree) return NULL;
+
+    // Build the nodes in post-order, the children of a node are the last ones built
+    TreeIterator *iterator = TreeIteratorNew(tree, treePostOrder);
+    GArray *built = g_array_new(FALSE, FALSE, sizeof(PersistentTree *));
+    int failed = !iterator;
+
+    Tree *node;
+    while(!failed && (node = TreeIteratorNext(iterator)))
+    {
+        int childCount = 0;
+        TreeForEachChild(node, countChild, &childCount);
+
+        // The nodes share the snapshots of the attributes of the tree, the text is copied
+        size_t textLength;
+        const char *text = TreeGetText(node, &textLength);
+        FrozenHashMap *attributes = FrozenHashMapRetain(TreeFreezeAttributes(node));
+        PersistentTree *copy = (!attributes && TreeGetAttributes(node)) ? NULL : allocateNode(TreeGetType(node), TreeGetId(node), text, textLength, attributes, childCount);
+        if((failed = !copy))
+        {
+            FrozenHashMapRelease(attributes);
+            break;
+        }
+
+        size_t first = built->len - childCount;
+        if(childCount) memcpy(copy->children, &g_array_index(built, PersistentTree *, first), childCount * sizeof(PersistentTree *));
+        g_array_set_size(built, first);
+        g_array_append_val(built, copy);
+    }
+
+    PersistentTree *root = NULL;
+    if(!failed && built->len == 1) root = g_array_index(built, PersistentTree *, 0);
+    else for(guint i = 0; i < built->len; i++) PersistentTreeRelease(g_array_index(built, PersistentTree *, i));
+
+    g_array_free(built, TRUE);
+    TreeIteratorFree(iterator);
+    return root;
+}
+
+
+/** @brief Gives a Tree node the text of a persistent node, in a block of its own */
+static int copyText(Tree *node, const PersistentTree *from)
+{
+    if(!from->text) return 1;
+
+    char *bytes = AllocatorAlloc(allocatorTree, from->textLength + 1);
+    if(!bytes) return -1;
+    memcpy(bytes, from->text, from->textLength + 1);
+
+    TextBlock *block = TextBlockAdopt(bytes, from->textLength + 1);
+    int result = block ? TreeSetText(node, block, 0, from->textLength) : -1;
+    TextBlockRelease(block);
+    return result;
+}
+
+
+/**
+ * @brief Represents a node of a Tree being built from a persistent tree
+ */
+struct BuildFrame
+{
+    const PersistentTree *node; ///< The node to build
+    Tree *parent;               ///< The Tree node to add it to, NULL for the root
+};
+
+
+
+
+Tree *PersistentTreeToTree(const PersistentTree *root)
+{
+    // Check the input parameter
+    if(!root) return NULL;
+
+    // Build the nodes in pre-order, the children are pushed last first so they are added in order
+    GArray *stack = g_array_new(FALSE, FALSE, sizeof(struct BuildFrame));
+    struct BuildFrame frame = {root, NULL};
+    g_array_append_val(stack, frame);
+
+    Tree *tree = NULL;
+    while(stack->len)
+    {
+        frame = g_array_index(stack, struct BuildFrame, stack->len - 1);
+        g_array_set_size(stack, stack->len - 1);
+
+        HashMap *attributes = frame.node->attributes ? FrozenHashMapThaw(frame.node->attributes) : NULL;
+        Tree *node = (frame.node->attributes && !attributes) ? NULL : TreeNewAdopt(frame.node->type, g_strdup(frame.node->id), NULL, attributes);
+        if(!node || copyText(node, frame.node) < 0 || (frame.parent && TreeAddChild(frame.parent, node) < 0))
+        {
+            TreeDestroy(node);
+            TreeDestroyAll(tree);
+            tree = NULL;
+            break;
+        }
+        if(!frame.parent) tree = node;
+
+        for(int i = frame.node->childCount - 1; i >= 0; i--)
+        {
+            struct BuildFrame child = {frame.node->children[i], node};
+            g_array_append_val(stack, child);
+        }
+    }
+
+    g_array_free(stack, TRUE);
+    return tree;
+}
+
+
+
+
+PersistentTree *PersistentTreeRetain(PersistentTree *node)
+{
+    // Check the input parameter
+    if(!node) return NULL;
+
+    atomic_fetch_add_explicit(&node->references, 1, memory_order_relaxed);
+    return node;
+}
+
+
+/** @brief Drops a reference to a node, returns whether it was the last one */
+static int dropReference(PersistentTree *node)
+{
+    if(atomic_fetch_sub_explicit(&node->references, 1, memory_order_release) != 1) return 0;
+    atomic_thread_fence(memory_order_acquire);
+    return 1;
+}
+
+
+
+
+void PersistentTreeRelease(PersistentTree *node)
+{
+    // Check the input parameter
+    if(!node || !dropReference(node)) return;
+
+    // The dead nodes are linked through their attributes field, so freeing a deep tree needs no stack
+    FrozenHashMapRelease(node->attributes);
+    node->nextDead = NULL;
+    while(node)
+    {
+        PersistentTree *dead = node;
+        node = node->nextDead;
+
+        for(int i = 0; i < dead->childCount; i++)
+        {
+            PersistentTree *child = dead->children[i];
+            if(!dropReference(child)) continue;
+
+            FrozenHashMapRelease(child->attributes);
+            child->nextDead = node;
+            node = child;
+        }
+        free(dead);
+    }
+}
+
+
+/** @brief Follows a path from the root, storing each node met, returns -1 if the path is not valid */
+static int walkPath(const PersistentTree *root, const int *path, int depth, const PersistentTree **nodes)
+{
+    nodes[0] = root;
+    for(int i = 0; i < depth; i++)
+    {
+        if(path[i] < 0 || path[i] >= nodes[i]->childCount) return -1;
+        nodes[i + 1] = nodes[i]->children[path[i]];
+    }
+    return 1;
+}
+
+
+
+
+const PersistentTree *PersistentTreeGetNode(const PersistentTree *root, const int *path, int depth)
+{
+    // Check the input parameters
+    if(!root || depth < 0 || (depth && !path)) return NULL;
+
+    const PersistentTree *node = root;
+    for(int i = 0; i < depth; i++)
+    {
+        if(path[i] < 0 || path[i] >= node->childCount) return NULL;
+        node = node->children[path[i]];
+    }
+    return node;
+}
+
+
+
+
+int PersistentTreeFindPath(const PersistentTree *root, const char *id, int *path, int capacity)
+{
+    // Check the input parameters
+    if(!root || !id || !path || capacity < 0) return -1;
+    if(strcmp(root->id, id) == 0) return 0;
+    if(capacity == 0) return -1;
+
+    // Depth first, path[depth] being the child of nodes[depth] looked at
+    const PersistentTree **nodes = malloc(capacity * sizeof(PersistentTree *));
+    if(!nodes) return -1;
+
+    int depth = 0, found = -1;
+    nodes[0] = root;
+    path[0] = 0;
+    while(depth >= 0)
+    {
+        const PersistentTree *node = nodes[depth];
+        if(path[depth] >= node->childCount)
+        {
+            if(--depth >= 0) path[depth]++;
+            continue;
+        }
+
+        const PersistentTree *child = node->children[path[depth]];
+        if(strcmp(child->id, id) == 0)
+        {
+            found = depth + 1;
+            break;
+        }
+
+        if(child->childCount && depth + 1 < capacity)
+        {
+            nodes[++depth] = child;
+            path[depth] = 0;
+        }
+        else path[depth]++;
+    }
+
+    free(nodes);
+    return found;
+}
+
+
+/**
+ * @brief Edits the node at a level of a path and copies the nodes above it
+ * 
+ * The edit returns the new version of the node (with a reference), each ancestor is copied with
+ * the new version of its child on the path and the other children shared.
+ */
+static PersistentTree *editPath(const PersistentTree *root, const int *path, int depth, int level,
+                                PersistentTree *(*edit)(const PersistentTree *node, const void *data), const void *data)
+{
+    if(!root || depth < 0 || level < 0 || (depth && !path)) return NULL;
+
+    const PersistentTree *inlineNodes[PERSISTENT_TREE_INLINE_PATH];
+    const PersistentTree **nodes = (depth < PERSISTENT_TREE_INLINE_PATH) ? inlineNodes : malloc((depth + 1) * sizeof(PersistentTree *));
+    if(!nodes) return NULL;
+
+    PersistentTree *replacement = NULL;
+    if(walkPath(root, path, depth, nodes) > 0) replacement = edit(nodes[level], data);
+
+    // Copy the path from the edited node up to the root
+    for(int i = level - 1; i >= 0 && replacement; i--)
+    {
+        const PersistentTree *node = nodes[i];
+        PersistentTree *copy = copyNode(node, FrozenHashMapRetain(node->attributes), node->childCount);
+        if(copy)
+        {
+            for(int j = 0; j < node->childCount; j++)
+                copy->children[j] = (j == path[i]) ? replacement : PersistentTreeRetain(node->children[j]);
+        }
+        else PersistentTreeRelease(replacement);
+        replacement = copy;
+    }
+
+    if(nodes != inlineNodes) free(nodes);
+    return replacement;
+}
+
+
+/** @brief Copies a node with a child appended */
+static PersistentTree *appendChild(const PersistentTree *node, const void *child)
+{
+    PersistentTree *copy = copyNode(node, FrozenHashMapRetain(node->attributes), node->childCount + 1);
+    if(!copy) return NULL;
+
+    for(int i = 0; i < node->childCount; i++) copy->children[i] = PersistentTreeRetain(node->children[i]);
+    copy->children[node->childCount] = PersistentTreeRetain((PersistentTree *)child);
+    return copy;
+}
+
+
+/** @brief Copies a node without one of its children */
+static PersistentTree *removeChild(const PersistentTree *node, const void *index)
+{
+    int removed = *(const int *)index;
+    PersistentTree *copy = copyNode(node, FrozenHashMapRetain(node->attributes), node->childCount - 1);
+    if(!copy) return NULL;
+
+    for(int i = 0, j = 0; i < node->childCount; i++)
+        if(i != removed) copy->children[j++] = PersistentTreeRetain(node->children[i]);
+    return copy;
+}
+
+
+/** @brief Returns the new subtree in place of a node */
+static PersistentTree *replaceNode(const PersistentTree *node, const void *replacement)
+{
+    (void)node;
+    return PersistentTreeRetain((PersistentTree *)replacement);
+}
+
+
+/**
+ * @brief Represents an attribute change
+ */
+struct AttributeChange
+{
+    const char *key;    ///< The name of the attribute
+    const char *value;  ///< The new value, or NULL to remove the attribute
+};
+
+
+/** @brief Copies a node with an attribute changed */
+static PersistentTree *changeAttribute(const PersistentTree *node, const void *data)
+{
+    const struct AttributeChange *change = data;
+
+    // Frozen attributes are rebuilt with the change
+    HashMap *map = node->attributes ? FrozenHashMapThaw(node->attributes) : HashMapNew();
+    if(!map) return NULL;
+    if(change->value) HashMapPut(map, change->key, change->value);
+    else HashMapRemove(map, (char *)change->key);
+    FrozenHashMap *attributes = HashMapFreeze(map);
+    HashMapFree(map);
+    if(!attributes) return NULL;
+
+    PersistentTree *copy = copyNode(node, attributes, node->childCount);
+    if(!copy) return NULL;
+
+    for(int i = 0; i < node->childCount; i++) copy->children[i] = PersistentTreeRetain(node->children[i]);
+    return copy;
+}
+
+
+
+
+PersistentTree *PersistentTreeAddChild(const PersistentTree *root, const int *path, int depth, PersistentTree *child)
+{
+    // Check the input parameters
+    if(!child) return NULL;
+
+    return editPath(root, path, depth, depth, appendChild, child);
+}
+
+
+
+
+PersistentTree *PersistentTreeRemoveChild(const PersistentTree *root, const int *path, int depth)
+{
+    // Check the input parameters, the parent of the node is the one edited
+    if(depth < 1 || !path) return NULL;
+
+    return editPath(root, path, depth, depth - 1, removeChild, &path[depth - 1]);
+}
+
+
+
+
+PersistentTree *PersistentTreeUpdateNode(const PersistentTree *root, const int *path, int depth, PersistentTree *node)
+{
+    // Check the input parameters
+    if(!node) return NULL;
+
+    return editPath(root, path, depth, depth, replaceNode, node);
+}
+
+
+
+
+PersistentTree *PersistentTreeSetAttribute(const PersistentTree *root, const int *path, int depth, const char *key, const char *value)
+{
+    // Check the input parameters
+    if(!key) return NULL;
+
+    struct AttributeChange change = {key, value};
+    return editPath(root, path, depth, depth, changeAttribute, &change);
+}
+
+
+
+
+widgetType PersistentTreeGetType(const PersistentTree *node)
+{
+    // Check the input parameter
+    if(!node) return -1;
+
+    return node->type;
+}
+
+
+
+
+const char *PersistentTreeGetId(const PersistentTree *node)
+{
+    // Check the input parameter
+    if(!node) return NULL;
+
+    return node->id;
+}
+
+
+
+
+const FrozenHashMap *PersistentTreeGetAttributes(const PersistentTree *node)
+{
+    // Check the input parameter
+    if(!node) return NULL;
+
+    return node->attributes;
+}
+
+
+
+
+const char *PersistentTreeGetText(const PersistentTree *node, size_t *length)
+{
+    // Check the input parameter
+    if(!node) return NULL;
+
+    if(length) *length = node->textLength;
+    return node->text;
+}
+
+
+
+
+int PersistentTreeGetChildCount(const PersistentTree *node)
+{
+    // Check the input parameter
+    if(!node) return -1;
+
+    return node->childCount;
+}
+
+
+
+
+const PersistentTree *PersistentTreeGetChild(const PersistentTree *node, int index)
+{
+    // Check the input parameters
+    if(!node || index < 0 || index >= node->childCount) return NULL;
+
+    return node->children[index];
+}
+
+
+
+
+TreeHistory *TreeHistoryNew(PersistentTree *initial)
+{
+    // Check the input parameter
+    if(!initial) return NULL;
+
+    TreeHistory *history = malloc(sizeof(TreeHistory));
+    if(!history) return NULL;
+
+    history->capacity = 16;
+    history->versions = malloc(history->capacity * sizeof(PersistentTree *));
+    if(!history->versions)
+    {
+        free(history);
+        return NULL;
+    }
+
+    history->versions[0] = initial;
+    history->count = 1;
+    history->current = 0;
+    return history;
+}
+
+
+
+
+int TreeHistoryCommit(TreeHistory *history, PersistentTree *version)
+{
+    // Check the input parameters
+    if(!history || !version)
+    {
+        PersistentTreeRelease(version);
+        return -1;
+    }
+
+    // The versions undone so far cannot be redone anymore
+    while(history->count > history->current + 1) PersistentTreeRelease(history->versions[--history->count]);
+
+    if(history->count == history->capacity)
+    {
+        PersistentTree **versions = realloc(history->versions, 2 * history->capacity * sizeof(PersistentTree *));
+        if(!versions)
+        {
+            PersistentTreeRelease(version);
+            return -1;
+        }
+        history->versions = versions;
+        history->capacity *= 2;
+    }
+
+    history->versions[history->count] = version;
+    history->current = history->count++;
+    return 1;
+}
+
+
+
+
+const PersistentTree *TreeHistoryCurrent(const TreeHistory *history)
+{
+    // Check the input parameter
+    if(!history) return NULL;
+
+    return history->versions[history->current];
+}
+
+
+
+
+int TreeHistoryUndo(TreeHistory *history)
+{
+    // Check the input parameter
+    if(!history) return -1;
+    if(history->current == 0) return 0;
+
+    history->current--;
+    return 1;
+}
+
+
+
+
+int TreeHistoryRedo(TreeHistory *history)
+{
+    // Check the input parameter
+    if(!history) return -1;
+    if(history->current + 1 >= history->count) return 0;
+
+    history->current++;
+    return 1;
+}
+
+
+
+
+void TreeHistoryFree(TreeHistory *history)
+{
+    // Check the input parameter
+    if(!history) return;
+
+    for(int i = 0; i < history->count; i++) PersistentTreeRelease(history->versions[i]);
+    free(history->versions);
+    free(history);
+}
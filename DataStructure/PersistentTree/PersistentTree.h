@@ -0,0 +1,241 @@
+/***************************************************************************************************
+ * @file PersistentTree.h                                                                          *
+ * @brief Defines the immutable trees whose versions share their untouched nodes                   *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see PersistentTree.c                                                                           *
+ **************************************************************************************************/
+
+#ifndef PERSISTENT_TREE_H
+#define PERSISTENT_TREE_H
+
+#include "../Tree/Tree.h"
+
+typedef struct PersistentTree PersistentTree;
+typedef struct TreeHistory TreeHistory;
+
+/**
+ * @brief Creates a new node without children
+ * 
+ * Persistent trees are never modified: an edit returns a new version of the tree, made of
+ * copies of the nodes on the path to the edited node and of every other node of the previous
+ * version, shared. Nodes are reference counted, each function returning a node gives the caller
+ * a reference to release with PersistentTreeRelease. They can be read from any thread.
+ * 
+ * @param type The type of the node
+ * @param id The identifier of the node
+ * @param attributes The attributes of the node (copied), or NULL
+ * @return PersistentTree* The node, or NULL if allocation fails or the id is NULL
+ */
+PersistentTree *PersistentTreeNew(widgetType type, const char *id, const HashMap *attributes);
+
+
+/**
+ * @brief Makes a persistent copy of a Tree
+ * 
+ * The attributes are shared with the tree through their snapshots, the text content of the
+ * nodes is copied into them.
+ * 
+ * @param tree The root of the tree to copy
+ * @return PersistentTree* The copy, or NULL if allocation fails or the tree is NULL
+ */
+PersistentTree *PersistentTreeFromTree(Tree *tree);
+
+
+/**
+ * @brief Makes a Tree from a version of a persistent tree, e.g., to render it
+ * 
+ * Each node with a text content gets a text block of its own holding it.
+ * 
+ * @param root The root of the version
+ * @return Tree* The new Tree, or NULL if allocation fails or the root is NULL
+ */
+Tree *PersistentTreeToTree(const PersistentTree *root);
+
+
+/**
+ * @brief Takes a new reference to a node (and so to its whole subtree)
+ * @param node The node
+ * @return PersistentTree* The node
+ */
+PersistentTree *PersistentTreeRetain(PersistentTree *node);
+
+
+/**
+ * @brief Drops a reference to a node, the nodes no version uses anymore are freed
+ * @param node The node
+ */
+void PersistentTreeRelease(PersistentTree *node);
+
+
+/**
+ * @brief Returns the node at the end of a path
+ * @param root The root of the version
+ * @param path The index of the child to follow at each level, from the root
+ * @param depth The length of the path, 0 for the root
+ * @return const PersistentTree* The node (no reference is taken), or NULL if the path is not valid
+ */
+const PersistentTree *PersistentTreeGetNode(const PersistentTree *root, const int *path, int depth);
+
+
+/**
+ * @brief Finds the path to the node with an identifier, in pre-order
+ * @param root The root of the version
+ * @param id The identifier of the node
+ * @param path Receives the path to the node
+ * @param capacity The maximum length of the path
+ * @return The length of the path, or -1 if the node is not found within this depth
+ */
+int PersistentTreeFindPath(const PersistentTree *root, const char *id, int *path, int capacity);
+
+
+/**
+ * @brief Returns a new version with a child appended to the children of a node
+ * @param root The root of the version to edit
+ * @param path The path to the parent
+ * @param depth The length of the path
+ * @param child The child to add, a reference to it is taken
+ * @return PersistentTree* The root of the new version, or NULL if any error occurs
+ */
+PersistentTree *PersistentTreeAddChild(const PersistentTree *root, const int *path, int depth, PersistentTree *child);
+
+
+/**
+ * @brief Returns a new version without a node (and its subtree)
+ * @param root The root of the version to edit
+ * @param path The path to the node to remove
+ * @param depth The length of the path, at least 1 (the root cannot be removed)
+ * @return PersistentTree* The root of the new version, or NULL if any error occurs
+ */
+PersistentTree *PersistentTreeRemoveChild(const PersistentTree *root, const int *path, int depth);
+
+
+/**
+ * @brief Returns a new version with a node replaced by another subtree
+ * @param root The root of the version to edit
+ * @param path The path to the node to replace
+ * @param depth The length of the path
+ * @param node The new subtree, a reference to it is taken
+ * @return PersistentTree* The root of the new version, or NULL if any error occurs
+ */
+PersistentTree *PersistentTreeUpdateNode(const PersistentTree *root, const int *path, int depth, PersistentTree *node);
+
+
+/**
+ * @brief Returns a new version with an attribute of a node set (or removed)
+ * @param root The root of the version to edit
+ * @param path The path to the node
+ * @param depth The length of the path
+ * @param key The name of the attribute
+ * @param value The new value, or NULL to remove the attribute
+ * @return PersistentTree* The root of the new version, or NULL if any error occurs
+ */
+PersistentTree *PersistentTreeSetAttribute(const PersistentTree *root, const int *path, int depth, const char *key, const char *value);
+
+
+/**
+ * @brief Retrieves the type of a node
+ * @param node The node
+ * @return widgetType The type of the node, or -1 if the node is NULL
+ */
+widgetType PersistentTreeGetType(const PersistentTree *node);
+
+
+/**
+ * @brief Retrieves the identifier of a node
+ * @param node The node
+ * @return const char* The identifier, or NULL if the node is NULL
+ */
+const char *PersistentTreeGetId(const PersistentTree *node);
+
+
+/**
+ * @brief Retrieves the attributes of a node
+ * @param node The node
+ * @return const FrozenHashMap* The attributes, or NULL if the node has none
+ */
+const FrozenHashMap *PersistentTreeGetAttributes(const PersistentTree *node);
+
+
+/**
+ * @brief Retrieves the text content of a node
+ * @param node The node
+ * @param length Where the length of the text is stored, or NULL
+ * @return const char* The text (NUL terminated), or NULL if the node has none or is NULL
+ */
+const char *PersistentTreeGetText(const PersistentTree *node, size_t *length);
+
+
+/**
+ * @brief Returns the number of children of a node
+ * @param node The node
+ * @return The number of children, or -1 if the node is NULL
+ */
+int PersistentTreeGetChildCount(const PersistentTree *node);
+
+
+/**
+ * @brief Returns a child of a node
+ * @param node The node
+ * @param index The index of the child
+ * @return const PersistentTree* The child (no reference is taken), or NULL if the index is out of range
+ */
+const PersistentTree *PersistentTreeGetChild(const PersistentTree *node, int index);
+
+
+/**
+ * @brief Creates an undo history starting at a version
+ * 
+ * The history keeps a reference to each version, undo and redo only move between them.
+ * 
+ * @param initial The first version, the history takes the caller's reference to it
+ * @return TreeHistory* The history, or NULL if allocation fails or the version is NULL
+ */
+TreeHistory *TreeHistoryNew(PersistentTree *initial);
+
+
+/**
+ * @brief Makes a version the current one, the versions that could be redone are dropped
+ * @param history The history
+ * @param version The new version, the history takes the caller's reference to it
+ * @return 1 on success, -1 on failure (the reference is then released)
+ */
+int TreeHistoryCommit(TreeHistory *history, PersistentTree *version);
+
+
+/**
+ * @brief Returns the current version
+ * @param history The history
+ * @return const PersistentTree* The current version (no reference is taken), or NULL if the history is NULL
+ */
+const PersistentTree *TreeHistoryCurrent(const TreeHistory *history);
+
+
+/**
+ * @brief Goes back to the previous version
+ * @param history The history
+ * @return 1 on success, 0 if there is nothing to undo, -1 if any error occurs
+ */
+int TreeHistoryUndo(TreeHistory *history);
+
+
+/**
+ * @brief Goes forward to the version undone last
+ * @param history The history
+ * @return 1 on success, 0 if there is nothing to redo, -1 if any error occurs
+ */
+int TreeHistoryRedo(TreeHistory *history);
+
+
+/**
+ * @brief Frees a history and releases its versions
+ * @param history The history to free
+ */
+void TreeHistoryFree(TreeHistory *history);
+
+#endif // PERSISTENT_TREE_H
@@ -0,0 +1,457 @@
+/***************************************************************************************************
+ * @file RowModel.c                                                                                *
+ * @brief The implementation of the compact rows of a virtualized grid                             *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see RowModel.h                                                                                 *
+ **************************************************************************************************/
+
+#include "RowModel.h"
+#include <stdint.h>
+
+/**
+ * @brief Represents the template of the cells of a column
+ */
+struct Column
+{
+    widgetType type;        ///< The widget type of the cells
+    HashMap *attributes;    ///< The attributes shared by the cells
+    char *boundKey;         ///< The attribute set to the value of each row
+};
+
+
+/**
+ * @brief Represents the node kept for a cell looked up without being materialized
+ */
+struct Lookup
+{
+    size_t index;           ///< The index + 1 of the cell, row after row (0 if the slot is free)
+    unsigned long used;     ///< The lookup that last returned the node
+    Tree *cell;             ///< The node of the cell
+};
+
+
+struct RowModel
+{
+    struct Column *columns;     ///< The columns
+    int columnCount;            ///< The number of columns
+    int rowCount;               ///< The number of rows
+    int rowCapacity;            ///< The number of rows the values can hold
+    uint32_t *values;           ///< The offset + 1 of each value in the text, row after row (0 for NULL)
+    char *text;                 ///< The values, each followed by its '\0'
+    size_t textSize;            ///< The number of bytes of text used
+    size_t textCapacity;        ///< The number of bytes of text allocated
+    int windowFirst;            ///< The first materialized row
+    int windowCount;            ///< The number of materialized rows
+    Tree **window;              ///< The nodes of the materialized cells, row after row (NULL if not made)
+    struct Lookup *lookups;     ///< The ROW_MODEL_LOOKUPS nodes of the cells last looked up without being materialized
+    unsigned long lookupCount;  ///< The number of lookups that returned one of those nodes
+    Tree **scratch;             ///< For each column, the node the cells that are not materialized are peeked through
+};
+
+
+/** @brief Copies a value at the end of the text, returns its offset + 1 (0 for NULL, and on failure) */
+static uint32_t storeValue(RowModel *model, const char *value)
+{
+    if(!value) return 0;
+
+    size_t length = strlen(value) + 1;
+    if(model->textSize + length >= UINT32_MAX) return 0;
+    if(model->textSize + length > model->textCapacity)
+    {
+        size_t capacity = model->textCapacity ? 2 * model->textCapacity : 4096;
+        while(capacity < model->textSize + length) capacity *= 2;
+
+        char *text = realloc(model->text, capacity);
+        if(!text) return 0;
+        model->text = text;
+        model->textCapacity = capacity;
+    }
+
+    memcpy(model->text + model->textSize, value, length);
+    model->textSize += length;
+    return (uint32_t)(model->textSize - length + 1);
+}
+
+
+/** @brief Makes the id of a cell */
+static char *cellId(const char *gridId, int row, int column)
+{
+    return g_strdup_printf("%s:%d:%d", gridId, row, column);
+}
+
+
+
+
+RowModel *RowModelNew(void)
+{
+    return calloc(1, sizeof(RowModel));
+}
+
+
+
+
+int RowModelAddColumn(RowModel *model, widgetType type, const HashMap *attributes, const char *boundKey)
+{
+    // Check the input parameters
+    if(!model || !boundKey || model->rowCount) return -1;
+
+    struct Column *columns = realloc(model->columns, (model->columnCount + 1) * sizeof(struct Column));
+    if(!columns) return -1;
+    model->columns = columns;
+
+    struct Column *column = &columns[model->columnCount];
+    column->type = type;
+    column->attributes = attributes ? HashMapGetCopy(attributes) : HashMapNew();
+    column->boundKey = g_strdup(boundKey);
+    if(!column->attributes)
+    {
+        g_free(column->boundKey);
+        return -1;
+    }
+
+    return model->columnCount++;
+}
+
+
+
+
+int RowModelAppendRow(RowModel *model, const char *const *values)
+{
+    // Check the input parameters
+    if(!model || !values || !model->columnCount) return -1;
+
+    if(model->rowCount == model->rowCapacity)
+    {
+        int capacity = model->rowCapacity ? 2 * model->rowCapacity : 64;
+        uint32_t *grown = realloc(model->values, (size_t)capacity * model->columnCount * sizeof(uint32_t));
+        if(!grown) return -1;
+        model->values = grown;
+        model->rowCapacity = capacity;
+    }
+
+    uint32_t *row = &model->values[(size_t)model->rowCount * model->columnCount];
+    for(int i = 0; i < model->columnCount; i++)
+    {
+        row[i] = storeValue(model, values[i]);
+        if(values[i] && !row[i]) return -1;
+    }
+
+    return model->rowCount++;
+}
+
+
+
+
+int RowModelSetValue(RowModel *model, int row, int column, const char *value)
+{
+    // Check the input parameters
+    if(!model || row < 0 || row >= model->rowCount || column < 0 || column >= model->columnCount) return -1;
+
+    // The previous value stays in the text, values are rarely changed compared to how many there are
+    uint32_t offset = storeValue(model, value);
+    if(value && !offset) return -1;
+
+    size_t index = (size_t)row * model->columnCount + column;
+    model->values[index] = offset;
+
+    // A node made by a lookup shows the new value too
+    for(int i = 0; model->lookups && i < ROW_MODEL_LOOKUPS; i++)
+    {
+        if(model->lookups[i].index != index + 1) continue;
+        if(TreeSetAttribute(model->lookups[i].cell, model->columns[column].boundKey, value) < 0) return -1;
+        break;
+    }
+
+    return 1;
+}
+
+
+
+
+const char *RowModelGetValue(const RowModel *model, int row, int column)
+{
+    // Check the input parameters
+    if(!model || row < 0 || row >= model->rowCount || column < 0 || column >= model->columnCount) return NULL;
+
+    uint32_t offset = model->values[(size_t)row * model->columnCount + column];
+    return offset ? model->text + offset - 1 : NULL;
+}
+
+
+
+
+int RowModelGetRowCount(const RowModel *model)
+{
+    return model ? model->rowCount : -1;
+}
+
+
+
+
+int RowModelGetColumnCount(const RowModel *model)
+{
+    return model ? model->columnCount : -1;
+}
+
+
+
+
+const char *RowModelGetBoundKey(const RowModel *model, int column)
+{
+    // Check the input parameters
+    if(!model || column < 0 || column >= model->columnCount) return NULL;
+
+    return model->columns[column].boundKey;
+}
+
+
+
+
+int RowModelParseId(const char *gridId, const char *id, int *row, int *column)
+{
+    // Check the input parameters
+    if(!gridId || !id || !row || !column) return -1;
+
+    size_t length = strlen(gridId);
+    if(strncmp(id, gridId, length) != 0 || id[length] != ':') return 0;
+
+    // Two decimal numbers separated by ':', and nothing else
+    const char *cursor = id + length + 1;
+    long numbers[2];
+    for(int i = 0; i < 2; i++)
+    {
+        if(*cursor < '0' || *cursor > '9') return 0;
+
+        char *end;
+        numbers[i] = strtol(cursor, &end, 10);
+        if(numbers[i] > INT32_MAX || *end != (i ? '\0' : ':')) return 0;
+        cursor = end + 1;
+    }
+
+    *row = (int)numbers[0];
+    *column = (int)numbers[1];
+    return 1;
+}
+
+
+
+
+Tree *RowModelNewCell(const RowModel *model, const char *gridId, int row, int column)
+{
+    // Check the input parameters
+    if(!model || !gridId || row < 0 || row >= model->rowCount || column < 0 || column >= model->columnCount) return NULL;
+
+    const struct Column *template = &model->columns[column];
+    HashMap *attributes = HashMapGetCopy(template->attributes);
+    if(!attributes) return NULL;
+
+    const char *value = RowModelGetValue(model, row, column);
+    if((value && HashMapPut(attributes, template->boundKey, value) < 0) ||
+       HashMapPutInt(attributes, "row", row) < 0 || HashMapPutInt(attributes, "column", column) < 0)
+    {
+        HashMapFree(attributes);
+        return NULL;
+    }
+
+    return TreeNewAdopt(template->type, cellId(gridId, row, column), NULL, attributes);
+}
+
+
+
+
+int RowModelBindCell(const RowModel *model, const char *gridId, Tree *cell, int row)
+{
+    // Check the input parameters
+    if(!model || !gridId || !cell || row < 0 || row >= model->rowCount) return -1;
+
+    int previousRow, column;
+    if(RowModelParseId(gridId, TreeGetId(cell), &previousRow, &column) != 1 || column >= model->columnCount) return -1;
+
+    char *id = cellId(gridId, row, column);
+    char number[16];
+    snprintf(number, sizeof(number), "%d", row);
+
+    int result = TreeSetId(cell, id) < 0 ||
+                 TreeSetAttribute(cell, model->columns[column].boundKey, RowModelGetValue(model, row, column)) < 0 ||
+                 TreeSetAttribute(cell, "row", number) < 0 ? -1 : 1;
+
+    g_free(id);
+    return result;
+}
+
+
+
+
+int RowModelSetWindow(RowModel *model, int first, int count)
+{
+    // Check the input parameters
+    if(!model || first < 0 || count < 0) return -1;
+
+    Tree **window = count ? calloc((size_t)count * model->columnCount, sizeof(Tree *)) : NULL;
+    if(count && !window) return -1;
+
+    // Keep the nodes of the rows in both windows
+    int start = first > model->windowFirst ? first : model->windowFirst;
+    int end = first + count < model->windowFirst + model->windowCount ? first + count : model->windowFirst + model->windowCount;
+    for(int row = start; row < end; row++)
+    {
+        memcpy(&window[(size_t)(row - first) * model->columnCount],
+               &model->window[(size_t)(row - model->windowFirst) * model->columnCount],
+               model->columnCount * sizeof(Tree *));
+    }
+
+    free(model->window);
+    model->window = window;
+    model->windowFirst = first;
+    model->windowCount = count;
+
+    return 1;
+}
+
+
+
+
+int RowModelSetCell(RowModel *model, int row, int column, Tree *cell)
+{
+    // Check the input parameters
+    if(!model || row < model->windowFirst || row >= model->windowFirst + model->windowCount) return -1;
+    if(column < 0 || column >= model->columnCount) return -1;
+
+    model->window[(size_t)(row - model->windowFirst) * model->columnCount + column] = cell;
+    return 1;
+}
+
+
+
+
+/** @brief Returns the materialized node of a cell, or NULL if it is not materialized */
+static Tree *materializedCell(const RowModel *model, int row, int column)
+{
+    if(row < model->windowFirst || row >= model->windowFirst + model->windowCount) return NULL;
+
+    return model->window[(size_t)(row - model->windowFirst) * model->columnCount + column];
+}
+
+
+
+
+Tree *RowModelGetCell(RowModel *model, const char *gridId, int row, int column)
+{
+    // Check the input parameters
+    if(!model || !gridId || row < 0 || row >= model->rowCount || column < 0 || column >= model->columnCount) return NULL;
+
+    Tree *cell = materializedCell(model, row, column);
+    if(cell) return cell;
+
+    if(!model->lookups)
+    {
+        model->lookups = calloc(ROW_MODEL_LOOKUPS, sizeof(struct Lookup));
+        if(!model->lookups) return NULL;
+    }
+
+    // The node of a cell looked up lately is returned again, else the least recently used one is replaced
+    size_t index = (size_t)row * model->columnCount + column + 1;
+    struct Lookup *lookup = &model->lookups[0];
+    for(int i = 1; i < ROW_MODEL_LOOKUPS && lookup->index != index; i++)
+    {
+        struct Lookup *slot = &model->lookups[i];
+        if(slot->index == index || slot->used < lookup->used) lookup = slot;
+    }
+
+    if(lookup->index != index)
+    {
+        cell = RowModelNewCell(model, gridId, row, column);
+        if(!cell) return NULL;
+
+        TreeDestroy(lookup->cell);
+        lookup->index = index;
+        lookup->cell = cell;
+    }
+
+    lookup->used = ++model->lookupCount;
+    return lookup->cell;
+}
+
+
+
+
+Tree *RowModelPeekCell(RowModel *model, const char *gridId, int row, int column)
+{
+    // Check the input parameters
+    if(!model || !gridId || row < 0 || row >= model->rowCount || column < 0 || column >= model->columnCount) return NULL;
+
+    Tree *cell = materializedCell(model, row, column);
+    if(cell) return cell;
+
+    // Read the cell through the scratch node of its column
+    if(!model->scratch)
+    {
+        model->scratch = calloc(model->columnCount, sizeof(Tree *));
+        if(!model->scratch) return NULL;
+    }
+    if(!model->scratch[column])
+    {
+        model->scratch[column] = RowModelNewCell(model, gridId, row, column);
+        return model->scratch[column];
+    }
+
+    return RowModelBindCell(model, gridId, model->scratch[column], row) == 1 ? model->scratch[column] : NULL;
+}
+
+
+
+
+size_t RowModelGetMemoryUsage(const RowModel *model)
+{
+    // Check the input parameter
+    if(!model) return 0;
+
+    size_t size = sizeof(RowModel) + model->columnCount * sizeof(struct Column) +
+                  (size_t)model->rowCapacity * model->columnCount * sizeof(uint32_t) + model->textCapacity +
+                  (size_t)model->windowCount * model->columnCount * sizeof(Tree *);
+
+    // The nodes the model keeps for the cells that are not materialized
+    if(model->lookups)
+    {
+        size += ROW_MODEL_LOOKUPS * sizeof(struct Lookup);
+        for(int i = 0; i < ROW_MODEL_LOOKUPS; i++) size += TreeMemoryUsage(model->lookups[i].cell, NULL);
+    }
+    if(model->scratch)
+    {
+        size += model->columnCount * sizeof(Tree *);
+        for(int i = 0; i < model->columnCount; i++) size += TreeMemoryUsage(model->scratch[i], NULL);
+    }
+
+    return size;
+}
+
+
+
+
+void RowModelFree(RowModel *model)
+{
+    // Check the input parameter
+    if(!model) return;
+
+    for(int i = 0; i < model->columnCount; i++)
+    {
+        HashMapFree(model->columns[i].attributes);
+        g_free(model->columns[i].boundKey);
+        if(model->scratch) TreeDestroy(model->scratch[i]);
+    }
+
+    free(model->columns);
+    free(model->values);
+    free(model->text);
+    free(model->window);
+    free(model->scratch);
+    for(int i = 0; model->lookups && i < ROW_MODEL_LOOKUPS; i++) TreeDestroy(model->lookups[i].cell);
+    free(model->lookups);
+    free(model);
+}
@@ -0,0 +1,217 @@
+/***************************************************************************************************
+ * @file RowModel.h                                                                                *
+ * @brief Defines the compact rows of a virtualized grid                                           *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see RowModel.c                                                                                 *
+ **************************************************************************************************/
+
+#ifndef ROW_MODEL_H
+#define ROW_MODEL_H
+
+#include "Tree.h"
+
+#ifndef ROW_MODEL_LOOKUPS
+#define ROW_MODEL_LOOKUPS 16    ///< The number of cells looked up without being materialized whose nodes a model keeps
+#endif
+
+/**
+ * @brief Creates an empty row model
+ * 
+ * A row model describes the cells of a grid without making their nodes: each column is a
+ * template (a widget type, its attributes and the attribute bound to the data) and each row
+ * holds one value per column, stored back to back in a single buffer. Attached to a grid node
+ * with TreeSetRowModel, its cells are found by TreeGetNode and visited by TreeForEachVirtualChild
+ * as if they were children of the grid, and only the rows in view are materialized.
+ * 
+ * The cell at a row and a column has the id "<grid id>:<row>:<column>", and its "row" and
+ * "column" attributes place it in the grid.
+ * 
+ * @return RowModel* The model, or NULL if allocation fails
+ */
+RowModel *RowModelNew(void);
+
+
+/**
+ * @brief Adds a column, the columns must all be added before the first row
+ * @param model The model
+ * @param type The widget type of the cells of the column
+ * @param attributes The attributes shared by the cells of the column (copied), or NULL
+ * @param boundKey The attribute set to the value of each row (e.g., "text" for labels)
+ * @return The index of the column, or -1 if any error occurs
+ */
+int RowModelAddColumn(RowModel *model, widgetType type, const HashMap *attributes, const char *boundKey);
+
+
+/**
+ * @brief Appends a row
+ * @param model The model
+ * @param values One value per column, a NULL value leaves the bound attribute unset
+ * @return The index of the row, or -1 if any error occurs
+ */
+int RowModelAppendRow(RowModel *model, const char *const *values);
+
+
+/**
+ * @brief Changes the value of a cell
+ * 
+ * The materialized node of the cell, if any, is not updated: a virtualized grid does it.
+ * 
+ * @param model The model
+ * @param row The row of the cell
+ * @param column The column of the cell
+ * @param value The new value, or NULL
+ * @return 1 on success, -1 if any error occurs
+ */
+int RowModelSetValue(RowModel *model, int row, int column, const char *value);
+
+
+/**
+ * @brief Returns the value of a cell
+ * @param model The model
+ * @param row The row of the cell
+ * @param column The column of the cell
+ * @return const char* The value, or NULL if it has none or the cell does not exist
+ */
+const char *RowModelGetValue(const RowModel *model, int row, int column);
+
+
+/**
+ * @brief Returns the number of rows of a model
+ * @param model The model
+ * @return The number of rows, or -1 if the model is NULL
+ */
+int RowModelGetRowCount(const RowModel *model);
+
+
+/**
+ * @brief Returns the number of columns of a model
+ * @param model The model
+ * @return The number of columns, or -1 if the model is NULL
+ */
+int RowModelGetColumnCount(const RowModel *model);
+
+
+/**
+ * @brief Returns the attribute of a column bound to the data
+ * @param model The model
+ * @param column The column
+ * @return const char* The name of the attribute, or NULL if the column does not exist
+ */
+const char *RowModelGetBoundKey(const RowModel *model, int column);
+
+
+/**
+ * @brief Reads the row and the column of a cell from its id
+ * @param gridId The id of the grid holding the model
+ * @param id The id to read
+ * @param row Where the row is written
+ * @param column Where the column is written
+ * @return 1 if the id is the id of a cell of the grid, 0 if it is not, -1 if any error occurs
+ */
+int RowModelParseId(const char *gridId, const char *id, int *row, int *column);
+
+
+/**
+ * @brief Makes a new node for a cell, from the template of its column and the value of its row
+ * @param model The model
+ * @param gridId The id of the grid holding the model
+ * @param row The row of the cell
+ * @param column The column of the cell
+ * @return Tree* The node, owned by the caller, or NULL if any error occurs
+ */
+Tree *RowModelNewCell(const RowModel *model, const char *gridId, int row, int column);
+
+
+/**
+ * @brief Changes the row a node made by RowModelNewCell stands for, so it can be reused while scrolling
+ * @param model The model
+ * @param gridId The id of the grid holding the model
+ * @param cell The node of a cell of the same column
+ * @param row The new row of the cell
+ * @return 1 on success, -1 if any error occurs
+ */
+int RowModelBindCell(const RowModel *model, const char *gridId, Tree *cell, int row);
+
+
+/**
+ * @brief Records the rows that are materialized, their nodes are then returned by RowModelGetCell and RowModelPeekCell
+ * 
+ * The nodes of the rows still in the window are kept, the others are forgotten.
+ * 
+ * @param model The model
+ * @param first The first materialized row
+ * @param count The number of materialized rows
+ * @return 1 on success, -1 if any error occurs
+ */
+int RowModelSetWindow(RowModel *model, int first, int count);
+
+
+/**
+ * @brief Records the materialized node of a cell
+ * @param model The model
+ * @param row The row of the cell, in the window
+ * @param column The column of the cell
+ * @param cell The node of the cell, or NULL once it is removed
+ * @return 1 on success, -1 if any error occurs (e.g., the row is not in the window)
+ */
+int RowModelSetCell(RowModel *model, int row, int column, Tree *cell);
+
+
+/**
+ * @brief Returns the node of a cell, materialized or not
+ * 
+ * A cell that is not materialized is made on its first lookup and kept by the model with the
+ * last ROW_MODEL_LOOKUPS cells looked up, the least recently used one being freed to make room:
+ * the node stays valid until as many other cells are looked up (or the model is freed), and
+ * shows the changes made by RowModelSetValue meanwhile. Changing it changes neither the model
+ * nor the grid, and it must not be added to a tree. Use RowModelPeekCell to read many cells.
+ * 
+ * @param model The model
+ * @param gridId The id of the grid holding the model
+ * @param row The row of the cell
+ * @param column The column of the cell
+ * @return Tree* The node of the cell, or NULL if the cell does not exist or on failure
+ */
+Tree *RowModelGetCell(RowModel *model, const char *gridId, int row, int column);
+
+
+/**
+ * @brief Returns the node of a cell, materialized or not, without keeping a node for it
+ * 
+ * A cell that is not materialized is read through a temporary node owned by the model, rebound
+ * to the cell on each call: it is only valid until the next call for the same column and must
+ * not be changed or added to a tree.
+ * 
+ * @param model The model
+ * @param gridId The id of the grid holding the model
+ * @param row The row of the cell
+ * @param column The column of the cell
+ * @return Tree* The node of the cell, or NULL if the cell does not exist or on failure
+ */
+Tree *RowModelPeekCell(RowModel *model, const char *gridId, int row, int column);
+
+
+/**
+ * @brief Returns the number of bytes a model uses, the nodes it keeps for the cells that are not materialized included
+ * 
+ * The materialized nodes belong to the tree and are not counted.
+ * 
+ * @param model The model
+ * @return The number of bytes, or 0 if the model is NULL
+ */
+size_t RowModelGetMemoryUsage(const RowModel *model);
+
+
+/**
+ * @brief Frees a model, the materialized nodes are left to the tree
+ * @param model The model to free
+ */
+void RowModelFree(RowModel *model);
+
+#endif // ROW_MODEL_H
@@ -12,6 +12,11 @@
  **************************************************************************************************/
 
 #include "Tree.h"
+#include "RowModel.h"
+#include "../../Utils/Trace.h"
+#include "../../Utils/Hash.h"
+#include <limits.h>
+#include <stdatomic.h>
 
 /**
  * @brief Represents a tree structure for GUI elements with associated metadata
@@ -25,7 +30,15 @@ struct Tree
     char *id;                   ///< A unique identifier for the tree element (the widget)
     GtkWidget *widget;          ///< The GTK widget associated with this tree element
     HashMap *attributes;        ///< A HashMap containing additional properties or metadata
+    struct SharedAttributes *shared; ///< The owner of the attributes when they are shared with clones, NULL if the node owns them
+    FrozenHashMap *frozen;      ///< A snapshot of the attributes for other threads, or NULL if not frozen yet
     struct ChildNode *children; ///< Pointer to child nodes in the tree structure
+    Tree *parent;               ///< The node whose children hold this node, NULL for a root
+    RowModel *rows;             ///< The virtual rows of a grid, whose materialized cells are the children, or NULL
+    TextBlock *text;            ///< The block the text content is a slice of, or NULL if the node has no text
+    unsigned int textOffset;    ///< The offset of the text in the block
+    unsigned int textLength;    ///< The length of the text
+    struct TreeClock *clock;    ///< The generation of the tree, kept by roots only, NULL until TreeGetGeneration asks for it
 };
 
 
@@ -42,299 +55,1694 @@ struct ChildNode
 };
 
 
+/**
+ * @brief Represents attributes shared by a node and its clones
+ * 
+ * The HashMap is read only while it has more than one reference, a node changing its
+ * attributes takes a private copy first.
+ */
+struct SharedAttributes
+{
+    atomic_int references;  ///< The number of nodes using the attributes
+    HashMap *map;           ///< The attributes
+};
+
+
+/**
+ * @brief Represents the text content of a document, the text of each node being a slice of it
+ */
+struct TextBlock
+{
+    atomic_int references;  ///< The number of nodes (and builders) using the block
+    size_t size;            ///< The size of the buffer
+    char *bytes;            ///< The buffer, the slices are followed by a NUL
+};
+
+
+/**
+ * @brief Represents a change remembered by the clock of a tree
+ */
+struct TreeChange
+{
+    Tree *node;                 ///< The node whose id, attributes or text changed, NULL for a change of structure
+    unsigned long generation;   ///< The generation the change gave to the tree
+};
+
+
+/**
+ * @brief Represents the generation of one tree, kept by its root
+ * 
+ * The nodes find the clock through their root, so adding or detaching a subtree only moves a
+ * link: a subtree added to a tree drops its clock, a detached one gets a new clock when asked.
+ * Trees nobody asked the generation of have no clock, so changing them costs nothing.
+ */
+struct TreeClock
+{
+    atomic_ulong generation;    ///< The generation of the tree, changed by every change made to it
+    unsigned long created;      ///< The generation the clock started at, the changes before it are unknown
+    unsigned long count;        ///< The number of changes made since, the last TREE_CHANGES are kept
+    unsigned long dropped;      ///< The generation of the last change dropped from the ring, 0 if none
+    struct TreeChange changes[TREE_CHANGES]; ///< The last changes, in a ring
+};
+
+
+/**
+ * @brief Represents a node waiting in the stack (or the queue) of a TreeIterator
+ */
+struct Frame
+{
+    Tree *node;                     ///< The node
+    union
+    {
+        struct ChildNode *next;     ///< Depth first: the next child of the node to visit
+        Tree *parent;               ///< Breadth first: the parent of the node
+    };
+    int depth;                      ///< The depth of the node
+};
+
+/**
+ * @brief The last generation given to a tree, so that two trees never have the same one
+ */
+static atomic_ulong treeGeneration = 1;
+
+
+/**
+ * @brief The number of clocks alive, changes do not look for the root of their tree while it is 0
+ */
+static atomic_int treeClocks;
+
+
+/**
+ * @brief The trees waiting for the reclaimer thread, chained by links of their own
+ * 
+ * The thread is started by the first TreeDestroyDeferred and lives as long as the process.
+ */
+static GMutex reclaimerLock;
+static GCond reclaimerCond;
+static struct ChildNode *reclaimerQueue;    ///< The trees not taken by the thread yet
+static int reclaimerBusy;                   ///< Whether the thread is destroying the trees it took
+static GThread *reclaimerThread;
+
+
+#define TREE_ITERATOR_INLINE_FRAMES 32  ///< The frames a TreeIterator holds before allocating its stack
+
+
+/**
+ * @brief Represents a walk over a tree
+ * 
+ * Depth first walks keep a stack of the ancestors of the current node, each with its next
+ * child to visit. Breadth first walks keep a queue of the nodes to visit (frames[head..size]).
+ * The children of a node are only scheduled on the next call, so they can still be skipped.
+ */
+struct TreeIterator
+{
+    treeOrder order;        ///< The order of the walk
+    Tree *root;             ///< The root of the walk
+    int started;            ///< Whether the root was visited
+    int failed;             ///< Whether the stack could not grow
+    Tree *current;          ///< The node last returned
+    Tree *parent;           ///< The parent of the node last returned
+    int depth;              ///< The depth of the node last returned
+    int isLast;             ///< Whether the node last returned is the last child of its parent
+    int pending;            ///< Whether the children of the node last returned are still to be scheduled
+    struct Frame *frames;   ///< The stack (or the queue), inlined until it outgrows it
+    int head;               ///< The first frame of the queue
+    int size;               ///< The number of frames used
+    int capacity;           ///< The number of frames available
+    struct Frame inlined[TREE_ITERATOR_INLINE_FRAMES]; ///< The first frames
+};
+
+
+
+
+/**
+ * @brief Prepares an iterator to use its inline frames
+ */
+static TreeIterator *initIterator(TreeIterator *iterator)
+{
+    iterator->frames = iterator->inlined;
+    iterator->capacity = TREE_ITERATOR_INLINE_FRAMES;
+    iterator->head = iterator->size = 0;
+    return iterator;
+}
+
+
+/**
+ * @brief Frees the frames of an iterator if they outgrew the inline ones
+ */
+static void releaseIterator(TreeIterator *iterator)
+{
+    if(iterator->frames != iterator->inlined) AllocatorFree(allocatorTree, iterator->frames, iterator->capacity * sizeof(struct Frame));
+    iterator->frames = iterator->inlined;
+    iterator->capacity = TREE_ITERATOR_INLINE_FRAMES;
+}
+
+
+/**
+ * @brief Pushes a frame on the stack (or at the end of the queue), growing it when full
+ * 
+ * @return 1 on success, -1 if the stack cannot grow (the iterator then stops)
+ */
+static int pushFrame(TreeIterator *iterator, struct Frame frame)
+{
+    if(iterator->size == iterator->capacity)
+    {
+        // Move the queue back to the start of the frames before growing them
+        if(iterator->head)
+        {
+            memmove(iterator->frames, iterator->frames + iterator->head, (iterator->size - iterator->head) * sizeof(struct Frame));
+            iterator->size -= iterator->head;
+            iterator->head = 0;
+        }
+        else
+        {
+            int capacity = iterator->capacity * 2;
+            struct Frame *frames = iterator->frames == iterator->inlined ? AllocatorAlloc(allocatorTree, capacity * sizeof(struct Frame))
+                                                                         : AllocatorRealloc(allocatorTree, iterator->frames, iterator->capacity * sizeof(struct Frame),
+                                                                                            capacity * sizeof(struct Frame));
+            if(!frames)
+            {
+                iterator->failed = 1;
+                return -1;
+            }
+            if(iterator->frames == iterator->inlined) memcpy(frames, iterator->inlined, sizeof(iterator->inlined));
+
+            iterator->frames = frames;
+            iterator->capacity = capacity;
+        }
+    }
+
+    iterator->frames[iterator->size++] = frame;
+    return 1;
+}
+
+
+/**
+ * @brief Makes a node the current one of the walk and returns it
+ */
+static Tree *visitFrame(TreeIterator *iterator, struct Frame frame, int isLast)
+{
+    iterator->current = frame.node;
+    iterator->parent = frame.parent;
+    iterator->depth = frame.depth;
+    iterator->isLast = isLast;
+    iterator->pending = 1;
+
+    // The queue is empty again, start it over at the first frame
+    if(iterator->head && iterator->head == iterator->size) iterator->head = iterator->size = 0;
+
+    return frame.node;
+}
+
+
+/**
+ * @brief Ends the walk, every node was visited
+ */
+static Tree *finishWalk(TreeIterator *iterator)
+{
+    iterator->current = NULL;
+    iterator->parent = NULL;
+    iterator->depth = -1;
+    iterator->pending = 0;
+    iterator->head = iterator->size = 0;
+    return NULL;
+}
+
+
+/**
+ * @brief Gives the tree of a node a new generation, if anything asked for it
+ * @param node The changed node
+ * @param content Whether only the id, the attributes or the text of the node changed
+ */
+static void touchTree(Tree *node, int content)
+{
+    if(!atomic_load_explicit(&treeClocks, memory_order_relaxed)) return;
+
+    Tree *root = node;
+    while(root->parent) root = root->parent;
+    struct TreeClock *clock = root->clock;
+    if(!clock) return;
+
+    unsigned long generation = atomic_fetch_add_explicit(&treeGeneration, 1, memory_order_relaxed) + 1;
+    struct TreeChange *change = &clock->changes[clock->count++ % TREE_CHANGES];
+    if(clock->count > TREE_CHANGES) clock->dropped = change->generation;
+    *change = (struct TreeChange){content ? node : NULL, generation};
+    atomic_store_explicit(&clock->generation, generation, memory_order_relaxed);
+}
+
+
+/**
+ * @brief Frees the clock of a node, if it has one
+ */
+static void releaseClock(Tree *node)
+{
+    if(!node->clock) return;
+
+    AllocatorFree(allocatorTree, node->clock, sizeof(struct TreeClock));
+    atomic_fetch_sub_explicit(&treeClocks, 1, memory_order_relaxed);
+    node->clock = NULL;
+}
+
+
+/**
+ * @brief Drops the attributes of a node, freeing them unless clones still share them
+ */
+static void releaseAttributes(Tree *node)
+{
+    if(!node->shared) HashMapFree(node->attributes);
+    else if(atomic_fetch_sub(&node->shared->references, 1) == 1)
+    {
+        HashMapFree(node->shared->map);
+        AllocatorFree(allocatorTree, node->shared, sizeof(struct SharedAttributes));
+    }
+
+    node->attributes = NULL;
+    node->shared = NULL;
+}
+
+
+/**
+ * @brief Makes the text of a node a slice of a block, taking a reference before dropping the old one
+ */
+static void shareText(Tree *node, TextBlock *block, unsigned int offset, unsigned int length)
+{
+    if(block) atomic_fetch_add(&block->references, 1);
+    TextBlockRelease(node->text);
+
+    node->text = block;
+    node->textOffset = block ? offset : 0;
+    node->textLength = block ? length : 0;
+}
+
+
+/**
+ * @brief Gives a node a new id, widget and attributes, and the children of another node if it has any
+ */
+static void replaceNode(Tree *node, char *id, GtkWidget *widget, HashMap *attributes, struct SharedAttributes *shared, Tree *from)
+{
+    g_free(node->id);
+    node->id = id;
+    node->widget = widget;
+
+    releaseAttributes(node);
+    node->attributes = attributes;
+    node->shared = shared;
+    FrozenHashMapRelease(node->frozen);
+    node->frozen = NULL;
+    shareText(node, from->text, from->textOffset, from->textLength);
+
+    if(from->children)
+    {
+        // Destroy the old subtrees, then take the children of the other node
+        struct ChildNode *curr = node->children;
+        while(curr)
+        {
+            struct ChildNode *next = curr->next;
+            TreeDestroyAll(curr->child);
+            AllocatorFree(allocatorTree, curr, sizeof(struct ChildNode));
+            curr = next;
+        }
+        node->children = from->children;
+        from->children = NULL;
+        for(struct ChildNode *link = node->children; link; link = link->next) link->child->parent = node;
+    }
+
+    // The virtual rows go with the children they describe
+    if(from->rows)
+    {
+        RowModelFree(node->rows);
+        node->rows = from->rows;
+        from->rows = NULL;
+    }
+
+    touchTree(node, 0);
+}
+
+
+
+
+Tree *TreeNew(const widgetType type, const char *id, GtkWidget *widget, HashMap *attributes)
+{
+    // Copy the id and the attributes, then adopt the copies
+    char *idCopy = g_strdup(id);
+    HashMap *attributesCopy = attributes ? HashMapGetCopy(attributes) : NULL;
+    if(attributes && !attributesCopy)
+    {
+        g_free(idCopy);
+        return NULL;
+    }
+
+    return TreeNewAdopt(type, idCopy, widget, attributesCopy);
+}
+
+
+
+
+Tree *TreeNewAdopt(const widgetType type, char *id, GtkWidget *widget, HashMap *attributes)
+{
+    // Allocate memory for the Tree structure, the id and the attributes are freed if it fails
+    Tree *tree = (Tree *)AllocatorAlloc(allocatorTree, sizeof(Tree));
+    if(!tree)
+    {
+        g_free(id);
+        HashMapFree(attributes);
+        return NULL;
+    }
+
+    // Initialize the Tree structure, it now owns the id and the attributes
+    tree->type = type;
+    tree->id = id;
+    tree->widget = widget;
+    tree->attributes = attributes;
+    tree->shared = NULL;
+
+    // Initialize the child nodes
+    tree->frozen = NULL;
+    tree->children = NULL;
+    tree->parent = NULL;
+    tree->rows = NULL;
+    tree->text = NULL;
+    tree->textOffset = tree->textLength = 0;
+    tree->clock = NULL;
+
+    return tree;
+}
+
+
+
+
+/**
+ * @brief The node built for a record and the end of its children list, while TreeBuild runs
+ */
+struct BuildSlot
+{
+    Tree *node;                 ///< The node of the record
+    struct ChildNode **tail;    ///< Where the link to its next child goes
+};
+
+
+/**
+ * @brief Adds an id to the set of the ids seen by TreeBuild (open addressing, record index + 1 per slot)
+ * 
+ * @return 1 if it was added, 0 if a record already has it
+ */
+static int addBuildId(int *set, int mask, const TreeRecord *records, int index)
+{
+    int slot = HashString(records[index].id) & mask;
+    for(; set[slot]; slot = (slot + 1) & mask)
+    {
+        if(strcmp(records[set[slot] - 1].id, records[index].id) == 0) return 0;
+    }
+
+    set[slot] = index + 1;
+    return 1;
+}
+
+
+/** @brief Builds the node of a record, its attributes in a HashMap of their exact size */
+static Tree *buildNode(const TreeRecord *record, const char *const *keys, const char *const *values)
+{
+    HashMap *attributes = NULL;
+    if(record->attributeCount)
+    {
+        if(!(attributes = HashMapNewWithCapacity(record->attributeCount))) return NULL;
+
+        for(int i = record->firstAttribute; i < record->firstAttribute + record->attributeCount; i++)
+        {
+            if(HashMapPut(attributes, keys[i], values[i]) == -1)
+            {
+                HashMapFree(attributes);
+                return NULL;
+            }
+        }
+    }
+
+    char *id = g_strdup(record->id);
+    if(!id)
+    {
+        HashMapFree(attributes);
+        return NULL;
+    }
+
+    return TreeNewAdopt(record->type, id, NULL, attributes);
+}
+
+
+Tree *TreeBuild(const TreeRecord *records, int count, const char *const *keys, const char *const *values)
+{
+    // Check the input parameters
+    if(!records || count <= 0 || count > INT_MAX / 4) return NULL;
+
+    // The ids are checked in a set at least twice as big as the records
+    int setSize = 1;
+    while(setSize < count * 2) setSize *= 2;
+
+    struct BuildSlot *slots = (struct BuildSlot *)AllocatorAlloc(allocatorTree, count * sizeof(struct BuildSlot));
+    int *ids = (int *)AllocatorCalloc(allocatorTree, setSize, sizeof(int));
+
+    Tree *root = NULL;
+    int failed = !slots || !ids;
+    for(int i = 0; i < count && !failed; i++)
+    {
+        const TreeRecord *record = &records[i];
+
+        // Only the first record is a root, the others come after their parent
+        failed = (i == 0) ? record->parent != -1 : (record->parent < 0 || record->parent >= i);
+        failed = failed || (int)record->type < 0 || record->type >= WIDGET_TYPE_COUNT || !record->id;
+        failed = failed || record->attributeCount < 0 || record->firstAttribute < 0;
+        failed = failed || (record->attributeCount && (!keys || !values));
+        failed = failed || !addBuildId(ids, setSize - 1, records, i);
+        if(failed) break;
+
+        Tree *node = buildNode(record, keys, values);
+        struct ChildNode *link = (i && node) ? (struct ChildNode *)AllocatorAlloc(allocatorTree, sizeof(struct ChildNode)) : NULL;
+        if(!node || (i && !link))
+        {
+            TreeDestroy(node);
+            failed = 1;
+            break;
+        }
+
+        // Append the node to the children of its parent, without walking them
+        if(i)
+        {
+            link->child = node;
+            link->next = NULL;
+            node->parent = slots[record->parent].node;
+            *slots[record->parent].tail = link;
+            slots[record->parent].tail = &link->next;
+        }
+        else root = node;
+
+        slots[i] = (struct BuildSlot){ node, &node->children };
+    }
+
+    AllocatorFree(allocatorTree, slots, count * sizeof(struct BuildSlot));
+    AllocatorFree(allocatorTree, ids, setSize * sizeof(int));
+
+    if(failed)
+    {
+        TreeDestroyAll(root);
+        return NULL;
+    }
+
+    return root;
+}
+
+
+
+
+int TreeAddChild(Tree *parent, Tree *child)
+{
+    // Check the input parameters
+    if(!parent || !child) return -1;
+
+    // Traverse the child nodes list to find the last one
+    struct ChildNode *lastChild = parent->children;
+    while(lastChild && lastChild->next) lastChild = lastChild->next;
+
+    // Create a new child node and add it to the list
+    struct ChildNode *newChild = (struct ChildNode *)AllocatorAlloc(allocatorTree, sizeof(struct ChildNode));
+    if(!newChild) return -1;
+
+    newChild->child = child;
+    newChild->next = NULL;
+
+    // Add the new child node to the list, the subtree now goes by the clock of the parent's tree
+    if(lastChild) lastChild->next = newChild;
+    else parent->children = newChild;
+    child->parent = parent;
+    releaseClock(child);
+
+    touchTree(parent, 0);
+    return 1;
+}
+
+
+
+
+int TreeRemoveChild(Tree *parent, const char *id) {
+    // Check the input parameters
+    if (!parent || !id) return -1;
+
+    struct ChildNode *curr = parent->children;
+    struct ChildNode *prev = NULL;
+
+    // Traverse the child nodes list to find the node with the specified identifier
+    while (curr) {
+        if (strcmp(curr->child->id, id) == 0) {
+            Tree *child = curr->child;
+
+            // Check if the child node has children
+            if (!TreeIsLeaf(child)) {
+                return -1;
+            }
+
+            // Remove the child node from the parent's children list
+            if (prev) {
+                prev->next = curr->next;
+            } else {
+                parent->children = curr->next;
+            }
+
+            // Free the memory allocated for the
+            AllocatorFree(allocatorTree, curr, sizeof(struct ChildNode));
+            TreeDestroy(child);
+
+            touchTree(parent, 0);
+            return 1;
+        }
+        prev = curr;
+        curr = curr->next;
+    }
+
+    // Node with the specified identifier not found
+    return -1;
+}
+
+
+
+
+/**
+ * @brief Searches a node and its descendants in pre-order, see TreeGetNode
+ * 
+ * @param virtualCells Non zero to find the cells of virtual rows that are not materialized too
+ */
+static Tree *findNode(Tree *parent, const char *id, int virtualCells)
+{
+    struct TreeIterator iterator;
+    TreeIteratorReset(initIterator(&iterator), parent, treePreOrder);
+
+    Tree *node;
+    int row, column;
+    while((node = TreeIteratorNext(&iterator)) && strcmp(node->id, id) != 0)
+    {
+        // The cells of virtual rows are found without being materialized
+        if(virtualCells && node->rows && RowModelParseId(node->id, id, &row, &column) == 1)
+        {
+            Tree *cell = RowModelGetCell(node->rows, node->id, row, column);
+            if(cell)
+            {
+                node = cell;
+                break;
+            }
+        }
+    }
+
+    releaseIterator(&iterator);
+    return node;
+}
+
+
+
+
+Tree *TreeGetNode(Tree *parent, const char *id)
+{
+    // Check the input parameters
+    if(!parent || !id) return NULL;
+
+    return findNode(parent, id, 1);
+}
+
+
+
+
+int TreeUpdateNode(Tree *root, char *id, Tree *newChild)
+{
+    // Check the input parameters
+    if(!root || !id || !newChild) return -1;
+
+    // Get the node with the specified identifier, the cells of virtual rows change through their model
+    Tree *node = findNode(root, id, 0);
+    if(!node) return -1;
+
+    // Copy the id and the attributes of the new child, its children are moved
+    char *idCopy = g_strdup(newChild->id);
+    HashMap *attributesCopy = newChild->attributes ? HashMapGetCopy(newChild->attributes) : NULL;
+    if(newChild->attributes && !attributesCopy)
+    {
+        g_free(idCopy);
+        return -1;
+    }
+
+    replaceNode(node, idCopy, newChild->widget, attributesCopy, NULL, newChild);
+    return 1;
+}
+
+
+
+
+int TreeUpdateNodeMove(Tree *root, char *id, Tree *newChild)
+{
+    // Check the input parameters
+    if(!root || !id || !newChild) return -1;
+
+    // Get the node with the specified identifier, the cells of virtual rows change through their model
+    Tree *node = findNode(root, id, 0);
+    if(!node || node == newChild) return -1;
+
+    // Steal everything from the new child, then free what is left of it
+    replaceNode(node, newChild->id, newChild->widget, newChild->attributes, newChild->shared, newChild);
+    FrozenHashMapRelease(newChild->frozen);
+    TextBlockRelease(newChild->text);
+    releaseClock(newChild);
+    AllocatorFree(allocatorTree, newChild, sizeof(Tree));
+
+    return 1;
+}
+
+
+
+
+void TreeDestroy(Tree *tree)
+{
+    // Check the input parameter
+    if(!tree) return;
+
+    // Free the attributes HashMap (or drop the node's share of it) and its reference to its snapshot
+    releaseAttributes(tree);
+    FrozenHashMapRelease(tree->frozen);
+    RowModelFree(tree->rows);
+    TextBlockRelease(tree->text);
+    releaseClock(tree);
+    
+    g_free(tree->id);
+    AllocatorFree(allocatorTree, tree, sizeof(Tree));
+}
+
+
+
+
+void TreeDestroyAll(Tree *tree)
+{
+    // Check the input parameter
+    if(!tree) return;
+
+    TRACE_BEGIN(destroy, "destroy");
+
+    // The children of each destroyed node are chained to the links still to visit, so the
+    // teardown needs no stack however deep the tree is (and cannot fail half way)
+    struct ChildNode *pending = NULL;
+    long destroyed = 0;
+    while(tree)
+    {
+        if(tree->children)
+        {
+            struct ChildNode *last = tree->children;
+            while(last->next) last = last->next;
+            last->next = pending;
+            pending = tree->children;
+        }
+
+        TreeDestroy(tree);
+        destroyed++;
+
+        // Take the next node, its link is not needed anymore
+        tree = NULL;
+        if(pending)
+        {
+            struct ChildNode *link = pending;
+            pending = link->next;
+            tree = link->child;
+            AllocatorFree(allocatorTree, link, sizeof(struct ChildNode));
+        }
+    }
+
+    TRACE_END(destroy, destroyed, 0);
+}
+
+
+
+
+int TreeDetachChild(Tree *parent, Tree *child)
+{
+    // Check the input parameters
+    if(!parent || !child) return -1;
+
+    // Only the link is released, the subtree is left as it is
+    for(struct ChildNode **link = &parent->children; *link; link = &(*link)->next)
+    {
+        if((*link)->child != child) continue;
+
+        struct ChildNode *found = *link;
+        *link = found->next;
+        AllocatorFree(allocatorTree, found, sizeof(struct ChildNode));
+        child->parent = NULL;
+
+        touchTree(parent, 0);
+        return 1;
+    }
+
+    return -1;
+}
+
+
+
+
+/** @brief The reclaimer thread: destroys the queued trees, all that were queued at once */
+static gpointer reclaimTrees(gpointer data)
+{
+    (void)data;
+    g_mutex_lock(&reclaimerLock);
+    for(;;)
+    {
+        while(!reclaimerQueue) g_cond_wait(&reclaimerCond, &reclaimerLock);
+
+        struct ChildNode *queue = reclaimerQueue;
+        reclaimerQueue = NULL;
+        reclaimerBusy = 1;
+        g_mutex_unlock(&reclaimerLock);
+
+        while(queue)
+        {
+            struct ChildNode *next = queue->next;
+            TreeDestroyAll(queue->child);
+            AllocatorFree(allocatorTree, queue, sizeof(struct ChildNode));
+            queue = next;
+        }
+
+        // Wake up TreeReclaimerFlush
+        g_mutex_lock(&reclaimerLock);
+        reclaimerBusy = 0;
+        g_cond_broadcast(&reclaimerCond);
+    }
+
+    return NULL;
+}
+
+
+int TreeDestroyDeferred(Tree *tree)
+{
+    // Check the input parameter
+    if(!tree) return -1;
+
+    struct ChildNode *link = AllocatorAlloc(allocatorTree, sizeof(struct ChildNode));
+
+    g_mutex_lock(&reclaimerLock);
+    if(link && !reclaimerThread) reclaimerThread = g_thread_try_new("tree-reclaimer", reclaimTrees, NULL, NULL);
+
+    // Without the thread the tree is destroyed right away
+    if(!link || !reclaimerThread)
+    {
+        g_mutex_unlock(&reclaimerLock);
+        AllocatorFree(allocatorTree, link, sizeof(struct ChildNode));
+        TreeDestroyAll(tree);
+        return 0;
+    }
+
+    link->child = tree;
+    link->next = reclaimerQueue;
+    reclaimerQueue = link;
+    g_cond_broadcast(&reclaimerCond);
+    g_mutex_unlock(&reclaimerLock);
+
+    return 1;
+}
+
+
+
+
+void TreeReclaimerFlush(void)
+{
+    g_mutex_lock(&reclaimerLock);
+    while(reclaimerQueue || reclaimerBusy) g_cond_wait(&reclaimerCond, &reclaimerLock);
+    g_mutex_unlock(&reclaimerLock);
+}
+
+
+
+
+int TreeIsLeaf(const Tree *tree)
+{
+    // Check the input parameter
+    if(!tree) return -1;
+
+    // Check if the tree has any children
+    return (tree->children == NULL) ? 1 : 0;
+}
+
+
+
+
+void TreePrint(const Tree *tree, const char *prefix, int isLast)
+{
+    // Check The input parameter
+    if (!tree || !prefix) return;
+
+    // Display a header when printing the root of the tree
+    if (strcmp(prefix, "") == 0) {
+        printf("\n\n\n-------------------------------------\n");
+        printf("The current state of the Tree is :\n");
+        printf("-------------------------------------\n");
+    }
+
+    // The line prefix, and where the prefix of each depth ends in it
+    GString *line = g_string_new(prefix);
+    GArray *ends = g_array_new(FALSE, FALSE, sizeof(gsize));
+    g_array_append_val(ends, line->len);
+
+    struct TreeIterator iterator;
+    TreeIteratorReset(initIterator(&iterator), (Tree *)tree, treePreOrder);
+
+    for (Tree *node = TreeIteratorNext(&iterator); node; node = TreeIteratorNext(&iterator)) {
+        int depth = TreeIteratorDepth(&iterator);
+        int last = depth ? TreeIteratorIsLast(&iterator) : isLast;
+
+        // Print the prefix of the node's depth and the tree structure line
+        g_string_truncate(line, g_array_index(ends, gsize, depth));
+        printf("%s", line->str);
+        printf("%s── %s\n", last ? "└" : "├", node->id);
+
+        // The prefix of the children (indentation of the next level)
+        g_string_append(line, last ? "    " : "│   ");
+        g_array_set_size(ends, depth + 2);
+        g_array_index(ends, gsize, depth + 1) = line->len;
+    }
+
+    releaseIterator(&iterator);
+    g_array_free(ends, TRUE);
+    g_string_free(line, TRUE);
+}
+
+
+
+
+Tree *TreeGetParent(Tree *root, const Tree *tree)
+{
+    // Check the input parameters
+    if (!root || !tree) return NULL;
+
+    // Go up from the node, it must be in the tree of the root (and the root itself has no parent)
+    for (const Tree *node = tree; node; node = node->parent) {
+        if (node == root) return tree == root ? NULL : tree->parent;
+    }
+
+    return NULL;
+}
+
+
+
+
+Tree *TreeGetParentNode(const Tree *tree)
+{
+    // Check the input parameter
+    if(!tree) return NULL;
+
+    return tree->parent;
+}
+
+
+
+
+widgetType TreeGetType(const Tree *tree)
+{
+    // Check the input parameter
+    if(!tree) return -1;
+
+    return tree->type;
+}
+
+
+
+
+const char *TreeGetId(const Tree *tree)
+{
+    // Check the input parameter
+    if(!tree) return NULL;
+
+    return tree->id;
+}
+
+
+
+
+GtkWidget *TreeGetWidget(const Tree *tree)
+{
+    // Check the input parameter
+    if(!tree) return NULL;
+
+    return tree->widget;
+}
+
+
+
+
+int TreeSetWidget(Tree *tree, GtkWidget *widget)
+{
+    // Check the input parameter
+    if(!tree) return -1;
+
+    tree->widget = widget;
+    return 1;
+}
+
+
+
+
+int TreeSetId(Tree *tree, const char *id)
+{
+    // Check the input parameters
+    if(!tree || !id) return -1;
+
+    char *copy = g_strdup(id);
+    if(!copy) return -1;
+
+    g_free(tree->id);
+    tree->id = copy;
+
+    touchTree(tree, 1);
+    return 1;
+}
+
+
+
+
+const HashMap *TreeGetAttributes(const Tree *tree)
+{
+    // Check the input parameter
+    if(!tree) return NULL;
+
+    return tree->attributes;
+}
+
+
+
+
+TextBlock *TextBlockAdopt(char *bytes, size_t size)
+{
+    // Check the input parameter
+    if(!bytes) return NULL;
+
+    TextBlock *block = (TextBlock *)AllocatorAlloc(allocatorTree, sizeof(TextBlock));
+    if(!block)
+    {
+        AllocatorFree(allocatorTree, bytes, size);
+        return NULL;
+    }
+
+    atomic_init(&block->references, 1);
+    block->size = size;
+    block->bytes = bytes;
+    return block;
+}
+
+
+
+
+void TextBlockRelease(TextBlock *block)
+{
+    // Check the input parameter
+    if(!block) return;
+
+    if(atomic_fetch_sub(&block->references, 1) == 1)
+    {
+        AllocatorFree(allocatorTree, block->bytes, block->size);
+        AllocatorFree(allocatorTree, block, sizeof(TextBlock));
+    }
+}
+
+
+
+
+int TreeSetText(Tree *tree, TextBlock *block, size_t offset, size_t length)
+{
+    // Check the input parameters
+    if(!tree) return -1;
+
+    // The slice must be a string of the block
+    if(block && (offset >= block->size || length >= block->size - offset || offset > UINT_MAX || length > UINT_MAX || block->bytes[offset + length] != '\0')) return -1;
+
+    shareText(tree, block, (unsigned int)offset, (unsigned int)length);
+    touchTree(tree, 1);
+    return 1;
+}
+
+
+
+
+const char *TreeGetText(const Tree *tree, size_t *length)
+{
+    // Check the input parameter
+    if(!tree || !tree->text) return NULL;
+
+    if(length) *length = tree->textLength;
+    return tree->text->bytes + tree->textOffset;
+}
+
+
+
+
+int TreeForEachChild(const Tree *tree, void (*callback)(Tree *child, void *userData), void *userData)
+{
+    // Check the input parameters
+    if(!tree || !callback) return -1;
+
+    // Visit the children in their insertion order
+    int count = 0;
+    for(struct ChildNode *curr = tree->children; curr; curr = curr->next)
+    {
+        callback(curr->child, userData);
+        count++;
+    }
+
+    return count;
+}
+
+
+
+
+int TreeSetRowModel(Tree *tree, RowModel *model)
+{
+    // Check the input parameters
+    if(!tree || tree->type != grid)
+    {
+        RowModelFree(model);
+        return -1;
+    }
+
+    RowModelFree(tree->rows);
+    tree->rows = model;
 
+    touchTree(tree, 0);
+    return 1;
+}
 
-Tree *TreeNew(const widgetType type, const char *id, GtkWidget *widget, HashMap *attributes)
+
+
+
+RowModel *TreeGetRowModel(const Tree *tree)
 {
-    // Allocate memory for the Tree structure
-    Tree *tree = (Tree *)malloc(sizeof(Tree));
+    // Check the input parameter
     if(!tree) return NULL;
 
-    // Initialize the Tree structure
-    tree->type = type;
-    tree->id = g_strdup(id);
-    tree->widget = widget;
-    
-    // Copy the HashMap attributes
-    tree->attributes = HashMapGetCopy(attributes);
-    if(!tree->attributes)
+    return tree->rows;
+}
+
+
+
+
+int TreeForEachVirtualChild(Tree *tree, void (*callback)(Tree *child, void *userData), void *userData)
+{
+    // Check the input parameters
+    if(!tree || !callback) return -1;
+    if(!tree->rows) return TreeForEachChild(tree, callback, userData);
+
+    // Every cell, row after row, materialized or read through the model
+    int rows = RowModelGetRowCount(tree->rows), columns = RowModelGetColumnCount(tree->rows);
+    for(int row = 0; row < rows; row++)
     {
-        free(tree);
-        return NULL;
+        for(int column = 0; column < columns; column++)
+        {
+            Tree *cell = RowModelPeekCell(tree->rows, tree->id, row, column);
+            if(!cell) return -1;
+            callback(cell, userData);
+        }
     }
 
-    // Initialize the child nodes
-    tree->children = NULL;
-
-    return tree;
+    return rows * columns;
 }
 
 
 
 
-int TreeAddChild(Tree *parent, Tree *child)
+FrozenHashMap *TreeFreezeAttributes(Tree *tree)
 {
-    // Check the input parameters
-    if(!parent || !child) return -1;
+    // Check the input parameter
+    if(!tree || !tree->attributes) return NULL;
 
-    // Traverse the child nodes list to find the last one
-    struct ChildNode *lastChild = parent->children;
-    while(lastChild && lastChild->next) lastChild = lastChild->next;
+    // The snapshot is made once and kept until the attributes change
+    if(!tree->frozen) tree->frozen = HashMapFreeze(tree->attributes);
 
-    // Create a new child node and add it to the list
-    struct ChildNode *newChild = (struct ChildNode *)malloc(sizeof(struct ChildNode));
-    if(!newChild) return -1;
+    return tree->frozen;
+}
 
-    newChild->child = child;
-    newChild->next = NULL;
 
-    // Add the new child node to the list
-    if(lastChild) lastChild->next = newChild;
-    else parent->children = newChild;
 
-    return 1;
-}
 
+/**
+ * @brief Snapshots that were already made by TreeFreezeAll, open addressed by their hash
+ */
+struct FrozenSet
+{
+    FrozenHashMap **slots;  ///< The snapshots, NULL marks an empty slot
+    int capacity;           ///< The number of slots (a power of two)
+    int size;               ///< The number of snapshots
+};
 
 
+/**
+ * @brief Returns the snapshot of the set equal to the given one, adding it if there is none
+ */
+static FrozenHashMap *shareFrozen(struct FrozenSet *set, FrozenHashMap *frozen)
+{
+    // Keep the set at most half full
+    if((set->size + 1) * 2 > set->capacity)
+    {
+        int capacity = set->capacity ? set->capacity * 2 : 64;
+        FrozenHashMap **slots = (FrozenHashMap **)AllocatorCalloc(allocatorTree, capacity, sizeof(FrozenHashMap *));
+        if(!slots) return NULL;
 
-int TreeRemoveChild(Tree *parent, const char *id) {
-    // Check the input parameters
-    if (!parent || !id) return -1;
+        for(int i = 0; i < set->capacity; i++)
+        {
+            if(!set->slots[i]) continue;
+            int slot = FrozenHashMapHash(set->slots[i]) & (capacity - 1);
+            while(slots[slot]) slot = (slot + 1) & (capacity - 1);
+            slots[slot] = set->slots[i];
+        }
 
-    struct ChildNode *curr = parent->children;
-    struct ChildNode *prev = NULL;
+        AllocatorFree(allocatorTree, set->slots, set->capacity * sizeof(FrozenHashMap *));
+        set->slots = slots;
+        set->capacity = capacity;
+    }
 
-    // Traverse the child nodes list to find the node with the specified identifier
-    while (curr) {
-        if (strcmp(curr->child->id, id) == 0) {
-            Tree *child = curr->child;
+    int slot = FrozenHashMapHash(frozen) & (set->capacity - 1);
+    while(set->slots[slot])
+    {
+        if(FrozenHashMapEquals(set->slots[slot], frozen) == 1) return set->slots[slot];
+        slot = (slot + 1) & (set->capacity - 1);
+    }
 
-            // Check if the child node has children
-            if (!TreeIsLeaf(child)) {
-                return -1;
-            }
+    set->slots[slot] = frozen;
+    set->size++;
+    return frozen;
+}
 
-            // Remove the child node from the parent's children list
-            if (prev) {
-                prev->next = curr->next;
-            } else {
-                parent->children = curr->next;
-            }
 
-            // Free the memory allocated for the
-            free(curr);
-            TreeDestroy(child);
+int TreeFreezeAll(Tree *root)
+{
+    // Check the input parameter
+    if(!root) return -1;
 
-            return 1;
+    TRACE_BEGIN(freeze, "freeze");
+
+    struct FrozenSet set = { NULL, 0, 0 };
+    struct TreeIterator iterator;
+    TreeIteratorReset(initIterator(&iterator), root, treePreOrder);
+
+    int result = 1;
+    long frozenNodes = 0;
+    for(Tree *node = TreeIteratorNext(&iterator); node && result != -1; node = TreeIteratorNext(&iterator))
+    {
+        frozenNodes++;
+        FrozenHashMap *frozen = TreeFreezeAttributes(node);
+        if(!frozen)
+        {
+            if(node->attributes) result = -1;
+            continue;
+        }
+
+        FrozenHashMap *shared = shareFrozen(&set, frozen);
+        if(!shared) result = -1;
+
+        // Another node already holds the same pairs, use its snapshot instead
+        else if(shared != frozen)
+        {
+            FrozenHashMapRelease(frozen);
+            node->frozen = FrozenHashMapRetain(shared);
         }
-        prev = curr;
-        curr = curr->next;
     }
+    if(iterator.failed) result = -1;
 
-    // Node with the specified identifier not found
-    return -1;
+    releaseIterator(&iterator);
+    AllocatorFree(allocatorTree, set.slots, set.capacity * sizeof(FrozenHashMap *));
+
+    TRACE_END(freeze, frozenNodes, 0);
+    return result == -1 ? -1 : set.size;
 }
 
 
 
 
-Tree *TreeGetNode(Tree *parent, const char *id)
+int TreeSetAttribute(Tree *tree, const char *key, const char *value)
 {
     // Check the input parameters
-    if(!parent || !id) return NULL;
+    if(!tree || !key) return -1;
 
-    // Check if the parent node is the search target
-    if(strcmp(parent->id, id) == 0) return parent;
-
-    Tree *node = NULL;
+    // Attributes still shared with clones are copied before the first change
+    if(tree->shared && atomic_load(&tree->shared->references) > 1)
+    {
+        HashMap *copy = HashMapGetCopy(tree->attributes);
+        if(!copy) return -1;
+        releaseAttributes(tree);
+        tree->attributes = copy;
+    }
 
-    // Traverse the child nodes list to find the node with the specified identifier
-    struct ChildNode *curr = parent->children;
-    while(curr)
+    if(!value)
     {
-        if(strcmp(curr->child->id, id) == 0) return curr->child;
-        node = TreeGetNode(curr->child, id);
-        if(node) return node;
-        curr = curr->next;
+        if(!tree->attributes || HashMapContainsKey(tree->attributes, key) != 1) return 0;
+        HashMapRemove(tree->attributes, (char *)key);
+    }
+    else
+    {
+        if(!tree->attributes && !(tree->attributes = HashMapNew())) return -1;
+        if(HashMapPut(tree->attributes, key, value) < 0) return -1;
     }
 
-    return NULL;
+    FrozenHashMapRelease(tree->frozen);
+    tree->frozen = NULL;
+    touchTree(tree, 1);
+    return 1;
 }
 
 
+/**
+ * @brief Represents a node of a clone being built, with the place where its next child goes
+ */
+struct CloneFrame
+{
+    Tree *clone;                ///< The clone of the node
+    struct ChildNode **tail;    ///< The link the next child of the clone is stored in
+};
 
 
-int TreeUpdateNode(Tree *root, char *id, Tree *newChild)
+/** @brief Makes a copy of a single node sharing its attributes, without children or widget */
+static Tree *cloneNode(Tree *node, const char *prefix)
 {
-    // Check the input parameters
-    if(!root || !id || !newChild) return -1;
+    // The id is the prefix, a dash and the id of the node, in a single allocation
+    char *id;
+    if(!prefix) id = g_strdup(node->id);
+    else
+    {
+        size_t prefixLength = strlen(prefix), idLength = strlen(node->id);
+        id = g_malloc(prefixLength + idLength + 2);
+        memcpy(id, prefix, prefixLength);
+        id[prefixLength] = '-';
+        memcpy(id + prefixLength + 1, node->id, idLength + 1);
+    }
+
+    Tree *clone = TreeNewAdopt(node->type, id, NULL, NULL);
+    if(clone) shareText(clone, node->text, node->textOffset, node->textLength);
+    if(!clone || !node->attributes) return clone;
+
+    // The first clone turns the attributes of the node into shared ones
+    if(!node->shared)
+    {
+        if(!(node->shared = AllocatorAlloc(allocatorTree, sizeof(struct SharedAttributes))))
+        {
+            TreeDestroy(clone);
+            return NULL;
+        }
+        atomic_init(&node->shared->references, 1);
+        node->shared->map = node->attributes;
+    }
+
+    atomic_fetch_add(&node->shared->references, 1);
+    clone->shared = node->shared;
+    clone->attributes = node->attributes;
+    clone->frozen = node->frozen ? FrozenHashMapRetain(node->frozen) : NULL;
+    return clone;
+}
 
-    // Get the node with the specified identifier
-    Tree *node = TreeGetNode(root, id);
-    if(!node) return -1;
 
-    // Update the node with the new child
-    g_free(node->id); node->id = g_strdup(newChild->id);
-    node->widget = newChild->widget;
+/** @brief Makes a copy of a subtree sharing its attributes, the ids prefixed if a prefix is given */
+static Tree *cloneTree(Tree *tree, const char *prefix)
+{
+    TRACE_BEGIN(clone, "clone");
 
-    if(node->attributes) HashMapFree(node->attributes);
-    node->attributes = HashMapGetCopy(newChild->attributes);
+    struct TreeIterator iterator;
+    TreeIteratorReset(initIterator(&iterator), tree, treePreOrder);
 
-    if(newChild->children)
+    // The clone of the last node seen at each depth is the parent of the next deeper node
+    GArray *frames = g_array_new(FALSE, FALSE, sizeof(struct CloneFrame));
+    Tree *root = NULL, *node;
+    long cloned = 0;
+    while((node = TreeIteratorNext(&iterator)))
     {
-        // Free the old children nodes
-        struct ChildNode *curr = node->children;
-        while(curr)
+        Tree *clone = cloneNode(node, prefix);
+        cloned++;
+        struct ChildNode *link = (iterator.depth && clone) ? AllocatorAlloc(allocatorTree, sizeof(struct ChildNode)) : NULL;
+        if(!clone || (iterator.depth && !link))
         {
-            struct ChildNode *next = curr->next;
-            TreeDestroy(curr->child);
-            free(curr);
-            curr = next;
+            TreeDestroy(clone);
+            TreeDestroyAll(root);
+            root = NULL;
+            break;
+        }
+
+        // Append the clone to the children of its parent's clone
+        if(iterator.depth)
+        {
+            struct CloneFrame *parent = &g_array_index(frames, struct CloneFrame, iterator.depth - 1);
+            link->child = clone;
+            link->next = NULL;
+            clone->parent = parent->clone;
+            *parent->tail = link;
+            parent->tail = &link->next;
         }
-        node->children = newChild->children;
-        newChild->children = NULL;
+        else root = clone;
+
+        g_array_set_size(frames, iterator.depth + 1);
+        g_array_index(frames, struct CloneFrame, iterator.depth) = (struct CloneFrame){clone, &clone->children};
     }
 
-    return 1;
+    if(iterator.failed)
+    {
+        TreeDestroyAll(root);
+        root = NULL;
+    }
+
+    g_array_free(frames, TRUE);
+    releaseIterator(&iterator);
+    TRACE_END(clone, cloned, 0);
+    return root;
 }
 
 
 
 
-void TreeDestroy(Tree *tree)
+Tree *TreeClone(Tree *tree)
 {
     // Check the input parameter
-    if(!tree) return;
+    if(!tree) return NULL;
 
-    // Free the attributes HashMap
-    if(tree->attributes) HashMapFree(tree->attributes);
-    
-    g_free(tree->id);
-    g_free(tree);
+    return cloneTree(tree, NULL);
 }
 
 
 
 
-void TreeDestroyAll(Tree *tree)
+Tree *TreeInstantiate(Tree *templateRoot, const char *prefix)
+{
+    // Check the input parameters
+    if(!templateRoot || !prefix) return NULL;
+
+    return cloneTree(templateRoot, prefix);
+}
+
+
+
+
+TreeIterator *TreeIteratorNew(Tree *root, treeOrder order)
+{
+    // Check the input parameters
+    if(!root) return NULL;
+
+    TreeIterator *iterator = (TreeIterator *)AllocatorAlloc(allocatorTree, sizeof(TreeIterator));
+    if(!iterator) return NULL;
+
+    if(TreeIteratorReset(initIterator(iterator), root, order) == -1)
+    {
+        AllocatorFree(allocatorTree, iterator, sizeof(TreeIterator));
+        return NULL;
+    }
+
+    return iterator;
+}
+
+
+
+
+int TreeIteratorReset(TreeIterator *iterator, Tree *root, treeOrder order)
+{
+    // Check the input parameters
+    if(!iterator || !root) return -1;
+    if(order != treePreOrder && order != treePostOrder && order != treeBreadthFirst) return -1;
+
+    // Keep the frames, only forget what they hold
+    iterator->order = order;
+    iterator->root = root;
+    iterator->started = 0;
+    iterator->failed = 0;
+    iterator->current = NULL;
+    iterator->parent = NULL;
+    iterator->depth = -1;
+    iterator->isLast = 1;
+    iterator->pending = 0;
+    iterator->head = 0;
+    iterator->size = 0;
+
+    return 1;
+}
+
+
+
+
+Tree *TreeIteratorNext(TreeIterator *iterator)
 {
     // Check the input parameter
-    if(!tree) return;
+    if(!iterator || iterator->failed) return NULL;
 
-    // Save the children nodes
-    struct ChildNode *curr = tree->children;
+    // The root comes first, except in post-order where it is pushed and comes last
+    if(!iterator->started)
+    {
+        iterator->started = 1;
+        if(iterator->order == treePostOrder)
+        {
+            if(pushFrame(iterator, (struct Frame){ .node = iterator->root, .next = iterator->root->children }) == -1) return NULL;
+        }
+        else return visitFrame(iterator, (struct Frame){ .node = iterator->root, .parent = NULL, .depth = 0 }, 1);
+    }
 
-    // Destroy the children nodes
-    while(curr)
+    switch(iterator->order)
     {
-        // Save the next node
-        struct ChildNode *next = curr->next;
+        case treePreOrder:
+        {
+            // Descend into the node last returned, unless its children were skipped
+            Tree *current = iterator->current;
+            if(iterator->pending && current->children &&
+               pushFrame(iterator, (struct Frame){ .node = current, .next = current->children }) == -1) return NULL;
+            iterator->pending = 0;
+
+            // Go back up to the nearest ancestor with a child left
+            while(iterator->size && !iterator->frames[iterator->size - 1].next) iterator->size--;
+            if(!iterator->size) return finishWalk(iterator);
+
+            struct Frame *top = &iterator->frames[iterator->size - 1];
+            Tree *child = top->next->child;
+            top->next = top->next->next;
+            return visitFrame(iterator, (struct Frame){ .node = child, .parent = top->node, .depth = iterator->size }, !top->next);
+        }
+
+        case treePostOrder:
+        {
+            // Descend to the first child not visited yet, then return the node once it has none left
+            while(iterator->size)
+            {
+                struct Frame *top = &iterator->frames[iterator->size - 1];
+                if(top->next)
+                {
+                    Tree *child = top->next->child;
+                    top->next = top->next->next;
+                    if(pushFrame(iterator, (struct Frame){ .node = child, .next = child->children }) == -1) return NULL;
+                    continue;
+                }
+
+                Tree *node = top->node;
+                iterator->size--;
+                struct Frame *parent = iterator->size ? &iterator->frames[iterator->size - 1] : NULL;
+                return visitFrame(iterator, (struct Frame){ .node = node, .parent = parent ? parent->node : NULL,
+                                  .depth = iterator->size }, parent ? !parent->next : 1);
+            }
+            return finishWalk(iterator);
+        }
 
-        TreeDestroyAll(curr->child);
-        free(curr);
+        default:
+        {
+            // Queue the children of the node last returned, unless they were skipped
+            Tree *current = iterator->current;
+            if(iterator->pending)
+            {
+                for(struct ChildNode *curr = current->children; curr; curr = curr->next)
+                {
+                    if(pushFrame(iterator, (struct Frame){ .node = curr->child, .parent = current,
+                                 .depth = iterator->depth + 1 }) == -1) return NULL;
+                }
+            }
+            iterator->pending = 0;
 
-        curr = next;
+            if(iterator->head == iterator->size) return finishWalk(iterator);
+            return visitFrame(iterator, iterator->frames[iterator->head++], -1);
+        }
     }
+}
+
+
+
+
+int TreeIteratorSkipChildren(TreeIterator *iterator)
+{
+    // Check the input parameter
+    if(!iterator || !iterator->current || iterator->order == treePostOrder) return -1;
 
-    // Destroy the current node
-    TreeDestroy(tree);
+    iterator->pending = 0;
+    return 1;
 }
 
 
 
 
-int TreeIsLeaf(const Tree *tree)
+int TreeIteratorDepth(const TreeIterator *iterator)
 {
     // Check the input parameter
-    if(!tree) return -1;
+    if(!iterator || !iterator->current) return -1;
 
-    // Check if the tree has any children
-    return (tree->children == NULL) ? 1 : 0;
+    return iterator->depth;
 }
 
 
 
 
-void TreePrint(const Tree *tree, const char *prefix, int isLast)
+Tree *TreeIteratorParent(const TreeIterator *iterator)
 {
-    // Check The input parameter
-    if (!tree) return;
+    // Check the input parameter
+    if(!iterator) return NULL;
 
-    // Display a header when printing the root of the tree
-    if (strcmp(prefix, "") == 0) {
-        printf("\n\n\n-------------------------------------\n");
-        printf("The current state of the Tree is :\n");
-        printf("-------------------------------------\n");
-    }
+    return iterator->parent;
+}
 
-    // Print the prefix and the tree structure line
-    printf("%s", prefix);
-    printf("%s── %s\n", isLast ? "└" : "├", tree->id);
 
-    // Create a new prefix for the next level (children indentation)
-    char newPrefix[256];
-    snprintf(newPrefix, sizeof(newPrefix), "%s%s", prefix, isLast ? "    " : "│   ");
 
-    // Count the number of children to identify the last one
-    int count = 0;
-    for (struct ChildNode *c = tree->children; c; c = c->next) count++;
 
-    // Recursively print all children
-    int i = 0;
-    for (struct ChildNode *curr = tree->children; curr; curr = curr->next) {
-        TreePrint(curr->child, newPrefix, ++i == count);
-    }
+int TreeIteratorIsLast(const TreeIterator *iterator)
+{
+    // Check the input parameter
+    if(!iterator || !iterator->current) return -1;
+
+    return iterator->isLast;
 }
 
 
 
 
+void TreeIteratorFree(TreeIterator *iterator)
+{
+    // Check the input parameter
+    if(!iterator) return;
 
+    releaseIterator(iterator);
+    AllocatorFree(allocatorTree, iterator, sizeof(TreeIterator));
+}
 
-Tree *TreeGetParent(Tree *root, const Tree *tree)
+
+
+
+int TreeVisit(Tree *root, visitResult (*visitor)(Tree *node, int depth, void *userData), void *userData)
 {
     // Check the input parameters
-    if (!root || !tree) return NULL;
+    if(!root || !visitor) return -1;
 
-    // Traverse all children of the current node
-    struct ChildNode *curr = root->children;
-    while (curr)
+    struct TreeIterator iterator;
+    TreeIteratorReset(initIterator(&iterator), root, treePreOrder);
+
+    // Visit the nodes in pre-order, as long as the visitor asks for it
+    int count = 0;
+    for(Tree *node = TreeIteratorNext(&iterator); node; node = TreeIteratorNext(&iterator))
     {
-        // If the current child is the target node, return the parent node
-        if (curr->child == tree)
-            return root;
+        count++;
+        visitResult result = visitor(node, iterator.depth, userData);
+        if(result == visitStop) break;
+        if(result == visitSkipChildren) TreeIteratorSkipChildren(&iterator);
+    }
+
+    int failed = iterator.failed;
+    releaseIterator(&iterator);
+
+    return failed ? -1 : count;
+}
+
+
 
-        // Recursively check the descendants of the current child node
-        Tree *parent = TreeGetParent(curr->child, tree);
-        if (parent) return parent; // If found, return the parent
 
-        curr = curr->next; // Move to the next child
+unsigned long TreeGetGeneration(Tree *root)
+{
+    // Check the input parameter
+    if(!root) return 0;
+
+    // The clock is kept by the root of the tree, the first call gives it one
+    while(root->parent) root = root->parent;
+    if(!root->clock)
+    {
+        struct TreeClock *clock = AllocatorAlloc(allocatorTree, sizeof(struct TreeClock));
+        if(!clock) return 0;
+
+        atomic_fetch_add_explicit(&treeClocks, 1, memory_order_relaxed);
+        clock->created = atomic_fetch_add_explicit(&treeGeneration, 1, memory_order_relaxed) + 1;
+        clock->count = clock->dropped = 0;
+        atomic_init(&clock->generation, clock->created);
+        root->clock = clock;
     }
 
-    return NULL; // Parent not found
+    return atomic_load_explicit(&root->clock->generation, memory_order_relaxed);
 }
 
 
 
 
-widgetType TreeGetType(const Tree *tree)
+int TreeGetChanges(Tree *root, unsigned long since, Tree **nodes, int capacity)
 {
-    // Check the input parameter
-    if(!tree) return -1;
+    // Check the input parameters
+    if(!root || !nodes || capacity < 0) return -1;
 
-    return tree->type;
+    while(root->parent) root = root->parent;
+    const struct TreeClock *clock = root->clock;
+    if(!clock || since < clock->created) return -1;
+
+    // From the last change back to the first one made after the generation
+    int count = 0;
+    for(unsigned long i = 0; i < clock->count && i < TREE_CHANGES; i++)
+    {
+        const struct TreeChange *change = &clock->changes[(clock->count - 1 - i) % TREE_CHANGES];
+        if(change->generation <= since) return count;
+        if(!change->node || count == capacity) return -1;
+        nodes[count++] = change->node;
+    }
+
+    // Every change is known unless the ring dropped some made after the generation
+    return (clock->dropped <= since) ? count : -1;
 }
 
 
 
 
-const char *TreeGetId(const Tree *tree)
+size_t TreeMemoryUsage(const Tree *tree, MemoryUsage *usage)
 {
     // Check the input parameter
-    if(!tree) return NULL;
+    if(!tree) return 0;
 
-    return tree->id;
+    MemoryUsage total = { 0 };
+    struct TreeIterator iterator;
+    TreeIteratorReset(initIterator(&iterator), (Tree *)tree, treePreOrder);
+
+    for(Tree *node = TreeIteratorNext(&iterator); node; node = TreeIteratorNext(&iterator))
+    {
+        total.nodes += sizeof(Tree);
+        total.ids += strlen(node->id) + 1;
+        for(struct ChildNode *link = node->children; link; link = link->next) total.childLinks += sizeof(struct ChildNode);
+
+        if(!node->shared) HashMapMemoryUsage(node->attributes, &total);
+        else
+        {
+            // Shared attributes count for the share of each node using them
+            MemoryUsage shared = { .nodes = sizeof(struct SharedAttributes) };
+            HashMapMemoryUsage(node->shared->map, &shared);
+            int references = atomic_load(&node->shared->references);
+            total.nodes += shared.nodes / references;
+            total.maps += shared.maps / references;
+            total.keys += shared.keys / references;
+            total.values += shared.values / references;
+        }
+
+        total.frozen += FrozenHashMapMemoryUsage(node->frozen);
+        total.rows += RowModelGetMemoryUsage(node->rows);
+
+        // A text block counts for the share of each node using it, like shared attributes
+        if(node->text) total.text += (sizeof(TextBlock) + node->text->size) / atomic_load(&node->text->references);
+    }
+    releaseIterator(&iterator);
+
+    if(usage)
+    {
+        usage->nodes += total.nodes;
+        usage->childLinks += total.childLinks;
+        usage->ids += total.ids;
+        usage->maps += total.maps;
+        usage->keys += total.keys;
+        usage->values += total.values;
+        usage->frozen += total.frozen;
+        usage->rows += total.rows;
+        usage->text += total.text;
+    }
+    return MemoryUsageTotal(&total);
 }
 
 
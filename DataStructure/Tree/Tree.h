@@ -18,7 +18,46 @@
 #include "../HashMap/HashMap.h"
 #include "../../Utils/Enums.h"
 
+#ifndef TREE_CHANGES
+#define TREE_CHANGES 32     ///< The number of last changes a tree with a generation remembers (see TreeGetChanges)
+#endif
+
 typedef struct Tree Tree;
+typedef struct TreeIterator TreeIterator;
+typedef struct RowModel RowModel;
+typedef struct TextBlock TextBlock;
+
+/**
+ * @brief The orders a TreeIterator can visit the nodes in
+ */
+typedef enum
+{
+    treePreOrder,       ///< Each node before its children
+    treePostOrder,      ///< Each node after its children
+    treeBreadthFirst    ///< Level by level, from the root
+} treeOrder;
+
+/**
+ * @brief What a TreeVisit visitor asks for after visiting a node
+ */
+typedef enum
+{
+    visitContinue,      ///< Visit the children of the node, then go on
+    visitSkipChildren,  ///< Do not visit the children of the node
+    visitStop           ///< Stop the visit
+} visitResult;
+
+/**
+ * @brief A node of a Tree given as a flat record, see TreeBuild
+ */
+typedef struct
+{
+    int parent;             ///< The index of the record of the parent, -1 for the root
+    widgetType type;        ///< The type of the node
+    const char *id;         ///< The identifier of the node (copied), unique among the records
+    int firstAttribute;     ///< The index of the first attribute of the node in the keys and the values
+    int attributeCount;     ///< The number of attributes of the node
+} TreeRecord;
 
 /**
  * @brief Creates a new Tree instance
@@ -28,6 +67,40 @@ typedef struct Tree Tree;
 Tree *TreeNew(const widgetType type, const char *id, GtkWidget *widget, HashMap *attributes);
 
 
+/**
+ * @brief Creates a new Tree instance that takes ownership of its id and attributes, without copying them
+ * 
+ * Meant for builders that make a fresh id and HashMap for each node: they belong to the node
+ * from now on (even if the creation fails) and must not be used or freed by the caller.
+ * 
+ * @param type The type of the node
+ * @param id The identifier of the node, allocated with g_malloc (e.g., g_strdup)
+ * @param widget The GTK widget of the node, or NULL
+ * @param attributes The attributes of the node, or NULL
+ * @return Tree* A pointer to the newly created Tree, or NULL if allocation fails
+ */
+Tree *TreeNewAdopt(const widgetType type, char *id, GtkWidget *widget, HashMap *attributes);
+
+
+/**
+ * @brief Builds a whole Tree from flat records in a single pass
+ * 
+ * Every record comes after the record of its parent, so each node is attached as soon as it
+ * is built, after the children already attached. The attributes of a record are the pairs
+ * keys[firstAttribute + i] = values[firstAttribute + i], stored in a HashMap sized for them
+ * (a later pair replaces an earlier one with the same key). The records are validated in the
+ * same pass.
+ * 
+ * @param records The records, the root first
+ * @param count The number of records
+ * @param keys The keys of the attributes of all the records (may be NULL if no record has any)
+ * @param values The values of the attributes, in the same order as the keys
+ * @return The root of the Tree, or NULL if any error occurs (e.g., an unknown type, a parent
+ *         that is not an earlier record, a second root, a missing or repeated id)
+ */
+Tree *TreeBuild(const TreeRecord *records, int count, const char *const *keys, const char *const *values);
+
+
 /**
  * @brief Adds a child node to a parent tree
  * 
@@ -51,6 +124,11 @@ int TreeRemoveChild(Tree *parent, const char *id);
 /**
  * @brief Retrieves a specific child node from a parent tree by its identifier
  * 
+ * The cells of the virtual rows of a grid are found too, see TreeSetRowModel. The node of a
+ * cell that is not materialized belongs to the row model: it stays valid for the next
+ * ROW_MODEL_LOOKUPS lookups of such cells, and the lookup changes neither the tree nor its
+ * generation (see RowModelGetCell).
+ * 
  * @param parent The parent tree to search within
  * @param id The identifier of the child node to retrieve
  * @return Tree* A pointer to the found child node, or NULL if no matching node is found
@@ -61,6 +139,9 @@ Tree *TreeGetNode(Tree *parent, const char *id);
 /**
  * @brief Updates a specific node in the tree with a new child node
  * 
+ * The cells of virtual rows that are not materialized are not updated this way (the update
+ * fails), their values change with RowModelSetValue.
+ * 
  * @param root The root of the tree to search within
  * @param id The identifier of the node to be updated
  * @param newChild The new child node to replace the existing node
@@ -69,6 +150,22 @@ Tree *TreeGetNode(Tree *parent, const char *id);
 int TreeUpdateNode(Tree *root , char *id, Tree *newChild);
 
 
+/**
+ * @brief Updates a specific node in the tree by moving a new node into it, without copying
+ * 
+ * The id, widget, attributes and children (if it has any) are taken from newChild, which is
+ * freed on success and must not be used anymore. The old children of the node are destroyed
+ * when they are replaced. As with TreeUpdateNode, the cells of virtual rows that are not
+ * materialized cannot be updated.
+ * 
+ * @param root The root of the tree to search within
+ * @param id The identifier of the node to be updated
+ * @param newChild The node to move into the existing node, not part of any tree
+ * @return 1 on success, -1 on failure (newChild is then left untouched)
+ */
+int TreeUpdateNodeMove(Tree *root, char *id, Tree *newChild);
+
+
 /**
  * @brief Frees all memory associated with a Tree (not including the children)
  * 
@@ -78,13 +175,50 @@ void TreeDestroy(Tree *tree);
 
 
 /**
- * @brief Recursively frees all memory associated with a Tree, including its children
+ * @brief Frees all memory associated with a Tree, including its children
+ * 
+ * The nodes are destroyed iteratively without any stack, so the depth of the Tree does not matter.
  * 
  * @param tree The Tree to be destroyed, including all of its child nodes
  */
 void TreeDestroyAll(Tree *tree);
 
 
+/**
+ * @brief Removes a child node from its parent without destroying it
+ * 
+ * Only the link to the child is released, the subtree is not walked. The child becomes the
+ * root of its own Tree (e.g., for TreeDestroyDeferred).
+ * 
+ * @param parent The parent of the child
+ * @param child The child to detach
+ * @return 1 on success, -1 if the child is not a child of the parent
+ */
+int TreeDetachChild(Tree *parent, Tree *child);
+
+
+/**
+ * @brief Destroys a Tree on a background thread, like TreeDestroyAll
+ * 
+ * The Tree is queued in constant time and its memory is released later by the reclaimer
+ * thread. Its widgets are not touched: they must be destroyed (or recycled) beforehand on the
+ * main thread, see RendererDestroyAsync.
+ * 
+ * @param tree The root of the Tree, not part of any other Tree and not used anymore
+ * @return 1 if the Tree was queued, 0 if it was destroyed right away (the thread or the queue
+ *         link could not be created), -1 if the Tree is NULL
+ * 
+ * @warning The allocator hooks (see Allocator.h) are then called from the reclaimer thread too
+ */
+int TreeDestroyDeferred(Tree *tree);
+
+
+/**
+ * @brief Waits until every Tree given to TreeDestroyDeferred is destroyed
+ */
+void TreeReclaimerFlush(void);
+
+
 /**
  * @brief Checks if a given tree node is a leaf node
  * 
@@ -107,6 +241,9 @@ void TreePrint(const Tree *tree, const char *prefix, int isLast);
 /**
  * @brief Finds the parent node of a given tree node within a root tree
  * 
+ * The nodes know their parent, so only the ancestors of the node are visited to check it is
+ * in the tree of the root.
+ * 
  * @param root The root tree to search within
  * @param tree The tree node whose parent is to be found
  * @return Tree* A pointer to the parent node, or NULL if no parent is found
@@ -114,6 +251,15 @@ void TreePrint(const Tree *tree, const char *prefix, int isLast);
 Tree *TreeGetParent(Tree *root , const Tree *tree);
 
 
+/**
+ * @brief Returns the parent of a node, whatever tree it is in
+ * 
+ * @param tree The node
+ * @return Tree* The node whose children hold it, or NULL if it is a root (or NULL)
+ */
+Tree *TreeGetParentNode(const Tree *tree);
+
+
 /**
  * @brief Retrieves the type of a given tree node
  * 
@@ -134,6 +280,354 @@ const char *TreeGetId(const Tree *tree);
 
 
 
+/**
+ * @brief Retrieves the GTK widget associated with a given tree node
+ * 
+ * @param tree The tree node whose widget is to be retrieved
+ * @return GtkWidget* The widget of the node, or NULL if the node is not realized yet
+ */
+GtkWidget *TreeGetWidget(const Tree *tree);
+
+
+
+/**
+ * @brief Associates a GTK widget with a given tree node
+ * 
+ * @param tree The tree node to update
+ * @param widget The widget to associate with the node (may be NULL)
+ * @return 1 on success, -1 if the tree is NULL
+ */
+int TreeSetWidget(Tree *tree, GtkWidget *widget);
+
+
+
+/**
+ * @brief Changes the identifier of a given tree node
+ * 
+ * @param tree The tree node to update
+ * @param id The new identifier (copied)
+ * @return 1 on success, -1 if any error occurs
+ */
+int TreeSetId(Tree *tree, const char *id);
+
+
+
+/**
+ * @brief Retrieves the attributes of a given tree node
+ * 
+ * @param tree The tree node whose attributes are to be retrieved
+ * @return const HashMap* The attributes of the node, or NULL if the node has none
+ */
+const HashMap *TreeGetAttributes(const Tree *tree);
+
+
+/**
+ * @brief Makes a text block of a buffer, the storage the text content of nodes is sliced from
+ * 
+ * The block takes the buffer, which must have been allocated with AllocatorAlloc(allocatorTree, size),
+ * and frees it when its last reference is dropped. The caller holds the first reference.
+ * 
+ * @param bytes The buffer
+ * @param size The size of the buffer
+ * @return The block, or NULL if the allocation fails (the buffer is freed then)
+ */
+TextBlock *TextBlockAdopt(char *bytes, size_t size);
+
+
+/**
+ * @brief Drops a reference to a text block, freeing the block with the last one
+ * 
+ * @param block The block (NULL is ignored)
+ */
+void TextBlockRelease(TextBlock *block);
+
+
+/**
+ * @brief Sets the text content of a node to a slice of a text block, nothing is copied
+ * 
+ * The node keeps a reference to the block, clones of the node share the slice.
+ * 
+ * @param tree The node
+ * @param block The block, or NULL to remove the text of the node
+ * @param offset The offset of the slice in the block
+ * @param length The length of the slice, which must be followed by a NUL in the block
+ * @return 1 on success, -1 if the slice is out of the block or not followed by a NUL
+ */
+int TreeSetText(Tree *tree, TextBlock *block, size_t offset, size_t length);
+
+
+/**
+ * @brief Retrieves the text content of a node
+ * 
+ * @param tree The node
+ * @param length Where the length of the text is stored, or NULL
+ * @return The text (NUL terminated, valid while the node has it), or NULL if the node has none
+ */
+const char *TreeGetText(const Tree *tree, size_t *length);
+
+
+
+/**
+ * @brief Calls a function on every direct child of a given tree node, in order
+ * 
+ * @param tree The tree node whose children are to be visited
+ * @param callback The function to call for each child
+ * @param userData Pointer passed unchanged to the callback
+ * @return The number of children visited, or -1 if any error occurs
+ */
+int TreeForEachChild(const Tree *tree, void (*callback)(Tree *child, void *userData), void *userData);
+
+
+
+/**
+ * @brief Gives a grid node virtual rows, described by a row model instead of child nodes
+ * 
+ * The children of the grid are then the materialized cells of the model (see RowModel.h),
+ * usually the rows in view, kept by a virtualized grid. TreeGetNode finds any cell of the
+ * model, materialized or not, and TreeForEachVirtualChild visits them all. Clones do not
+ * copy the model.
+ * 
+ * @param tree The grid node
+ * @param model The model, owned by the node from now on (even on failure), or NULL to remove the current one
+ * @return 1 on success, -1 if any error occurs (e.g., the node is not a grid)
+ */
+int TreeSetRowModel(Tree *tree, RowModel *model);
+
+
+
+/**
+ * @brief Retrieves the row model of a grid node
+ * 
+ * @param tree The tree node
+ * @return RowModel* The model, or NULL if the node has none
+ */
+RowModel *TreeGetRowModel(const Tree *tree);
+
+
+
+/**
+ * @brief Calls a function on every child of a node, the cells of its virtual rows included
+ * 
+ * For a grid with a row model, each cell is visited row after row; a cell that is not
+ * materialized is passed as a node of the model that is only valid during the call.
+ * Otherwise this is TreeForEachChild.
+ * 
+ * @param tree The tree node whose children are to be visited
+ * @param callback The function to call for each child
+ * @param userData Pointer passed unchanged to the callback
+ * @return The number of children visited, or -1 if any error occurs
+ */
+int TreeForEachVirtualChild(Tree *tree, void (*callback)(Tree *child, void *userData), void *userData);
+
+
+
+/**
+ * @brief Retrieves an immutable snapshot of the attributes of a given tree node
+ * 
+ * The snapshot is made on the first call and kept by the node until its attributes change or
+ * it is destroyed. It can be read from any thread without locking; retain it with
+ * FrozenHashMapRetain to keep it longer than the node.
+ * 
+ * @param tree The tree node whose attributes are to be frozen
+ * @return FrozenHashMap* The snapshot, or NULL if the node has no attributes or on failure
+ */
+FrozenHashMap *TreeFreezeAttributes(Tree *tree);
+
+
+
+/**
+ * @brief Freezes the attributes of every node of a tree, nodes with equal attributes share one snapshot
+ * @param root The root of the tree to freeze
+ * @return The number of distinct snapshots, or -1 if any error occurs
+ */
+int TreeFreezeAll(Tree *root);
+
+
+
+/**
+ * @brief Sets (or removes) an attribute of a given tree node
+ * 
+ * Attributes shared with clones are copied on the first change, so the change is only seen by
+ * this node.
+ * 
+ * @param tree The tree node
+ * @param key The name of the attribute
+ * @param value The new value, or NULL to remove the attribute
+ * @return 1 on success, 0 if the attribute to remove does not exist, -1 if any error occurs
+ */
+int TreeSetAttribute(Tree *tree, const char *key, const char *value);
+
+
+
+/**
+ * @brief Copies a subtree, the copies share the attributes of the original nodes
+ * 
+ * Only the nodes and their ids are allocated, the attributes (and their frozen snapshots) are
+ * shared until either side changes them with TreeSetAttribute. Widgets are not copied.
+ * Not thread safe: the first clone of a node marks its attributes as shared.
+ * 
+ * @param tree The root of the subtree to copy
+ * @return Tree* The copy, or NULL if allocation fails or the tree is NULL
+ */
+Tree *TreeClone(Tree *tree);
+
+
+
+/**
+ * @brief Makes an instance of a template subtree, like TreeClone with the ids renamed
+ * 
+ * Each id of the instance is the prefix, a dash and the id in the template (e.g., "row-3-label"
+ * for the node "label" and the prefix "row-3"), so several instances can live in one tree.
+ * 
+ * @param templateRoot The root of the template
+ * @param prefix The prefix of the ids of the instance
+ * @return Tree* The instance, or NULL if allocation fails or an argument is NULL
+ */
+Tree *TreeInstantiate(Tree *templateRoot, const char *prefix);
+
+
+
+/**
+ * @brief Creates an iterator over a tree
+ * 
+ * The iterator walks the tree with an explicit stack (or queue for treeBreadthFirst), so the
+ * depth of the tree is only limited by memory. The tree must not be modified during the walk,
+ * except for destroying the nodes already returned by a treePostOrder iterator.
+ * 
+ * @param root The root of the tree to walk
+ * @param order The order to visit the nodes in
+ * @return TreeIterator* The iterator, or NULL if allocation fails or the root is NULL
+ */
+TreeIterator *TreeIteratorNew(Tree *root, treeOrder order);
+
+
+
+/**
+ * @brief Restarts an iterator on a tree, reusing its stack
+ * @param iterator The iterator to restart
+ * @param root The root of the tree to walk
+ * @param order The order to visit the nodes in
+ * @return 1 on success, -1 on failure
+ */
+int TreeIteratorReset(TreeIterator *iterator, Tree *root, treeOrder order);
+
+
+
+/**
+ * @brief Returns the next node of the walk
+ * @param iterator The iterator
+ * @return Tree* The next node, or NULL once every node was visited (or if the stack could not grow)
+ */
+Tree *TreeIteratorNext(TreeIterator *iterator);
+
+
+
+/**
+ * @brief Prevents the walk from visiting the children of the node last returned
+ * @param iterator A treePreOrder or treeBreadthFirst iterator
+ * @return 1 on success, -1 on failure (e.g., for a treePostOrder iterator, which already visited them)
+ */
+int TreeIteratorSkipChildren(TreeIterator *iterator);
+
+
+
+/**
+ * @brief Returns the depth of the node last returned
+ * @param iterator The iterator
+ * @return The depth of the node (0 for the root), or -1 if any error occurs
+ */
+int TreeIteratorDepth(const TreeIterator *iterator);
+
+
+
+/**
+ * @brief Returns the parent of the node last returned
+ * @param iterator The iterator
+ * @return Tree* The parent of the node, or NULL for the root
+ */
+Tree *TreeIteratorParent(const TreeIterator *iterator);
+
+
+
+/**
+ * @brief Checks if the node last returned is the last child of its parent
+ * @param iterator A treePreOrder or treePostOrder iterator
+ * @return 1 if it is the last child (or the root), 0 if it is not, -1 if any error occurs
+ */
+int TreeIteratorIsLast(const TreeIterator *iterator);
+
+
+
+/**
+ * @brief Frees an iterator
+ * @param iterator The iterator to free
+ */
+void TreeIteratorFree(TreeIterator *iterator);
+
+
+
+/**
+ * @brief Visits the nodes of a tree in pre-order, without recursion
+ * @param root The root of the tree to visit
+ * @param visitor The function called for each node with its depth, it decides whether the
+ *                children are visited and whether the visit goes on
+ * @param userData Pointer passed unchanged to the visitor
+ * @return The number of nodes visited, or -1 if any error occurs
+ */
+int TreeVisit(Tree *root, visitResult (*visitor)(Tree *node, int depth, void *userData), void *userData);
+
+
+
+/**
+ * @brief Returns the generation of a tree, it changes whenever a node of the tree is added, removed or updated
+ * 
+ * Anything derived from a tree (e.g., an index) can record the generation it was built at and
+ * compare it later to know whether it is still up to date. Each tree has its own generation,
+ * given on the first call, so changing one tree does not make what was built on the others stale.
+ * No two trees have the same generation, and a subtree added to a tree takes the generation of
+ * that tree. The generation is kept by the root, so any node of the tree can be given, and while
+ * any tree has one, a change costs a walk from the changed node up to its root.
+ * 
+ * @param root The root of the tree, or any of its nodes
+ * @return The current generation, or 0 if the root is NULL or any error occurs
+ */
+unsigned long TreeGetGeneration(Tree *root);
+
+
+/**
+ * @brief Lists the nodes whose id, attributes or text changed since a generation of their tree
+ * 
+ * Lets what was built at that generation catch up without being rebuilt. Only the last
+ * TREE_CHANGES changes are remembered, and a change of the structure (a node added, removed,
+ * detached or updated, or new virtual rows) is not listed, so the nodes are not known then.
+ * A node changed several times can be listed several times, the last change first.
+ * 
+ * @param root The root of the tree, or any of its nodes
+ * @param since A generation the tree had (see TreeGetGeneration)
+ * @param nodes Receives the changed nodes
+ * @param capacity The number of nodes the array can hold
+ * @return The number of changed nodes, or -1 if they are not all known (e.g., the structure
+ *         changed, the changes did not fit, the generation is older than the tree's first one)
+ */
+int TreeGetChanges(Tree *root, unsigned long since, Tree **nodes, int capacity);
+
+
+
+/**
+ * @brief Measures the memory used by a tree: its nodes, child links, ids, attributes, snapshots and virtual rows
+ * 
+ * Attributes shared with clones and snapshots shared between nodes count for the share of each
+ * node (see MemoryUsage). The widgets are not counted, the nodes a row model keeps for the cells
+ * that are not materialized count with its rows.
+ * 
+ * @param tree The root of the tree to measure
+ * @param usage The footprint the tree is added to, or NULL
+ * @return The number of bytes used by the tree
+ */
+size_t TreeMemoryUsage(const Tree *tree, MemoryUsage *usage);
+
+
+
 /**
  * @brief Retrieves the list of children for a given tree node
  * 
@@ -0,0 +1,846 @@
+/***************************************************************************************************
+ * @file Query.c                                                                                   *
+ * @brief The implementation of the selector queries                                               *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Query.h                                                                                    *
+ **************************************************************************************************/
+
+#include "Query.h"
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+
+/**
+ * @brief How a compound relates to the compound before it in a selector
+ */
+enum combinator
+{
+    combinatorNone,         ///< The first compound
+    combinatorDescendant,   ///< "a b": the node is a descendant of the node matching the previous compound
+    combinatorChild         ///< "a > b": the node is a child of the node matching the previous compound
+};
+
+
+/**
+ * @brief Represents an attribute condition of a compound
+ */
+struct Condition
+{
+    char *name;     ///< The name of the attribute
+    char *value;    ///< The expected value, or NULL if the attribute only has to be present
+};
+
+
+/**
+ * @brief Represents the conditions a single node has to meet
+ */
+struct Compound
+{
+    int type;                       ///< The widgetType of the node, or -1 for any type
+    char *id;                       ///< The id of the node, or NULL for any id
+    struct Condition *conditions;   ///< The attribute conditions
+    int conditionCount;             ///< The number of attribute conditions
+    enum combinator combinator;     ///< How the node relates to the node matching the previous compound
+};
+
+
+struct Selector
+{
+    struct Compound *compounds;     ///< The compounds, from left to right
+    int count;                      ///< The number of compounds
+};
+
+
+/**
+ * @brief Represents a node in a list sorted by a string (an id or an attribute value)
+ */
+struct Entry
+{
+    const char *key;    ///< The string, owned by the node
+    int node;           ///< The pre-order position of the node
+};
+
+
+/**
+ * @brief Represents the nodes sorted by the value of one attribute
+ */
+struct AttributeIndex
+{
+    char *name;             ///< The name of the attribute
+    struct Entry *entries;  ///< The nodes having the attribute, sorted by value then position
+    int count;              ///< The number of entries
+};
+
+
+/**
+ * @brief Represents an index over a tree
+ * 
+ * Nodes are identified by their pre-order position, so the descendants of a node are the
+ * positions after it up to its end, and each list below is sorted by position within a key.
+ */
+struct TreeIndex
+{
+    Tree *root;                         ///< The root of the indexed tree
+    unsigned long generation;           ///< The tree generation the index was built at, 0 if never built
+    int size;                           ///< The number of nodes
+    Tree **nodes;                       ///< The nodes in pre-order
+    int *parents;                       ///< The position of the parent of each node, -1 for the root
+    int *ends;                          ///< The position after the last descendant of each node
+    int typeStarts[WIDGET_TYPE_COUNT + 1]; ///< Where the nodes of each type start in typeNodes
+    int *typeNodes;                     ///< The positions of the nodes grouped by type
+    struct Entry *ids;                  ///< The nodes sorted by id then position
+    struct AttributeIndex *attributes;  ///< The attribute indexes
+    int attributeCount;                 ///< The number of attribute indexes
+    int *slots;                         ///< Open addressing table from a node to its position + 1 (0 when empty)
+    int slotMask;                       ///< The number of slots - 1
+};
+
+
+/**
+ * @brief Represents the positions a query looks at, a slice of one of the lists of the index
+ */
+struct Candidates
+{
+    const char *first;  ///< The position of the first candidate, inside an int or an Entry
+    size_t stride;      ///< The distance between two candidates, 0 for a range of positions
+    int start;          ///< The first position of a range of positions
+    int count;          ///< The number of candidates
+};
+
+
+/** @brief Checks if a character can be part of a name in a selector */
+static int isNameChar(char c)
+{
+    return isalnum((unsigned char)c) || c == '_' || c == '-';
+}
+
+
+/** @brief Skips the spaces of a selector, returns whether there were any */
+static int skipSpaces(const char **cursor)
+{
+    const char *start = *cursor;
+    while(isspace((unsigned char)**cursor)) (*cursor)++;
+    return *cursor != start;
+}
+
+
+/** @brief Reads a name from a selector, returns a copy of it or NULL if there is none */
+static char *parseName(const char **cursor)
+{
+    const char *start = *cursor;
+    while(isNameChar(**cursor)) (*cursor)++;
+    return (*cursor == start) ? NULL : g_strndup(start, *cursor - start);
+}
+
+
+/** @brief Reads a bare or quoted value from a selector, returns a copy of it or NULL if there is none */
+static char *parseValue(const char **cursor)
+{
+    char quote = **cursor;
+    if(quote != '\'' && quote != '"') return parseName(cursor);
+
+    const char *end = strchr(*cursor + 1, quote);
+    if(!end) return NULL;
+
+    char *value = g_strndup(*cursor + 1, end - *cursor - 1);
+    *cursor = end + 1;
+    return value;
+}
+
+
+/** @brief Frees the strings of a compound */
+static void clearCompound(struct Compound *compound)
+{
+    for(int i = 0; i < compound->conditionCount; i++)
+    {
+        g_free(compound->conditions[i].name);
+        g_free(compound->conditions[i].value);
+    }
+    free(compound->conditions);
+    g_free(compound->id);
+}
+
+
+/** @brief Reads an attribute condition "[name]" or "[name=value]", the cursor being after the '[' */
+static int parseCondition(const char **cursor, struct Compound *compound)
+{
+    struct Condition *conditions = realloc(compound->conditions, (compound->conditionCount + 1) * sizeof(struct Condition));
+    if(!conditions) return -1;
+    compound->conditions = conditions;
+
+    skipSpaces(cursor);
+    struct Condition *condition = &conditions[compound->conditionCount];
+    condition->name = parseName(cursor);
+    condition->value = NULL;
+    if(!condition->name) return -1;
+    compound->conditionCount++;
+
+    skipSpaces(cursor);
+    if(**cursor == '=')
+    {
+        (*cursor)++;
+        skipSpaces(cursor);
+        if(!(condition->value = parseValue(cursor))) return -1;
+        skipSpaces(cursor);
+    }
+
+    if(**cursor != ']') return -1;
+    (*cursor)++;
+    return 1;
+}
+
+
+/** @brief Reads a compound, returns 1 on success or -1 if the text is not a valid compound */
+static int parseCompound(const char **cursor, struct Compound *compound)
+{
+    const char *start = *cursor;
+
+    // The type comes first
+    compound->type = -1;
+    if(**cursor == '*') (*cursor)++;
+    else if(isNameChar(**cursor))
+    {
+        char *name = parseName(cursor);
+        compound->type = WidgetTypeFromName(name);
+        g_free(name);
+        if(compound->type < 0) return -1;
+    }
+
+    // Then any number of conditions
+    while(**cursor == '#' || **cursor == '[')
+    {
+        if(*(*cursor)++ == '[')
+        {
+            if(parseCondition(cursor, compound) < 0) return -1;
+        }
+        else if(compound->id || !(compound->id = parseName(cursor))) return -1;
+    }
+
+    return (*cursor == start) ? -1 : 1;
+}
+
+
+
+
+Selector *SelectorCompile(const char *text)
+{
+    // Check the input parameter
+    if(!text) return NULL;
+
+    Selector *selector = calloc(1, sizeof(Selector));
+    if(!selector) return NULL;
+
+    enum combinator combinator = combinatorNone;
+    skipSpaces(&text);
+    while(1)
+    {
+        // Read the next compound
+        struct Compound *compounds = realloc(selector->compounds, (selector->count + 1) * sizeof(struct Compound));
+        if(!compounds) break;
+        selector->compounds = compounds;
+
+        struct Compound *compound = &compounds[selector->count++];
+        memset(compound, 0, sizeof(struct Compound));
+        compound->combinator = combinator;
+        if(parseCompound(&text, compound) < 0) break;
+
+        // Then the combinator to the next one, if any
+        int spaces = skipSpaces(&text);
+        if(*text == '\0') return selector;
+
+        if(*text == '>')
+        {
+            combinator = combinatorChild;
+            text++;
+            skipSpaces(&text);
+        }
+        else if(spaces) combinator = combinatorDescendant;
+        else break;
+    }
+
+    SelectorFree(selector);
+    return NULL;
+}
+
+
+
+
+void SelectorFree(Selector *selector)
+{
+    // Check the input parameter
+    if(!selector) return;
+
+    for(int i = 0; i < selector->count; i++) clearCompound(&selector->compounds[i]);
+    free(selector->compounds);
+    free(selector);
+}
+
+
+/** @brief Orders entries by key, then by position */
+static int compareEntries(const void *first, const void *second)
+{
+    const struct Entry *a = first, *b = second;
+    int order = strcmp(a->key, b->key);
+    return order ? order : (a->node > b->node) - (a->node < b->node);
+}
+
+
+/** @brief Returns the first entry whose key (then position) is at or after the given ones */
+static int entryBound(const struct Entry *entries, int count, const char *key, int position)
+{
+    struct Entry target = {key, position};
+    int low = 0, high = count;
+    while(low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if(compareEntries(&entries[middle], &target) < 0) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+
+/** @brief Removes the entry of a node from a sorted list, if it has one, returns the new number of entries */
+static int removeEntry(struct Entry *entries, int count, int node)
+{
+    for(int i = 0; i < count; i++)
+    {
+        if(entries[i].node != node) continue;
+        memmove(&entries[i], &entries[i + 1], (count - i - 1) * sizeof(struct Entry));
+        return count - 1;
+    }
+    return count;
+}
+
+
+/** @brief Inserts the entry of a node in a sorted list, returns the new number of entries */
+static int insertEntry(struct Entry *entries, int count, const char *key, int node)
+{
+    int at = entryBound(entries, count, key, node);
+    memmove(&entries[at + 1], &entries[at], (count - at) * sizeof(struct Entry));
+    entries[at] = (struct Entry){key, node};
+    return count + 1;
+}
+
+
+/** @brief Returns the slot of a node in the table from the nodes to their positions */
+static int findSlot(const TreeIndex *index, const Tree *node)
+{
+    uint64_t hash = (uint64_t)(uintptr_t)node * 0x9E3779B97F4A7C15ull;
+    int slot = (int)(hash >> 40) & index->slotMask;
+    while(index->slots[slot] && index->nodes[index->slots[slot] - 1] != node) slot = (slot + 1) & index->slotMask;
+    return slot;
+}
+
+
+/** @brief Sorts the nodes having an attribute by its value */
+static int buildAttributeIndex(TreeIndex *index, struct AttributeIndex *attribute)
+{
+    free(attribute->entries);
+    attribute->entries = malloc((index->size ? index->size : 1) * sizeof(struct Entry));
+    attribute->count = 0;
+    if(!attribute->entries) return -1;
+
+    for(int i = 0; i < index->size; i++)
+    {
+        const char *value = HashMapGet(TreeGetAttributes(index->nodes[i]), attribute->name);
+        if(value) attribute->entries[attribute->count++] = (struct Entry){value, i};
+    }
+
+    qsort(attribute->entries, attribute->count, sizeof(struct Entry), compareEntries);
+    return 1;
+}
+
+
+/** @brief Frees the lists of an index, keeping the names of the indexed attributes */
+static void clearIndex(TreeIndex *index)
+{
+    free(index->nodes); free(index->parents); free(index->ends);
+    free(index->typeNodes); free(index->ids); free(index->slots);
+    index->nodes = NULL; index->parents = index->ends = index->typeNodes = index->slots = NULL;
+    index->ids = NULL;
+    index->size = 0;
+    index->generation = 0;
+}
+
+
+/** @brief Builds the lists of an index from its tree */
+static int buildIndex(TreeIndex *index)
+{
+    clearIndex(index);
+    unsigned long generation = TreeGetGeneration(index->root);
+
+    // List the nodes in pre-order with their parents, the last position seen at each depth is the parent of the next deeper node
+    TreeIterator *iterator = TreeIteratorNew(index->root, treePreOrder);
+    int capacity = 64, depthCapacity = 64;
+    int *ancestors = malloc(depthCapacity * sizeof(int));
+    index->nodes = malloc(capacity * sizeof(Tree *));
+    index->parents = malloc(capacity * sizeof(int));
+    int failed = !iterator || !ancestors || !index->nodes || !index->parents;
+
+    Tree *node;
+    while(!failed && (node = TreeIteratorNext(iterator)))
+    {
+        int depth = TreeIteratorDepth(iterator);
+        if(index->size == capacity)
+        {
+            capacity *= 2;
+            Tree **nodes = realloc(index->nodes, capacity * sizeof(Tree *));
+            if(nodes) index->nodes = nodes;
+            int *parents = realloc(index->parents, capacity * sizeof(int));
+            if(parents) index->parents = parents;
+            if((failed = !nodes || !parents)) break;
+        }
+        if(depth == depthCapacity)
+        {
+            int *grown = realloc(ancestors, (depthCapacity *= 2) * sizeof(int));
+            if((failed = !grown)) break;
+            ancestors = grown;
+        }
+
+        index->nodes[index->size] = node;
+        index->parents[index->size] = depth ? ancestors[depth - 1] : -1;
+        ancestors[depth] = index->size++;
+    }
+    TreeIteratorFree(iterator);
+    free(ancestors);
+
+    int size = index->size;
+    index->ends = malloc(size * sizeof(int));
+    index->typeNodes = malloc(size * sizeof(int));
+    index->ids = malloc(size * sizeof(struct Entry));
+    for(index->slotMask = 1; index->slotMask < 2 * size; index->slotMask <<= 1);
+    index->slots = calloc(index->slotMask--, sizeof(int));
+    if(failed || !index->ends || !index->typeNodes || !index->ids || !index->slots)
+    {
+        clearIndex(index);
+        return -1;
+    }
+
+    // The subtree of a node ends after the subtrees of its children, children come after their parents
+    for(int i = 0; i < size; i++) index->ends[i] = i + 1;
+    for(int i = size - 1; i > 0; i--)
+        if(index->ends[i] > index->ends[index->parents[i]]) index->ends[index->parents[i]] = index->ends[i];
+
+    // Group the nodes by type, in pre-order within a type
+    memset(index->typeStarts, 0, sizeof(index->typeStarts));
+    for(int i = 0; i < size; i++) index->typeStarts[TreeGetType(index->nodes[i]) + 1]++;
+    for(int type = 0; type < WIDGET_TYPE_COUNT; type++) index->typeStarts[type + 1] += index->typeStarts[type];
+
+    int next[WIDGET_TYPE_COUNT];
+    memcpy(next, index->typeStarts, sizeof(next));
+    for(int i = 0; i < size; i++) index->typeNodes[next[TreeGetType(index->nodes[i])]++] = i;
+
+    // Sort the nodes by id and map them to their positions
+    for(int i = 0; i < size; i++)
+    {
+        index->ids[i] = (struct Entry){TreeGetId(index->nodes[i]), i};
+        index->slots[findSlot(index, index->nodes[i])] = i + 1;
+    }
+    qsort(index->ids, size, sizeof(struct Entry), compareEntries);
+
+    for(int i = 0; i < index->attributeCount; i++)
+    {
+        if(buildAttributeIndex(index, &index->attributes[i]) < 0)
+        {
+            clearIndex(index);
+            return -1;
+        }
+    }
+
+    index->generation = generation;
+    return 1;
+}
+
+
+/**
+ * @brief Moves the changed nodes to their new places in the lists sorted by id or attribute value
+ * @return 1 on success, -1 if a node is not in the index
+ */
+static int applyChanges(TreeIndex *index, Tree *const *changed, int count)
+{
+    // The positions of the changed nodes, each once
+    int positions[TREE_CHANGES], unique = 0;
+    for(int i = 0; i < count; i++)
+    {
+        int slot = findSlot(index, changed[i]);
+        if(!index->slots[slot]) return -1;
+
+        int position = index->slots[slot] - 1, seen = 0;
+        for(int j = 0; j < unique && !seen; j++) seen = (positions[j] == position);
+        if(!seen) positions[unique++] = position;
+    }
+
+    // The old keys of the nodes may be freed already, so their entries all go before any comes back
+    int idCount = index->size;
+    for(int i = 0; i < unique; i++)
+    {
+        idCount = removeEntry(index->ids, idCount, positions[i]);
+        for(int j = 0; j < index->attributeCount; j++)
+        {
+            struct AttributeIndex *attribute = &index->attributes[j];
+            attribute->count = removeEntry(attribute->entries, attribute->count, positions[i]);
+        }
+    }
+
+    for(int i = 0; i < unique; i++)
+    {
+        Tree *node = index->nodes[positions[i]];
+        idCount = insertEntry(index->ids, idCount, TreeGetId(node), positions[i]);
+        for(int j = 0; j < index->attributeCount; j++)
+        {
+            struct AttributeIndex *attribute = &index->attributes[j];
+            const char *value = HashMapGet(TreeGetAttributes(node), attribute->name);
+            if(value) attribute->count = insertEntry(attribute->entries, attribute->count, value, positions[i]);
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Brings an index up to date with its tree
+ * 
+ * When only ids, attributes or texts changed since the index was built, the changed nodes are
+ * moved in the sorted lists, any other change rebuilds the index.
+ */
+static int refreshIndex(TreeIndex *index)
+{
+    unsigned long generation = TreeGetGeneration(index->root);
+    if(generation && index->generation == generation) return 1;
+    if(!generation || !index->generation) return buildIndex(index);
+
+    Tree *changed[TREE_CHANGES];
+    int count = TreeGetChanges(index->root, index->generation, changed, TREE_CHANGES);
+    if(count < 0 || applyChanges(index, changed, count) < 0) return buildIndex(index);
+
+    index->generation = generation;
+    return 1;
+}
+
+
+
+
+TreeIndex *TreeIndexNew(Tree *root)
+{
+    // Check the input parameter
+    if(!root) return NULL;
+
+    TreeIndex *index = calloc(1, sizeof(TreeIndex));
+    if(!index) return NULL;
+    index->root = root;
+
+    // The lists are built by the first query
+    return index;
+}
+
+
+
+
+int TreeIndexAddAttribute(TreeIndex *index, const char *name)
+{
+    // Check the input parameters
+    if(!index || !name) return -1;
+
+    for(int i = 0; i < index->attributeCount; i++)
+        if(strcmp(index->attributes[i].name, name) == 0) return 0;
+
+    struct AttributeIndex *attributes = realloc(index->attributes, (index->attributeCount + 1) * sizeof(struct AttributeIndex));
+    if(!attributes) return -1;
+    index->attributes = attributes;
+
+    struct AttributeIndex *attribute = &attributes[index->attributeCount];
+    *attribute = (struct AttributeIndex){g_strdup(name), NULL, 0};
+
+    // Once the lists are built, bring them up to date and build the new one, otherwise the next query builds them all
+    if(index->generation && (refreshIndex(index) < 0 || buildAttributeIndex(index, attribute) < 0))
+    {
+        g_free(attribute->name);
+        return -1;
+    }
+
+    index->attributeCount++;
+    return 1;
+}
+
+
+
+
+int TreeIndexSize(TreeIndex *index)
+{
+    // Check the input parameter
+    if(!index || refreshIndex(index) < 0) return -1;
+
+    return index->size;
+}
+
+
+
+
+void TreeIndexFree(TreeIndex *index)
+{
+    // Check the input parameter
+    if(!index) return;
+
+    clearIndex(index);
+    for(int i = 0; i < index->attributeCount; i++)
+    {
+        g_free(index->attributes[i].name);
+        free(index->attributes[i].entries);
+    }
+    free(index->attributes);
+    free(index);
+}
+
+
+/** @brief Returns the position of a candidate */
+static int candidateAt(const struct Candidates *candidates, int i)
+{
+    if(!candidates->stride) return candidates->start + i;
+    return *(const int *)(candidates->first + i * candidates->stride);
+}
+
+
+/** @brief Returns the first candidate at or after a position, the candidates being sorted by position */
+static int lowerBound(const struct Candidates *candidates, int position)
+{
+    int low = 0, high = candidates->count;
+    while(low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if(candidateAt(candidates, middle) < position) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+
+/** @brief Narrows a list sorted by position to the positions in [low, high) */
+static struct Candidates sliceCandidates(struct Candidates candidates, int low, int high)
+{
+    int first = lowerBound(&candidates, low);
+    candidates.count = lowerBound(&candidates, high) - first;
+    candidates.first += first * candidates.stride;
+    return candidates;
+}
+
+
+/** @brief Narrows a list of entries to the entries with a key and a position in [low, high) */
+static struct Candidates sliceEntries(const struct Entry *entries, int count, const char *key, int low, int high)
+{
+    int first = entryBound(entries, count, key, low);
+    struct Candidates candidates = {(const char *)&entries[first].node, sizeof(struct Entry), 0, 0};
+    candidates.count = entryBound(entries, count, key, high) - first;
+    return candidates;
+}
+
+
+/**
+ * @brief Returns the smallest list of the index holding every node in [low, high) that can match a compound
+ * 
+ * The id, the type and the values of the indexed attributes each give a list, the candidates
+ * are then checked against the whole selector.
+ */
+static struct Candidates findCandidates(const TreeIndex *index, const struct Compound *compound, int low, int high)
+{
+    // Every position in the range, when nothing narrows it
+    struct Candidates best = {NULL, 0, low, high - low};
+
+    if(compound->id)
+    {
+        struct Candidates byId = sliceEntries(index->ids, index->size, compound->id, low, high);
+        if(byId.count < best.count) best = byId;
+    }
+
+    if(compound->type >= 0)
+    {
+        int start = index->typeStarts[compound->type];
+        struct Candidates byType = {(const char *)&index->typeNodes[start], sizeof(int), 0, index->typeStarts[compound->type + 1] - start};
+        byType = sliceCandidates(byType, low, high);
+        if(byType.count < best.count) best = byType;
+    }
+
+    for(int i = 0; i < compound->conditionCount; i++)
+    {
+        if(!compound->conditions[i].value) continue;
+        for(int j = 0; j < index->attributeCount; j++)
+        {
+            const struct AttributeIndex *attribute = &index->attributes[j];
+            if(strcmp(attribute->name, compound->conditions[i].name) != 0) continue;
+
+            struct Candidates byValue = sliceEntries(attribute->entries, attribute->count, compound->conditions[i].value, low, high);
+            if(byValue.count < best.count) best = byValue;
+        }
+    }
+
+    return best;
+}
+
+
+/** @brief Checks if a node meets the conditions of a compound */
+static int matchesCompound(const struct Compound *compound, const Tree *node)
+{
+    if(compound->type >= 0 && (int)TreeGetType(node) != compound->type) return 0;
+    if(compound->id && strcmp(TreeGetId(node), compound->id) != 0) return 0;
+
+    const HashMap *attributes = TreeGetAttributes(node);
+    for(int i = 0; i < compound->conditionCount; i++)
+    {
+        const char *value = HashMapGet(attributes, compound->conditions[i].name);
+        if(!value) return 0;
+        if(compound->conditions[i].value && strcmp(value, compound->conditions[i].value) != 0) return 0;
+    }
+
+    return 1;
+}
+
+
+/** @brief Checks if a node matches the compounds of a selector up to the given one, from right to left */
+static int matchesSelector(const TreeIndex *index, const Selector *selector, int compound, int node)
+{
+    if(!matchesCompound(&selector->compounds[compound], index->nodes[node])) return 0;
+    if(compound == 0) return 1;
+
+    // A child has to match through its parent, a descendant through any of its ancestors
+    int ancestor = index->parents[node];
+    if(selector->compounds[compound].combinator == combinatorChild)
+        return ancestor >= 0 && matchesSelector(index, selector, compound - 1, ancestor);
+
+    for(; ancestor >= 0; ancestor = index->parents[ancestor])
+        if(matchesSelector(index, selector, compound - 1, ancestor)) return 1;
+
+    return 0;
+}
+
+
+/**
+ * @brief Represents the nodes found by a query so far
+ */
+struct Matches
+{
+    Tree **nodes;   ///< The matching nodes, in pre-order
+    int count;      ///< The number of matching nodes
+    int capacity;   ///< The number of nodes the array can hold
+    int limit;      ///< The number of nodes after which the query stops
+};
+
+
+/** @brief Adds the candidates matching a selector to the matches, returns -1 if the array cannot grow */
+static int collectMatches(const TreeIndex *index, const Selector *selector, const struct Candidates *candidates, struct Matches *matches)
+{
+    for(int i = 0; i < candidates->count && matches->count < matches->limit; i++)
+    {
+        int node = candidateAt(candidates, i);
+        if(!matchesSelector(index, selector, selector->count - 1, node)) continue;
+
+        if(matches->count == matches->capacity)
+        {
+            int capacity = matches->capacity ? 2 * matches->capacity : 16;
+            Tree **grown = realloc(matches->nodes, capacity * sizeof(Tree *));
+            if(!grown) return -1;
+            matches->nodes = grown;
+            matches->capacity = capacity;
+        }
+        matches->nodes[matches->count++] = index->nodes[node];
+    }
+
+    return 1;
+}
+
+
+/** @brief Finds the matching nodes, stops after the given number of them */
+static int selectNodes(TreeIndex *index, Tree *scope, const Selector *selector, Tree ***results, int limit)
+{
+    *results = NULL;
+    if(refreshIndex(index) < 0) return -1;
+
+    // The descendants of the scope are the positions after it, up to its end
+    int low = 0, high = index->size;
+    if(scope)
+    {
+        int position = index->slots[findSlot(index, scope)] - 1;
+        if(position < 0) return -1;
+        low = position + 1;
+        high = index->ends[position];
+    }
+
+    // Only the nodes the last compound allows are checked against the whole selector
+    const struct Compound *last = &selector->compounds[selector->count - 1];
+    struct Candidates candidates = findCandidates(index, last, low, high);
+
+    // Unless an ancestor compound allows fewer nodes (e.g., "#form button"), then only their descendants are looked at
+    struct Candidates anchors = candidates;
+    int anchor = -1;
+    for(int i = 0; i < selector->count - 1; i++)
+    {
+        struct Candidates allowed = findCandidates(index, &selector->compounds[i], 0, index->size);
+        if(allowed.count < anchors.count)
+        {
+            anchors = allowed;
+            anchor = i;
+        }
+    }
+
+    struct Matches matches = {NULL, 0, 0, limit};
+    int status = 1;
+    if(anchor < 0) status = collectMatches(index, selector, &candidates, &matches);
+
+    // The subtrees of the anchors are nested or disjoint, the part of a subtree already covered is skipped
+    int covered = low;
+    for(int i = 0; anchor >= 0 && i < anchors.count && status > 0 && matches.count < limit; i++)
+    {
+        int node = candidateAt(&anchors, i);
+        int start = (node + 1 > covered) ? node + 1 : covered;
+        int end = (index->ends[node] < high) ? index->ends[node] : high;
+        if(start >= end || !matchesCompound(&selector->compounds[anchor], index->nodes[node])) continue;
+
+        struct Candidates inside = findCandidates(index, last, start, end);
+        status = collectMatches(index, selector, &inside, &matches);
+        covered = end;
+    }
+
+    if(status < 0)
+    {
+        free(matches.nodes);
+        return -1;
+    }
+
+    *results = matches.nodes;
+    return matches.count;
+}
+
+
+
+
+int QuerySelectAll(TreeIndex *index, Tree *scope, const Selector *selector, Tree ***results)
+{
+    // Check the input parameters
+    if(!results) return -1;
+    *results = NULL;
+    if(!index || !selector) return -1;
+
+    return selectNodes(index, scope, selector, results, INT_MAX);
+}
+
+
+
+
+Tree *QuerySelectFirst(TreeIndex *index, Tree *scope, const Selector *selector)
+{
+    // Check the input parameters
+    if(!index || !selector) return NULL;
+
+    Tree **results;
+    if(selectNodes(index, scope, selector, &results, 1) <= 0) return NULL;
+
+    Tree *first = results[0];
+    free(results);
+    return first;
+}
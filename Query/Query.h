@@ -0,0 +1,109 @@
+/***************************************************************************************************
+ * @file Query.h                                                                                   *
+ * @brief Selectors and the indexes that answer them on a Tree                                     *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Query.c                                                                                    *
+ **************************************************************************************************/
+
+#ifndef QUERY_H
+#define QUERY_H
+
+#include "../DataStructure/Tree/Tree.h"
+
+typedef struct Selector Selector;
+typedef struct TreeIndex TreeIndex;
+
+/**
+ * @brief Compiles a selector
+ * 
+ * A selector is a list of compounds separated by combinators. A compound is an optional widget
+ * type (or "*") followed by any number of "#id", "[name]" and "[name=value]" conditions, the
+ * value being bare or quoted with ' or ". A space between two compounds matches descendants,
+ * a ">" matches children. For example: "box#main > button[label='OK']".
+ * 
+ * @param text The selector
+ * @return Selector* The compiled selector, or NULL if the text is not a valid selector
+ */
+Selector *SelectorCompile(const char *text);
+
+
+/**
+ * @brief Frees a compiled selector
+ * @param selector The selector to free
+ */
+void SelectorFree(Selector *selector);
+
+
+/**
+ * @brief Creates an index over a tree
+ * 
+ * The index keeps the nodes in pre-order with the range of their descendants, the nodes of each
+ * widget type and the nodes sorted by id, so a query only looks at the nodes that can match its
+ * last compound. It catches up on the next query once its tree changes: the nodes whose id or
+ * attributes changed are moved in its lists, other changes rebuild it (see TreeGetChanges).
+ * 
+ * @param root The root of the tree to index
+ * @return TreeIndex* The index, or NULL if allocation fails or the root is NULL
+ */
+TreeIndex *TreeIndexNew(Tree *root);
+
+
+/**
+ * @brief Also indexes the nodes by the value of an attribute
+ * 
+ * Queries with a "[name=value]" condition on an indexed attribute only look at the nodes that
+ * have this value. Worth it for the attributes that are often queried and rarely shared.
+ * 
+ * @param index The index
+ * @param name The name of the attribute
+ * @return 1 on success, 0 if the attribute is already indexed, -1 if any error occurs
+ */
+int TreeIndexAddAttribute(TreeIndex *index, const char *name);
+
+
+/**
+ * @brief Returns the number of nodes of the indexed tree
+ * @param index The index
+ * @return The number of nodes, or -1 if any error occurs (e.g., the index cannot be rebuilt)
+ */
+int TreeIndexSize(TreeIndex *index);
+
+
+/**
+ * @brief Frees an index, the tree is left untouched
+ * @param index The index to free
+ */
+void TreeIndexFree(TreeIndex *index);
+
+
+/**
+ * @brief Finds the nodes matching a selector
+ * 
+ * Only the descendants of the scope are returned, but the ancestors the selector refers to can
+ * be anywhere above them. The nodes are returned in document (pre-order) order.
+ * 
+ * @param index The index of the tree
+ * @param scope The node to search under, or NULL for the whole tree (root included)
+ * @param selector The compiled selector
+ * @param results Receives the array of the matching nodes, to be freed by the caller (NULL if none)
+ * @return The number of matching nodes, or -1 if any error occurs (e.g., the scope is not in the tree)
+ */
+int QuerySelectAll(TreeIndex *index, Tree *scope, const Selector *selector, Tree ***results);
+
+
+/**
+ * @brief Finds the first node matching a selector, in document order
+ * @param index The index of the tree
+ * @param scope The node to search under, or NULL for the whole tree (root included)
+ * @param selector The compiled selector
+ * @return Tree* The first matching node, or NULL if none matches or any error occurs
+ */
+Tree *QuerySelectFirst(TreeIndex *index, Tree *scope, const Selector *selector);
+
+#endif // QUERY_H
@@ -0,0 +1,419 @@
+/***************************************************************************************************
+ * @file AttributeRegistry.c                                                                       *
+ * @brief The implementation of the registry of the attributes of each widget type                 *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see AttributeRegistry.h                                                                        *
+ **************************************************************************************************/
+
+#include "AttributeRegistry.h"
+
+/**
+ * @brief The descriptors of each widget type, indexed by the atom of the attribute name
+ * 
+ * A descriptor whose setter is NULL marks an attribute the type does not support.
+ */
+static struct
+{
+    AttributeDescriptor *descriptors;   ///< The descriptors, descriptors[atom]
+    Atom **enumAtoms;                   ///< The atoms of the enumNames of each attributeEnum, 0 terminated
+    Atom size;                          ///< The number of descriptors allocated
+} registry[WIDGET_TYPE_COUNT];
+
+static int registryInitialized = 0;     ///< Set once the built-in attributes are registered
+
+
+static const char *const orientationNames[] = { "horizontal", "vertical", NULL };
+static const char *const alignNames[] = { "fill", "start", "end", "center", "baseline", NULL };
+
+
+
+
+/**
+ * @brief The setters of the built-in attributes that GTK has no function with a matching signature for
+ */
+static void setWidthRequest(GtkWidget *widget, int value) { g_object_set(widget, "width-request", value, NULL); }
+static void setHeightRequest(GtkWidget *widget, int value) { g_object_set(widget, "height-request", value, NULL); }
+static void setHalign(GtkWidget *widget, int value) { gtk_widget_set_halign(widget, (GtkAlign)value); }
+static void setValign(GtkWidget *widget, int value) { gtk_widget_set_valign(widget, (GtkAlign)value); }
+static void setTitle(GtkWidget *widget, const char *value) { gtk_window_set_title(GTK_WINDOW(widget), value); }
+static void setDefaultWidth(GtkWidget *widget, int value) { g_object_set(widget, "default-width", value, NULL); }
+static void setDefaultHeight(GtkWidget *widget, int value) { g_object_set(widget, "default-height", value, NULL); }
+static void setResizable(GtkWidget *widget, gboolean value) { gtk_window_set_resizable(GTK_WINDOW(widget), value); }
+static void setShowTitleButtons(GtkWidget *widget, gboolean value) { gtk_header_bar_set_show_title_buttons(GTK_HEADER_BAR(widget), value); }
+static void setOrientation(GtkWidget *widget, int value) { gtk_orientable_set_orientation(GTK_ORIENTABLE(widget), (GtkOrientation)value); }
+static void setSpacing(GtkWidget *widget, int value) { gtk_box_set_spacing(GTK_BOX(widget), value); }
+static void setHomogeneous(GtkWidget *widget, gboolean value) { gtk_box_set_homogeneous(GTK_BOX(widget), value); }
+static void setRowSpacing(GtkWidget *widget, int value) { gtk_grid_set_row_spacing(GTK_GRID(widget), value); }
+static void setColumnSpacing(GtkWidget *widget, int value) { gtk_grid_set_column_spacing(GTK_GRID(widget), value); }
+static void setText(GtkWidget *widget, const char *value) { gtk_label_set_text(GTK_LABEL(widget), value); }
+static void setWrap(GtkWidget *widget, gboolean value) { gtk_label_set_wrap(GTK_LABEL(widget), value); }
+static void setSelectable(GtkWidget *widget, gboolean value) { gtk_label_set_selectable(GTK_LABEL(widget), value); }
+static void setLabel(GtkWidget *widget, const char *value) { gtk_button_set_label(GTK_BUTTON(widget), value); }
+static void setIconName(GtkWidget *widget, const char *value) { gtk_button_set_icon_name(GTK_BUTTON(widget), value); }
+static void resetClass(GtkWidget *widget, const char *value) { gtk_widget_remove_css_class(widget, value); }
+static void resetOrientation(GtkWidget *widget, const char *value) { (void)value; setOrientation(widget, GTK_ORIENTATION_VERTICAL); }
+
+
+/**
+ * @brief Registers an attribute without initializing the registry
+ */
+static int addDescriptor(widgetType type, const char *name, const AttributeDescriptor *descriptor)
+{
+    Atom atom = AtomIntern(name);
+    if(!atom) return -1;
+
+    // Grow the table of the type so that it can be indexed by the atom
+    if(atom >= registry[type].size)
+    {
+        Atom size = registry[type].size ? registry[type].size : 32;
+        while(size <= atom) size *= 2;
+
+        AttributeDescriptor *descriptors = (AttributeDescriptor *)realloc(registry[type].descriptors, size * sizeof(AttributeDescriptor));
+        if(!descriptors) return -1;
+        memset(descriptors + registry[type].size, 0, (size - registry[type].size) * sizeof(AttributeDescriptor));
+
+        registry[type].descriptors = descriptors;
+
+        Atom **enumAtoms = (Atom **)realloc(registry[type].enumAtoms, size * sizeof(Atom *));
+        if(!enumAtoms) return -1;
+        memset(enumAtoms + registry[type].size, 0, (size - registry[type].size) * sizeof(Atom *));
+
+        registry[type].enumAtoms = enumAtoms;
+        registry[type].size = size;
+    }
+
+    // The accepted values of an enum are interned once, so applying one compares atoms
+    Atom *enumAtoms = NULL;
+    if(descriptor->kind == attributeEnum)
+    {
+        int count = 0;
+        while(descriptor->enumNames[count]) count++;
+
+        enumAtoms = (Atom *)malloc((count + 1) * sizeof(Atom));
+        if(!enumAtoms) return -1;
+        for(int i = 0; i < count; i++)
+        {
+            enumAtoms[i] = AtomIntern(descriptor->enumNames[i]);
+            if(!enumAtoms[i])
+            {
+                free(enumAtoms);
+                return -1;
+            }
+        }
+        enumAtoms[count] = 0;
+    }
+
+    int added = registry[type].descriptors[atom].setter.setString ? 0 : 1;
+    registry[type].descriptors[atom] = *descriptor;
+    free(registry[type].enumAtoms[atom]);
+    registry[type].enumAtoms[atom] = enumAtoms;
+
+    return added;
+}
+
+
+#define STRING(setter, p)   &(AttributeDescriptor){ attributeString, { .setString = (setter) }, NULL, (p), NULL }
+#define INT(setter, p)      &(AttributeDescriptor){ attributeInt, { .setInt = (setter) }, NULL, (p), NULL }
+#define DOUBLE(setter, p)   &(AttributeDescriptor){ attributeDouble, { .setDouble = (setter) }, NULL, (p), NULL }
+#define BOOL(setter, p)     &(AttributeDescriptor){ attributeBool, { .setBool = (setter) }, NULL, (p), NULL }
+#define ENUM(setter, n, p)  &(AttributeDescriptor){ attributeEnum, { .setInt = (setter) }, (n), (p), NULL }
+
+/**
+ * @brief Registers the built-in attributes, once
+ */
+static void initializeRegistry()
+{
+    if(registryInitialized) return;
+    registryInitialized = 1;
+
+    // The attributes shared by every widget
+    for(int type = 0; type < WIDGET_TYPE_COUNT; type++)
+    {
+        addDescriptor(type, "visible", BOOL(gtk_widget_set_visible, "visible"));
+        addDescriptor(type, "sensitive", BOOL(gtk_widget_set_sensitive, "sensitive"));
+        addDescriptor(type, "hexpand", BOOL(gtk_widget_set_hexpand, "hexpand"));
+        addDescriptor(type, "vexpand", BOOL(gtk_widget_set_vexpand, "vexpand"));
+        addDescriptor(type, "halign", ENUM(setHalign, alignNames, "halign"));
+        addDescriptor(type, "valign", ENUM(setValign, alignNames, "valign"));
+        addDescriptor(type, "widthRequest", INT(setWidthRequest, "width-request"));
+        addDescriptor(type, "heightRequest", INT(setHeightRequest, "height-request"));
+        addDescriptor(type, "marginStart", INT(gtk_widget_set_margin_start, "margin-start"));
+        addDescriptor(type, "marginEnd", INT(gtk_widget_set_margin_end, "margin-end"));
+        addDescriptor(type, "marginTop", INT(gtk_widget_set_margin_top, "margin-top"));
+        addDescriptor(type, "marginBottom", INT(gtk_widget_set_margin_bottom, "margin-bottom"));
+        addDescriptor(type, "opacity", DOUBLE(gtk_widget_set_opacity, "opacity"));
+        addDescriptor(type, "tooltip", STRING(gtk_widget_set_tooltip_text, "tooltip-text"));
+        addDescriptor(type, "name", STRING(gtk_widget_set_name, "name"));
+        addDescriptor(type, "class", &(AttributeDescriptor){ attributeString, { .setString = gtk_widget_add_css_class }, NULL, NULL, resetClass });
+    }
+
+    addDescriptor(window, "title", STRING(setTitle, "title"));
+    addDescriptor(window, "defaultWidth", INT(setDefaultWidth, "default-width"));
+    addDescriptor(window, "defaultHeight", INT(setDefaultHeight, "default-height"));
+    addDescriptor(window, "resizable", BOOL(setResizable, "resizable"));
+
+    addDescriptor(headerBar, "showTitleButtons", BOOL(setShowTitleButtons, "show-title-buttons"));
+
+    addDescriptor(box, "orientation", &(AttributeDescriptor){ attributeEnum, { .setInt = setOrientation }, orientationNames, NULL, resetOrientation });
+    addDescriptor(box, "spacing", INT(setSpacing, "spacing"));
+    addDescriptor(box, "homogeneous", BOOL(setHomogeneous, "homogeneous"));
+
+    addDescriptor(grid, "rowSpacing", INT(setRowSpacing, "row-spacing"));
+    addDescriptor(grid, "columnSpacing", INT(setColumnSpacing, "column-spacing"));
+
+    addDescriptor(label, "text", STRING(setText, "label"));
+    addDescriptor(label, "wrap", BOOL(setWrap, "wrap"));
+    addDescriptor(label, "selectable", BOOL(setSelectable, "selectable"));
+
+    addDescriptor(button, "label", STRING(setLabel, "label"));
+    addDescriptor(button, "iconName", STRING(setIconName, "icon-name"));
+}
+
+
+
+
+int AttributeRegistryAdd(widgetType type, const char *name, const AttributeDescriptor *descriptor)
+{
+    // Check the input parameters
+    if((int)type < 0 || type >= WIDGET_TYPE_COUNT || !name || !descriptor || !descriptor->setter.setString) return -1;
+    if(descriptor->kind == attributeEnum && !descriptor->enumNames) return -1;
+
+    initializeRegistry();
+    return addDescriptor(type, name, descriptor);
+}
+
+
+
+
+const AttributeDescriptor *AttributeRegistryLookup(widgetType type, Atom name)
+{
+    // Check the input parameters
+    if((int)type < 0 || type >= WIDGET_TYPE_COUNT) return NULL;
+
+    initializeRegistry();
+    if(name >= registry[type].size || !registry[type].descriptors[name].setter.setString) return NULL;
+
+    return &registry[type].descriptors[name];
+}
+
+
+
+
+/**
+ * @brief The state shared with applyAttribute while the attributes of one node are applied
+ */
+struct ApplyContext
+{
+    GtkWidget *widget;                  ///< The widget receiving the attributes
+    const AttributeDescriptor *table;   ///< The descriptors of the widget type
+    Atom *const *enumAtoms;             ///< The atoms of the enum values of the widget type
+    Atom size;                          ///< The number of descriptors of the widget type
+    int applied;                        ///< The number of attributes applied so far
+};
+
+
+/**
+ * @brief Converts the value of an entry to the kind of its descriptor and calls the setter
+ * 
+ * The value is read from the entry in hand, whose typed accessors keep the converted value,
+ * so applying the same attributes again (e.g., to a recycled widget) neither looks the key
+ * up nor parses the value again. An enum value is read as an atom and compared to the atoms
+ * interned when the descriptor was registered.
+ * 
+ * @return 1 if the value was applied, 0 if it could not be converted
+ */
+static int applyValue(GtkWidget *widget, const AttributeDescriptor *descriptor, const Atom *enumAtoms, const HashMapEntry *entry)
+{
+    const char *text;
+    long number;
+    double real;
+    int boolean;
+    Atom value;
+
+    switch(descriptor->kind)
+    {
+        case attributeString:
+            text = HashMapEntryGetValue(entry);
+            if(!text) return 0;
+            descriptor->setter.setString(widget, text);
+            return 1;
+
+        case attributeInt:
+            if(HashMapEntryGetInt(entry, &number) != 1) return 0;
+            descriptor->setter.setInt(widget, (int)number);
+            return 1;
+
+        case attributeDouble:
+            if(HashMapEntryGetDouble(entry, &real) != 1) return 0;
+            descriptor->setter.setDouble(widget, real);
+            return 1;
+
+        case attributeBool:
+            if(HashMapEntryGetBool(entry, &boolean) != 1) return 0;
+            descriptor->setter.setBool(widget, boolean ? TRUE : FALSE);
+            return 1;
+
+        case attributeEnum:
+            if(HashMapEntryGetAtom(entry, &value) != 1) return 0;
+            for(int i = 0; enumAtoms[i]; i++)
+            {
+                if(enumAtoms[i] == value)
+                {
+                    descriptor->setter.setInt(widget, i);
+                    return 1;
+                }
+            }
+            return 0;
+
+        default:
+            return 0;
+    }
+}
+
+
+static void applyAttribute(const HashMapEntry *entry, void *userData)
+{
+    struct ApplyContext *context = (struct ApplyContext *)userData;
+
+    // The atom of the name is kept with the entry, so the descriptor is found by index alone
+    Atom atom = HashMapEntryGetKeyAtom(entry);
+    if(!atom || atom >= context->size || !context->table[atom].setter.setString) return;
+
+    context->applied += applyValue(context->widget, &context->table[atom], context->enumAtoms[atom], entry);
+}
+
+
+
+
+int AttributeRegistryApply(const Tree *node)
+{
+    // Check the input parameter
+    if(!node || !TreeGetWidget(node)) return -1;
+
+    widgetType type = TreeGetType(node);
+    if((int)type < 0 || type >= WIDGET_TYPE_COUNT) return -1;
+
+    initializeRegistry();
+    const HashMap *attributes = TreeGetAttributes(node);
+    struct ApplyContext context = { TreeGetWidget(node), registry[type].descriptors, registry[type].enumAtoms,
+                                    registry[type].size, 0 };
+
+    // Emit the property notifications once, after every attribute is set
+    g_object_freeze_notify(G_OBJECT(context.widget));
+    HashMapForEachEntry(attributes, applyAttribute, &context);
+
+    // The text content of a label or a button is its text, unless an attribute sets it
+    const char *text = TreeGetText(node, NULL);
+    if(text && type == label && HashMapContainsKey(attributes, "text") != 1)
+    {
+        setText(context.widget, text);
+        context.applied++;
+    }
+    else if(text && type == button && HashMapContainsKey(attributes, "label") != 1)
+    {
+        setLabel(context.widget, text);
+        context.applied++;
+    }
+    g_object_thaw_notify(G_OBJECT(context.widget));
+
+    return context.applied;
+}
+
+
+
+
+int AttributeRegistryApplyNames(const Tree *node, const Atom *names, int count)
+{
+    // Check the input parameters
+    if(!node || !TreeGetWidget(node) || (count && !names) || count < 0) return -1;
+
+    widgetType type = TreeGetType(node);
+    if((int)type < 0 || type >= WIDGET_TYPE_COUNT) return -1;
+
+    initializeRegistry();
+    GtkWidget *widget = TreeGetWidget(node);
+    const HashMap *attributes = TreeGetAttributes(node);
+    int applied = 0;
+
+    g_object_freeze_notify(G_OBJECT(widget));
+    for(int i = 0; i < count; i++)
+    {
+        // Names the type does not support, or the node no longer has, are skipped
+        const AttributeDescriptor *descriptor = AttributeRegistryLookup(type, names[i]);
+        const char *key = descriptor ? AtomToString(names[i]) : NULL;
+        const HashMapEntry *entry = key ? HashMapGetEntry(attributes, key) : NULL;
+        if(entry) applied += applyValue(widget, descriptor, registry[type].enumAtoms[names[i]], entry);
+    }
+    g_object_thaw_notify(G_OBJECT(widget));
+
+    return applied;
+}
+
+
+
+
+/**
+ * @brief The state shared with resetAttribute while the attributes of one widget are reset
+ */
+struct ResetContext
+{
+    GtkWidget *widget;                  ///< The widget being reset
+    const AttributeDescriptor *table;   ///< The descriptors of the widget type
+    Atom size;                          ///< The number of descriptors of the widget type
+    int reset;                          ///< The number of attributes reset so far
+};
+
+
+/** @brief Sets a property of a widget back to its default value, returns 0 if the widget has no such property */
+static int resetProperty(GtkWidget *widget, const char *property)
+{
+    GParamSpec *spec = g_object_class_find_property(G_OBJECT_GET_CLASS(widget), property);
+    if(!spec) return 0;
+
+    g_object_set_property(G_OBJECT(widget), property, g_param_spec_get_default_value(spec));
+    return 1;
+}
+
+
+static void resetAttribute(const char *key, const char *value, void *userData)
+{
+    struct ResetContext *context = (struct ResetContext *)userData;
+
+    Atom atom = AtomLookup(key);
+    if(!atom || atom >= context->size || !context->table[atom].setter.setString) return;
+    const AttributeDescriptor *descriptor = &context->table[atom];
+
+    if(descriptor->reset)
+    {
+        descriptor->reset(context->widget, value);
+        context->reset++;
+    }
+    else if(descriptor->property && resetProperty(context->widget, descriptor->property)) context->reset++;
+}
+
+
+
+
+int AttributeRegistryReset(widgetType type, GtkWidget *widget, const FrozenHashMap *attributes)
+{
+    // Check the input parameters
+    if((int)type < 0 || type >= WIDGET_TYPE_COUNT || !widget) return -1;
+
+    initializeRegistry();
+    struct ResetContext context = { widget, registry[type].descriptors, registry[type].size, 0 };
+
+    g_object_freeze_notify(G_OBJECT(widget));
+
+    // The text content of the node was applied without an attribute, so it is cleared in any case
+    if(type == label || type == button) resetProperty(widget, "label");
+    if(attributes) FrozenHashMapForEach(attributes, resetAttribute, &context);
+    g_object_thaw_notify(G_OBJECT(widget));
+
+    return context.reset;
+}
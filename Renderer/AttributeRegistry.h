@@ -0,0 +1,128 @@
+/***************************************************************************************************
+ * @file AttributeRegistry.h                                                                       *
+ * @brief Defines the registry of the attributes supported by each widget type                     *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see AttributeRegistry.c                                                                        *
+ **************************************************************************************************/
+
+#ifndef ATTRIBUTE_REGISTRY_H
+#define ATTRIBUTE_REGISTRY_H
+
+#include <gtk/gtk.h>
+#include "../DataStructure/Tree/Tree.h"
+#include "../Utils/Atom.h"
+
+/**
+ * @brief The type a attribute value is converted to before its setter is called
+ */
+typedef enum
+{
+    attributeString,
+    attributeInt,
+    attributeDouble,
+    attributeBool,
+    attributeEnum   ///< One of the names of enumNames, passed to setInt as its index
+} attributeKind;
+
+
+/**
+ * @brief The function applying an attribute to a widget, the member used depends on the kind
+ */
+typedef union
+{
+    void (*setString)(GtkWidget *widget, const char *value);
+    void (*setInt)(GtkWidget *widget, int value);
+    void (*setDouble)(GtkWidget *widget, double value);
+    void (*setBool)(GtkWidget *widget, gboolean value);
+} AttributeSetter;
+
+
+/**
+ * @brief Describes how an attribute is applied to the widgets of one widget type
+ */
+typedef struct
+{
+    attributeKind kind;             ///< The type the value is converted to
+    AttributeSetter setter;         ///< The function applying the converted value
+    const char *const *enumNames;   ///< The accepted values of an attributeEnum, NULL terminated
+    const char *property;           ///< The property the setter changes, reset to its default value (or NULL)
+    void (*reset)(GtkWidget *widget, const char *value);    ///< Undoes the setter when there is no such property (or NULL)
+} AttributeDescriptor;
+
+
+/**
+ * @brief Registers (or replaces) how an attribute is applied to a widget type
+ * 
+ * The built-in attributes (e.g., "visible", "spacing", "text") are registered on first use
+ * of the registry. The name is interned, so applying attributes only indexes tables.
+ * 
+ * @param type The widget type supporting the attribute
+ * @param name The attribute name as written in the markup
+ * @param descriptor How the attribute is applied, copied in the registry
+ * @return 1 if the attribute was added, 0 if it replaced a previous one, -1 if an error occurs
+ * 
+ * @warning The registry must only be used from the main thread
+ */
+int AttributeRegistryAdd(widgetType type, const char *name, const AttributeDescriptor *descriptor);
+
+
+/**
+ * @brief Returns how an attribute is applied to a widget type
+ * 
+ * @param type The widget type
+ * @param name The atom of the attribute name
+ * @return const AttributeDescriptor* The descriptor, or NULL if the type does not support the attribute
+ */
+const AttributeDescriptor *AttributeRegistryLookup(widgetType type, Atom name);
+
+
+/**
+ * @brief Applies every supported attribute of a node to its widget
+ * 
+ * The property notifications of the widget are frozen while the attributes are applied, so
+ * they are emitted once at the end. Attributes the widget type does not support (e.g., the
+ * grid placement "row" and "column") and values that cannot be converted are skipped.
+ * 
+ * @param node The node whose attributes are applied, its widget must exist
+ * @return The number of attributes applied, or -1 if any error occurs
+ */
+int AttributeRegistryApply(const Tree *node);
+
+
+/**
+ * @brief Applies some of the attributes of a node to its widget
+ * 
+ * Used to apply the attributes changed since the widget was created, without setting the
+ * others again. The notifications are frozen as in AttributeRegistryApply.
+ * 
+ * @param node The node whose attributes are applied, its widget must exist
+ * @param names The atoms of the names of the attributes to apply
+ * @param count The number of names
+ * @return The number of attributes applied, or -1 if any error occurs
+ */
+int AttributeRegistryApplyNames(const Tree *node, const Atom *names, int count);
+
+
+
+/**
+ * @brief Undoes the attributes applied to a widget, so it can be reused for another node
+ * 
+ * Each supported attribute goes back to the default value of its property, or is undone by the
+ * reset function of its descriptor. Attributes with neither are left as they are. The text of a
+ * label and the label of a button are always cleared, as they may come from the text content of
+ * the node rather than from an attribute.
+ * 
+ * @param type The widget type of the widget
+ * @param widget The widget to reset
+ * @param attributes The attributes that were applied to the widget, or NULL if it had none
+ * @return The number of attributes reset, or -1 if any error occurs
+ */
+int AttributeRegistryReset(widgetType type, GtkWidget *widget, const FrozenHashMap *attributes);
+
+#endif // ATTRIBUTE_REGISTRY_H
@@ -0,0 +1,386 @@
+/***************************************************************************************************
+ * @file DirtySet.c                                                                                *
+ * @brief The implementation of the set of nodes changed by a transaction                          *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see DirtySet.h                                                                                 *
+ **************************************************************************************************/
+
+#include "DirtySet.h"
+#include <stdint.h>
+
+/**
+ * @brief Represents a node changed by a transaction
+ */
+struct DirtyNode
+{
+    Tree *node;     ///< The node, NULL once it was removed
+    int added;      ///< Whether the node was added, its whole subtree is then flushed with it
+    Atom *names;    ///< The attributes changed, each once
+    int count;      ///< The number of attributes changed
+    int capacity;   ///< The number of names the array can hold
+};
+
+
+struct DirtySet
+{
+    struct DirtyNode *dirty;    ///< The changed nodes, in the order they were first changed
+    int dirtyCount;             ///< The number of changed nodes (removed ones included)
+    int dirtyCapacity;          ///< The number of changed nodes the array can hold
+    int *slots;                 ///< Open addressing table from a node to its index in dirty + 1 (0 when empty)
+    int slotMask;               ///< The number of slots - 1
+};
+
+#define DIRTY_SET_INITIAL_SLOTS 64  ///< The number of slots of a new set
+
+
+/** @brief Returns the first slot to look at for a node */
+static int slotOf(const DirtySet *set, const Tree *node)
+{
+    uint64_t hash = (uint64_t)(uintptr_t)node * 0x9E3779B97F4A7C15ull;
+    return (int)(hash >> 40) & set->slotMask;
+}
+
+
+/** @brief Returns the record of a node, or NULL if the node did not change */
+static struct DirtyNode *findDirty(const DirtySet *set, const Tree *node)
+{
+    // Removed records keep their slot, their node is NULL so they never match
+    for(int slot = slotOf(set, node); set->slots[slot]; slot = (slot + 1) & set->slotMask)
+    {
+        struct DirtyNode *dirty = &set->dirty[set->slots[slot] - 1];
+        if(dirty->node == node) return dirty;
+    }
+    return NULL;
+}
+
+
+/** @brief Returns the record of a node, adding it if needed */
+static struct DirtyNode *getDirty(DirtySet *set, Tree *node)
+{
+    struct DirtyNode *dirty = findDirty(set, node);
+    if(dirty) return dirty;
+
+    // Keep the table at most half full
+    if(2 * (set->dirtyCount + 1) > set->slotMask + 1)
+    {
+        int size = 2 * (set->slotMask + 1);
+        int *slots = calloc(size, sizeof(int));
+        if(!slots) return NULL;
+
+        free(set->slots);
+        set->slots = slots;
+        set->slotMask = size - 1;
+        for(int i = 0; i < set->dirtyCount; i++)
+        {
+            int slot = slotOf(set, set->dirty[i].node);
+            while(slots[slot]) slot = (slot + 1) & set->slotMask;
+            slots[slot] = i + 1;
+        }
+    }
+
+    if(set->dirtyCount == set->dirtyCapacity)
+    {
+        int capacity = set->dirtyCapacity ? 2 * set->dirtyCapacity : 16;
+        struct DirtyNode *grown = realloc(set->dirty, capacity * sizeof(struct DirtyNode));
+        if(!grown) return NULL;
+        set->dirty = grown;
+        set->dirtyCapacity = capacity;
+    }
+
+    dirty = &set->dirty[set->dirtyCount++];
+    *dirty = (struct DirtyNode){node, 0, NULL, 0, 0};
+
+    int slot = slotOf(set, node);
+    while(set->slots[slot]) slot = (slot + 1) & set->slotMask;
+    set->slots[slot] = set->dirtyCount;
+    return dirty;
+}
+
+
+/** @brief Returns whether a record has anything to flush */
+static int isPending(const struct DirtyNode *dirty)
+{
+    return dirty->node && (dirty->added || dirty->count);
+}
+
+
+/** @brief Forgets every record, keeping the arrays for the next changes */
+static void clearSet(DirtySet *set)
+{
+    for(int i = 0; i < set->dirtyCount; i++) free(set->dirty[i].names);
+    set->dirtyCount = 0;
+    memset(set->slots, 0, (set->slotMask + 1) * sizeof(int));
+}
+
+
+
+
+DirtySet *DirtySetNew()
+{
+    DirtySet *set = calloc(1, sizeof(DirtySet));
+    if(!set) return NULL;
+
+    set->slots = calloc(DIRTY_SET_INITIAL_SLOTS, sizeof(int));
+    set->slotMask = DIRTY_SET_INITIAL_SLOTS - 1;
+    if(!set->slots)
+    {
+        free(set);
+        return NULL;
+    }
+
+    return set;
+}
+
+
+
+
+int DirtySetMarkAttribute(DirtySet *set, Tree *node, Atom name)
+{
+    // Check the input parameters
+    if(!set || !node || !name) return -1;
+
+    struct DirtyNode *dirty = getDirty(set, node);
+    if(!dirty) return -1;
+
+    // Each attribute is recorded once, the flush applies its last value
+    for(int i = 0; i < dirty->count; i++) if(dirty->names[i] == name) return 0;
+
+    if(dirty->count == dirty->capacity)
+    {
+        int capacity = dirty->capacity ? 2 * dirty->capacity : 4;
+        Atom *names = realloc(dirty->names, capacity * sizeof(Atom));
+        if(!names) return -1;
+        dirty->names = names;
+        dirty->capacity = capacity;
+    }
+    dirty->names[dirty->count++] = name;
+
+    return 1;
+}
+
+
+
+
+int DirtySetMarkAdded(DirtySet *set, Tree *node)
+{
+    // Check the input parameters
+    if(!set || !node) return -1;
+
+    struct DirtyNode *dirty = getDirty(set, node);
+    if(!dirty) return -1;
+
+    dirty->added = 1;
+    return 1;
+}
+
+
+
+
+int DirtySetForget(DirtySet *set, const Tree *node)
+{
+    // Check the input parameters
+    if(!set || !node) return -1;
+
+    struct DirtyNode *dirty = findDirty(set, node);
+    if(!dirty) return 0;
+
+    int pending = isPending(dirty);
+    dirty->node = NULL;
+    dirty->added = 0;
+    dirty->count = 0;
+    return pending;
+}
+
+
+
+
+int DirtySetCount(const DirtySet *set)
+{
+    // Check the input parameter
+    if(!set) return -1;
+
+    int pending = 0;
+    for(int i = 0; i < set->dirtyCount; i++) if(isPending(&set->dirty[i])) pending++;
+    return pending;
+}
+
+
+
+
+/**
+ * @brief Represents a changed node to flush, placed in the Tree by the positions of its ancestors
+ */
+struct FlushEntry
+{
+    struct DirtyNode *dirty;    ///< The record of the node
+    int *path;                  ///< The position of each ancestor among its siblings, from the child of the root down to the node
+    int depth;                  ///< The number of positions (0 for the root)
+};
+
+
+/** @brief Orders the entries in pre-order: by their paths, an ancestor before its descendants */
+static int compareEntries(const void *first, const void *second)
+{
+    const struct FlushEntry *a = first, *b = second;
+    for(int i = 0; i < a->depth && i < b->depth; i++)
+    {
+        if(a->path[i] != b->path[i]) return a->path[i] < b->path[i] ? -1 : 1;
+    }
+    return (a->depth > b->depth) - (a->depth < b->depth);
+}
+
+
+/** @brief Reads the positions of the children of a node, for those that are ancestors of changed nodes */
+struct PositionScan
+{
+    GHashTable *positions;  ///< From an ancestor to its position + 1 (0 until its parent is read)
+    int position;           ///< The number of children visited so far
+};
+
+
+/** @brief TreeForEachChild callback filling a PositionScan */
+static void recordPosition(Tree *child, void *userData)
+{
+    struct PositionScan *scan = userData;
+    if(g_hash_table_contains(scan->positions, child)) g_hash_table_insert(scan->positions, child, GINT_TO_POINTER(scan->position + 1));
+    scan->position++;
+}
+
+
+/**
+ * @brief Places the changed nodes in the Tree, in entries to sort
+ * 
+ * Only the ancestors of the changed nodes are visited, and the children of each of their
+ * parents read once to find their positions. The nodes that are not in the Tree of the root
+ * are left out.
+ * 
+ * @return The number of entries, or -1 if an allocation fails
+ */
+static int placeEntries(const DirtySet *set, Tree *root, struct FlushEntry *entries)
+{
+    GHashTable *positions = g_hash_table_new(g_direct_hash, g_direct_equal);
+    int count = 0;
+
+    // Keep the nodes in the Tree of the root, and record their ancestors
+    for(int i = 0; i < set->dirtyCount; i++)
+    {
+        struct DirtyNode *dirty = &set->dirty[i];
+        if(!isPending(dirty)) continue;
+
+        int depth = 0;
+        Tree *node = dirty->node;
+        for(; node != root && TreeGetParentNode(node); node = TreeGetParentNode(node)) depth++;
+        if(node != root) continue;
+
+        for(node = dirty->node; node != root; node = TreeGetParentNode(node)) g_hash_table_insert(positions, node, NULL);
+        entries[count++] = (struct FlushEntry){ dirty, NULL, depth };
+    }
+
+    // Read the children of each parent once, the first of its children met gives them all their position
+    guint ancestorCount;
+    gpointer *ancestors = g_hash_table_get_keys_as_array(positions, &ancestorCount);
+    for(guint i = 0; i < ancestorCount; i++)
+    {
+        if(g_hash_table_lookup(positions, ancestors[i])) continue;
+
+        struct PositionScan scan = { positions, 0 };
+        TreeForEachChild(TreeGetParentNode(ancestors[i]), recordPosition, &scan);
+    }
+    g_free(ancestors);
+
+    // Write the path of each node, from the root down
+    int failed = 0;
+    for(int i = 0; i < count && !failed; i++)
+    {
+        struct FlushEntry *entry = &entries[i];
+        if(!entry->depth) continue;
+
+        entry->path = malloc(entry->depth * sizeof(int));
+        if(!entry->path)
+        {
+            failed = 1;
+            break;
+        }
+
+        Tree *node = entry->dirty->node;
+        for(int level = entry->depth - 1; level >= 0; level--, node = TreeGetParentNode(node))
+        {
+            entry->path[level] = GPOINTER_TO_INT(g_hash_table_lookup(positions, node)) - 1;
+        }
+    }
+
+    g_hash_table_destroy(positions);
+    if(!failed) return count;
+
+    for(int i = 0; i < count; i++) free(entries[i].path);
+    return -1;
+}
+
+
+
+
+int DirtySetFlush(DirtySet *set, Tree *root, const DirtySetCallbacks *callbacks, void *userData)
+{
+    // Check the input parameters
+    if(!set || !root || !callbacks || !callbacks->added || !callbacks->changed) return -1;
+
+    // Put the changed nodes in tree order, without walking the rest of the Tree
+    int updates = 0;
+    int count = DirtySetCount(set);
+    struct FlushEntry *entries = count ? malloc(count * sizeof(struct FlushEntry)) : NULL;
+    if(count && (!entries || (count = placeEntries(set, root, entries)) == -1))
+    {
+        free(entries);
+        clearSet(set);
+        return -1;
+    }
+    if(count > 1) qsort(entries, count, sizeof(struct FlushEntry), compareEntries);
+
+    const struct FlushEntry *added = NULL;
+    for(int i = 0; i < count && updates != -1; i++)
+    {
+        const struct FlushEntry *entry = &entries[i];
+
+        // The nodes inside an added subtree follow it and are flushed with it
+        if(added && entry->depth > added->depth && (!added->depth || memcmp(entry->path, added->path, added->depth * sizeof(int)) == 0)) continue;
+        added = NULL;
+
+        Tree *node = entry->dirty->node;
+        int made;
+        if(entry->dirty->added)
+        {
+            added = entry;
+            made = callbacks->added(node, node == root ? NULL : TreeGetParentNode(node), userData);
+        }
+        else made = callbacks->changed(node, entry->dirty->names, entry->dirty->count, userData);
+
+        if(made == -1) updates = -1;
+        else updates += made;
+    }
+
+    for(int i = 0; i < count; i++) free(entries[i].path);
+    free(entries);
+    clearSet(set);
+
+    return updates;
+}
+
+
+
+
+void DirtySetFree(DirtySet *set)
+{
+    // Check the input parameter
+    if(!set) return;
+
+    for(int i = 0; i < set->dirtyCount; i++) free(set->dirty[i].names);
+    free(set->dirty);
+    free(set->slots);
+    free(set);
+}
@@ -0,0 +1,111 @@
+/***************************************************************************************************
+ * @file DirtySet.h                                                                                *
+ * @brief Defines the set of nodes changed by a transaction, without any widget                    *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see DirtySet.c                                                                                 *
+ **************************************************************************************************/
+
+#ifndef DIRTY_SET_H
+#define DIRTY_SET_H
+
+#include "../DataStructure/Tree/Tree.h"
+#include "../Utils/Atom.h"
+
+typedef struct DirtySet DirtySet;
+
+/**
+ * @brief The functions DirtySetFlush calls for the changed nodes
+ * 
+ * Each returns the number of updates it made, or -1 if an error occurs.
+ */
+typedef struct
+{
+    int (*added)(Tree *node, Tree *parent, void *userData);     ///< An added subtree, parent is NULL for the root
+    int (*changed)(Tree *node, const Atom *names, int count, void *userData);   ///< The attributes changed on a node, each named once
+} DirtySetCallbacks;
+
+
+/**
+ * @brief Creates an empty set of changed nodes
+ * @return DirtySet* The set, or NULL if allocation fails
+ */
+DirtySet *DirtySetNew();
+
+
+/**
+ * @brief Records that an attribute of a node changed
+ * 
+ * Only the name is recorded, so an attribute changed several times is flushed once, with
+ * the value the node has at that time.
+ * 
+ * @param set The set
+ * @param node The node
+ * @param name The atom of the name of the attribute
+ * @return 1 if the attribute was recorded, 0 if it already was, -1 if any error occurs
+ */
+int DirtySetMarkAttribute(DirtySet *set, Tree *node, Atom name);
+
+
+/**
+ * @brief Records that a node (and its subtree) was added to the Tree
+ * 
+ * The nodes of an added subtree are flushed with it, their own changes are not flushed.
+ * 
+ * @param set The set
+ * @param node The node
+ * @return 1 on success, -1 if any error occurs
+ */
+int DirtySetMarkAdded(DirtySet *set, Tree *node);
+
+
+/**
+ * @brief Forgets the changes of a node removed from the Tree
+ * 
+ * A node added then removed is never flushed, nor are the attributes changed before its removal.
+ * 
+ * @param set The set
+ * @param node The node
+ * @return 1 if the node had changes, 0 if it had none, -1 if any error occurs
+ */
+int DirtySetForget(DirtySet *set, const Tree *node);
+
+
+/**
+ * @brief Returns the number of nodes the next flush has to visit
+ * @param set The set
+ * @return The number of changed nodes, or -1 if any error occurs
+ */
+int DirtySetCount(const DirtySet *set);
+
+
+/**
+ * @brief Calls the callbacks for the changed nodes, in tree order, then empties the set
+ * 
+ * The Tree is not walked: the changed nodes are put in pre-order from the positions of their
+ * ancestors, so a flush costs what the changed nodes and their ancestors (with the children of
+ * these) cost, whatever the size of the Tree. The nodes that are not in the Tree of the root are
+ * not flushed. An added subtree is passed to the added callback once, whatever was changed inside it.
+ * 
+ * @param set The set
+ * @param root The root of the Tree holding the changed nodes
+ * @param callbacks The functions to call
+ * @param userData Pointer passed unchanged to the callbacks
+ * @return The sum of the updates made by the callbacks, or -1 if any error occurs (the walk
+ *         stops at the first callback failing)
+ */
+int DirtySetFlush(DirtySet *set, Tree *root, const DirtySetCallbacks *callbacks, void *userData);
+
+
+/**
+ * @brief Frees a set of changed nodes
+ * @param set The set, may be NULL
+ */
+void DirtySetFree(DirtySet *set);
+
+#endif // DIRTY_SET_H
@@ -0,0 +1,522 @@
+/***************************************************************************************************
+ * @file Renderer.c                                                                                *
+ * @brief The implementation of the creation of the GTK widgets of a Tree                          *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Renderer.h                                                                                 *
+ **************************************************************************************************/
+
+#include "Renderer.h"
+#include "AttributeRegistry.h"
+#include "WidgetPool.h"
+#include "../Scanner/Scanner.h"
+#include "../Utils/Trace.h"
+
+/**
+ * @brief Represents the creation of one widget: the node, its parent and its position
+ */
+struct RealizeStep
+{
+    Tree *node;     ///< The node whose widget is to be created
+    Tree *parent;   ///< The parent node (NULL for the root), realized before the node
+    int index;      ///< The position of the node among the children of its parent
+};
+
+
+/**
+ * @brief Represents an asynchronous realization of a Tree
+ * 
+ * The steps are planned once, in breadth-first order, so that every batch only has to
+ * walk the array from where the previous batch stopped.
+ */
+struct RendererJob
+{
+    char *path;                         ///< The markup file to load (NULL if the Tree is given)
+    Tree *tree;                         ///< The Tree being realized
+    struct RealizeStep *steps;          ///< The widgets to create, parents first
+    int count;                          ///< The number of steps
+    int capacity;                       ///< The allocated number of steps
+    int realized;                       ///< The number of steps already done
+    gint64 frameBudget;                 ///< The time spent per batch, in microseconds
+    RendererProgressCallback progress;  ///< Called after each batch
+    RendererCompleteCallback complete;  ///< Called once every widget is created
+    void *userData;                     ///< Passed unchanged to the callbacks
+    int cancelled;                      ///< Set by RendererCancel, checked by the next batch
+    int failed;                         ///< Set if the file could not be read or parsed, or the plan could not be made
+};
+
+
+/**
+ * @brief Represents an asynchronous destruction of a Tree
+ */
+struct DestroyJob
+{
+    Tree *tree;                 ///< The Tree being destroyed
+    TreeIterator *iterator;     ///< The nodes whose widget is still to release, children first
+    GtkWidget *root;            ///< The widget of the root, held until the last batch (or NULL)
+    gint64 frameBudget;         ///< The time spent per batch, in microseconds
+};
+
+
+
+
+/**
+ * @brief Adds a step to the plan of a job, growing the array if needed
+ */
+static int addStep(RendererJob *job, Tree *node, Tree *parent, int index)
+{
+    if(job->count == job->capacity)
+    {
+        int capacity = job->capacity ? job->capacity * 2 : 64;
+        struct RealizeStep *steps = (struct RealizeStep *)realloc(job->steps, capacity * sizeof(struct RealizeStep));
+        if(!steps) return -1;
+        job->steps = steps;
+        job->capacity = capacity;
+    }
+
+    job->steps[job->count].node = node;
+    job->steps[job->count].parent = parent;
+    job->steps[job->count].index = index;
+    job->count++;
+
+    return 1;
+}
+
+
+/**
+ * @brief The state shared with planChild while the children of one node are planned
+ */
+struct PlanContext
+{
+    RendererJob *job;   ///< The job being planned
+    Tree *parent;       ///< The node whose children are visited
+    int index;          ///< The position of the next child
+    int failed;         ///< Set if a step could not be added
+};
+
+
+static void planChild(Tree *child, void *userData)
+{
+    struct PlanContext *context = (struct PlanContext *)userData;
+    if(addStep(context->job, child, context->parent, context->index++) == -1) context->failed = 1;
+}
+
+
+/**
+ * @brief Plans the realization of the job's Tree in breadth-first order
+ * 
+ * The steps array is its own queue: the children of the step i are appended while it is visited.
+ */
+static int planRealization(RendererJob *job)
+{
+    if(!job->tree) return 1;
+    if(addStep(job, job->tree, NULL, 0) == -1) return -1;
+
+    for(int i = 0; i < job->count; i++)
+    {
+        struct PlanContext context = { job, job->steps[i].node, 0, 0 };
+        TreeForEachChild(job->steps[i].node, planChild, &context);
+        if(context.failed) return -1;
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Creates the widget of one step, applies its attributes and adds it to the widget of its parent
+ */
+static int realizeStep(const struct RealizeStep *step)
+{
+    TRACE_BEGIN(create, "create widget");
+    GtkWidget *widget = RendererCreateWidget(step->node);
+    if(!widget) return -1;
+    TreeSetWidget(step->node, widget);
+    TRACE_END(create, 1, 0);
+
+    TRACE_BEGIN(apply, "apply attributes");
+    AttributeRegistryApply(step->node);
+    TRACE_END(apply, 1, 0);
+
+    // A widget that could not be added to its parent is still floating, nothing else would free it
+    if(step->parent && RendererAttachChild(step->parent, step->node, step->index) == -1)
+    {
+        TreeSetWidget(step->node, NULL);
+        g_object_unref(g_object_ref_sink(widget));
+        return -1;
+    }
+    return 1;
+}
+
+
+/**
+ * @brief Destroys the widgets of a Tree that never reached the complete callback, then the Tree
+ */
+static void releaseTree(Tree *tree)
+{
+    if(!tree) return;
+
+    // The widgets of the children were added to the root widget, they go away with it
+    GtkWidget *widget = TreeGetWidget(tree);
+    if(widget && TreeGetType(tree) == window) gtk_window_destroy(GTK_WINDOW(widget));
+    else if(widget) g_object_unref(g_object_ref_sink(widget));
+
+    TreeDestroyDeferred(tree);
+}
+
+
+static void destroyJob(RendererJob *job)
+{
+    releaseTree(job->tree);
+    free(job->steps);
+    g_free(job->path);
+    free(job);
+}
+
+
+/**
+ * @brief Creates widgets until the frame budget is spent, then yields to the main loop
+ */
+static gboolean realizeBatch(gpointer data)
+{
+    RendererJob *job = (RendererJob *)data;
+
+    // The job may have been cancelled while the previous batch was waiting
+    if(job->cancelled)
+    {
+        destroyJob(job);
+        return G_SOURCE_REMOVE;
+    }
+
+    // Create widgets until the budget of this iteration is spent, a widget that cannot be made stops the job
+    gint64 deadline = g_get_monotonic_time() + job->frameBudget;
+    while(!job->failed && job->realized < job->count)
+    {
+        if(realizeStep(&job->steps[job->realized++]) == -1) job->failed = 1;
+        else if(g_get_monotonic_time() >= deadline) break;
+    }
+
+    // Report the error like RendererRealize, the widgets made so far go away with the Tree
+    if(job->failed)
+    {
+        if(job->complete) job->complete(NULL, -1, job->userData);
+        destroyJob(job);
+        return G_SOURCE_REMOVE;
+    }
+
+    if(job->progress) job->progress(job->realized, job->count, job->userData);
+    if(job->realized < job->count) return G_SOURCE_CONTINUE;
+
+    // Hand the Tree over to the caller
+    if(job->complete)
+    {
+        job->complete(job->tree, job->count, job->userData);
+        job->tree = NULL;
+    }
+    destroyJob(job);
+
+    return G_SOURCE_REMOVE;
+}
+
+
+/**
+ * @brief Builds the Tree of the job's file on the worker thread, then hands it to the main loop
+ */
+static gpointer buildTree(gpointer data)
+{
+    RendererJob *job = (RendererJob *)data;
+
+    // An invalid markup must not exit the process, it is reported by the first batch
+    FILE *file = fopen(job->path, "r");
+    if(file)
+    {
+        int errorLine;
+        job->tree = tryLexicalAnalysis(file, &errorLine);
+        job->failed = errorLine != 0;
+        fclose(file);
+    }
+    else job->failed = 1;
+
+    // Planning walks the whole Tree, it is done here rather than on the main loop
+    if(!job->failed && planRealization(job) == -1)
+    {
+        TreeDestroyAll(job->tree);
+        job->tree = NULL;
+        job->count = 0;
+        job->failed = 1;
+    }
+
+    g_idle_add(realizeBatch, job);
+    return NULL;
+}
+
+
+static RendererJob *newJob(gint64 frameBudget, RendererProgressCallback progress,
+                           RendererCompleteCallback complete, void *userData)
+{
+    RendererJob *job = (RendererJob *)calloc(1, sizeof(RendererJob));
+    if(!job) return NULL;
+
+    job->frameBudget = frameBudget > 0 ? frameBudget : RENDERER_DEFAULT_FRAME_BUDGET;
+    job->progress = progress;
+    job->complete = complete;
+    job->userData = userData;
+
+    return job;
+}
+
+
+
+
+GtkWidget *RendererCreateWidget(const Tree *node)
+{
+    // Check the input parameter
+    if(!node) return NULL;
+
+    // Reuse a widget of the same type when one was recycled
+    GtkWidget *widget = WidgetPoolTake(TreeGetType(node));
+    if(widget) return widget;
+
+    switch(TreeGetType(node))
+    {
+        case window:    return gtk_window_new();
+        case headerBar: return gtk_header_bar_new();
+        case box:       return gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+        case grid:      return gtk_grid_new();
+        case label:     return gtk_label_new(NULL);
+        case button:    return gtk_button_new();
+        default:        return NULL;
+    }
+}
+
+
+
+
+/**
+ * @brief Reads an integer attribute of a node, or returns a default value if it is missing
+ */
+static int getIntAttribute(const Tree *node, const char *key, int defaultValue)
+{
+    const char *value = HashMapGet(TreeGetAttributes(node), key);
+    return value ? atoi(value) : defaultValue;
+}
+
+
+int RendererAttachChild(Tree *parent, Tree *child, int index)
+{
+    // Check the input parameters
+    if(!parent || !child) return -1;
+
+    GtkWidget *parentWidget = TreeGetWidget(parent);
+    GtkWidget *childWidget = TreeGetWidget(child);
+    if(!parentWidget || !childWidget) return -1;
+
+    switch(TreeGetType(parent))
+    {
+        case window:
+            if(TreeGetType(child) == headerBar) gtk_window_set_titlebar(GTK_WINDOW(parentWidget), childWidget);
+            else gtk_window_set_child(GTK_WINDOW(parentWidget), childWidget);
+            return 1;
+
+        case headerBar:
+            gtk_header_bar_pack_start(GTK_HEADER_BAR(parentWidget), childWidget);
+            return 1;
+
+        case box:
+            gtk_box_append(GTK_BOX(parentWidget), childWidget);
+            return 1;
+
+        case grid:
+            gtk_grid_attach(GTK_GRID(parentWidget), childWidget,
+                            getIntAttribute(child, "column", 0), getIntAttribute(child, "row", index),
+                            getIntAttribute(child, "columnSpan", 1), getIntAttribute(child, "rowSpan", 1));
+            return 1;
+
+        case button:
+            gtk_button_set_child(GTK_BUTTON(parentWidget), childWidget);
+            return 1;
+
+        default:
+            return -1;
+    }
+}
+
+
+
+
+int RendererDetachWidget(GtkWidget *child)
+{
+    // Check the input parameter
+    if(!child) return -1;
+
+    GtkWidget *parent = gtk_widget_get_parent(child);
+    if(!parent) return 0;
+
+    // The reverse of RendererAttachChild, for each kind of container
+    if(GTK_IS_WINDOW(parent))
+    {
+        if(gtk_window_get_titlebar(GTK_WINDOW(parent)) == child) gtk_window_set_titlebar(GTK_WINDOW(parent), NULL);
+        else gtk_window_set_child(GTK_WINDOW(parent), NULL);
+    }
+    else if(GTK_IS_HEADER_BAR(parent)) gtk_header_bar_remove(GTK_HEADER_BAR(parent), child);
+    else if(GTK_IS_BOX(parent)) gtk_box_remove(GTK_BOX(parent), child);
+    else if(GTK_IS_GRID(parent)) gtk_grid_remove(GTK_GRID(parent), child);
+    else if(GTK_IS_BUTTON(parent)) gtk_button_set_child(GTK_BUTTON(parent), NULL);
+    else return -1;
+
+    return 1;
+}
+
+
+
+
+int RendererRealize(Tree *root)
+{
+    // Check the input parameter
+    if(!root) return -1;
+
+    RendererJob *job = newJob(0, NULL, NULL, NULL);
+    if(!job) return -1;
+    job->tree = root;
+
+    // Create every widget without yielding to the main loop
+    int created = planRealization(job);
+    for(int i = 0; created != -1 && i < job->count; i++)
+    {
+        if(realizeStep(&job->steps[i]) == -1) created = -1;
+    }
+    if(created != -1) created = job->count;
+
+    free(job->steps);
+    free(job);
+
+    return created;
+}
+
+
+
+
+RendererJob *RendererRealizeAsync(const char *path, gint64 frameBudget, RendererProgressCallback progress,
+                                  RendererCompleteCallback complete, void *userData)
+{
+    // Check the input parameter
+    if(!path) return NULL;
+
+    RendererJob *job = newJob(frameBudget, progress, complete, userData);
+    if(!job) return NULL;
+    job->path = g_strdup(path);
+
+    // Parse and plan on a worker thread, the first batch is queued when it is done
+    GThread *thread = g_thread_new("markup-builder", buildTree, job);
+    g_thread_unref(thread);
+
+    return job;
+}
+
+
+
+
+RendererJob *RendererRealizeTreeAsync(Tree *tree, gint64 frameBudget, RendererProgressCallback progress,
+                                      RendererCompleteCallback complete, void *userData)
+{
+    // Check the input parameter
+    if(!tree) return NULL;
+
+    RendererJob *job = newJob(frameBudget, progress, complete, userData);
+    if(!job) return NULL;
+    job->tree = tree;
+
+    if(planRealization(job) == -1)
+    {
+        job->tree = NULL;
+        destroyJob(job);
+        return NULL;
+    }
+
+    g_idle_add(realizeBatch, job);
+    return job;
+}
+
+
+
+
+void RendererCancel(RendererJob *job)
+{
+    // Check the input parameter
+    if(!job) return;
+
+    // The next batch (or the handover from the worker thread) releases the job
+    job->cancelled = 1;
+}
+
+
+
+
+/**
+ * @brief Releases widgets until the frame budget is spent, then hands the nodes to the reclaimer
+ */
+static gboolean destroyBatch(gpointer data)
+{
+    struct DestroyJob *job = (struct DestroyJob *)data;
+
+    // Recycle (or destroy) widgets until the budget of this iteration is spent
+    gint64 deadline = g_get_monotonic_time() + job->frameBudget;
+    for(Tree *node; (node = TreeIteratorNext(job->iterator));)
+    {
+        GtkWidget *widget = TreeGetWidget(node);
+        if(widget)
+        {
+            TreeSetWidget(node, NULL);
+            WidgetPoolRecycle(TreeGetType(node), widget, TreeFreezeAttributes(node));
+        }
+        if(g_get_monotonic_time() >= deadline) return G_SOURCE_CONTINUE;
+    }
+
+    // If the walk stopped early, the widgets left go away with the widget of the root
+    GtkWidget *widget = TreeGetWidget(job->tree);
+    if(widget && GTK_IS_WINDOW(widget)) gtk_window_destroy(GTK_WINDOW(widget));
+    if(job->root) g_object_unref(job->root);
+
+    TreeIteratorFree(job->iterator);
+    TreeDestroyDeferred(job->tree);
+    free(job);
+
+    return G_SOURCE_REMOVE;
+}
+
+
+int RendererDestroyAsync(Tree *tree, gint64 frameBudget)
+{
+    // Check the input parameter
+    if(!tree) return -1;
+
+    struct DestroyJob *job = (struct DestroyJob *)calloc(1, sizeof(struct DestroyJob));
+    TreeIterator *iterator = job ? TreeIteratorNew(tree, treePostOrder) : NULL;
+    if(!iterator)
+    {
+        free(job);
+        releaseTree(tree);
+        return 0;
+    }
+
+    job->tree = tree;
+    job->iterator = iterator;
+    job->frameBudget = frameBudget > 0 ? frameBudget : RENDERER_DEFAULT_FRAME_BUDGET;
+
+    // Take the widgets out of sight at once, the batches then work on widgets no one sees
+    GtkWidget *widget = TreeGetWidget(tree);
+    if(widget)
+    {
+        job->root = g_object_ref_sink(widget);
+        if(GTK_IS_WINDOW(widget)) gtk_widget_set_visible(widget, FALSE);
+        else RendererDetachWidget(widget);
+    }
+
+    g_idle_add(destroyBatch, job);
+    return 1;
+}
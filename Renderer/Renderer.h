@@ -0,0 +1,157 @@
+/***************************************************************************************************
+ * @file Renderer.h                                                                                *
+ * @brief Defines the creation of the GTK widgets of a Tree                                        *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Renderer.c                                                                                 *
+ **************************************************************************************************/
+
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <gtk/gtk.h>
+#include "../DataStructure/Tree/Tree.h"
+
+#define RENDERER_DEFAULT_FRAME_BUDGET 4000  ///< Default time spent creating widgets per main loop iteration (µs)
+
+typedef struct RendererJob RendererJob;
+
+/**
+ * @brief Called on the main thread after each batch of widgets created by an asynchronous job
+ * 
+ * @param realized The number of nodes whose widget has been created so far
+ * @param total The number of nodes in the Tree
+ * @param userData The pointer given when the job was started
+ */
+typedef void (*RendererProgressCallback)(int realized, int total, void *userData);
+
+/**
+ * @brief Called on the main thread once an asynchronous job has created every widget, or failed
+ * 
+ * @param tree The realized Tree, now owned by the callback (NULL if the file contains no element
+ *             or on failure)
+ * @param created The number of widgets created, or -1 if the file could not be read or parsed or
+ *                a widget could not be created (the Tree and its widgets are then destroyed)
+ * @param userData The pointer given when the job was started
+ */
+typedef void (*RendererCompleteCallback)(Tree *tree, int created, void *userData);
+
+
+/**
+ * @brief Creates the GTK widget matching the type of a tree node
+ * 
+ * A widget recycled in the pool of the type (see WidgetPool.h) is reused when there is one.
+ * 
+ * @param node The tree node whose widget is to be created
+ * @return GtkWidget* The new widget, or NULL if the node is NULL or its type is unknown
+ */
+GtkWidget *RendererCreateWidget(const Tree *node);
+
+
+/**
+ * @brief Adds the widget of a child node to the widget of its parent node
+ * 
+ * The child is placed according to the parent type: the title bar or the content of a
+ * window, packed in a header bar, appended to a box, attached to a grid (using the child's
+ * "column", "row", "columnSpan" and "rowSpan" attributes) or set as the content of a button.
+ * 
+ * @param parent The parent node, whose widget must exist
+ * @param child The child node, whose widget must exist
+ * @param index The position of the child among the children of the parent
+ * @return 1 on success, -1 if a widget is missing or the parent cannot contain the child
+ */
+int RendererAttachChild(Tree *parent, Tree *child, int index);
+
+
+/**
+ * @brief Removes a widget from the widget it was attached to by RendererAttachChild
+ * 
+ * Works from the widgets alone, so it can be used after the nodes are destroyed. The widget
+ * is destroyed unless the caller holds a reference to it.
+ * 
+ * @param child The widget to remove
+ * @return 1 on success, 0 if the widget has no parent, -1 if the parent is not a known container
+ */
+int RendererDetachWidget(GtkWidget *child);
+
+
+/**
+ * @brief Creates the widgets of a whole Tree on the calling thread
+ * 
+ * @param root The root of the Tree to realize
+ * @return The number of widgets created, or -1 if any error occurs
+ * 
+ * @warning Blocks the main loop until every widget is created, prefer RendererRealizeAsync for big Trees
+ */
+int RendererRealize(Tree *root);
+
+
+/**
+ * @brief Builds the Tree of a markup file on a worker thread, then creates its widgets on the main loop
+ * 
+ * The widgets are created in batches from idle sources, each batch stopping once the frame budget
+ * is spent, so the main loop keeps handling events while a big layout streams in. Parents are
+ * realized before their children, level by level. An invalid markup or an allocation failure while
+ * it is read is reported to the complete callback, the process does not exit (see tryLexicalAnalysis).
+ * 
+ * @param path The path of the markup file to load
+ * @param frameBudget The time spent creating widgets per batch in microseconds (0 for the default)
+ * @param progress Called after each batch (may be NULL)
+ * @param complete Called once every widget is created or on failure (may be NULL, the Tree is then destroyed)
+ * @param userData Pointer passed unchanged to the callbacks
+ * @return RendererJob* The running job, or NULL if any error occurs
+ * 
+ * @warning Must be called from the thread running the default main context
+ */
+RendererJob *RendererRealizeAsync(const char *path, gint64 frameBudget, RendererProgressCallback progress,
+                                  RendererCompleteCallback complete, void *userData);
+
+
+/**
+ * @brief Creates the widgets of an already built Tree in batches on the main loop
+ * 
+ * @param tree The Tree to realize, owned by the job until the complete callback
+ * @param frameBudget The time spent creating widgets per batch in microseconds (0 for the default)
+ * @param progress Called after each batch (may be NULL)
+ * @param complete Called once every widget is created or on failure (may be NULL, the Tree is then destroyed)
+ * @param userData Pointer passed unchanged to the callbacks
+ * @return RendererJob* The running job, or NULL if any error occurs
+ */
+RendererJob *RendererRealizeTreeAsync(Tree *tree, gint64 frameBudget, RendererProgressCallback progress,
+                                      RendererCompleteCallback complete, void *userData);
+
+
+/**
+ * @brief Cancels an asynchronous job, destroying its Tree and the widgets created so far
+ * 
+ * @param job The job to cancel
+ * 
+ * @warning Must not be called once the complete callback of the job has run
+ */
+void RendererCancel(RendererJob *job);
+
+
+/**
+ * @brief Destroys a Tree and its widgets without stalling the main loop
+ * 
+ * The widget of the root is hidden (or removed from its parent) at once. The widgets are then
+ * recycled into their pools (see WidgetPool.h), children first, in batches from idle sources,
+ * each batch stopping once the frame budget is spent. The memory of the nodes is released
+ * last, on the reclaimer thread (see TreeDestroyDeferred).
+ * 
+ * @param tree The root of the Tree, detached from any other Tree (see TreeDetachChild)
+ * @param frameBudget The time spent destroying widgets per batch in microseconds (0 for the default)
+ * @return 1 if the destruction was started, 0 if it was done right away because it could not
+ *         be started, -1 if the Tree is NULL
+ * 
+ * @warning Must be called from the thread running the default main context, and the Tree
+ *          must not be used anymore
+ */
+int RendererDestroyAsync(Tree *tree, gint64 frameBudget);
+
+#endif // RENDERER_H
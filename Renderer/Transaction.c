@@ -0,0 +1,249 @@
+/***************************************************************************************************
+ * @file Transaction.c                                                                             *
+ * @brief The implementation of the Tree transactions                                              *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Transaction.h                                                                              *
+ **************************************************************************************************/
+
+#include "Transaction.h"
+#include "AttributeRegistry.h"
+#include "DirtySet.h"
+#include "Renderer.h"
+#include "WidgetPool.h"
+
+/**
+ * @brief Represents the widget of a node removed by a transaction
+ */
+struct RemovedWidget
+{
+    GtkWidget *widget;          ///< The widget, referenced until the commit
+    widgetType type;            ///< The type of the node
+    FrozenHashMap *attributes;  ///< The attributes applied to the widget, retained (or NULL)
+};
+
+
+struct Transaction
+{
+    Tree *root;             ///< The root of the Tree
+    DirtySet *dirty;        ///< The changed nodes and attributes, applied by the commit
+    GArray *removed;        ///< The widgets of the removed nodes, recycled by the commit
+};
+
+
+/** @brief Looks for a child of a node, by identifier or by address */
+struct ChildSearch
+{
+    const char *id;     ///< The identifier of the child, or NULL to search by address
+    Tree *child;        ///< The child found (or to find)
+    int position;       ///< The number of children visited so far
+    int index;          ///< The position of the child, -1 until found
+};
+
+
+/** @brief TreeForEachChild callback filling a ChildSearch */
+static void findChild(Tree *child, void *userData)
+{
+    struct ChildSearch *search = userData;
+    if(search->index == -1)
+    {
+        const char *id = TreeGetId(child);
+        if(search->id ? (id && strcmp(id, search->id) == 0) : child == search->child)
+        {
+            search->child = child;
+            search->index = search->position;
+        }
+    }
+    search->position++;
+}
+
+
+/** @brief DirtySetCallbacks.added: realizes an added subtree and attaches it to its parent's widget */
+static int attachAdded(Tree *node, Tree *parent, void *userData)
+{
+    (void)userData;
+
+    // An added subtree without a realized parent is left for its ancestor or the next RendererRealize
+    if(!parent || !TreeGetWidget(parent)) return 0;
+
+    struct ChildSearch search = { NULL, node, 0, -1 };
+    TreeForEachChild(parent, findChild, &search);
+    if(RendererRealize(node) == -1 || RendererAttachChild(parent, node, search.index) == -1) return -1;
+
+    return 1;
+}
+
+
+/** @brief Resets a removed attribute on the widget of a node, from a snapshot holding it alone (as VirtualGrid does) */
+static int resetRemoved(const Tree *node, const char *key)
+{
+    HashMap *removed = HashMapNew();
+    FrozenHashMap *snapshot = removed && HashMapPut(removed, key, "") != -1 ? HashMapFreeze(removed) : NULL;
+    HashMapFree(removed);
+    if(!snapshot) return -1;
+
+    int reset = AttributeRegistryReset(TreeGetType(node), TreeGetWidget(node), snapshot);
+    FrozenHashMapRelease(snapshot);
+    return reset;
+}
+
+
+/** @brief DirtySetCallbacks.changed: applies the last values of the changed attributes, resetting the removed ones */
+static int applyChanged(Tree *node, const Atom *names, int count, void *userData)
+{
+    (void)userData;
+
+    int updates = 0, removed = 0;
+    for(int i = 0; i < count; i++)
+    {
+        const char *key = AtomToString(names[i]);
+        if(HashMapContainsKey(TreeGetAttributes(node), key) == 1) continue;
+
+        int reset = resetRemoved(node, key);
+        if(reset == -1) return -1;
+        updates += reset;
+        removed++;
+    }
+    if(!removed) return AttributeRegistryApplyNames(node, names, count);
+
+    // A reset clears the text of a label or a button, which is applied again with the other attributes
+    widgetType type = TreeGetType(node);
+    int applied = type == label || type == button ? AttributeRegistryApply(node) : AttributeRegistryApplyNames(node, names, count);
+    return applied == -1 ? -1 : updates + applied;
+}
+
+
+/** @brief Frees a transaction, releasing the widgets it still holds */
+static void freeTransaction(Transaction *transaction)
+{
+    DirtySetFree(transaction->dirty);
+    for(guint i = 0; i < transaction->removed->len; i++)
+    {
+        struct RemovedWidget *removed = &g_array_index(transaction->removed, struct RemovedWidget, i);
+        g_object_unref(removed->widget);
+        FrozenHashMapRelease(removed->attributes);
+    }
+    g_array_free(transaction->removed, TRUE);
+    free(transaction);
+}
+
+
+
+
+Transaction *TransactionBegin(Tree *root)
+{
+    // Check the input parameter
+    if(!root) return NULL;
+
+    Transaction *transaction = calloc(1, sizeof(Transaction));
+    if(!transaction) return NULL;
+
+    transaction->root = root;
+    transaction->dirty = DirtySetNew();
+    transaction->removed = g_array_new(FALSE, FALSE, sizeof(struct RemovedWidget));
+    if(!transaction->dirty)
+    {
+        freeTransaction(transaction);
+        return NULL;
+    }
+
+    return transaction;
+}
+
+
+
+
+int TransactionSetAttribute(Transaction *transaction, Tree *node, const char *key, const char *value)
+{
+    // Check the input parameters
+    if(!transaction || !node || !key) return -1;
+
+    // Setting the value an attribute already has changes nothing
+    const char *current = HashMapGet(TreeGetAttributes(node), key);
+    if(value ? (current && strcmp(current, value) == 0) : !current) return 0;
+
+    if(TreeSetAttribute(node, key, value) < 0) return -1;
+
+    // Nodes without widget get all their attributes when they are realized
+    if(!TreeGetWidget(node)) return 1;
+
+    // Each attribute is recorded once, the commit applies its last value (or resets it once removed)
+    Atom name = AtomIntern(key);
+    if(!name || DirtySetMarkAttribute(transaction->dirty, node, name) == -1) return -1;
+
+    return 1;
+}
+
+
+
+
+int TransactionAddChild(Transaction *transaction, Tree *parent, Tree *child)
+{
+    // Check the input parameters
+    if(!transaction || !parent || !child) return -1;
+
+    if(DirtySetMarkAdded(transaction->dirty, child) == -1) return -1;
+    if(TreeAddChild(parent, child) < 0)
+    {
+        DirtySetForget(transaction->dirty, child);
+        return -1;
+    }
+
+    return 1;
+}
+
+
+
+
+int TransactionRemoveChild(Transaction *transaction, Tree *parent, const char *id)
+{
+    // Check the input parameters
+    if(!transaction || !parent || !id) return -1;
+
+    struct ChildSearch search = { id, NULL, 0, -1 };
+    TreeForEachChild(parent, findChild, &search);
+    Tree *child = search.child;
+    if(!child || TreeIsLeaf(child) != 1) return -1;
+
+    // Keep the widget and the attributes to undo until the commit, a node added by the transaction has no widget
+    GtkWidget *widget = TreeGetWidget(child);
+    if(widget)
+    {
+        struct RemovedWidget removed = { g_object_ref(widget), TreeGetType(child), TreeFreezeAttributes(child) };
+        if(removed.attributes) FrozenHashMapRetain(removed.attributes);
+        g_array_append_val(transaction->removed, removed);
+    }
+
+    // Forget the changes made to the node
+    DirtySetForget(transaction->dirty, child);
+
+    return TreeRemoveChild(parent, id);
+}
+
+
+int TransactionCommit(Transaction *transaction)
+{
+    // Check the input parameter
+    if(!transaction) return -1;
+
+    int updates = 0;
+
+    // Remove the widgets first, so the positions used to attach the new ones are right, and the added nodes can reuse them
+    for(guint i = 0; i < transaction->removed->len; i++)
+    {
+        struct RemovedWidget *removed = &g_array_index(transaction->removed, struct RemovedWidget, i);
+        if(WidgetPoolRecycle(removed->type, removed->widget, removed->attributes) != -1) updates++;
+    }
+
+    // Then walk the Tree once, attaching the added subtrees and applying the changed attributes
+    static const DirtySetCallbacks callbacks = { attachAdded, applyChanged };
+    int flushed = DirtySetFlush(transaction->dirty, transaction->root, &callbacks, NULL);
+    freeTransaction(transaction);
+
+    return flushed == -1 ? -1 : updates + flushed;
+}
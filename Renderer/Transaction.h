@@ -0,0 +1,80 @@
+/***************************************************************************************************
+ * @file Transaction.h                                                                             *
+ * @brief Groups Tree changes and applies them to the widgets once                                 *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Transaction.c                                                                              *
+ **************************************************************************************************/
+
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+#include <gtk/gtk.h>
+#include "../DataStructure/Tree/Tree.h"
+
+typedef struct Transaction Transaction;
+
+/**
+ * @brief Starts a transaction on a realized Tree
+ * 
+ * The changes made through the transaction update the Tree right away, so it can be read as
+ * usual, but the widgets are only updated by TransactionCommit: each changed attribute is set
+ * once with its last value, the widgets of added nodes are created and attached once, nodes
+ * added then removed never get a widget, and the updates are applied in tree order.
+ * 
+ * @param root The root of the Tree
+ * @return Transaction* The transaction, or NULL if allocation fails or the root is NULL
+ * 
+ * @warning Must be used from the main thread, the Tree must not be changed by other means until the commit
+ */
+Transaction *TransactionBegin(Tree *root);
+
+
+/**
+ * @brief Sets (or removes) an attribute of a node
+ * 
+ * Removing an attribute resets it on the widget at the commit, as AttributeRegistryReset does
+ * (the property goes back to its default).
+ * 
+ * @param transaction The transaction
+ * @param node The node, in the Tree of the transaction
+ * @param key The name of the attribute
+ * @param value The new value, or NULL to remove the attribute
+ * @return 1 if the attribute changed, 0 if it already had this value, -1 if any error occurs
+ */
+int TransactionSetAttribute(Transaction *transaction, Tree *node, const char *key, const char *value);
+
+
+/**
+ * @brief Adds a child (and its subtree) to a node, its widgets are created by the commit
+ * @param transaction The transaction
+ * @param parent The parent node, in the Tree of the transaction
+ * @param child The child to add, without widgets
+ * @return 1 on success, -1 if any error occurs
+ */
+int TransactionAddChild(Transaction *transaction, Tree *parent, Tree *child);
+
+
+/**
+ * @brief Removes a leaf child of a node, as TreeRemoveChild, its widget is recycled by the commit
+ * @param transaction The transaction
+ * @param parent The parent node, in the Tree of the transaction
+ * @param id The identifier of the child to remove
+ * @return 1 on success, -1 if any error occurs (e.g., the child is not found or has children)
+ */
+int TransactionRemoveChild(Transaction *transaction, Tree *parent, const char *id);
+
+
+/**
+ * @brief Applies the net result of the changes to the widgets, then frees the transaction
+ * @param transaction The transaction
+ * @return The number of widget updates made (attributes set, widgets attached or removed), or -1 if any error occurs
+ */
+int TransactionCommit(Transaction *transaction);
+
+#endif // TRANSACTION_H
@@ -0,0 +1,273 @@
+/***************************************************************************************************
+ * @file VirtualGrid.c                                                                             *
+ * @brief The implementation of the grids that only materialize the rows in view                   *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see VirtualGrid.h                                                                              *
+ **************************************************************************************************/
+
+#include "VirtualGrid.h"
+#include "AttributeRegistry.h"
+#include "Renderer.h"
+#include "WidgetPool.h"
+
+struct VirtualGrid
+{
+    Tree *grid;                 ///< The grid node
+    RowModel *model;            ///< The row model of the grid
+    int columns;                ///< The number of columns of the model
+    int rowHeight;              ///< The height of a row, in pixels
+    int overscan;               ///< The number of rows materialized around the viewport
+    int slotCount;              ///< The number of materialized rows
+    int slotCapacity;           ///< The number of rows the slots can hold
+    int *slotRows;              ///< The row each slot is bound to
+    Tree **slotCells;           ///< The cells of each slot, slot after slot
+    Atom *boundNames;           ///< The atom of the bound attribute of each column
+    FrozenHashMap **unbound;    ///< For each column, the bound attribute alone, to reset it when a row has no value
+};
+
+
+/** @brief Applies the bound attribute of a cell to its widget, or resets it when the row has no value */
+static int applyValue(VirtualGrid *grid, Tree *cell, int column)
+{
+    if(HashMapGet(TreeGetAttributes(cell), RowModelGetBoundKey(grid->model, column)))
+    {
+        return AttributeRegistryApplyNames(cell, &grid->boundNames[column], 1);
+    }
+    return AttributeRegistryReset(TreeGetType(cell), TreeGetWidget(cell), grid->unbound[column]);
+}
+
+
+/** @brief Binds the cells of a slot to another row, moving their widgets in the grid */
+static int rebindSlot(VirtualGrid *grid, int slot, int row)
+{
+    const char *gridId = TreeGetId(grid->grid);
+    for(int column = 0; column < grid->columns; column++)
+    {
+        Tree *cell = grid->slotCells[slot * grid->columns + column];
+        GtkWidget *widget = TreeGetWidget(cell);
+        if(RowModelBindCell(grid->model, gridId, cell, row) == -1 || applyValue(grid, cell, column) == -1) return -1;
+
+        // Attach the widget again at the new row
+        g_object_ref(widget);
+        RendererDetachWidget(widget);
+        int attached = RendererAttachChild(grid->grid, cell, row);
+        g_object_unref(widget);
+        if(attached == -1) return -1;
+
+        RowModelSetCell(grid->model, row, column, cell);
+    }
+
+    grid->slotRows[slot] = row;
+    return 1;
+}
+
+
+/** @brief Materializes a row in a new slot */
+static int addSlot(VirtualGrid *grid, int row)
+{
+    if(grid->slotCount == grid->slotCapacity)
+    {
+        int capacity = grid->slotCapacity ? 2 * grid->slotCapacity : 32;
+        int *rows = realloc(grid->slotRows, capacity * sizeof(int));
+        if(!rows) return -1;
+        grid->slotRows = rows;
+
+        Tree **cells = realloc(grid->slotCells, (size_t)capacity * grid->columns * sizeof(Tree *));
+        if(!cells) return -1;
+        grid->slotCells = cells;
+        grid->slotCapacity = capacity;
+    }
+
+    const char *gridId = TreeGetId(grid->grid);
+    int slot = grid->slotCount;
+    for(int column = 0; column < grid->columns; column++)
+    {
+        Tree *cell = RowModelNewCell(grid->model, gridId, row, column);
+        if(!cell || TreeAddChild(grid->grid, cell) == -1)
+        {
+            TreeDestroy(cell);
+            return -1;
+        }
+
+        // The widget comes from the pool of its type when rows were released before
+        if(RendererRealize(cell) == -1 || RendererAttachChild(grid->grid, cell, row) == -1) return -1;
+
+        grid->slotCells[slot * grid->columns + column] = cell;
+        RowModelSetCell(grid->model, row, column, cell);
+    }
+
+    grid->slotRows[slot] = row;
+    grid->slotCount++;
+    return 1;
+}
+
+
+/** @brief Releases the row of a slot, its widgets go back to the pools, the last slot takes its place */
+static void removeSlot(VirtualGrid *grid, int slot)
+{
+    for(int column = 0; column < grid->columns; column++)
+    {
+        Tree *cell = grid->slotCells[slot * grid->columns + column];
+        WidgetPoolRecycleTree(cell);
+        TreeRemoveChild(grid->grid, TreeGetId(cell));
+    }
+
+    grid->slotCount--;
+    grid->slotRows[slot] = grid->slotRows[grid->slotCount];
+    memcpy(&grid->slotCells[slot * grid->columns], &grid->slotCells[grid->slotCount * grid->columns],
+           grid->columns * sizeof(Tree *));
+}
+
+
+/** @brief Sets a margin of the grid node to stand for the rows that are not materialized */
+static int setMargin(VirtualGrid *grid, const char *key, int rows)
+{
+    char value[16];
+    snprintf(value, sizeof(value), "%d", rows * grid->rowHeight);
+    if(TreeSetAttribute(grid->grid, key, value) == -1) return -1;
+
+    Atom name = AtomIntern(key);
+    return AttributeRegistryApplyNames(grid->grid, &name, 1);
+}
+
+
+
+
+VirtualGrid *VirtualGridNew(Tree *node, int rowHeight, int overscan)
+{
+    // Check the input parameters
+    if(!node || TreeGetType(node) != grid || !TreeGetWidget(node) || !TreeGetRowModel(node)) return NULL;
+    if(rowHeight <= 0 || overscan < 0 || TreeIsLeaf(node) != 1) return NULL;
+
+    VirtualGrid *virtualGrid = calloc(1, sizeof(VirtualGrid));
+    if(!virtualGrid) return NULL;
+
+    virtualGrid->grid = node;
+    virtualGrid->model = TreeGetRowModel(node);
+    virtualGrid->columns = RowModelGetColumnCount(virtualGrid->model);
+    virtualGrid->rowHeight = rowHeight;
+    virtualGrid->overscan = overscan;
+    virtualGrid->boundNames = calloc(virtualGrid->columns, sizeof(Atom));
+    virtualGrid->unbound = calloc(virtualGrid->columns, sizeof(FrozenHashMap *));
+    if(!virtualGrid->boundNames || !virtualGrid->unbound)
+    {
+        VirtualGridFree(virtualGrid);
+        return NULL;
+    }
+
+    for(int column = 0; column < virtualGrid->columns; column++)
+    {
+        const char *key = RowModelGetBoundKey(virtualGrid->model, column);
+        HashMap *unbound = HashMapNew();
+        if(unbound) HashMapPut(unbound, key, "");
+
+        virtualGrid->boundNames[column] = AtomIntern(key);
+        virtualGrid->unbound[column] = unbound ? HashMapFreeze(unbound) : NULL;
+        HashMapFree(unbound);
+        if(!virtualGrid->boundNames[column] || !virtualGrid->unbound[column])
+        {
+            VirtualGridFree(virtualGrid);
+            return NULL;
+        }
+    }
+
+    return virtualGrid;
+}
+
+
+
+
+int VirtualGridSetViewport(VirtualGrid *grid, int firstRow, int visibleRows)
+{
+    // Check the input parameters
+    if(!grid || firstRow < 0 || visibleRows < 0) return -1;
+
+    // The rows to materialize: the viewport and the overscan, within the model
+    int rows = RowModelGetRowCount(grid->model);
+    int first = firstRow - grid->overscan > 0 ? firstRow - grid->overscan : 0;
+    if(first > rows) first = rows;
+    long end = (long)firstRow + visibleRows + grid->overscan;
+    int last = end < rows ? (int)end : rows;
+    int count = last - first;
+
+    // Find the rows already materialized, and the slots free to take the others
+    int *slotOfRow = malloc((count ? count : 1) * sizeof(int));
+    int *freeSlots = malloc((grid->slotCount ? grid->slotCount : 1) * sizeof(int));
+    if(!slotOfRow || !freeSlots || RowModelSetWindow(grid->model, first, count) == -1)
+    {
+        free(slotOfRow);
+        free(freeSlots);
+        return -1;
+    }
+
+    for(int i = 0; i < count; i++) slotOfRow[i] = -1;
+    int freeCount = 0;
+    for(int slot = 0; slot < grid->slotCount; slot++)
+    {
+        int row = grid->slotRows[slot];
+        if(row >= first && row < last) slotOfRow[row - first] = slot;
+        else freeSlots[freeCount++] = slot;
+    }
+
+    // Rebind the free slots first, then make new ones only if the window grew
+    int bound = 0;
+    for(int row = first; row < last && bound != -1; row++)
+    {
+        if(slotOfRow[row - first] != -1) continue;
+
+        int result = freeCount ? rebindSlot(grid, freeSlots[--freeCount], row) : addSlot(grid, row);
+        bound = result == -1 ? -1 : bound + 1;
+    }
+
+    // Release the rows left over if the window shrank, from the highest slot so the others keep their index
+    while(bound != -1 && freeCount) removeSlot(grid, freeSlots[--freeCount]);
+
+    free(slotOfRow);
+    free(freeSlots);
+
+    if(bound != -1 && (setMargin(grid, "marginTop", first) == -1 || setMargin(grid, "marginBottom", rows - last) == -1)) return -1;
+    return bound;
+}
+
+
+
+
+int VirtualGridSetValue(VirtualGrid *grid, int row, int column, const char *value)
+{
+    // Check the input parameters
+    if(!grid || RowModelSetValue(grid->model, row, column, value) == -1) return -1;
+
+    for(int slot = 0; slot < grid->slotCount; slot++)
+    {
+        if(grid->slotRows[slot] != row) continue;
+
+        Tree *cell = grid->slotCells[slot * grid->columns + column];
+        if(RowModelBindCell(grid->model, TreeGetId(grid->grid), cell, row) == -1) return -1;
+        return applyValue(grid, cell, column) == -1 ? -1 : 1;
+    }
+
+    return 1;
+}
+
+
+
+
+void VirtualGridFree(VirtualGrid *grid)
+{
+    // Check the input parameter
+    if(!grid) return;
+
+    for(int column = 0; column < grid->columns && grid->unbound; column++) FrozenHashMapRelease(grid->unbound[column]);
+
+    free(grid->slotRows);
+    free(grid->slotCells);
+    free(grid->boundNames);
+    free(grid->unbound);
+    free(grid);
+}
@@ -0,0 +1,70 @@
+/***************************************************************************************************
+ * @file VirtualGrid.h                                                                             *
+ * @brief Defines the grids that only materialize the rows in view                                 *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see VirtualGrid.c                                                                              *
+ **************************************************************************************************/
+
+#ifndef VIRTUAL_GRID_H
+#define VIRTUAL_GRID_H
+
+#include <gtk/gtk.h>
+#include "../DataStructure/Tree/Tree.h"
+#include "../DataStructure/Tree/RowModel.h"
+
+#define VIRTUAL_GRID_DEFAULT_OVERSCAN 8    ///< The number of rows materialized above and below the viewport by default
+
+typedef struct VirtualGrid VirtualGrid;
+
+/**
+ * @brief Starts materializing the rows of a grid node around a viewport
+ * 
+ * Only the rows in the viewport, plus an overscan margin on each side, have nodes and widgets.
+ * When the viewport moves, the rows leaving it are rebound to the rows entering it, so the
+ * widgets are reused, and the margins of the grid stand for the other rows so its height and
+ * the position of the visible rows are the same as if every row was there.
+ * 
+ * @param node A realized grid node with a row model (see TreeSetRowModel) and no children
+ * @param rowHeight The height of a row, row spacing included, in pixels
+ * @param overscan The number of rows materialized above and below the viewport
+ * @return VirtualGrid* The virtualized grid, or NULL if any error occurs
+ * 
+ * @warning Must be used from the main thread
+ */
+VirtualGrid *VirtualGridNew(Tree *node, int rowHeight, int overscan);
+
+
+/**
+ * @brief Moves the viewport, materializing the rows entering it and releasing the rows leaving it
+ * @param grid The virtualized grid
+ * @param firstRow The first visible row
+ * @param visibleRows The number of visible rows
+ * @return The number of rows bound to new data, or -1 if any error occurs
+ */
+int VirtualGridSetViewport(VirtualGrid *grid, int firstRow, int visibleRows);
+
+
+/**
+ * @brief Changes the value of a cell, its widget is updated if the row is materialized
+ * @param grid The virtualized grid
+ * @param row The row of the cell
+ * @param column The column of the cell
+ * @param value The new value, or NULL
+ * @return 1 on success, -1 if any error occurs
+ */
+int VirtualGridSetValue(VirtualGrid *grid, int row, int column, const char *value);
+
+
+/**
+ * @brief Frees a virtualized grid, the materialized rows stay in the grid node
+ * @param grid The virtualized grid to free
+ */
+void VirtualGridFree(VirtualGrid *grid);
+
+#endif // VIRTUAL_GRID_H
@@ -0,0 +1,184 @@
+/***************************************************************************************************
+ * @file WidgetPool.c                                                                              *
+ * @brief The implementation of the pools of reusable widgets                                      *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see WidgetPool.h                                                                               *
+ **************************************************************************************************/
+
+#include "WidgetPool.h"
+#include "AttributeRegistry.h"
+#include "Renderer.h"
+
+/**
+ * @brief The widgets kept for one widget type, each holding a reference
+ */
+static struct
+{
+    GtkWidget **widgets;        ///< The pooled widgets, the last one is taken first
+    WidgetPoolStats stats;      ///< The counters and the capacity
+    int initialized;            ///< Set once the capacity was given its default value
+} pools[WIDGET_TYPE_COUNT];
+
+
+/** @brief Gives the pool of a type its default capacity on first use */
+static void initializePool(widgetType type)
+{
+    if(pools[type].initialized) return;
+    pools[type].initialized = 1;
+    pools[type].stats.capacity = type == window ? 0 : WIDGET_POOL_DEFAULT_CAPACITY;
+}
+
+
+/** @brief Destroys a widget no longer in any parent, the caller's reference is released */
+static void destroyWidget(GtkWidget *widget)
+{
+    if(GTK_IS_WINDOW(widget)) gtk_window_destroy(GTK_WINDOW(widget));
+    g_object_unref(widget);
+}
+
+
+
+
+int WidgetPoolSetCapacity(widgetType type, int capacity)
+{
+    // Check the input parameters
+    if((int)type < 0 || type >= WIDGET_TYPE_COUNT || capacity < 0) return -1;
+    if(type == window && capacity) return -1;
+
+    initializePool(type);
+
+    // Destroy the widgets that no longer fit
+    while(pools[type].stats.size > capacity)
+    {
+        destroyWidget(pools[type].widgets[--pools[type].stats.size]);
+        pools[type].stats.dropped++;
+    }
+
+    GtkWidget **widgets = realloc(pools[type].widgets, (capacity ? capacity : 1) * sizeof(GtkWidget *));
+    if(!widgets) return -1;
+
+    pools[type].widgets = widgets;
+    pools[type].stats.capacity = capacity;
+
+    return 1;
+}
+
+
+
+
+GtkWidget *WidgetPoolTake(widgetType type)
+{
+    // Check the input parameter
+    if((int)type < 0 || type >= WIDGET_TYPE_COUNT) return NULL;
+
+    initializePool(type);
+    if(!pools[type].stats.size)
+    {
+        pools[type].stats.misses++;
+        return NULL;
+    }
+
+    pools[type].stats.hits++;
+    GtkWidget *widget = pools[type].widgets[--pools[type].stats.size];
+
+    // Hand the pool's reference over as a floating one, like a new widget
+    g_object_force_floating(G_OBJECT(widget));
+    return widget;
+}
+
+
+
+
+int WidgetPoolRecycle(widgetType type, GtkWidget *widget, const FrozenHashMap *attributes)
+{
+    // Check the input parameters
+    if((int)type < 0 || type >= WIDGET_TYPE_COUNT || !widget) return -1;
+
+    initializePool(type);
+
+    // Own the widget before its parent lets it go
+    g_object_ref_sink(widget);
+    RendererDetachWidget(widget);
+
+    if(pools[type].stats.size == pools[type].stats.capacity)
+    {
+        destroyWidget(widget);
+        pools[type].stats.dropped++;
+        return 0;
+    }
+
+    // The array is only allocated once something is pooled
+    if(!pools[type].widgets && WidgetPoolSetCapacity(type, pools[type].stats.capacity) == -1)
+    {
+        destroyWidget(widget);
+        return -1;
+    }
+
+    AttributeRegistryReset(type, widget, attributes);
+    pools[type].widgets[pools[type].stats.size++] = widget;
+    pools[type].stats.recycled++;
+
+    return 1;
+}
+
+
+
+
+int WidgetPoolRecycleTree(Tree *node)
+{
+    // Check the input parameter
+    if(!node) return -1;
+
+    TreeIterator *iterator = TreeIteratorNew(node, treePostOrder);
+    if(!iterator) return -1;
+
+    int pooled = 0;
+    for(Tree *current; (current = TreeIteratorNext(iterator));)
+    {
+        GtkWidget *widget = TreeGetWidget(current);
+        if(!widget) continue;
+
+        TreeSetWidget(current, NULL);
+        if(WidgetPoolRecycle(TreeGetType(current), widget, TreeFreezeAttributes(current)) == 1) pooled++;
+    }
+
+    TreeIteratorFree(iterator);
+    return pooled;
+}
+
+
+
+
+int WidgetPoolGetStats(widgetType type, WidgetPoolStats *stats)
+{
+    // Check the input parameters
+    if((int)type < 0 || type >= WIDGET_TYPE_COUNT || !stats) return -1;
+
+    initializePool(type);
+    *stats = pools[type].stats;
+
+    return 1;
+}
+
+
+
+
+void WidgetPoolClear(void)
+{
+    for(int type = 0; type < WIDGET_TYPE_COUNT; type++)
+    {
+        while(pools[type].stats.size) destroyWidget(pools[type].widgets[--pools[type].stats.size]);
+
+        int capacity = pools[type].stats.capacity;
+        free(pools[type].widgets);
+        pools[type].widgets = NULL;
+        pools[type].stats = (WidgetPoolStats){ 0 };
+        pools[type].stats.capacity = capacity;
+    }
+}
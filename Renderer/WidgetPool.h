@@ -0,0 +1,97 @@
+/***************************************************************************************************
+ * @file WidgetPool.h                                                                              *
+ * @brief Defines the pools of widgets reused by the Renderer                                      *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see WidgetPool.c                                                                               *
+ **************************************************************************************************/
+
+#ifndef WIDGET_POOL_H
+#define WIDGET_POOL_H
+
+#include <gtk/gtk.h>
+#include "../DataStructure/Tree/Tree.h"
+
+#define WIDGET_POOL_DEFAULT_CAPACITY 64    ///< The number of widgets a pool keeps by default (windows are never kept)
+
+/**
+ * @brief The counters of the pool of one widget type
+ */
+typedef struct
+{
+    unsigned long hits;         ///< The widgets taken from the pool
+    unsigned long misses;       ///< The widgets that had to be created because the pool was empty
+    unsigned long recycled;     ///< The widgets returned to the pool
+    unsigned long dropped;      ///< The widgets destroyed because the pool was full
+    int size;                   ///< The number of widgets in the pool
+    int capacity;               ///< The maximum number of widgets in the pool
+} WidgetPoolStats;
+
+
+/**
+ * @brief Sets the number of widgets the pool of a type can keep, the extra widgets are destroyed
+ * @param type The widget type
+ * @param capacity The maximum number of widgets, 0 disables the pool
+ * @return 1 on success, -1 if any error occurs (e.g., a capacity for windows, which cannot be pooled)
+ * 
+ * @warning The pools must only be used from the main thread
+ */
+int WidgetPoolSetCapacity(widgetType type, int capacity);
+
+
+/**
+ * @brief Takes a widget from the pool of a type
+ * 
+ * The widget is returned floating, as if it was just created, with its attributes reset.
+ * 
+ * @param type The widget type
+ * @return GtkWidget* The widget, or NULL if the pool is empty (counted as a miss)
+ */
+GtkWidget *WidgetPoolTake(widgetType type);
+
+
+/**
+ * @brief Removes a widget from its parent, resets the attributes applied to it and keeps it in the pool of its type
+ * 
+ * The widget must not hold children anymore: the widgets of child nodes are recycled (or
+ * removed) first. Signal handlers connected by the application are not disconnected.
+ * 
+ * @param type The widget type of the widget
+ * @param widget The widget to recycle
+ * @param attributes The attributes that were applied to the widget, or NULL if none
+ * @return 1 if the widget was pooled, 0 if it was destroyed because the pool is full, -1 if any error occurs
+ */
+int WidgetPoolRecycle(widgetType type, GtkWidget *widget, const FrozenHashMap *attributes);
+
+
+/**
+ * @brief Recycles the widgets of a node and its descendants, children first, and clears them from the nodes
+ * 
+ * To be called before the node is removed (e.g., by TreeRemoveChild or TreeUpdateNode).
+ * 
+ * @param node The root of the subtree whose widgets are recycled
+ * @return The number of widgets pooled, or -1 if any error occurs
+ */
+int WidgetPoolRecycleTree(Tree *node);
+
+
+/**
+ * @brief Returns the counters of the pool of a type
+ * @param type The widget type
+ * @param stats Where the counters are written
+ * @return 1 on success, -1 if any error occurs
+ */
+int WidgetPoolGetStats(widgetType type, WidgetPoolStats *stats);
+
+
+/**
+ * @brief Destroys the widgets of every pool and resets the counters, the capacities are kept
+ */
+void WidgetPoolClear(void);
+
+#endif // WIDGET_POOL_H
@@ -1,11 +1,17 @@
 
 #include "Scanner.h"
+#include "../Utils/Trace.h"
+#include "../Utils/Entities.h"
 #include <stdio.h>
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <setjmp.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 char readChar(FILE *file, int *line) {
     char c = fgetc(file);
@@ -15,44 +21,87 @@ char readChar(FILE *file, int *line) {
 
 
 
-int isValidAttributes(char *attribute) {
+// Cherche la fin d'une valeur (son délimiteur ou un caractère interdit) et note si elle contient un '&',
+// seize caractères à la fois quand SSE2 est disponible
+static char *scanValue(char *ptr, const char *end, char delim, int *escaped) {
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8(delim), less = _mm_set1_epi8('<'), greater = _mm_set1_epi8('>');
+    const __m128i zero = _mm_setzero_si128(), ampersand = _mm_set1_epi8('&');
+    while (end - ptr >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)ptr);
+        __m128i stops = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, zero)),
+                                     _mm_or_si128(_mm_cmpeq_epi8(chunk, less), _mm_cmpeq_epi8(chunk, greater)));
+        unsigned stopMask = (unsigned)_mm_movemask_epi8(stops);
+        unsigned ampersandMask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, ampersand));
+
+        // Seuls les '&' avant la fin de la valeur comptent
+        if (stopMask) {
+            int index = __builtin_ctz(stopMask);
+            if (ampersandMask & ((1u << index) - 1)) *escaped = 1;
+            return ptr + index;
+        }
+        if (ampersandMask) *escaped = 1;
+        ptr += 16;
+    }
+#else
+    (void)end;
+#endif
+    while (*ptr != delim && *ptr != '\0' && *ptr != '<' && *ptr != '>') {
+        if (*ptr == '&') *escaped = 1;
+        ptr++;
+    }
+    return ptr;
+}
+
+// Valide et extrait les paires nom/valeur en une seule passe, directement dans la HashMap
+// (les noms et les valeurs sont terminés sur place, chaque nom ne peut apparaître qu'une fois,
+// les entités des valeurs ne sont décodées que si la valeur est lue)
+int parseAttributes(char *attribute, size_t length, HashMap *attributes) {
     char *ptr = attribute;
+    const char *end = attribute + length;
+    int count = 0;
     while (1) {
         // Ignorer les espaces
         while (isspace((unsigned char)*ptr)) ptr++;
-        if (*ptr == '\0') break;
+        if (*ptr == '\0') return count;
 
         // Extraire le nom de l'attribut
-        char *attr_start = ptr;
-        while (*ptr != '\0' && !isspace(*ptr) && *ptr != '=') ptr++;
-        if (attr_start == ptr) return 0;
+        char *nameStart = ptr;
+        while (*ptr != '\0' && !isspace((unsigned char)*ptr) && *ptr != '=') ptr++;
+        char *nameEnd = ptr;
+        if (nameStart == nameEnd) return -1;
 
-        // Passer à '='
-        while (isspace(*ptr)) ptr++;
-        if (*ptr != '=') return 0;
+        // Passer le '=' et les espaces jusqu'au délimiteur
+        while (isspace((unsigned char)*ptr)) ptr++;
+        if (*ptr != '=') return -1;
         ptr++;
-
-        // Passer à la valeur
-        while (isspace(*ptr)) ptr++;
+        while (isspace((unsigned char)*ptr)) ptr++;
 
         char delim = *ptr;
-        if (delim != '"' && delim != '\'') return 0;
+        if (delim != '"' && delim != '\'') return -1;
         ptr++;
 
-        // Vérifier les caractères interdits dans la valeur
-        while (*ptr != delim && *ptr != '\0') {
-            if (*ptr == '<' || *ptr == '>') return 0;
-            ptr++;
-        }
-        if (*ptr != delim) return 0;
-        ptr++;
+        // Extraire la valeur en vérifiant les caractères interdits
+        char *valueStart = ptr;
+        int escaped = 0;
+        ptr = scanValue(ptr, end, delim, &escaped);
+        if (*ptr != delim) return -1;
+
+        // Terminer le nom et la valeur sur place, un nom déjà présent est une erreur
+        *nameEnd = '\0';
+        *ptr++ = '\0';
+        int result = HashMapPutEscaped(attributes, nameStart, valueStart, escaped);
+        if (result == -1) return -2;
+        if (result != 1) return -1;
+        count++;
     }
-    return 1;
 }
 
-// Structure pour un nœud de la stack (chaîne + pointeur vers le suivant)
+// Structure pour un nœud de la stack (chaîne + nœud de l'arbre + pointeur vers le suivant)
 typedef struct StackNode {
     char* data;
+    Tree* node;
+    int textRun;    // L'indice du texte du nœud dans ScannerState.runs, -1 s'il n'en a pas encore
     struct StackNode* next;
 } StackNode;
 
@@ -61,13 +110,10 @@ typedef struct {
     StackNode* top;
 } StringStack;
 
-// Initialise une stack vide
+// Initialise une stack vide (NULL si l'allocation échoue)
 StringStack* StackCreate() {
-    StringStack* stack = (StringStack*)malloc(sizeof(StringStack));
-    if (!stack) {
-        fprintf(stderr, "Erreur d'allocation mémoire\n");
-        exit(EXIT_FAILURE);
-    }
+    StringStack* stack = (StringStack*)AllocatorAlloc(allocatorScanner, sizeof(StringStack));
+    if (!stack) return NULL;
     stack->top = NULL;
     return stack;
 }
@@ -77,23 +123,23 @@ bool StackIsEmpty(StringStack* stack) {
     return (stack->top == NULL);
 }
 
-// Empile une chaîne (alloue dynamiquement une copie)
-void StackPush(StringStack* stack, const char* str) {
-    StackNode* newNode = (StackNode*)malloc(sizeof(StackNode));
-    if (!newNode) {
-        fprintf(stderr, "Erreur d'allocation mémoire\n");
-        exit(EXIT_FAILURE);
-    }
+// Empile une chaîne (alloue dynamiquement une copie) et le nœud de l'arbre associé,
+// retourne false si l'allocation échoue (la stack est alors inchangée)
+bool StackPush(StringStack* stack, const char* str, Tree* node) {
+    StackNode* newNode = (StackNode*)AllocatorAlloc(allocatorScanner, sizeof(StackNode));
+    if (!newNode) return false;
 
-    newNode->data = strdup(str); // Copie la chaîne
+    newNode->data = AllocatorStrdup(allocatorScanner, str); // Copie la chaîne
     if (!newNode->data) {
-        fprintf(stderr, "Erreur de duplication de chaîne\n");
-        free(newNode);
-        exit(EXIT_FAILURE);
+        AllocatorFree(allocatorScanner, newNode, sizeof(StackNode));
+        return false;
     }
 
+    newNode->node = node;
+    newNode->textRun = -1;
     newNode->next = stack->top;
     stack->top = newNode;
+    return true;
 }
 
 // Dépile et retourne la chaîne (libère la mémoire du nœud)
@@ -106,11 +152,29 @@ char* StackPop(StringStack* stack) {
     StackNode* temp = stack->top;
     char* poppedData = temp->data; // Récupère la chaîne avant de libérer le nœud
     stack->top = temp->next;
-    free(temp); // Libère le nœud (mais pas la chaîne, car elle est retournée)
+    AllocatorFree(allocatorScanner, temp, sizeof(StackNode)); // Libère le nœud (mais pas la chaîne, car elle est retournée)
 
     return poppedData;
 }
 
+// Retourne le nœud de l'arbre au sommet de la stack (NULL si elle est vide)
+Tree* StackPeekNode(StringStack* stack) {
+    if (StackIsEmpty(stack)) return NULL;
+    return stack->top->node;
+}
+
+// Libère une chaîne retournée par StackPop
+void StackFreeString(char* str) {
+    if (str) AllocatorFree(allocatorScanner, str, strlen(str) + 1);
+}
+
+// Libère la stack et les chaînes qu'elle contient encore
+void StackFree(StringStack* stack) {
+    if (!stack) return;
+    while (!StackIsEmpty(stack)) StackFreeString(StackPop(stack));
+    AllocatorFree(allocatorScanner, stack, sizeof(StringStack));
+}
+
 int isWhiteSpace(char character, int *line){
     if (character == ' ' || character == '\n' || character == '\t') {
         return 1;
@@ -126,16 +190,388 @@ int isLetter(char character){
     return 0;
 }
 
-StringStack* TagStack;
+/**
+ * @brief One part of the text of an element, the parts being split by its children or by comments
+ */
+struct TextSegment {
+    size_t offset;  ///< The offset of the part in ScannerState.text
+    size_t length;  ///< The length of the part, followed by a NUL
+    int next;       ///< The index of the next part of the same element, -1 for the last one
+};
+
+/**
+ * @brief The text of an element, its parts joined by a space
+ */
+struct TextRun {
+    Tree *node;     ///< The element
+    int first;      ///< The index of its first part in ScannerState.segments
+    int last;       ///< The index of its last part
+    size_t length;  ///< The length of the joined text
+};
+
+/**
+ * @brief The state of one analysis, so that several files can be analysed at the same time
+ */
+typedef struct {
+    StringStack *tagStack;  ///< The opening tags waiting for their closing tag
+    Tree *root;             ///< The first element of the document
+    int generatedIds;       ///< The number of ids generated for elements without an "id" attribute
+    long builtNodes;        ///< The number of nodes built, given to the trace
+    char *buffer;           ///< The attributes of the current tag, reused by every tag
+    size_t capacity;        ///< The size of the buffer
+    char *text;             ///< The text content of the document, the elements get slices of it
+    size_t textLength;      ///< The bytes used in the text
+    size_t textCapacity;    ///< The size of the text
+    struct TextRun *runs;   ///< The text of each element having some
+    int runCount;           ///< The number of runs
+    int runCapacity;        ///< The size of the runs
+    struct TextSegment *segments;   ///< The parts of the texts, in the order they were read
+    int segmentCount;       ///< The number of segments
+    int segmentCapacity;    ///< The size of the segments
+    jmp_buf *onError;       ///< Where an invalid markup or an allocation failure goes back to, NULL to exit the process
+    int errorLine;          ///< The line of the error (or SCANNER_OUT_OF_MEMORY), once onError was jumped to
+} ScannerState;
+
+
+/**
+ * @brief Reports an invalid markup: goes back to tryLexicalAnalysis, or exits the process
+ */
+_Noreturn static void syntaxError(ScannerState *state, int line) {
+    if (state->onError) {
+        state->errorLine = line;
+        longjmp(*state->onError, 1);
+    }
+
+    printf("Error at line %d\n", line);
+    exit(1);
+}
+
+
+/**
+ * @brief Reports an allocation failure: goes back to tryLexicalAnalysis, or exits the process
+ */
+_Noreturn static void outOfMemory(ScannerState *state) {
+    if (state->onError) {
+        state->errorLine = SCANNER_OUT_OF_MEMORY;
+        longjmp(*state->onError, 1);
+    }
+
+    fprintf(stderr, "Erreur d'allocation mémoire\n");
+    exit(EXIT_FAILURE);
+}
+
 
+// Agrandit le tampon des attributs (il n'a pas de taille maximale)
+static void growBuffer(ScannerState *state) {
+    size_t capacity = state->capacity ? state->capacity * 2 : 256;
+    char *buffer = (char *)AllocatorRealloc(allocatorScanner, state->buffer, state->capacity, capacity);
+    if (!buffer) outOfMemory(state);
+
+    state->buffer = buffer;
+    state->capacity = capacity;
+}
+
+
+/**
+ * @brief Makes room for some more bytes at the end of the text of the document
+ */
+static void reserveText(ScannerState *state, size_t bytes) {
+    if (state->textLength + bytes <= state->textCapacity) return;
+
+    size_t capacity = state->textCapacity ? state->textCapacity : 256;
+    while (capacity < state->textLength + bytes) capacity *= 2;
+
+    // The text goes to the tree once the document is read, so it is counted for the trees
+    char *text = (char *)AllocatorRealloc(allocatorTree, state->text, state->textCapacity, capacity);
+    if (!text) outOfMemory(state);
+
+    state->text = text;
+    state->textCapacity = capacity;
+}
+
+
+/**
+ * @brief Grows an array of records of the scanner (the runs or the segments) to hold one more
+ */
+static void *reserveRecord(ScannerState *state, void *records, int count, int *capacity, size_t size) {
+    if (count < *capacity) return records;
+
+    int grown = *capacity ? *capacity * 2 : 64;
+    records = AllocatorRealloc(allocatorScanner, records, *capacity * size, grown * size);
+    if (!records) outOfMemory(state);
+
+    *capacity = grown;
+    return records;
+}
+
+
+/**
+ * @brief Starts a new part of the text of the open element, at the end of the text of the document
+ * 
+ * The parts of an element are only joined once the document is read (see attachText), so a text
+ * split by many children is not moved each time it goes on.
+ * 
+ * @return The run of the element, its last segment being the new part
+ */
+static struct TextRun *openTextRun(ScannerState *state, StackNode *element) {
+    state->segments = (struct TextSegment *)reserveRecord(state, state->segments, state->segmentCount,
+        &state->segmentCapacity, sizeof(struct TextSegment));
+    int segment = state->segmentCount++;
+    state->segments[segment] = (struct TextSegment){ state->textLength, 0, -1 };
+
+    if (element->textRun == -1) {
+        state->runs = (struct TextRun *)reserveRecord(state, state->runs, state->runCount, &state->runCapacity, sizeof(struct TextRun));
+        element->textRun = state->runCount;
+        state->runs[state->runCount++] = (struct TextRun){ element->node, segment, segment, 0 };
+        return &state->runs[element->textRun];
+    }
+
+    // The parts are joined by a space
+    struct TextRun *run = &state->runs[element->textRun];
+    state->segments[run->last].next = segment;
+    run->last = segment;
+    run->length++;
+    return run;
+}
+
+
+/**
+ * @brief Reads a text up to the next tag, into the text of the element it is in
+ * 
+ * The white spaces around each text are dropped (the caller skipped the leading ones), and the
+ * texts of an element split by its children or by comments are joined by a space.
+ * 
+ * @return The character ending the text, '<' or EOF
+ */
+static char handleText(ScannerState *state, FILE *file, char character, int *line) {
+    // Text is only allowed inside an element
+    StackNode *element = state->tagStack->top;
+    if (!element) syntaxError(state, *line);
+
+    struct TextRun *run = openTextRun(state, element);
+    size_t start = state->textLength;
+    int escaped = 0;
+    while (character != '<' && character != EOF) {
+        if (character == '&') escaped = 1;
+
+        reserveText(state, 2);
+        state->text[state->textLength++] = character;
+        character = readChar(file, line);
+    }
+
+    // Drop the trailing white spaces, then decode the entities in place (they only get shorter)
+    while (state->textLength > start && isWhiteSpace(state->text[state->textLength - 1], line)) state->textLength--;
+    state->text[state->textLength] = '\0';
+    if (escaped) state->textLength = start + EntitiesDecode(state->text + start, state->text + start);
+
+    state->segments[run->last].length = state->textLength - start;
+    run->length += state->textLength - start;
+    state->textLength++;
+    return character;
+}
+
+
+/**
+ * @brief Gives the elements their text, as slices of one block holding the text of the document
+ * 
+ * When no element had its text split, the text is already made of the slices and becomes the
+ * block as it is. Otherwise the parts of each element are joined into a new text, once.
+ */
+static void attachText(ScannerState *state) {
+    if (state->runCount) {
+        int split = 0;
+        size_t length = 0;
+        for (int i = 0; i < state->runCount; i++) {
+            if (state->runs[i].first != state->runs[i].last) split = 1;
+            length += state->runs[i].length + 1;
+        }
+
+        char *text = NULL;
+        if (split) {
+            text = (char *)AllocatorAlloc(allocatorTree, length);
+            if (text) {
+                // Join the parts of each element, then give its slice the offsets in the new text
+                size_t offset = 0;
+                for (int i = 0; i < state->runCount; i++) {
+                    struct TextRun *run = &state->runs[i];
+                    size_t start = offset;
+                    for (int segment = run->first; segment != -1; segment = state->segments[segment].next) {
+                        if (offset > start) text[offset++] = ' ';
+                        memcpy(text + offset, state->text + state->segments[segment].offset, state->segments[segment].length);
+                        offset += state->segments[segment].length;
+                    }
+                    text[offset++] = '\0';
+                    state->segments[run->first] = (struct TextSegment){ start, run->length, -1 };
+                }
+            }
+        } else {
+            // Give back the unused end of the text before it becomes the block
+            text = (char *)AllocatorRealloc(allocatorTree, state->text, state->textCapacity, length);
+        }
+        if (!text) outOfMemory(state);
+
+        // The block takes the text, and frees it if it cannot be made
+        if (split) AllocatorFree(allocatorTree, state->text, state->textCapacity);
+        state->text = NULL;
+        state->textCapacity = 0;
+        TextBlock *block = TextBlockAdopt(text, length);
+        if (!block) outOfMemory(state);
+        for (int i = 0; i < state->runCount; i++) {
+            struct TextSegment *segment = &state->segments[state->runs[i].first];
+            TreeSetText(state->runs[i].node, block, segment->offset, segment->length);
+        }
+        TextBlockRelease(block);
+    } else {
+        AllocatorFree(allocatorTree, state->text, state->textCapacity);
+        state->text = NULL;
+        state->textCapacity = 0;
+    }
+
+    AllocatorFree(allocatorScanner, state->runs, state->runCapacity * sizeof(struct TextRun));
+    AllocatorFree(allocatorScanner, state->segments, state->segmentCapacity * sizeof(struct TextSegment));
+    state->runs = NULL;
+    state->segments = NULL;
+    state->runCapacity = state->segmentCapacity = 0;
+}
 
-void handleClosingTag(FILE *file, char *character, int *line){
+
+/**
+ * @brief Tells if the '>' at an index of a block ends a comment, the two bytes before the block are given
+ */
+static int isCommentEnd(const char *block, size_t index, const char previous[2]) {
+    char first = index >= 2 ? block[index - 2] : previous[index];
+    char second = index >= 1 ? block[index - 1] : previous[1];
+    return first == '-' && second == '-';
+}
+
+
+/**
+ * @brief Searches a block of a comment for its "-->", counting the lines up to it
+ * 
+ * The '>' and the new lines are looked for sixteen bytes at a time when SSE2 is available.
+ * 
+ * @return The index following the "-->", or 0 if the comment goes on
+ */
+static size_t findCommentEnd(const char *block, size_t count, char previous[2], int *line) {
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i greater = _mm_set1_epi8('>'), newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= count; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(block + i));
+        unsigned ends = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, greater));
+        unsigned newlines = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+
+        for (; ends; ends &= ends - 1) {
+            int index = __builtin_ctz(ends);
+            if (isCommentEnd(block, i + index, previous)) {
+                *line += __builtin_popcount(newlines & ((1u << index) - 1));
+                return i + index + 1;
+            }
+        }
+        *line += __builtin_popcount(newlines);
+    }
+#endif
+    for (; i < count; i++) {
+        if (block[i] == '>' && isCommentEnd(block, i, previous)) return i + 1;
+        if (block[i] == '\n') (*line)++;
+    }
+
+    // Keep the end of the block, the "--" may be split between two blocks
+    previous[0] = count >= 2 ? block[count - 2] : previous[1];
+    previous[1] = block[count - 1];
+    return 0;
+}
+
+
+/**
+ * @brief Skips a comment, the "<!" being read, up to the end of its "-->"
+ * 
+ * The body is read by blocks and searched without going through readChar, then what follows
+ * the comment is given back to the file. A file that cannot seek is read a character at a time.
+ */
+static void skipComment(ScannerState *state, FILE *file, int *line) {
+    if (readChar(file, line) != '-' || readChar(file, line) != '-') syntaxError(state, *line);
+
+    if (ftell(file) == -1) {
+        int dashes = 0;
+        char character;
+        while ((character = readChar(file, line)) != EOF) {
+            if (character == '>' && dashes >= 2) return;
+            dashes = character == '-' ? dashes + 1 : 0;
+        }
+        syntaxError(state, *line);
+    }
+
+    char block[4096];
+    char previous[2] = { 0, 0 };
+    size_t count;
+    while ((count = fread(block, 1, sizeof(block), file)) > 0) {
+        size_t end = findCommentEnd(block, count, previous, line);
+        if (!end) continue;
+
+        if (fseek(file, (long)end - (long)count, SEEK_CUR) != 0) syntaxError(state, *line);
+        return;
+    }
+
+    // The comment is not closed
+    syntaxError(state, *line);
+}
+
+
+void openElement(ScannerState *state, const char *tagName, HashMap *attributes, int isSelfClosing, int line)
+{
+    TRACE_BEGIN(build, "build");
+    if (!attributes) outOfMemory(state);
+
+    // The tag name must be a known widget
+    widgetType type = WidgetTypeFromName(tagName);
+    if ((int)type == -1) {
+        HashMapFree(attributes);
+        syntaxError(state, line);
+    }
+
+    // Take the id from the attributes, or generate one
+    char *id;
+    if (HashMapContainsKey(attributes, "id") == 1) {
+        id = g_strdup(HashMapGet(attributes, "id"));
+        HashMapRemove(attributes, "id");
+    } else {
+        id = g_strdup_printf("%s-%d", tagName, ++state->generatedIds);
+    }
+
+    // The node takes the id and the attributes as they are, nothing is copied
+    Tree *node = TreeNewAdopt(type, id, NULL, attributes);
+    if (!node) outOfMemory(state);
+
+    // Attach the element to the currently open element, only one root is allowed
+    Tree *parent = StackPeekNode(state->tagStack);
+    if (parent) {
+        if (TreeAddChild(parent, node) == -1) {
+            TreeDestroy(node);
+            outOfMemory(state);
+        }
+    }
+    else if (!state->root) state->root = node;
+    else {
+        TreeDestroy(node);
+        syntaxError(state, line);
+    }
+
+    // Wait for the closing tag if the element is not self closing
+    if (!isSelfClosing && !StackPush(state->tagStack, tagName, node)) outOfMemory(state);
+
+    state->builtNodes++;
+    TRACE_END(build, 1, 0);
+}
+
+
+void handleClosingTag(ScannerState *state, FILE *file, char *character, int *line){
     // Skip white spaces
     *character = readChar(file, line);
     while (isWhiteSpace(*character, line)) *character = readChar(file, line);
 
     // If the character is not a literal so Error
-    if (!isLetter(*character)) { printf("Error at line %d\n", *line); exit(1); }
+    if (!isLetter(*character)) syntaxError(state, *line);
 
     // Get the closing tag name
     char closingTagName[10000];
@@ -147,19 +583,22 @@ void handleClosingTag(FILE *file, char *character, int *line){
     closingTagName[index] = '\0';
 
     // If the closing tag name is not equal to the opening tag name so Error
-    char *openingTagName = StackPop(TagStack);
-    if(!openingTagName) { printf("Error at line %d\n", *line); exit(1); }
-    if  (strcmp(closingTagName, openingTagName) != 0)
-        { printf("Error at line %d\n", *line); exit(1); }
+    char *openingTagName = StackPop(state->tagStack);
+    if(!openingTagName) syntaxError(state, *line);
+    if  (strcmp(closingTagName, openingTagName) != 0) {
+        StackFreeString(openingTagName);
+        syntaxError(state, *line);
+    }
+    StackFreeString(openingTagName);
 
     // Skip white spaces
     while (isWhiteSpace(*character, line)) *character = readChar(file, line);
 
     // If the character is not a '>' so Error
-    if (*character != '>') { printf("Error at line %d\n", *line); exit(1); }
+    if (*character != '>') syntaxError(state, *line);
 }
 
-void handleOpeningTag(FILE *file, char *character, int *line)
+void handleOpeningTag(ScannerState *state, FILE *file, char *character, int *line)
 {
     // Get the tag name
     char tagName[100];
@@ -172,61 +611,88 @@ void handleOpeningTag(FILE *file, char *character, int *line)
 
     // check if the *character is not a white space and not '>', Error
     if (!isWhiteSpace(*character, line) && *character != '>' && *character != '/')
-        { printf("Error at line %d\n", *line); exit(1); }
+        syntaxError(state, *line);
 
-    // If the *character is '>' so is a self closing tag
+    // If the *character is '/' so is a self closing tag
     if (*character == '/'){
         *character = readChar(file, line);
         while(isWhiteSpace(*character, line)) *character = readChar(file, line);
-        if(*character != '>') { printf("Error at line %d\n", *line); exit(1); }
+        if(*character != '>') syntaxError(state, *line);
+        openElement(state, tagName, HashMapNew(), 1, *line);
+        return;
     }
 
-    if (*character == '>'){ StackPush(TagStack, tagName); return; }
+    if (*character == '>'){ openElement(state, tagName, HashMapNew(), 0, *line); return; }
 
     // Skip  white spaces
     while (isWhiteSpace(*character, line)) *character = readChar(file, line);
 
     // Check for attributes
     if (!isLetter(*character) && *character != '>' && *character != '/')
-        { printf("Error at line %d\n", *line); exit(1); }
+        syntaxError(state, *line);
 
-    if(*character == '>') { StackPush(TagStack, tagName); return; }
+    if(*character == '>') { openElement(state, tagName, HashMapNew(), 0, *line); return; }
 
     if(*character == '/') {
         *character = readChar(file, line);
         while(isWhiteSpace(*character, line)) *character = readChar(file, line);
-        if(*character != '>') { printf("Error at line %d\n", *line); exit(1); }
+        if(*character != '>') syntaxError(state, *line);
+        openElement(state, tagName, HashMapNew(), 1, *line);
+        return;
     }
 
-    // Get attributes
-    char attributeName[MAX];
-    int index2 = 0;
+    // Get the attributes, however long they are, counting the pairs on the way
+    size_t length = 0;
     int isQuoted = 0;
+    int pairs = 0;
     while (*character != '>' && *character != '<' && *character != EOF){
 
         if(*character == '"' || *character == '\'') isQuoted = !isQuoted;
         if(*character == '/' && !isQuoted) break;
+        if(*character == '=' && !isQuoted) pairs++;
 
-        attributeName[index2++] = *character;
+        if(length + 1 >= state->capacity) growBuffer(state);
+        state->buffer[length++] = *character;
         *character = readChar(file, line);
     }
 
-    attributeName[index2] = '\0';
-
-    if(!isValidAttributes(attributeName)) { printf("Error at line %d\n", *line); exit(1); }
+    if(length + 1 >= state->capacity) growBuffer(state);
+    state->buffer[length] = '\0';
+
+    // Validate and store the pairs in one pass, in a HashMap sized for them
+    TRACE_BEGIN(attributeSpan, "attributes");
+    HashMap *attributes = HashMapNewWithCapacity(pairs);
+    if(!attributes) outOfMemory(state);
+    int parsed = parseAttributes(state->buffer, length, attributes);
+    if(parsed < 0) {
+        HashMapFree(attributes);
+        if(parsed == -2) outOfMemory(state);
+        syntaxError(state, *line);
+    }
+    TRACE_END(attributeSpan, 0, length);
 
-    if(*character == '>') { StackPush(TagStack, tagName); }
+    if(*character == '>') { openElement(state, tagName, attributes, 0, *line); return; }
     if(*character == '/') {
         *character = readChar(file, line);
         while(isWhiteSpace(*character, line)) *character = readChar(file, line);
-        if (*character != '>') { printf("Error at line %d\n", *line); exit(1); }
+        if (*character == '>') {
+            openElement(state, tagName, attributes, 1, *line);
+            return;
+        }
     }
+
+    // The tag was not closed by '>' or '/>'
+    HashMapFree(attributes);
+    syntaxError(state, *line);
 }
 
 
-void performLexicalAnalysis(FILE *file)
+/**
+ * @brief Reads a document into the state, the markup errors going through syntaxError
+ */
+static void analyse(ScannerState *state, FILE *file)
 {
-    TagStack = StackCreate();
+    TRACE_BEGIN(scan, "scan");
     char character;
     int line = 1;
 
@@ -237,34 +703,106 @@ void performLexicalAnalysis(FILE *file)
         while(isWhiteSpace(character, &line)) character = readChar(file, &line);
         if(character == EOF) break;
 
-        // If the character is not a '<' so Error
-        if (character != '<') { printf("Error at line %d\n", line); exit(1); }
+        // Any other character than '<' starts a text, up to the next tag
+        if (character != '<') character = handleText(state, file, character, &line);
+        if (character == EOF) break;
 
         //  Skip white spaces
         character = readChar(file, &line);
         while (isWhiteSpace(character, &line)) character = readChar(file, &line);
 
-        if (!isLetter(character) && character != '/')
-            { printf("Error at line %d\n", line); exit(1); }
+        // A comment is skipped whole
+        if (character == '!') { skipComment(state, file, &line); continue; }
+
+        if (!isLetter(character) && character != '/') syntaxError(state, line);
 
         // If the character is'/' so is a closing tag
-        if (character == '/') { handleClosingTag(file, &character, &line); continue; }
+        if (character == '/') { handleClosingTag(state, file, &character, &line); continue; }
 
         // If the character is not a letter so Error
-        if (!isLetter(character)) { printf("Error at line %d\n", line); exit(1); }
+        if (!isLetter(character)) syntaxError(state, line);
 
         // So is an opening tag
-        handleOpeningTag(file, &character, &line);
+        handleOpeningTag(state, file, &character, &line);
 
     }
 
-    if(!StackIsEmpty(TagStack)) { printf("Error at line %d\n", line); exit(1); }
+    if(!StackIsEmpty(state->tagStack)) syntaxError(state, line);
+    StackFree(state->tagStack);
+    AllocatorFree(allocatorScanner, state->buffer, state->capacity);
+    state->tagStack = NULL;
+    state->buffer = NULL;
+    state->capacity = 0;
+    attachText(state);
+
+    // The bytes scanned are the position reached in the file
+    TRACE_END(scan, state->builtNodes, ftell(file));
 }
 
-int main(){
-    FILE *file = fopen("../index.html", "r");
-    if (file == NULL) { printf("Error opening file\n"); exit(1); }
 
-    performLexicalAnalysis(file);
-    return 0;
+/**
+ * @brief Makes the state of a new analysis
+ * 
+ * @return The state, or NULL if the allocation fails
+ */
+static ScannerState *newState(jmp_buf *onError) {
+    ScannerState *state = (ScannerState *)AllocatorCalloc(allocatorScanner, 1, sizeof(ScannerState));
+    if (!state) return NULL;
+
+    state->tagStack = StackCreate();
+    if (!state->tagStack) {
+        AllocatorFree(allocatorScanner, state, sizeof(ScannerState));
+        return NULL;
+    }
+
+    state->onError = onError;
+    return state;
+}
+
+
+Tree *performLexicalAnalysis(FILE *file)
+{
+    ScannerState *state = newState(NULL);
+    if (!state) {
+        fprintf(stderr, "Erreur d'allocation mémoire\n");
+        exit(EXIT_FAILURE);
+    }
+    analyse(state, file);
+
+    Tree *root = state->root;
+    AllocatorFree(allocatorScanner, state, sizeof(ScannerState));
+    return root;
+}
+
+
+Tree *tryLexicalAnalysis(FILE *file, int *errorLine)
+{
+    // The state lives on the heap, so it is still up to date once an error jumped back here
+    jmp_buf onError;
+    ScannerState *state = newState(&onError);
+    if (!state) {
+        if (errorLine) *errorLine = SCANNER_OUT_OF_MEMORY;
+        return NULL;
+    }
+
+    if (setjmp(onError)) {
+        if (errorLine) *errorLine = state->errorLine;
+
+        // Free what was built before the error, what analyse and attachText freed is NULL
+        StackFree(state->tagStack);
+        AllocatorFree(allocatorScanner, state->buffer, state->capacity);
+        AllocatorFree(allocatorTree, state->text, state->textCapacity);
+        AllocatorFree(allocatorScanner, state->runs, state->runCapacity * sizeof(struct TextRun));
+        AllocatorFree(allocatorScanner, state->segments, state->segmentCapacity * sizeof(struct TextSegment));
+        TreeDestroyAll(state->root);
+        AllocatorFree(allocatorScanner, state, sizeof(ScannerState));
+        return NULL;
+    }
+
+    analyse(state, file);
+    if (errorLine) *errorLine = 0;
+
+    Tree *root = state->root;
+    AllocatorFree(allocatorScanner, state, sizeof(ScannerState));
+    return root;
 }
@@ -1,2 +1,64 @@
 
-#define MAX 10000
\ No newline at end of file
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <stdio.h>
+#include "../DataStructure/Tree/Tree.h"
+
+#define SCANNER_OUT_OF_MEMORY -1    ///< The error line given by tryLexicalAnalysis when an allocation fails
+
+/**
+ * @brief Analyses a markup file and builds the Tree it describes
+ * 
+ * Every element becomes a Tree node whose type is given by the tag name and whose id is
+ * given by the "id" attribute (an id is generated if the attribute is missing). The other
+ * attributes are stored in the node's HashMap. The widgets are not created.
+ * 
+ * The text between the tags of an element, without the white spaces around it, becomes the
+ * text of the node (see TreeGetText): the texts of the whole document are stored in a single
+ * TextBlock the nodes hold slices of, their entities decoded. The texts of an element split by
+ * its children or by comments are joined by a space. Comments (<!-- ... -->) are skipped.
+ * 
+ * @param file The markup file to analyse, opened for reading
+ * @return The root of the built Tree, or NULL if the file contains no element
+ * 
+ * @warning The process exits with "Error at line" if the markup is not valid, or if an allocation
+ *          fails, see tryLexicalAnalysis
+ */
+Tree *performLexicalAnalysis(FILE *file);
+
+
+/**
+ * @brief Analyses a markup file like performLexicalAnalysis, but returns on an invalid markup or an allocation failure
+ * 
+ * What was built before the error is freed, so it can be used where exiting is not an option
+ * (e.g., on the worker thread of an asynchronous load).
+ * 
+ * @param file The markup file to analyse, opened for reading
+ * @param errorLine Where the line of the error is stored, SCANNER_OUT_OF_MEMORY if an allocation
+ *                  failed, 0 if the markup is valid (may be NULL)
+ * @return The root of the built Tree, or NULL if the file contains no element, the markup is not
+ *         valid or an allocation failed
+ */
+Tree *tryLexicalAnalysis(FILE *file, int *errorLine);
+
+
+/**
+ * @brief Validates the attributes of a tag and stores them in a HashMap, in a single pass
+ * 
+ * The attributes are name="value" (or name='value') pairs separated by white spaces, the
+ * values cannot contain '<' or '>' and a name cannot appear twice. Each pair is put in the
+ * HashMap as soon as it is read, so the caller sizes the HashMap for them beforehand (see
+ * HashMapNewWithCapacity). The pairs read before an error stay in the HashMap. The values are
+ * stored as they are written, their entities (&amp; ...) being decoded when they are first read
+ * (see HashMapPutEscaped).
+ * 
+ * @param attribute The text between the tag name and the end of the tag, of any length (the
+ *                  names and the values are terminated in place)
+ * @param length The length of the text
+ * @param attributes The HashMap receiving the pairs
+ * @return The number of pairs, -1 if the text is not valid or a name is repeated, -2 if an allocation fails
+ */
+int parseAttributes(char *attribute, size_t length, HashMap *attributes);
+
+#endif // SCANNER_H
@@ -0,0 +1,559 @@
+/***************************************************************************************************
+ * @file Serializer.c                                                                              *
+ * @brief The implementation of the Tree serializers                                               *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Serializer.h                                                                               *
+ **************************************************************************************************/
+
+#include "Serializer.h"
+#include <errno.h>
+#include <unistd.h>
+
+#define SERIALIZER_INITIAL_CAPACITY 4096        ///< The initial size of the output buffer
+#define SERIALIZER_CHUNK_SIZE (256 * 1024)      ///< The size of the writes to a file descriptor
+
+/**
+ * @brief Represents the buffer a document is built in
+ * 
+ * In memory the buffer grows to hold the whole document. For a file descriptor it is written
+ * out each time it is full, in large chunks, so big documents do not take (and fault in) as
+ * much memory as their size.
+ */
+struct Buffer
+{
+    char *data;         ///< The document, or the part of it not written yet
+    size_t length;      ///< The number of bytes in data
+    size_t capacity;    ///< The number of bytes allocated
+    int failed;         ///< Whether the buffer could not grow or be written, the document is then dropped
+    int fd;             ///< The file descriptor written to, or -1 to keep the document in memory
+    size_t written;     ///< The number of bytes already written to the file descriptor
+};
+
+
+/**
+ * @brief Represents a key-value pair of a node, while its attributes are sorted
+ */
+struct Attribute
+{
+    const char *key;
+    const char *value;
+};
+
+
+/**
+ * @brief Represents the state of a serialization
+ * 
+ * The attributes array is reused from one node to the next.
+ */
+struct Writer
+{
+    struct Buffer buffer;           ///< The output
+    int indent;                     ///< The number of spaces per level, 0 for one line
+    int needComma;                  ///< Whether the next JSON object follows a sibling
+    struct Attribute *attributes;   ///< The attributes of the current node
+    int attributeCount;             ///< The number of attributes of the current node
+    int attributeCapacity;          ///< The number of attributes allocated
+};
+
+
+/**
+ * @brief Represents an output format, as the functions writing the start and the end of a node
+ */
+struct Format
+{
+    void (*open)(struct Writer *writer, const Tree *node, int depth, int isLeaf);
+    void (*close)(struct Writer *writer, const Tree *node, int depth);
+};
+
+
+
+
+/**
+ * @brief Writes the content of the buffer to its file descriptor and empties it
+ * 
+ * @return 1 on success, -1 if the write failed
+ */
+static int flush(struct Buffer *buffer)
+{
+    size_t done = 0;
+    while(done < buffer->length)
+    {
+        ssize_t result = write(buffer->fd, buffer->data + done, buffer->length - done);
+        if(result < 0 && errno == EINTR) continue;
+        if(result <= 0)
+        {
+            buffer->failed = 1;
+            return -1;
+        }
+        done += result;
+    }
+
+    buffer->written += buffer->length;
+    buffer->length = 0;
+    return 1;
+}
+
+
+/**
+ * @brief Makes room for a number of bytes (and the terminating NUL) at the end of the buffer
+ * 
+ * @return 1 on success, 0 if the buffer could not grow
+ */
+static int reserve(struct Buffer *buffer, size_t bytes)
+{
+    if(buffer->failed) return 0;
+    if(buffer->length + bytes < buffer->capacity) return 1;
+
+    // Write the buffer out rather than growing it, unless a single piece does not fit
+    if(buffer->fd >= 0 && buffer->length)
+    {
+        if(flush(buffer) == -1) return 0;
+        if(bytes < buffer->capacity) return 1;
+    }
+
+    size_t capacity = buffer->capacity ? buffer->capacity : SERIALIZER_INITIAL_CAPACITY;
+    while(buffer->length + bytes >= capacity) capacity *= 2;
+
+    char *data = (char *)realloc(buffer->data, capacity);
+    if(!data)
+    {
+        buffer->failed = 1;
+        return 0;
+    }
+
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 1;
+}
+
+
+static void append(struct Buffer *buffer, const char *text, size_t length)
+{
+    if(!reserve(buffer, length)) return;
+
+    memcpy(buffer->data + buffer->length, text, length);
+    buffer->length += length;
+}
+
+
+static void appendString(struct Buffer *buffer, const char *text)
+{
+    append(buffer, text, strlen(text));
+}
+
+
+/**
+ * @brief Starts a new line indented for a depth, does nothing for one line documents
+ */
+static void appendLine(struct Writer *writer, int depth, int isFirst)
+{
+    if(!writer->indent) return;
+
+    size_t spaces = (size_t)depth * writer->indent;
+    if(!reserve(&writer->buffer, spaces + 1)) return;
+
+    if(!isFirst) writer->buffer.data[writer->buffer.length++] = '\n';
+    memset(writer->buffer.data + writer->buffer.length, ' ', spaces);
+    writer->buffer.length += spaces;
+}
+
+
+/**
+ * @brief The characters written as entities in markup values (non-zero), NUL ends the scan
+ */
+static const unsigned char markupSpecial[256] = { [0] = 1, ['&'] = 1, ['<'] = 1, ['>'] = 1, ['"'] = 1, ['\''] = 1 };
+
+
+/**
+ * @brief The characters escaped in JSON strings (non-zero): quotes, backslashes and control characters
+ */
+static const unsigned char jsonSpecial[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    ['"'] = 1, ['\\'] = 1
+};
+
+
+/**
+ * @brief Returns the length of the run of characters before the first one marked in a table
+ */
+static size_t plainRun(const char *value, const unsigned char *special)
+{
+    const unsigned char *end = (const unsigned char *)value;
+    while(!special[*end]) end++;
+    return end - (const unsigned char *)value;
+}
+
+
+/**
+ * @brief Appends a value with its markup special characters written as entities
+ * 
+ * Most values have nothing to escape and are copied at once. Otherwise room is made for the
+ * longest possible result first, and the value is written straight into the buffer.
+ */
+static void appendMarkupEscaped(struct Buffer *buffer, const char *value)
+{
+    size_t run = plainRun(value, markupSpecial);
+    if(!value[run])
+    {
+        append(buffer, value, run);
+        return;
+    }
+
+    if(!reserve(buffer, run + strlen(value + run) * 6)) return;
+    char *out = buffer->data + buffer->length;
+    memcpy(out, value, run);
+    out += run;
+
+    for(const char *in = value + run; *in; in++)
+    {
+        switch(*in)
+        {
+            case '&': memcpy(out, "&amp;", 5); out += 5; break;
+            case '<': memcpy(out, "&lt;", 4); out += 4; break;
+            case '>': memcpy(out, "&gt;", 4); out += 4; break;
+            case '"': memcpy(out, "&quot;", 6); out += 6; break;
+            case '\'': memcpy(out, "&apos;", 6); out += 6; break;
+            default: *out++ = *in;
+        }
+    }
+
+    buffer->length = out - buffer->data;
+}
+
+
+/**
+ * @brief Appends a value as a JSON string, quotes included
+ * 
+ * Most values have nothing to escape and are copied at once. Otherwise room is made for the
+ * longest possible result first, and the value is written straight into the buffer.
+ */
+static void appendJsonString(struct Buffer *buffer, const char *value)
+{
+    size_t run = plainRun(value, jsonSpecial);
+    if(!value[run])
+    {
+        if(!reserve(buffer, run + 2)) return;
+        char *out = buffer->data + buffer->length;
+        *out++ = '"';
+        memcpy(out, value, run);
+        out[run] = '"';
+        buffer->length += run + 2;
+        return;
+    }
+
+    if(!reserve(buffer, run + strlen(value + run) * 6 + 2)) return;
+    char *out = buffer->data + buffer->length;
+    *out++ = '"';
+    memcpy(out, value, run);
+    out += run;
+
+    static const char hex[] = "0123456789abcdef";
+    for(const unsigned char *in = (const unsigned char *)value + run; *in; in++)
+    {
+        if(!jsonSpecial[*in])
+        {
+            *out++ = *in;
+            continue;
+        }
+
+        *out++ = '\\';
+        switch(*in)
+        {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '\n': *out++ = 'n'; break;
+            case '\r': *out++ = 'r'; break;
+            case '\t': *out++ = 't'; break;
+            default:
+                memcpy(out, "u00", 3);
+                out[3] = hex[*in >> 4];
+                out[4] = hex[*in & 15];
+                out += 5;
+        }
+    }
+
+    *out++ = '"';
+    buffer->length = out - buffer->data;
+}
+
+
+static void collectAttribute(const char *key, const char *value, void *userData)
+{
+    struct Writer *writer = userData;
+
+    if(writer->attributeCount == writer->attributeCapacity)
+    {
+        int capacity = writer->attributeCapacity ? writer->attributeCapacity * 2 : 16;
+        struct Attribute *attributes = (struct Attribute *)realloc(writer->attributes, capacity * sizeof(struct Attribute));
+        if(!attributes)
+        {
+            writer->buffer.failed = 1;
+            return;
+        }
+        writer->attributes = attributes;
+        writer->attributeCapacity = capacity;
+    }
+
+    writer->attributes[writer->attributeCount++] = (struct Attribute){ key, value };
+}
+
+
+/**
+ * @brief Gathers the attributes of a node in writer->attributes, sorted by name
+ */
+static void sortAttributes(struct Writer *writer, const Tree *node)
+{
+    writer->attributeCount = 0;
+
+    const HashMap *attributes = TreeGetAttributes(node);
+    if(!attributes) return;
+
+    HashMapForEach(attributes, collectAttribute, writer);
+
+    // Nodes have a few attributes, an insertion sort beats qsort's indirect comparisons
+    for(int i = 1; i < writer->attributeCount; i++)
+    {
+        struct Attribute attribute = writer->attributes[i];
+        int j = i;
+        while(j > 0 && strcmp(writer->attributes[j - 1].key, attribute.key) > 0)
+        {
+            writer->attributes[j] = writer->attributes[j - 1];
+            j--;
+        }
+        writer->attributes[j] = attribute;
+    }
+}
+
+
+static void openMarkup(struct Writer *writer, const Tree *node, int depth, int isLeaf)
+{
+    struct Buffer *buffer = &writer->buffer;
+
+    appendLine(writer, depth, buffer->length == 0);
+    append(buffer, "<", 1);
+    appendString(buffer, WidgetTypeToName(TreeGetType(node)));
+    append(buffer, " id=\"", 5);
+    appendMarkupEscaped(buffer, TreeGetId(node));
+    append(buffer, "\"", 1);
+
+    sortAttributes(writer, node);
+    for(int i = 0; i < writer->attributeCount; i++)
+    {
+        append(buffer, " ", 1);
+        appendString(buffer, writer->attributes[i].key);
+        append(buffer, "=\"", 2);
+        appendMarkupEscaped(buffer, writer->attributes[i].value);
+        append(buffer, "\"", 1);
+    }
+
+    const char *text = TreeGetText(node, NULL);
+    if(isLeaf && !text) append(buffer, " />", 3);
+    else append(buffer, ">", 1);
+
+    // The text comes before the children, a leaf with a text is closed right after it
+    if(!text) return;
+    appendMarkupEscaped(buffer, text);
+    if(isLeaf)
+    {
+        append(buffer, "</", 2);
+        appendString(buffer, WidgetTypeToName(TreeGetType(node)));
+        append(buffer, ">", 1);
+    }
+}
+
+
+static void closeMarkup(struct Writer *writer, const Tree *node, int depth)
+{
+    appendLine(writer, depth, 0);
+    append(&writer->buffer, "</", 2);
+    appendString(&writer->buffer, WidgetTypeToName(TreeGetType(node)));
+    append(&writer->buffer, ">", 1);
+}
+
+
+static void openJson(struct Writer *writer, const Tree *node, int depth, int isLeaf)
+{
+    struct Buffer *buffer = &writer->buffer;
+
+    if(writer->needComma) append(buffer, ",", 1);
+    appendLine(writer, depth, buffer->length == 0);
+
+    append(buffer, "{\"type\":", 8);
+    appendJsonString(buffer, WidgetTypeToName(TreeGetType(node)));
+    append(buffer, ",\"id\":", 6);
+    appendJsonString(buffer, TreeGetId(node));
+    append(buffer, ",\"attributes\":{", 15);
+
+    sortAttributes(writer, node);
+    for(int i = 0; i < writer->attributeCount; i++)
+    {
+        if(i) append(buffer, ",", 1);
+        appendJsonString(buffer, writer->attributes[i].key);
+        append(buffer, ":", 1);
+        appendJsonString(buffer, writer->attributes[i].value);
+    }
+    append(buffer, "}", 1);
+
+    const char *text = TreeGetText(node, NULL);
+    if(text)
+    {
+        append(buffer, ",\"text\":", 8);
+        appendJsonString(buffer, text);
+    }
+
+    // The children follow, the object is closed by closeJson
+    if(isLeaf) append(buffer, "}", 1);
+    else append(buffer, ",\"children\":[", 13);
+    writer->needComma = isLeaf;
+}
+
+
+static void closeJson(struct Writer *writer, const Tree *node, int depth)
+{
+    (void)node;
+    appendLine(writer, depth, 0);
+    append(&writer->buffer, "]}", 2);
+    writer->needComma = 1;
+}
+
+
+static const struct Format markupFormat = { openMarkup, closeMarkup };
+static const struct Format jsonFormat = { openJson, closeJson };
+
+
+/**
+ * @brief Walks a tree in pre-order and writes it in a format
+ * 
+ * The nodes with children stay open on a stack until the walk leaves their subtree.
+ * 
+ * @return 1 on success, -1 if an error occurs (the buffer still has to be freed)
+ */
+static int serialize(const Tree *root, int indent, const struct Format *format, struct Buffer *buffer)
+{
+    TreeIterator *iterator = TreeIteratorNew((Tree *)root, treePreOrder);
+    if(!iterator) return -1;
+
+    struct Writer writer = { *buffer, indent, 0, NULL, 0, 0 };
+    const Tree **open = NULL;
+    int openCount = 0, openCapacity = 0;
+
+    for(Tree *node = TreeIteratorNext(iterator); node && !writer.buffer.failed; node = TreeIteratorNext(iterator))
+    {
+        // Close the nodes whose subtree was left
+        int depth = TreeIteratorDepth(iterator);
+        while(openCount > depth)
+        {
+            openCount--;
+            format->close(&writer, open[openCount], openCount);
+        }
+
+        int isLeaf = TreeIsLeaf(node) == 1;
+        format->open(&writer, node, depth, isLeaf);
+        if(isLeaf) continue;
+
+        // Keep the node open until its last descendant is written
+        if(openCount == openCapacity)
+        {
+            openCapacity = openCapacity ? openCapacity * 2 : 64;
+            const Tree **grown = (const Tree **)realloc(open, openCapacity * sizeof(Tree *));
+            if(!grown)
+            {
+                writer.buffer.failed = 1;
+                break;
+            }
+            open = grown;
+        }
+        open[openCount++] = node;
+    }
+    while(openCount > 0)
+    {
+        openCount--;
+        format->close(&writer, open[openCount], openCount);
+    }
+    if(writer.indent) append(&writer.buffer, "\n", 1);
+
+    TreeIteratorFree(iterator);
+    free(open);
+    free(writer.attributes);
+
+    *buffer = writer.buffer;
+    return buffer->failed ? -1 : 1;
+}
+
+
+/**
+ * @brief Writes a document to memory, and returns it NUL terminated
+ */
+static char *serializeToMemory(const Tree *root, int indent, size_t *length, const struct Format *format)
+{
+    // Check the input parameters
+    if(!root || indent < 0) return NULL;
+
+    struct Buffer buffer = { NULL, 0, 0, 0, -1, 0 };
+    if(serialize(root, indent, format, &buffer) == -1 || !reserve(&buffer, 0))
+    {
+        free(buffer.data);
+        return NULL;
+    }
+
+    buffer.data[buffer.length] = '\0';
+    if(length) *length = buffer.length;
+    return buffer.data;
+}
+
+
+/**
+ * @brief Writes a document to a file descriptor, and returns its length
+ */
+static long serializeToFile(const Tree *root, int indent, int fd, const struct Format *format)
+{
+    // Check the input parameters
+    if(!root || indent < 0 || fd < 0) return -1;
+
+    struct Buffer buffer = { malloc(SERIALIZER_CHUNK_SIZE), 0, SERIALIZER_CHUNK_SIZE, 0, fd, 0 };
+    if(!buffer.data) return -1;
+
+    int result = serialize(root, indent, format, &buffer);
+    if(result != -1) result = flush(&buffer);
+    free(buffer.data);
+
+    return result == -1 ? -1 : (long)buffer.written;
+}
+
+
+
+
+char *SerializerToMarkup(const Tree *root, int indent, size_t *length)
+{
+    return serializeToMemory(root, indent, length, &markupFormat);
+}
+
+
+
+
+char *SerializerToJson(const Tree *root, int indent, size_t *length)
+{
+    return serializeToMemory(root, indent, length, &jsonFormat);
+}
+
+
+
+
+long SerializerWriteMarkup(const Tree *root, int indent, int fd)
+{
+    return serializeToFile(root, indent, fd, &markupFormat);
+}
+
+
+
+
+long SerializerWriteJson(const Tree *root, int indent, int fd)
+{
+    return serializeToFile(root, indent, fd, &jsonFormat);
+}
@@ -0,0 +1,75 @@
+/***************************************************************************************************
+ * @file Serializer.h                                                                              *
+ * @brief Writes a Tree back to markup or to JSON                                                  *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Serializer.c                                                                               *
+ **************************************************************************************************/
+
+#ifndef SERIALIZER_H
+#define SERIALIZER_H
+
+#include <stddef.h>
+#include "../DataStructure/Tree/Tree.h"
+
+/**
+ * @brief Writes a Tree as markup, the format read by performLexicalAnalysis
+ * 
+ * Each element is written with its "id" first, then its attributes sorted by name, so the
+ * output does not depend on the order the attributes were put in. The text of an element
+ * follows its opening tag, before its children, and elements without children or text are
+ * self closing. The characters & < > " and ' of the values and texts are written as entities.
+ * The whole document is built in one growable buffer, the tree is walked without recursion.
+ * 
+ * @param root The root of the Tree to write
+ * @param indent The number of spaces per level, or 0 to write the document on one line
+ * @param length Receives the length of the document (may be NULL)
+ * @return The NUL terminated document, to be freed by the caller, or NULL if an error occurs
+ */
+char *SerializerToMarkup(const Tree *root, int indent, size_t *length);
+
+
+/**
+ * @brief Writes a Tree as JSON
+ * 
+ * Each node is an object {"type": ..., "id": ..., "attributes": {...}, "text": ..., "children": [...]},
+ * the attributes sorted by name, "text" and "children" only written for nodes that have some.
+ * 
+ * @param root The root of the Tree to write
+ * @param indent The number of spaces per level, or 0 to write the document on one line
+ * @param length Receives the length of the document (may be NULL)
+ * @return The NUL terminated document, to be freed by the caller, or NULL if an error occurs
+ */
+char *SerializerToJson(const Tree *root, int indent, size_t *length);
+
+
+/**
+ * @brief Writes a Tree as markup to a file descriptor
+ * 
+ * The document is built in a fixed buffer written out in large chunks each time it is full,
+ * so writing a big tree does not take as much memory as its document.
+ * 
+ * @param root The root of the Tree to write
+ * @param indent The number of spaces per level, or 0 to write the document on one line
+ * @param fd The file descriptor to write to
+ * @return The number of bytes written, or -1 if an error occurs
+ */
+long SerializerWriteMarkup(const Tree *root, int indent, int fd);
+
+
+/**
+ * @brief Writes a Tree as JSON to a file descriptor, in large chunks as SerializerWriteMarkup
+ * 
+ * @param root The root of the Tree to write
+ * @param indent The number of spaces per level, or 0 to write the document on one line
+ * @param fd The file descriptor to write to
+ * @return The number of bytes written, or -1 if an error occurs
+ */
+long SerializerWriteJson(const Tree *root, int indent, int fd);
+
+#endif // SERIALIZER_H
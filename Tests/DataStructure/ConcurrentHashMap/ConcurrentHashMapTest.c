@@ -0,0 +1,189 @@
+/***************************************************************************************************
+ * @file ConcurrentHashMapTest.c                                                                   *
+ * @brief The unit tests for the ConcurrentHashMap data structure                                  *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see ConcurrentHashMap.h                                                                        *
+ **************************************************************************************************/
+
+#include "../../../DataStructure/ConcurrentHashMap/ConcurrentHashMap.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#define KEYS 256
+#define READERS 4
+#define WRITERS 2
+
+void test_put_and_get() {
+    ConcurrentHashMap* map = ConcurrentHashMapNew();
+    assert(map != NULL);
+    assert(ConcurrentHashMapSize(map) == 0);
+
+    assert(ConcurrentHashMapPut(map, "title", "Hello") == 1);
+    assert(ConcurrentHashMapPut(map, "title", "World") == 0);
+    assert(ConcurrentHashMapSize(map) == 1);
+
+    ConcurrentHashMapReadBegin();
+    assert(strcmp(ConcurrentHashMapGet(map, "title"), "World") == 0);
+    assert(ConcurrentHashMapGet(map, "missing") == NULL);
+    ConcurrentHashMapReadEnd();
+
+    char* copy = ConcurrentHashMapGetCopy(map, "title");
+    assert(strcmp(copy, "World") == 0);
+    free(copy);
+
+    ConcurrentHashMapFree(map);
+    printf("Put/get test passed!\n");
+}
+
+void test_remove_and_contains() {
+    ConcurrentHashMap* map = ConcurrentHashMapNew();
+    ConcurrentHashMapPut(map, "a", "1");
+    ConcurrentHashMapPut(map, "b", "2");
+
+    assert(ConcurrentHashMapContainsKey(map, "a") == 1);
+    assert(ConcurrentHashMapRemove(map, "a") == 1);
+    assert(ConcurrentHashMapRemove(map, "a") == 0);
+    assert(ConcurrentHashMapContainsKey(map, "a") == 0);
+    assert(ConcurrentHashMapContainsKey(map, "b") == 1);
+    assert(ConcurrentHashMapSize(map) == 1);
+
+    ConcurrentHashMapFree(map);
+    printf("Remove/contains test passed!\n");
+}
+
+void test_growth() {
+    ConcurrentHashMap* map = ConcurrentHashMapNew();
+    char key[16], value[32];
+
+    for (int i = 0; i < 1000; i++) {
+        sprintf(key, "key%d", i);
+        sprintf(value, "value%d", i);
+        assert(ConcurrentHashMapPut(map, key, value) == 1);
+    }
+    assert(ConcurrentHashMapSize(map) == 1000);
+
+    ConcurrentHashMapReadBegin();
+    for (int i = 0; i < 1000; i++) {
+        sprintf(key, "key%d", i);
+        sprintf(value, "value%d", i);
+        assert(strcmp(ConcurrentHashMapGet(map, key), value) == 0);
+    }
+    ConcurrentHashMapReadEnd();
+
+    ConcurrentHashMapFree(map);
+    printf("Growth test passed!\n");
+}
+
+struct Shared {
+    ConcurrentHashMap* map;
+    atomic_int done;
+};
+
+void* read_values(void* data) {
+    struct Shared* shared = data;
+    char key[16];
+    long reads = 0;
+
+    // Every value read must be complete and belong to its key, whatever the writers do
+    while (!atomic_load(&shared->done) || reads < 1000) {
+        int i = reads++ % KEYS;
+        sprintf(key, "key%d", i);
+
+        ConcurrentHashMapReadBegin();
+        const char* value = ConcurrentHashMapGet(shared->map, key);
+        if (value) {
+            int index, version;
+            assert(sscanf(value, "%d:%d", &index, &version) == 2 && index == i);
+        }
+        ConcurrentHashMapReadEnd();
+    }
+
+    return NULL;
+}
+
+void* write_values(void* data) {
+    struct Shared* shared = data;
+    char key[16], value[32];
+
+    for (int version = 0; version < 200; version++) {
+        for (int i = 0; i < KEYS; i++) {
+            sprintf(key, "key%d", i);
+            sprintf(value, "%d:%d", i, version);
+            if ((i + version) % 7 == 0) ConcurrentHashMapRemove(shared->map, key);
+            else ConcurrentHashMapPut(shared->map, key, value);
+        }
+    }
+
+    return NULL;
+}
+
+void test_concurrent_access() {
+    struct Shared shared = { ConcurrentHashMapNew(), 0 };
+    pthread_t readers[READERS], writers[WRITERS];
+
+    for (int i = 0; i < READERS; i++) pthread_create(&readers[i], NULL, read_values, &shared);
+    for (int i = 0; i < WRITERS; i++) pthread_create(&writers[i], NULL, write_values, &shared);
+    for (int i = 0; i < WRITERS; i++) pthread_join(writers[i], NULL);
+    atomic_store(&shared.done, 1);
+    for (int i = 0; i < READERS; i++) pthread_join(readers[i], NULL);
+
+    // Both writers ended with the same last version
+    char key[16], value[32];
+    for (int i = 0; i < KEYS; i++) {
+        sprintf(key, "key%d", i);
+        sprintf(value, "%d:%d", i, 199);
+        char* copy = ConcurrentHashMapGetCopy(shared.map, key);
+        if ((i + 199) % 7 == 0) assert(copy == NULL);
+        else assert(strcmp(copy, value) == 0);
+        free(copy);
+    }
+
+    // Once every reader is gone, every replaced value can be freed
+    assert(ConcurrentHashMapReclaim() == 0);
+
+    ConcurrentHashMapFree(shared.map);
+    printf("Concurrent access test passed!\n");
+}
+
+void test_edge_cases() {
+    ConcurrentHashMap* map = ConcurrentHashMapNew();
+
+    assert(ConcurrentHashMapPut(NULL, "key", "value") == -1);
+    assert(ConcurrentHashMapPut(map, NULL, "value") == -1);
+    assert(ConcurrentHashMapPut(map, "key", NULL) == -1);
+    assert(ConcurrentHashMapGet(NULL, "key") == NULL);
+    assert(ConcurrentHashMapGet(map, NULL) == NULL);
+    assert(ConcurrentHashMapGetCopy(map, "key") == NULL);
+    assert(ConcurrentHashMapRemove(map, NULL) == -1);
+    assert(ConcurrentHashMapRemove(map, "key") == 0);
+    assert(ConcurrentHashMapContainsKey(NULL, "key") == -1);
+    assert(ConcurrentHashMapSize(NULL) == -1);
+
+    // Read sections can be nested
+    ConcurrentHashMapReadBegin();
+    ConcurrentHashMapReadBegin();
+    ConcurrentHashMapReadEnd();
+    ConcurrentHashMapReadEnd();
+
+    ConcurrentHashMapFree(map);
+    printf("Edge cases test passed!\n");
+}
+
+int main() {
+    test_put_and_get();
+    test_remove_and_contains();
+    test_growth();
+    test_concurrent_access();
+    test_edge_cases();
+
+    printf("\nAll tests passed successfully!\n");
+    return 0;
+}
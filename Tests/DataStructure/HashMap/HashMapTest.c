@@ -14,6 +14,7 @@
 
 #include "../../../DataStructure/HashMap/HashMap.h"
 #include <assert.h>
+#include <pthread.h>
 #include <string.h>
 
 void test_creation_and_deletion() {
@@ -73,6 +74,496 @@ void test_contains() {
     printf("Contains test passed!\n");
 }
 
+void count_pairs(const char *key, const char *value, void *userData) {
+    assert(strcmp(key, "key1") == 0 || strcmp(key, "key2") == 0);
+    assert(strcmp(value, "value1") == 0 || strcmp(value, "value2") == 0);
+    (*(int *)userData)++;
+}
+
+void count_any(const char *key, const char *value, void *userData) {
+    assert(key && value);
+    (*(int *)userData)++;
+}
+
+void test_for_each() {
+    HashMap* map = HashMapNew();
+    int count = 0;
+
+    assert(HashMapForEach(map, count_pairs, &count) == 0);
+    assert(count == 0);
+
+    HashMapPut(map, "key1", "value1");
+    HashMapPut(map, "key2", "value2");
+    assert(HashMapForEach(map, count_pairs, &count) == 2);
+    assert(count == 2);
+
+    assert(HashMapForEach(NULL, count_pairs, &count) == -1);
+    assert(HashMapForEach(map, NULL, &count) == -1);
+
+    HashMapFree(map);
+    printf("For each test passed!\n");
+}
+
+void* read_typed(void* map) {
+    // Every reader parses the same values, as integers or as numbers, whichever kind was kept
+    char key[16];
+    long number;
+    double real;
+    for (int i = 0; i < 64; i++) {
+        sprintf(key, "number%d", i);
+        assert(HashMapGetInt((const HashMap*)map, key, &number) == 1 && number == 7);
+        assert(HashMapGetDouble((const HashMap*)map, key, &real) == 1 && real == 7.0);
+    }
+    return NULL;
+}
+
+void test_typed_values() {
+    HashMap* map = HashMapNew();
+    long number;
+    double real;
+    int boolean;
+    Atom atom;
+
+    // Parsed on the first typed access, the string stays where it was
+    HashMapPut(map, "spacing", "12");
+    char* text = HashMapGet(map, "spacing");
+    assert(HashMapGetInt(map, "spacing", &number) == 1 && number == 12);
+    assert(HashMapGetInt(map, "spacing", &number) == 1 && number == 12);
+    assert(HashMapGet(map, "spacing") == text);
+    assert(HashMapGetDouble(map, "spacing", &real) == 1 && real == 12.0);
+
+    HashMapPut(map, "opacity", "0.5");
+    assert(HashMapGetDouble(map, "opacity", &real) == 1 && real == 0.5);
+    assert(HashMapGetInt(map, "opacity", &number) == 0);
+
+    HashMapPut(map, "visible", "true");
+    assert(HashMapGetBool(map, "visible", &boolean) == 1 && boolean == 1);
+
+    HashMapPut(map, "orientation", "vertical");
+    assert(HashMapGetAtom(map, "orientation", &atom) == 1 && atom == AtomLookup("vertical"));
+    assert(HashMapGetBool(map, "orientation", &boolean) == 0);
+
+    // Typed puts store the string too
+    assert(HashMapPutInt(map, "width", -3) == 1);
+    assert(strcmp(HashMapGet(map, "width"), "-3") == 0);
+    assert(HashMapPutBool(map, "visible", 0) == 0);
+    assert(strcmp(HashMapGet(map, "visible"), "false") == 0);
+    assert(HashMapGetBool(map, "visible", &boolean) == 1 && boolean == 0);
+    assert(HashMapPutDouble(map, "opacity", 0.25) == 0);
+    assert(HashMapGetDouble(map, "opacity", &real) == 1 && real == 0.25);
+
+    // Updating with a string drops the parsed value
+    HashMapPut(map, "width", "40");
+    assert(HashMapGetInt(map, "width", &number) == 1 && number == 40);
+
+    // Copies keep the parsed values
+    HashMap* copy = HashMapGetCopy(map);
+    assert(HashMapGetInt(copy, "spacing", &number) == 1 && number == 12);
+    assert(HashMapContainsValue(copy, "12") == 1);
+    HashMapFree(copy);
+
+    // Readers on several threads parse the values of the same map at once
+    HashMap* shared = HashMapNew();
+    char key[16];
+    for (int i = 0; i < 64; i++) {
+        sprintf(key, "number%d", i);
+        HashMapPut(shared, key, "7");
+    }
+    pthread_t readers[4];
+    for (int i = 0; i < 4; i++) pthread_create(&readers[i], NULL, read_typed, shared);
+    for (int i = 0; i < 4; i++) pthread_join(readers[i], NULL);
+    assert(strcmp(HashMapGet(shared, "number0"), "7") == 0);
+    HashMapFree(shared);
+
+    assert(HashMapRemove(map, "spacing") == 1);
+    assert(HashMapGetInt(map, "missing", &number) == 0);
+    assert(HashMapGetInt(NULL, "spacing", &number) == -1);
+    assert(HashMapGetInt(map, "width", NULL) == -1);
+
+    HashMapFree(map);
+    printf("Typed values test passed!\n");
+}
+
+void collect_entries(const HashMapEntry *entry, void *userData) {
+    Atom *atoms = (Atom *)userData;
+    // The key atom is interned once, then read back from the entry
+    atoms[0]++;
+    assert(HashMapEntryGetKeyAtom(entry) == AtomLookup(HashMapEntryGetKey(entry)));
+    if (strcmp(HashMapEntryGetKey(entry), "spacing") == 0) atoms[1] = HashMapEntryGetKeyAtom(entry);
+}
+
+void test_entries() {
+    HashMap* map = HashMapNew();
+    long number;
+    double real;
+    int boolean;
+    Atom atom, atoms[2] = { 0, 0 };
+
+    HashMapPut(map, "spacing", "12");
+    HashMapPut(map, "opacity", "0.5");
+    HashMapPut(map, "visible", "true");
+    HashMapPutEscaped(map, "orientation", "vertical", 1);
+
+    // The values are read from the entry, with the same cache as the typed getters
+    const HashMapEntry* entry = HashMapGetEntry(map, "spacing");
+    assert(entry && strcmp(HashMapEntryGetKey(entry), "spacing") == 0);
+    assert(HashMapEntryGetInt(entry, &number) == 1 && number == 12);
+    assert(HashMapEntryGetValue(entry) == HashMapGet(map, "spacing"));
+    assert(HashMapEntryGetDouble(HashMapGetEntry(map, "opacity"), &real) == 1 && real == 0.5);
+    assert(HashMapEntryGetInt(HashMapGetEntry(map, "opacity"), &number) == 0);
+    assert(HashMapEntryGetBool(HashMapGetEntry(map, "visible"), &boolean) == 1 && boolean == 1);
+    assert(HashMapEntryGetAtom(HashMapGetEntry(map, "orientation"), &atom) == 1 && atom == AtomLookup("vertical"));
+    assert(strcmp(HashMapEntryGetValue(HashMapGetEntry(map, "orientation")), "vertical") == 0);
+
+    // Every entry is visited, its key atom kept through updates and copies
+    assert(HashMapForEachEntry(map, collect_entries, atoms) == 4 && atoms[0] == 4);
+    assert(atoms[1] == AtomLookup("spacing"));
+    HashMapPut(map, "spacing", "a value long enough to move the entry");
+    assert(HashMapEntryGetKeyAtom(HashMapGetEntry(map, "spacing")) == atoms[1]);
+    HashMap* copy = HashMapGetCopy(map);
+    assert(HashMapEntryGetKeyAtom(HashMapGetEntry(copy, "spacing")) == atoms[1]);
+    HashMapFree(copy);
+
+    // The entries survive the move to a table
+    char key[16];
+    for (int i = 0; i < 32; i++) {
+        snprintf(key, sizeof(key), "key%d", i);
+        HashMapPut(map, key, "1");
+    }
+    assert(HashMapEntryGetKeyAtom(HashMapGetEntry(map, "spacing")) == atoms[1]);
+    assert(HashMapEntryGetInt(HashMapGetEntry(map, "key31"), &number) == 1 && number == 1);
+
+    assert(HashMapGetEntry(map, "missing") == NULL);
+    assert(HashMapGetEntry(NULL, "spacing") == NULL);
+    assert(HashMapForEachEntry(map, NULL, NULL) == -1);
+    assert(HashMapEntryGetKeyAtom(NULL) == 0);
+    assert(HashMapEntryGetInt(NULL, &number) == -1);
+
+    HashMapFree(map);
+    printf("Entries test passed!\n");
+}
+
+void* read_escaped(void* map) {
+    // Every reader sees the same decoded values, whichever reader decoded them
+    char key[16];
+    for (int i = 0; i < 64; i++) {
+        sprintf(key, "text%d", i);
+        assert(strcmp(HashMapGet((const HashMap*)map, key), "a < b") == 0);
+    }
+    return NULL;
+}
+
+void test_escaped_values() {
+    HashMap* map = HashMapNew();
+
+    // Values without entities are stored and returned as they are
+    assert(HashMapPutEscaped(map, "plain", "Save", 0) == 1);
+    assert(strcmp(HashMapGet(map, "plain"), "Save") == 0);
+
+    // The entities are decoded on the first read only, then the decoded value is kept
+    assert(HashMapPutEscaped(map, "title", "Tom &amp; &quot;Jerry&quot; &lt;3&gt; &apos;s", 1) == 1);
+    char* title = HashMapGet(map, "title");
+    assert(strcmp(title, "Tom & \"Jerry\" <3> 's") == 0);
+    assert(HashMapGet(map, "title") == title);
+    assert(HashMapContainsValue(map, "Tom & \"Jerry\" <3> 's") == 1);
+
+    // Numeric entities are written in UTF-8, unknown or invalid ones are kept
+    HashMapPutEscaped(map, "numeric", "&#65;&#x42;&#xe9;&#8364;&#x1F600;", 1);
+    assert(strcmp(HashMapGet(map, "numeric"), "AB\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80") == 0);
+    HashMapPutEscaped(map, "unknown", "a & b &nbsp; &#0; &#xD800; &#x110000; &#12 &", 1);
+    assert(strcmp(HashMapGet(map, "unknown"), "a & b &nbsp; &#0; &#xD800; &#x110000; &#12 &") == 0);
+
+    // Typed reads and copies see the decoded value
+    long number;
+    HashMapPutEscaped(map, "spacing", "&#52;2", 1);
+    HashMap* copy = HashMapGetCopy(map);
+    assert(HashMapGetInt(map, "spacing", &number) == 1 && number == 42);
+    assert(HashMapGetInt(copy, "spacing", &number) == 1 && number == 42);
+    assert(strcmp(HashMapGet(copy, "title"), "Tom & \"Jerry\" <3> 's") == 0);
+    HashMapFree(copy);
+
+    // The key stays where it was when the value is decoded
+    HashMapPutEscaped(map, "quoted", "&quot;", 1);
+    const HashMapEntry* entry = HashMapGetEntry(map, "quoted");
+    const char* quoted = HashMapEntryGetKey(entry);
+    assert(strcmp(HashMapEntryGetValue(entry), "\"") == 0);
+    assert(HashMapEntryGetKey(entry) == quoted && strcmp(quoted, "quoted") == 0);
+
+    // Readers on several threads decode the values of the same map at once
+    HashMap* shared = HashMapNew();
+    char key[16];
+    for (int i = 0; i < 64; i++) {
+        sprintf(key, "text%d", i);
+        HashMapPutEscaped(shared, key, "a &lt; b", 1);
+    }
+    pthread_t readers[4];
+    for (int i = 0; i < 4; i++) pthread_create(&readers[i], NULL, read_escaped, shared);
+    for (int i = 0; i < 4; i++) pthread_join(readers[i], NULL);
+    HashMapFree(shared);
+
+    // A plain put replaces the raw value, which is then never decoded
+    HashMapPutEscaped(map, "raw", "x", 1);
+    assert(HashMapPut(map, "raw", "&amp;") == 0);
+    assert(strcmp(HashMapGet(map, "raw"), "&amp;") == 0);
+
+    FrozenHashMap* frozen = HashMapFreeze(map);
+    assert(strcmp(FrozenHashMapGet(frozen, "numeric"), HashMapGet(map, "numeric")) == 0);
+    FrozenHashMapRelease(frozen);
+
+    assert(HashMapPutEscaped(NULL, "key", "value", 1) == -1);
+    assert(HashMapPutEscaped(map, NULL, "value", 1) == -1);
+    HashMapFree(map);
+    printf("Escaped values test passed!\n");
+}
+
+void test_growth() {
+    HashMap* map = HashMapNew();
+    char key[32], value[32];
+
+    // Beyond the inline entries the HashMap moves to a table
+    for (int i = 0; i < 64; i++) {
+        sprintf(key, "key%d", i);
+        sprintf(value, "value%d", i);
+        assert(HashMapPut(map, key, value) == 1);
+        assert(HashMapSize(map) == i + 1);
+    }
+    for (int i = 0; i < 64; i++) {
+        sprintf(key, "key%d", i);
+        sprintf(value, "value%d", i);
+        assert(strcmp(HashMapGet(map, key), value) == 0);
+    }
+    assert(HashMapPut(map, "key3", "updated") == 0);
+    assert(strcmp(HashMapGet(map, "key3"), "updated") == 0);
+
+    HashMap* copy = HashMapGetCopy(map);
+    assert(HashMapSize(copy) == 64);
+    assert(strcmp(HashMapGet(copy, "key63"), "value63") == 0);
+
+    for (int i = 0; i < 64; i += 2) {
+        sprintf(key, "key%d", i);
+        assert(HashMapRemove(map, key) == 1);
+        assert(HashMapContainsKey(map, key) == 0);
+    }
+    assert(HashMapSize(map) == 32);
+    assert(HashMapContainsKey(map, "key1") == 1);
+    assert(HashMapContainsValue(map, "value63") == 1);
+    assert(HashMapContainsKey(copy, "key0") == 1);
+
+    int count = 0;
+    assert(HashMapForEach(copy, count_any, &count) == 64 && count == 64);
+
+    HashMapFree(copy);
+    HashMapFree(map);
+
+    // A map sized beforehand allocates its table once, then only the entries
+    AllocatorStats before, after;
+    HashMap* sized = HashMapNewWithCapacity(64);
+    AllocatorGetStats(allocatorHashMap, &before);
+    for (int i = 0; i < 64; i++) {
+        sprintf(key, "key%d", i);
+        sprintf(value, "value%d", i);
+        assert(HashMapPut(sized, key, value) == 1);
+    }
+    AllocatorGetStats(allocatorHashMap, &after);
+    assert(after.allocations - before.allocations == 64);
+    assert(HashMapSize(sized) == 64 && strcmp(HashMapGet(sized, "key40"), "value40") == 0);
+    HashMapFree(sized);
+    assert(HashMapNewWithCapacity(-1) == NULL);
+    printf("Growth test passed!\n");
+}
+
+void* read_frozen(void* frozen) {
+    char key[32], value[32];
+
+    // Every reader looks up every key many times, without any lock
+    for (int round = 0; round < 1000; round++) {
+        for (int i = 0; i < 32; i++) {
+            sprintf(key, "key%d", i);
+            sprintf(value, "value%d", i);
+            assert(strcmp(FrozenHashMapGet(frozen, key), value) == 0);
+        }
+        assert(FrozenHashMapGet(frozen, "missing") == NULL);
+    }
+
+    FrozenHashMapRelease(frozen);
+    return NULL;
+}
+
+void test_freeze() {
+    HashMap* map = HashMapNew();
+    char key[32], value[32];
+
+    for (int i = 0; i < 32; i++) {
+        sprintf(key, "key%d", i);
+        sprintf(value, "value%d", i);
+        HashMapPut(map, key, value);
+    }
+
+    FrozenHashMap* frozen = HashMapFreeze(map);
+    assert(FrozenHashMapSize(frozen) == 32);
+    assert(strcmp(FrozenHashMapGet(frozen, "key7"), "value7") == 0);
+    assert(FrozenHashMapContainsKey(frozen, "key31") == 1);
+    assert(FrozenHashMapContainsKey(frozen, "key32") == 0);
+    int count = 0;
+    assert(FrozenHashMapForEach(frozen, count_any, &count) == 32 && count == 32);
+
+    // Later changes to the HashMap do not reach the snapshot
+    HashMapPut(map, "key7", "changed");
+    HashMapRemove(map, "key8");
+    assert(strcmp(FrozenHashMapGet(frozen, "key7"), "value7") == 0);
+    assert(strcmp(FrozenHashMapGet(frozen, "key8"), "value8") == 0);
+
+    // Readers on other threads share it, each one dropping its reference when done
+    pthread_t readers[4];
+    for (int i = 0; i < 4; i++) pthread_create(&readers[i], NULL, read_frozen, FrozenHashMapRetain(frozen));
+    for (int i = 0; i < 4; i++) pthread_join(readers[i], NULL);
+
+    // Equal pairs put in another order give an equal snapshot
+    HashMap* small = HashMapNew();
+    HashMapPut(small, "a", "1");
+    HashMapPut(small, "b", "2");
+    HashMap* reversed = HashMapNew();
+    HashMapPut(reversed, "b", "2");
+    HashMapPut(reversed, "a", "1");
+    FrozenHashMap* first = HashMapFreeze(small);
+    FrozenHashMap* second = HashMapFreeze(reversed);
+    assert(FrozenHashMapEquals(first, second) == 1);
+    assert(FrozenHashMapHash(first) == FrozenHashMapHash(second));
+    assert(FrozenHashMapEquals(first, frozen) == 0);
+
+    HashMapPut(reversed, "a", "3");
+    FrozenHashMap* third = HashMapFreeze(reversed);
+    assert(FrozenHashMapEquals(first, third) == 0);
+
+    // Thawing gives back a mutable HashMap
+    HashMap* thawed = FrozenHashMapThaw(third);
+    assert(HashMapSize(thawed) == 2);
+    assert(strcmp(HashMapGet(thawed, "a"), "3") == 0);
+
+    HashMap* nothing = HashMapNew();
+    FrozenHashMap* empty = HashMapFreeze(nothing);
+    assert(FrozenHashMapSize(empty) == 0);
+    assert(FrozenHashMapGet(empty, "a") == NULL);
+
+    assert(HashMapFreeze(NULL) == NULL);
+    assert(FrozenHashMapGet(NULL, "a") == NULL);
+    assert(FrozenHashMapContainsKey(frozen, NULL) == -1);
+    assert(FrozenHashMapEquals(frozen, NULL) == -1);
+
+    FrozenHashMapRelease(frozen);
+    FrozenHashMapRelease(first);
+    FrozenHashMapRelease(second);
+    FrozenHashMapRelease(third);
+    FrozenHashMapRelease(empty);
+    HashMapFree(thawed);
+    HashMapFree(nothing);
+    HashMapFree(small);
+    HashMapFree(reversed);
+    HashMapFree(map);
+    printf("Freeze test passed!\n");
+}
+
+// Allocator hooks checking that every block is released with the size it was allocated with
+#define TRACKED_BLOCKS 4096
+static struct { void* block; size_t size; } tracked[TRACKED_BLOCKS];
+
+static int find_tracked(void* block) {
+    for (int i = 0; i < TRACKED_BLOCKS; i++) if (tracked[i].block == block) return i;
+    return -1;
+}
+
+static void* tracked_allocate(size_t size, void* userData) {
+    void* block = malloc(size);
+    int slot = find_tracked(NULL);
+    assert(slot != -1);
+    tracked[slot].block = block;
+    tracked[slot].size = size;
+    (*(int*)userData)++;
+    return block;
+}
+
+static void* tracked_reallocate(void* block, size_t oldSize, size_t size, void* userData) {
+    (void)userData;
+    int slot = find_tracked(block);
+    assert(slot != -1 && tracked[slot].size == oldSize);
+    tracked[slot].block = realloc(block, size);
+    tracked[slot].size = size;
+    return tracked[slot].block;
+}
+
+static void tracked_release(void* block, size_t size, void* userData) {
+    (void)userData;
+    int slot = find_tracked(block);
+    assert(slot != -1 && tracked[slot].size == size);
+    tracked[slot].block = NULL;
+    free(block);
+}
+
+void test_memory() {
+    int calls = 0;
+    AllocatorHooks hooks = { tracked_allocate, tracked_reallocate, tracked_release, &calls };
+    assert(AllocatorSetHooks(&hooks) == 1);
+
+    AllocatorStats before, stats;
+    AllocatorGetStats(allocatorHashMap, &before);
+    assert(before.live == 0);
+
+    // The counters follow the blocks of the map, and its footprint matches them
+    HashMap* map = HashMapNew();
+    HashMapPut(map, "text", "Hello");
+    HashMapPut(map, "spacing", "6");
+    MemoryUsage usage = { 0 };
+    size_t bytes = HashMapMemoryUsage(map, &usage);
+    AllocatorGetStats(allocatorHashMap, &stats);
+    assert(stats.allocations - before.allocations == 3 && calls == 3);
+    assert(stats.live == bytes && bytes == MemoryUsageTotal(&usage));
+    assert(usage.maps == bytes - usage.keys - usage.values);
+    assert(usage.keys >= strlen("text") + strlen("spacing") + 2);
+    assert(usage.values >= strlen("Hello") + strlen("6") + 2);
+
+    // Table, typed values, new values and removals
+    char key[32], value[32];
+    for (int i = 0; i < 100; i++) {
+        sprintf(key, "key%d", i);
+        sprintf(value, "value%d", i);
+        HashMapPut(map, key, value);
+    }
+    HashMapPutInt(map, "width", 640);
+    HashMapPutEscaped(map, "title", "Tom &amp; Jerry", 1);
+    assert(strcmp(HashMapGet(map, "title"), "Tom & Jerry") == 0);
+    HashMapPut(map, "text", "A much longer text than before");
+    HashMapRemove(map, "key50");
+    FrozenHashMap* frozen = HashMapFreeze(map);
+    AllocatorGetStats(allocatorHashMap, &stats);
+    assert(stats.live == HashMapMemoryUsage(map, NULL) + FrozenHashMapMemoryUsage(frozen));
+    assert(stats.peak >= stats.live);
+
+    // A snapshot is shared evenly between its owners
+    size_t whole = FrozenHashMapMemoryUsage(frozen);
+    FrozenHashMapRetain(frozen);
+    assert(FrozenHashMapMemoryUsage(frozen) == whole / 2);
+    FrozenHashMapRelease(frozen);
+
+    // The copy keeps the decoded title only, the map its escaped value too
+    HashMap* copy = HashMapGetCopy(map);
+    assert(HashMapMemoryUsage(copy, NULL) == HashMapMemoryUsage(map, NULL) - strlen("Tom &amp; Jerry") - 1);
+
+    // The hooks cannot change while blocks are live
+    assert(AllocatorSetHooks(NULL) == -1);
+
+    FrozenHashMapRelease(frozen);
+    HashMapFree(copy);
+    HashMapFree(map);
+    AllocatorGetStats(allocatorHashMap, &stats);
+    assert(stats.live == 0);
+    assert(stats.frees - before.frees == stats.allocations - before.allocations);
+
+    assert(HashMapMemoryUsage(NULL, &usage) == 0);
+    assert(AllocatorGetStats(ALLOCATOR_SUBSYSTEM_COUNT, &stats) == -1);
+    assert(AllocatorSetHooks(NULL) == 1);
+    printf("Memory accounting test passed!\n");
+}
+
 void test_edge_cases() {
     // Test NULL parameters
     assert(HashMapPut(NULL, "key", "value") == -1);
@@ -87,6 +578,7 @@ void test_edge_cases() {
     assert(HashMapPut(map, "key", NULL) == -1);
     assert(HashMapGet(map, NULL) == NULL);
     assert(HashMapRemove(map, NULL) == -1);
+    assert(HashMapRemove(map, "key") == 0);
     assert(HashMapContainsKey(map, NULL) == -1);
     assert(HashMapContainsValue(map, NULL) == -1);
     
@@ -99,6 +591,13 @@ int main() {
     test_put_and_get();
     test_remove();
     test_contains();
+    test_for_each();
+    test_typed_values();
+    test_entries();
+    test_escaped_values();
+    test_growth();
+    test_freeze();
+    test_memory();
     test_edge_cases();
 
     HashMap *hashmap = HashMapNew();
@@ -0,0 +1,256 @@
+/***************************************************************************************************
+ * @file PersistentTreeTest.c                                                                      *
+ * @brief The unit tests for the persistent trees and their history                                *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see PersistentTree.h                                                                           *
+ **************************************************************************************************/
+
+#include "../../../DataStructure/PersistentTree/PersistentTree.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * window#main
+ *   box#toolbar
+ *     button#open [label=Open]
+ *   box#content
+ *     label#name [text=Name]
+ */
+static PersistentTree *buildWindow() {
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "label", "Open");
+    PersistentTree *open = PersistentTreeNew(button, "open", attributes);
+    HashMapFree(attributes);
+
+    attributes = HashMapNew();
+    HashMapPut(attributes, "text", "Name");
+    PersistentTree *name = PersistentTreeNew(label, "name", attributes);
+    HashMapFree(attributes);
+
+    PersistentTree *toolbar = PersistentTreeNew(box, "toolbar", NULL);
+    PersistentTree *content = PersistentTreeNew(box, "content", NULL);
+    PersistentTree *root = PersistentTreeNew(window, "main", NULL);
+
+    // Each edit returns a new version, the previous ones are released as they are not kept
+    PersistentTree *next = PersistentTreeAddChild(toolbar, NULL, 0, open);
+    PersistentTreeRelease(toolbar); PersistentTreeRelease(open);
+    toolbar = next;
+    next = PersistentTreeAddChild(content, NULL, 0, name);
+    PersistentTreeRelease(content); PersistentTreeRelease(name);
+    content = next;
+
+    next = PersistentTreeAddChild(root, NULL, 0, toolbar);
+    PersistentTreeRelease(root); PersistentTreeRelease(toolbar);
+    root = PersistentTreeAddChild(next, NULL, 0, content);
+    PersistentTreeRelease(next); PersistentTreeRelease(content);
+    return root;
+}
+
+static const char *attribute(const PersistentTree *root, const char *id, const char *key) {
+    int path[16];
+    int depth = PersistentTreeFindPath(root, id, path, 16);
+    assert(depth >= 0);
+    return FrozenHashMapGet(PersistentTreeGetAttributes(PersistentTreeGetNode(root, path, depth)), key);
+}
+
+void testPersistentTreeEdits() {
+    printf("Testing PersistentTree edits... ");
+
+    PersistentTree *first = buildWindow();
+    assert(PersistentTreeGetChildCount(first) == 2);
+    assert(strcmp(PersistentTreeGetId(PersistentTreeGetChild(first, 1)), "content") == 0);
+
+    int path[16];
+    assert(PersistentTreeFindPath(first, "main", path, 16) == 0);
+    assert(PersistentTreeFindPath(first, "name", path, 1) == -1);
+    assert(PersistentTreeFindPath(first, "missing", path, 16) == -1);
+    assert(PersistentTreeFindPath(first, "name", path, 16) == 2 && path[0] == 1 && path[1] == 0);
+
+    // Setting an attribute copies the path to the node only, the other subtrees are shared
+    PersistentTree *second = PersistentTreeSetAttribute(first, path, 2, "text", "Changed");
+    assert(strcmp(attribute(first, "name", "text"), "Name") == 0);
+    assert(strcmp(attribute(second, "name", "text"), "Changed") == 0);
+    assert(PersistentTreeGetChild(second, 0) == PersistentTreeGetChild(first, 0));
+    assert(PersistentTreeGetChild(second, 1) != PersistentTreeGetChild(first, 1));
+
+    // Removing and adding
+    int toolbar[] = {0}, open[] = {0, 0};
+    PersistentTree *third = PersistentTreeRemoveChild(second, open, 2);
+    assert(PersistentTreeGetChildCount(PersistentTreeGetNode(third, toolbar, 1)) == 0);
+    assert(PersistentTreeGetChildCount(PersistentTreeGetNode(second, toolbar, 1)) == 1);
+    assert(PersistentTreeGetChild(third, 1) == PersistentTreeGetChild(second, 1));
+
+    PersistentTree *save = PersistentTreeNew(button, "save", NULL);
+    PersistentTree *fourth = PersistentTreeAddChild(third, toolbar, 1, save);
+    assert(strcmp(PersistentTreeGetId(PersistentTreeGetNode(fourth, open, 2)), "save") == 0);
+
+    // Replacing a subtree
+    PersistentTree *fifth = PersistentTreeUpdateNode(fourth, toolbar, 1, save);
+    PersistentTreeRelease(save);
+    assert(strcmp(PersistentTreeGetId(PersistentTreeGetChild(fifth, 0)), "save") == 0);
+    assert(strcmp(PersistentTreeGetId(PersistentTreeGetChild(fourth, 0)), "toolbar") == 0);
+
+    // Invalid paths and arguments
+    int invalid[] = {5};
+    assert(PersistentTreeSetAttribute(first, invalid, 1, "text", "x") == NULL);
+    assert(PersistentTreeRemoveChild(first, NULL, 0) == NULL);
+    assert(PersistentTreeAddChild(first, NULL, 0, NULL) == NULL);
+    assert(PersistentTreeGetNode(first, invalid, 1) == NULL);
+    assert(PersistentTreeNew(box, NULL, NULL) == NULL);
+
+    // The versions are independent, they can be released in any order
+    PersistentTreeRelease(third);
+    PersistentTreeRelease(first);
+    assert(strcmp(attribute(second, "name", "text"), "Changed") == 0);
+    PersistentTreeRelease(fifth);
+    PersistentTreeRelease(second);
+    assert(PersistentTreeFindPath(fourth, "save", path, 16) == 2);
+    PersistentTreeRelease(fourth);
+
+    printf("Passed!\n");
+}
+
+void testTreeHistory() {
+    printf("Testing TreeHistory... ");
+
+    TreeHistory *history = TreeHistoryNew(buildWindow());
+    int path[16];
+    char value[32];
+
+    // Ten edits, each committed as a new version
+    int depth = PersistentTreeFindPath(TreeHistoryCurrent(history), "open", path, 16);
+    for (int i = 0; i < 10; i++) {
+        sprintf(value, "Open %d", i);
+        assert(TreeHistoryCommit(history, PersistentTreeSetAttribute(TreeHistoryCurrent(history), path, depth, "label", value)) == 1);
+    }
+    assert(strcmp(attribute(TreeHistoryCurrent(history), "open", "label"), "Open 9") == 0);
+
+    // Undo and redo move between them
+    for (int i = 0; i < 3; i++) assert(TreeHistoryUndo(history) == 1);
+    assert(strcmp(attribute(TreeHistoryCurrent(history), "open", "label"), "Open 6") == 0);
+    assert(TreeHistoryRedo(history) == 1);
+    assert(strcmp(attribute(TreeHistoryCurrent(history), "open", "label"), "Open 7") == 0);
+
+    // A commit after an undo drops the versions that could be redone
+    assert(TreeHistoryCommit(history, PersistentTreeSetAttribute(TreeHistoryCurrent(history), path, depth, "label", "Other")) == 1);
+    assert(TreeHistoryRedo(history) == 0);
+    assert(strcmp(attribute(TreeHistoryCurrent(history), "open", "label"), "Other") == 0);
+
+    while (TreeHistoryUndo(history) == 1);
+    assert(strcmp(attribute(TreeHistoryCurrent(history), "open", "label"), "Open") == 0);
+
+    assert(TreeHistoryCommit(history, NULL) == -1);
+    assert(TreeHistoryUndo(NULL) == -1);
+    assert(TreeHistoryNew(NULL) == NULL);
+
+    TreeHistoryFree(history);
+    printf("Passed!\n");
+}
+
+void testPersistentTreeConversions() {
+    printf("Testing PersistentTree conversions... ");
+
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "title", "Main");
+    Tree *tree = TreeNew(window, "main", NULL, attributes);
+    HashMapFree(attributes);
+    Tree *content = TreeNew(box, "content", NULL, NULL);
+    TreeAddChild(tree, content);
+    Tree *first = TreeNew(label, "first", NULL, NULL);
+    TreeAddChild(content, first);
+    TreeAddChild(content, TreeNew(button, "second", NULL, NULL));
+
+    char *bytes = AllocatorAlloc(allocatorTree, 12);
+    memcpy(bytes, "Hello\0World", 12);
+    TextBlock *block = TextBlockAdopt(bytes, 12);
+    TreeSetText(first, block, 6, 5);
+    TextBlockRelease(block);
+
+    // The persistent copy shares the snapshots of the attributes of the tree
+    PersistentTree *persistent = PersistentTreeFromTree(tree);
+    assert(PersistentTreeGetAttributes(persistent) == TreeFreezeAttributes(tree));
+    int path[16];
+    assert(PersistentTreeFindPath(persistent, "second", path, 16) == 2 && path[0] == 0 && path[1] == 1);
+    TreeDestroyAll(tree);
+    assert(strcmp(attribute(persistent, "main", "title"), "Main") == 0);
+
+    // The text outlives the tree it was copied from
+    size_t length;
+    const int firstPath[] = {0, 0};
+    const PersistentTree *copied = PersistentTreeGetNode(persistent, firstPath, 2);
+    assert(strcmp(PersistentTreeGetText(copied, &length), "World") == 0 && length == 5);
+    assert(PersistentTreeGetText(persistent, &length) == NULL && length == 0);
+    PersistentTree *relabeled = PersistentTreeSetAttribute(persistent, firstPath, 2, "label", "Hi");
+    assert(PersistentTreeGetNode(relabeled, firstPath, 2) != copied);
+    assert(strcmp(PersistentTreeGetText(PersistentTreeGetNode(relabeled, firstPath, 2), NULL), "World") == 0);
+    PersistentTreeRelease(relabeled);
+
+    // And back, the children in the same order
+    PersistentTree *edited = PersistentTreeSetAttribute(persistent, path, 2, "label", "OK");
+    Tree *back = PersistentTreeToTree(edited);
+    assert(TreeGetType(back) == window);
+    assert(strcmp(HashMapGet(TreeGetAttributes(back), "title"), "Main") == 0);
+    Tree *second = TreeGetNode(back, "second");
+    assert(strcmp(HashMapGet(TreeGetAttributes(second), "label"), "OK") == 0);
+    assert(TreeGetParent(back, second) == TreeGetNode(back, "content"));
+    assert(strcmp(TreeGetText(TreeGetNode(back, "first"), &length), "World") == 0 && length == 5);
+    assert(TreeGetText(second, NULL) == NULL);
+
+    const char *order[] = {"main", "content", "first", "second"};
+    TreeIterator *iterator = TreeIteratorNew(back, treePreOrder);
+    for (int i = 0; i < 4; i++) assert(strcmp(TreeGetId(TreeIteratorNext(iterator)), order[i]) == 0);
+    assert(TreeIteratorNext(iterator) == NULL);
+    TreeIteratorFree(iterator);
+
+    TreeDestroyAll(back);
+    PersistentTreeRelease(edited);
+    PersistentTreeRelease(persistent);
+    assert(PersistentTreeFromTree(NULL) == NULL && PersistentTreeToTree(NULL) == NULL);
+
+    printf("Passed!\n");
+}
+
+void testPersistentTreeDeep() {
+    printf("Testing deep persistent trees... ");
+
+    // A chain of 100000 nodes, edited at the bottom and released without recursion
+    enum { LEVELS = 100000 };
+    PersistentTree *chain = PersistentTreeNew(label, "leaf", NULL);
+    char id[32];
+    for (int i = LEVELS - 2; i >= 0; i--) {
+        sprintf(id, "level-%d", i);
+        PersistentTree *parent = PersistentTreeNew(box, id, NULL);
+        PersistentTree *next = PersistentTreeAddChild(parent, NULL, 0, chain);
+        PersistentTreeRelease(parent);
+        PersistentTreeRelease(chain);
+        chain = next;
+    }
+
+    static int path[LEVELS];
+    int depth = PersistentTreeFindPath(chain, "leaf", path, LEVELS);
+    assert(depth == LEVELS - 1);
+    PersistentTree *edited = PersistentTreeSetAttribute(chain, path, depth, "text", "bottom");
+    assert(strcmp(FrozenHashMapGet(PersistentTreeGetAttributes(PersistentTreeGetNode(edited, path, depth)), "text"), "bottom") == 0);
+    assert(PersistentTreeGetAttributes(PersistentTreeGetNode(chain, path, depth)) == NULL);
+
+    PersistentTreeRelease(chain);
+    PersistentTreeRelease(edited);
+    printf("Passed!\n");
+}
+
+int main() {
+    testPersistentTreeEdits();
+    testTreeHistory();
+    testPersistentTreeConversions();
+    testPersistentTreeDeep();
+
+    printf("\nAll tests passed successfully!\n");
+    return 0;
+}
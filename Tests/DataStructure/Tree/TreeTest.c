@@ -13,10 +13,39 @@
 
 
 #include "../../DataStructure/Tree/Tree.h"
+#include "../../DataStructure/Tree/RowModel.h"
 #include <assert.h>
 #include <stdio.h>
 #include <string.h>
 
+/*
+ * Counts the allocations made while countAllocations is set, by wrapping the allocator of the
+ * C library (g_malloc goes through it too). Left out under AddressSanitizer, which replaces it.
+ */
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define COUNT_ALLOCATIONS
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+static int countAllocations, allocations;
+
+void *malloc(size_t size) {
+    if (countAllocations) allocations++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    if (countAllocations) allocations++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    if (countAllocations) allocations++;
+    return __libc_realloc(pointer, size);
+}
+#endif
+
 void testTreeNew() {
     printf("Testing TreeNew... ");
 
@@ -149,6 +178,290 @@ void testTreeUpdateNode() {
     printf("Passed!\n");
 }
 
+void testTreeNewAdopt() {
+    printf("Testing TreeNewAdopt and TreeUpdateNodeMove... ");
+
+    // A builder makes a fresh id and HashMap per node
+    enum { NODES = 1000 };
+    static char *ids[NODES];
+    static HashMap *maps[NODES];
+    static Tree *nodes[NODES];
+    for (int i = 0; i < NODES; i++) {
+        ids[i] = g_strdup_printf("node-%d", i);
+        maps[i] = HashMapNew();
+        HashMapPut(maps[i], "label", "text");
+    }
+
+#ifdef COUNT_ALLOCATIONS
+    // Copying the id and the attributes costs more than the node itself
+    allocations = 0;
+    countAllocations = 1;
+    Tree *copy = TreeNew(label, ids[0], NULL, maps[0]);
+    countAllocations = 0;
+    assert(allocations > 1);
+    TreeDestroy(copy);
+
+    // Adopting them costs exactly one allocation per node
+    allocations = 0;
+    countAllocations = 1;
+#endif
+    for (int i = 0; i < NODES; i++) nodes[i] = TreeNewAdopt(label, ids[i], NULL, maps[i]);
+#ifdef COUNT_ALLOCATIONS
+    countAllocations = 0;
+    assert(allocations == NODES);
+#endif
+
+    // The node holds the very strings and map it was given
+    assert(TreeGetId(nodes[7]) == ids[7]);
+    assert(TreeGetAttributes(nodes[7]) == maps[7]);
+
+    Tree *root = TreeNewAdopt(window, g_strdup("root"), NULL, NULL);
+    for (int i = 0; i < NODES; i++) TreeAddChild(root, nodes[i]);
+
+    // Moving a node into the tree takes its id, attributes and children without allocating
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "label", "moved");
+    Tree *replacement = TreeNewAdopt(button, g_strdup("moved"), NULL, attributes);
+    TreeAddChild(replacement, TreeNewAdopt(label, g_strdup("moved-child"), NULL, NULL));
+
+#ifdef COUNT_ALLOCATIONS
+    allocations = 0;
+    countAllocations = 1;
+#endif
+    assert(TreeUpdateNodeMove(root, "node-7", replacement) == 1);
+#ifdef COUNT_ALLOCATIONS
+    countAllocations = 0;
+    assert(allocations == 0);
+#endif
+
+    assert(TreeGetNode(root, "node-7") == NULL);
+    assert(TreeGetNode(root, "moved") == nodes[7]);
+    assert(TreeGetAttributes(nodes[7]) == attributes);
+    assert(TreeGetNode(nodes[7], "moved-child") != NULL);
+
+    // A failed move leaves the new node to the caller
+    Tree *unused = TreeNewAdopt(button, g_strdup("unused"), NULL, NULL);
+    assert(TreeUpdateNodeMove(root, "missing", unused) == -1);
+    assert(TreeUpdateNodeMove(NULL, "moved", unused) == -1);
+    assert(strcmp(TreeGetId(unused), "unused") == 0);
+    TreeDestroy(unused);
+
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+static Tree *buildCard() {
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "orientation", "vertical");
+    Tree *card = TreeNewAdopt(box, g_strdup("card"), NULL, attributes);
+
+    attributes = HashMapNew();
+    HashMapPut(attributes, "text", "Title");
+    TreeAddChild(card, TreeNewAdopt(label, g_strdup("title"), NULL, attributes));
+
+    attributes = HashMapNew();
+    HashMapPut(attributes, "label", "Go");
+    TreeAddChild(card, TreeNewAdopt(button, g_strdup("action"), NULL, attributes));
+    return card;
+}
+
+void testTreeClone() {
+    printf("Testing TreeClone and TreeInstantiate... ");
+
+    Tree *card = buildCard();
+    Tree *title = TreeGetNode(card, "title");
+    FrozenHashMap *frozen = TreeFreezeAttributes(title);
+
+    // The instance has renamed ids and shares the attributes (and snapshots) of the template
+    Tree *first = TreeInstantiate(card, "row-1");
+    Tree *second = TreeInstantiate(card, "row-2");
+    assert(strcmp(TreeGetId(first), "row-1-card") == 0);
+    Tree *firstTitle = TreeGetNode(first, "row-1-title");
+    Tree *secondTitle = TreeGetNode(second, "row-2-title");
+    assert(firstTitle && secondTitle && TreeGetNode(first, "row-1-action"));
+    assert(TreeGetParent(first, firstTitle) == first);
+    assert(TreeGetType(firstTitle) == label);
+    assert(TreeGetAttributes(firstTitle) == TreeGetAttributes(title));
+    assert(TreeFreezeAttributes(firstTitle) == frozen);
+
+    // An override copies the attributes of this node only
+    assert(TreeSetAttribute(firstTitle, "text", "First") == 1);
+    assert(TreeGetAttributes(firstTitle) != TreeGetAttributes(title));
+    assert(strcmp(HashMapGet(TreeGetAttributes(firstTitle), "text"), "First") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(title), "text"), "Title") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(secondTitle), "text"), "Title") == 0);
+    assert(TreeFreezeAttributes(firstTitle) != frozen);
+
+    // So does a change of the template
+    assert(TreeSetAttribute(title, "text", "Template") == 1);
+    assert(strcmp(HashMapGet(TreeGetAttributes(secondTitle), "text"), "Title") == 0);
+    assert(TreeSetAttribute(secondTitle, "missing", NULL) == 0);
+    assert(TreeSetAttribute(secondTitle, "text", NULL) == 1);
+    assert(HashMapGet(TreeGetAttributes(secondTitle), "text") == NULL);
+    assert(TreeSetAttribute(NULL, "text", "x") == -1);
+
+    // Instances outlive their template, a clone keeps the ids
+    TreeDestroyAll(card);
+    Tree *copy = TreeClone(first);
+    TreeDestroyAll(first);
+    assert(strcmp(HashMapGet(TreeGetAttributes(TreeGetNode(copy, "row-1-action")), "label"), "Go") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(TreeGetNode(copy, "row-1-title")), "text"), "First") == 0);
+    TreeDestroyAll(copy);
+    TreeDestroyAll(second);
+
+    assert(TreeInstantiate(NULL, "row") == NULL);
+    assert(TreeClone(NULL) == NULL);
+
+#ifdef COUNT_ALLOCATIONS
+    // The attributes are not copied: an instance costs the same whatever their number
+    enum { ATTRIBUTES = 16 };
+    Tree *plain = buildCard();
+    card = buildCard();
+    char key[16];
+    for (int i = 0; i < ATTRIBUTES; i++) {
+        sprintf(key, "key-%d", i);
+        TreeSetAttribute(TreeGetNode(card, "action"), key, "a value that would have to be copied");
+    }
+    TreeDestroyAll(TreeInstantiate(plain, "row-3"));
+    TreeDestroyAll(TreeInstantiate(card, "row-3"));
+
+    allocations = 0;
+    countAllocations = 1;
+    Tree *instance = TreeInstantiate(plain, "row-4");
+    countAllocations = 0;
+    int plainAllocations = allocations;
+    TreeDestroyAll(instance);
+
+    allocations = 0;
+    countAllocations = 1;
+    instance = TreeInstantiate(card, "row-4");
+    countAllocations = 0;
+    assert(allocations == plainAllocations);
+    TreeDestroyAll(instance);
+    TreeDestroyAll(plain);
+    TreeDestroyAll(card);
+#endif
+
+    printf("Passed!\n");
+}
+
+static void countCell(Tree *cell, void *userData) {
+    (void)cell;
+    int *count = userData;
+    (*count)++;
+}
+
+
+void testTreeRowModel() {
+    printf("Testing TreeSetRowModel... ");
+
+    enum { ROWS = 100000 };
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "wrap", "true");
+
+    RowModel *model = RowModelNew();
+    assert(RowModelAddColumn(model, label, attributes, "text") == 0);
+    assert(RowModelAddColumn(model, button, NULL, "label") == 1);
+    HashMapFree(attributes);
+
+    char text[32];
+    for (int i = 0; i < ROWS; i++) {
+        sprintf(text, "Item %d", i);
+        const char *values[] = { text, i % 2 ? "Open" : NULL };
+        assert(RowModelAppendRow(model, values) == i);
+    }
+    assert(RowModelAddColumn(model, label, NULL, "text") == -1);
+    assert(RowModelGetRowCount(model) == ROWS && RowModelGetColumnCount(model) == 2);
+
+    // The rows cost their values and an offset per cell, far less than nodes
+    assert(RowModelGetMemoryUsage(model) < (size_t)ROWS * 32);
+
+    Tree *root = TreeNew(box, "root", NULL, NULL);
+    Tree *table = TreeNew(grid, "table", NULL, NULL);
+    TreeAddChild(root, table);
+    assert(TreeSetRowModel(root, RowModelNew()) == -1);
+    assert(TreeSetRowModel(table, model) == 1);
+    assert(TreeGetRowModel(table) == model);
+
+    // Any cell is found without materializing the rows
+    Tree *cell = TreeGetNode(root, "table:76543:0");
+    assert(cell && TreeGetType(cell) == label);
+    assert(strcmp(TreeGetId(cell), "table:76543:0") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(cell), "text"), "Item 76543") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(cell), "wrap"), "true") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(cell), "row"), "76543") == 0);
+    unsigned long generation = TreeGetGeneration(root);
+    cell = TreeGetNode(root, "table:2:1");
+    assert(cell && HashMapGet(TreeGetAttributes(cell), "label") == NULL);
+
+    // A looked up cell stays valid, and reading cells changes nothing
+    Tree *first = TreeGetNode(root, "table:1:0"), *second = TreeGetNode(root, "table:2:0");
+    assert(first && second && first != second && TreeGetNode(root, "table:1:0") == first);
+    assert(strcmp(TreeGetId(first), "table:1:0") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(first), "text"), "Item 1") == 0);
+    assert(TreeGetGeneration(root) == generation);
+    assert(TreeIsLeaf(table) == 1);
+    assert(TreeGetNode(root, "table:100000:0") == NULL);
+    assert(TreeGetNode(root, "table:1:2") == NULL);
+    assert(TreeGetNode(root, "table:1") == NULL);
+    assert(TreeGetNode(root, "table:1:1x") == NULL);
+
+    // Only the last looked up cells keep a node, counted with the model
+    size_t before = RowModelGetMemoryUsage(model), usage = 0;
+    for (int row = 100; row < 900; row++) {
+        assert(TreeGetNode(root, row % 2 ? "table:3:0" : "table:4:0") != NULL);
+        char id[32];
+        sprintf(id, "table:%d:0", row);
+        assert(strcmp(TreeGetId(TreeGetNode(root, id)), id) == 0);
+        if (row == 499) usage = RowModelGetMemoryUsage(model);
+    }
+    assert(usage > before && RowModelGetMemoryUsage(model) == usage);
+    Tree *kept = TreeGetNode(root, "table:3:0");
+    assert(TreeGetNode(root, "table:4:0") != kept && TreeGetNode(root, "table:3:0") == kept);
+
+    // The cells that are not materialized change through the model only
+    Tree *replacement = TreeNew(label, "table:5:0", NULL, NULL);
+    TreeAddChild(replacement, TreeNew(label, "orphan", NULL, NULL));
+    assert(TreeUpdateNode(root, "table:5:0", replacement) == -1);
+    assert(TreeUpdateNodeMove(root, "table:5:0", replacement) == -1);
+    TreeDestroyAll(replacement);
+
+    // The materialized cells are the ones returned, changed values are read again
+    assert(RowModelSetWindow(model, 10, 5) == 1);
+    for (int row = 10; row < 15; row++) {
+        for (int column = 0; column < 2; column++) {
+            Tree *node = RowModelNewCell(model, "table", row, column);
+            TreeAddChild(table, node);
+            assert(RowModelSetCell(model, row, column, node) == 1);
+        }
+    }
+    assert(RowModelSetCell(model, 15, 0, NULL) == -1);
+    Tree *materialized = TreeGetNode(table, "table:12:1");
+    assert(TreeGetParent(root, materialized) == table);
+    assert(RowModelBindCell(model, "table", materialized, 20) == 1);
+    assert(strcmp(TreeGetId(materialized), "table:20:1") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(materialized), "row"), "20") == 0);
+    assert(RowModelBindCell(model, "table", materialized, 12) == 1);
+    assert(RowModelSetValue(model, 40, 0, "Changed") == 1);
+    assert(strcmp(HashMapGet(TreeGetAttributes(TreeGetNode(root, "table:40:0")), "text"), "Changed") == 0);
+
+    // Moving the window keeps the cells still in it
+    Tree *left = TreeGetNode(root, "table:10:0");
+    assert(RowModelSetWindow(model, 12, 10) == 1);
+    assert(TreeGetNode(root, "table:12:1") == materialized);
+    assert(TreeGetNode(root, "table:10:0") != left);
+
+    int count = 0;
+    assert(TreeForEachVirtualChild(table, countCell, &count) == 2 * ROWS);
+    assert(count == 2 * ROWS);
+    count = 0;
+    assert(TreeForEachVirtualChild(root, countCell, &count) == 1 && count == 1);
+
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+
 void testTreeDestroy() {
     printf("Testing TreeDestroy... ");
 
@@ -207,15 +520,472 @@ void testTreeGetParent() {
     printf("Passed!\n");
 }
 
+void testTreeFreezeAll() {
+    printf("Testing TreeFreezeAll... ");
+
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "label", "OK");
+    HashMap *other = HashMapNew();
+    HashMapPut(other, "label", "Cancel");
+
+    Tree *root = TreeNew(box, "root", NULL, other);
+    Tree *first = TreeNew(button, "first", NULL, attributes);
+    Tree *second = TreeNew(button, "second", NULL, attributes);
+    Tree *third = TreeNew(button, "third", NULL, other);
+    TreeAddChild(root, first);
+    TreeAddChild(root, second);
+    TreeAddChild(first, third);
+
+    // Nodes with equal attributes share one snapshot
+    assert(TreeFreezeAll(root) == 2);
+    assert(TreeFreezeAttributes(first) == TreeFreezeAttributes(second));
+    assert(TreeFreezeAttributes(root) == TreeFreezeAttributes(third));
+    assert(strcmp(FrozenHashMapGet(TreeFreezeAttributes(second), "label"), "OK") == 0);
+
+    // A snapshot retained by a reader outlives the node, an update drops the node's snapshot
+    FrozenHashMap *kept = FrozenHashMapRetain(TreeFreezeAttributes(second));
+    assert(TreeUpdateNode(root, "second", TreeNew(label, "updated", NULL, other)) == 1);
+    assert(strcmp(FrozenHashMapGet(TreeFreezeAttributes(TreeGetNode(root, "updated")), "label"), "Cancel") == 0);
+    assert(strcmp(FrozenHashMapGet(kept, "label"), "OK") == 0);
+    FrozenHashMapRelease(kept);
+
+    assert(TreeFreezeAll(NULL) == -1);
+    assert(TreeFreezeAttributes(NULL) == NULL);
+
+    TreeDestroyAll(root);
+    HashMapFree(attributes);
+    HashMapFree(other);
+    printf("Passed!\n");
+}
+
+static size_t distance(size_t a, size_t b) {
+    return a > b ? a - b : b - a;
+}
+
+void testTreeMemoryUsage() {
+    printf("Testing TreeMemoryUsage... ");
+
+    AllocatorStats treeBefore, mapBefore, treeAfter, mapAfter;
+    AllocatorGetStats(allocatorTree, &treeBefore);
+    AllocatorGetStats(allocatorHashMap, &mapBefore);
+
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "label", "OK");
+    HashMapPut(attributes, "tooltip", "Saves the document");
+    Tree *root = TreeNew(box, "root", NULL, NULL);
+    TreeAddChild(root, TreeNew(button, "save", NULL, attributes));
+    TreeAddChild(root, TreeNew(button, "open", NULL, attributes));
+    TreeAddChild(root, TreeNew(label, "status", NULL, NULL));
+    HashMapFree(attributes);
+
+    // The categories add up, and the ids and links are what the nodes hold
+    MemoryUsage usage = { 0 };
+    size_t bytes = TreeMemoryUsage(root, &usage);
+    assert(bytes == MemoryUsageTotal(&usage));
+    assert(usage.ids == strlen("root") + strlen("save") + strlen("open") + strlen("status") + 4);
+    assert(usage.childLinks == 3 * 2 * sizeof(void *));
+    assert(usage.keys > 0 && usage.values > 0 && usage.maps > 0 && usage.frozen == 0 && usage.rows == 0);
+
+    // A clone shares the attributes, the two footprints add up to what is really allocated
+    Tree *copy = TreeInstantiate(root, "copy");
+    TreeFreezeAll(root);
+    MemoryUsage both = { 0 };
+    TreeMemoryUsage(root, &both);
+    TreeMemoryUsage(copy, &both);
+    assert(both.frozen > 0);
+
+    AllocatorGetStats(allocatorTree, &treeAfter);
+    AllocatorGetStats(allocatorHashMap, &mapAfter);
+    assert(distance(treeAfter.live - treeBefore.live, both.nodes + both.childLinks) <= 8 * 4);
+    assert(distance(mapAfter.live - mapBefore.live, both.maps + both.keys + both.values + both.frozen) <= 8 * 4);
+
+    // A missing tree adds nothing
+    MemoryUsage twice = usage;
+    assert(TreeMemoryUsage(NULL, &twice) == 0);
+    assert(twice.nodes == usage.nodes);
+
+    TreeDestroyAll(copy);
+    TreeDestroyAll(root);
+    AllocatorGetStats(allocatorTree, &treeAfter);
+    assert(treeAfter.live == treeBefore.live);
+    assert(treeAfter.frees > treeBefore.frees);
+    printf("Passed!\n");
+}
+
+static char visited[256];
+
+static void collect(TreeIterator *iterator) {
+    visited[0] = '\0';
+    for (Tree *node = TreeIteratorNext(iterator); node; node = TreeIteratorNext(iterator)) {
+        strcat(visited, TreeGetId(node));
+    }
+}
+
+static visitResult skipB(Tree *node, int depth, void *userData) {
+    strcat(visited, TreeGetId(node));
+    (*(int *)userData) += depth;
+    if (strcmp(TreeGetId(node), "b") == 0) return visitSkipChildren;
+    if (strcmp(TreeGetId(node), "f") == 0) return visitStop;
+    return visitContinue;
+}
+
+void testTreeIterators() {
+    printf("Testing TreeIterator... ");
+
+    // a has the children b, c and f, b has d and e, f has g
+    Tree *a = TreeNew(box, "a", NULL, NULL);
+    Tree *b = TreeNew(box, "b", NULL, NULL);
+    Tree *f = TreeNew(box, "f", NULL, NULL);
+    TreeAddChild(a, b);
+    TreeAddChild(a, TreeNew(label, "c", NULL, NULL));
+    TreeAddChild(a, f);
+    TreeAddChild(b, TreeNew(label, "d", NULL, NULL));
+    TreeAddChild(b, TreeNew(label, "e", NULL, NULL));
+    TreeAddChild(f, TreeNew(label, "g", NULL, NULL));
+
+    TreeIterator *iterator = TreeIteratorNew(a, treePreOrder);
+    collect(iterator);
+    assert(strcmp(visited, "abdecfg") == 0);
+
+    // The same iterator is reused for the other orders
+    assert(TreeIteratorReset(iterator, a, treePostOrder) == 1);
+    collect(iterator);
+    assert(strcmp(visited, "debcgfa") == 0);
+
+    assert(TreeIteratorReset(iterator, a, treeBreadthFirst) == 1);
+    collect(iterator);
+    assert(strcmp(visited, "abcfdeg") == 0);
+
+    // Depth, parent and last child of the current node
+    TreeIteratorReset(iterator, a, treePreOrder);
+    assert(TreeIteratorNext(iterator) == a && TreeIteratorDepth(iterator) == 0 && TreeIteratorParent(iterator) == NULL);
+    assert(TreeIteratorNext(iterator) == b && TreeIteratorDepth(iterator) == 1 && TreeIteratorIsLast(iterator) == 0);
+    assert(TreeIteratorSkipChildren(iterator) == 1);
+    assert(strcmp(TreeGetId(TreeIteratorNext(iterator)), "c") == 0 && TreeIteratorParent(iterator) == a);
+    assert(TreeIteratorNext(iterator) == f && TreeIteratorIsLast(iterator) == 1);
+    assert(strcmp(TreeGetId(TreeIteratorNext(iterator)), "g") == 0 && TreeIteratorDepth(iterator) == 2);
+    assert(TreeIteratorNext(iterator) == NULL && TreeIteratorNext(iterator) == NULL);
+
+    // Skipping in breadth first order leaves the children out of the queue
+    TreeIteratorReset(iterator, a, treeBreadthFirst);
+    TreeIteratorNext(iterator);
+    assert(TreeIteratorNext(iterator) == b && TreeIteratorSkipChildren(iterator) == 1);
+    visited[0] = '\0';
+    for (Tree *node = TreeIteratorNext(iterator); node; node = TreeIteratorNext(iterator)) strcat(visited, TreeGetId(node));
+    assert(strcmp(visited, "cfg") == 0);
+
+    TreeIteratorReset(iterator, a, treePostOrder);
+    TreeIteratorNext(iterator);
+    assert(TreeIteratorSkipChildren(iterator) == -1);
+    TreeIteratorFree(iterator);
+
+    // The visitor skips the children of b and stops at f
+    int depths = 0;
+    visited[0] = '\0';
+    assert(TreeVisit(a, skipB, &depths) == 4);
+    assert(strcmp(visited, "abcf") == 0 && depths == 3);
+
+    assert(TreeIteratorNew(NULL, treePreOrder) == NULL);
+    assert(TreeIteratorNext(NULL) == NULL);
+    assert(TreeVisit(a, NULL, NULL) == -1);
+
+    TreeDestroyAll(a);
+    printf("Passed!\n");
+}
+
+static visitResult countNodes(Tree *node, int depth, void *userData) {
+    (void)node;
+    (void)depth;
+    (*(int *)userData)++;
+    return visitContinue;
+}
+
+void testTreeDeepNesting() {
+    printf("Testing deep nesting... ");
+
+    // A chain of one million nodes, far deeper than the call stack allows recursing
+    enum { LEVELS = 1000000 };
+    char id[32];
+    Tree *root = TreeNew(box, "level-0", NULL, NULL);
+    Tree *deepest = root, *parent = NULL;
+    for (int i = 1; i < LEVELS; i++) {
+        sprintf(id, "level-%d", i);
+        Tree *node = TreeNew(box, id, NULL, NULL);
+        TreeAddChild(deepest, node);
+        parent = deepest;
+        deepest = node;
+    }
+
+    sprintf(id, "level-%d", LEVELS - 1);
+    assert(TreeGetNode(root, id) == deepest);
+    assert(TreeGetNode(root, "missing") == NULL);
+    assert(TreeGetParent(root, deepest) == parent);
+
+    int count = 0;
+    assert(TreeVisit(root, countNodes, &count) == LEVELS && count == LEVELS);
+
+    TreeIterator *iterator = TreeIteratorNew(root, treePostOrder);
+    assert(TreeIteratorNext(iterator) == deepest && TreeIteratorDepth(iterator) == LEVELS - 1);
+    TreeIteratorReset(iterator, root, treeBreadthFirst);
+    count = 0;
+    while (TreeIteratorNext(iterator)) count++;
+    assert(count == LEVELS);
+    TreeIteratorFree(iterator);
+
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+void testTreeBuild() {
+    printf("Testing TreeBuild... ");
+
+    AllocatorStats before, after;
+    AllocatorGetStats(allocatorTree, &before);
+
+    // window > (box > (label, button), label), the pairs of each record follow each other
+    const char *keys[] = { "title", "spacing", "label", "label", "tooltip", "label" };
+    const char *values[] = { "Main", "6", "Name", "OK", "Saves", "Ready" };
+    TreeRecord records[] = {
+        { -1, window, "main", 0, 1 },
+        { 0, box, "content", 1, 1 },
+        { 1, label, "name", 2, 1 },
+        { 1, button, "save", 3, 2 },
+        { 0, label, "status", 5, 1 },
+    };
+    Tree *root = TreeBuild(records, 5, keys, values);
+    assert(root != NULL);
+    assert(TreeGetType(root) == window && strcmp(TreeGetId(root), "main") == 0);
+
+    // The children keep the order of the records
+    Tree *content = TreeGetNode(root, "content");
+    Tree *save = TreeGetNode(root, "save");
+    assert(TreeGetParent(root, save) == content);
+    assert(TreeGetParent(root, TreeGetNode(root, "status")) == root);
+    TreeIterator *iterator = TreeIteratorNew(root, treePreOrder);
+    const char *order[] = { "main", "content", "name", "save", "status" };
+    for (int i = 0; i < 5; i++) assert(strcmp(TreeGetId(TreeIteratorNext(iterator)), order[i]) == 0);
+    assert(TreeIteratorNext(iterator) == NULL);
+    TreeIteratorFree(iterator);
+
+    assert(HashMapSize(TreeGetAttributes(save)) == 2);
+    assert(strcmp(HashMapGet(TreeGetAttributes(save), "tooltip"), "Saves") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(root), "title"), "Main") == 0);
+    TreeDestroyAll(root);
+
+    // A record without attributes needs no keys
+    TreeRecord single = { -1, label, "alone", 0, 0 };
+    root = TreeBuild(&single, 1, NULL, NULL);
+    assert(root != NULL && TreeGetAttributes(root) == NULL);
+    TreeDestroyAll(root);
+
+    // Invalid records are rejected, and what was built so far is released
+    TreeRecord repeated[] = { { -1, box, "a", 0, 0 }, { 0, label, "b", 0, 0 }, { 0, label, "a", 0, 0 } };
+    assert(TreeBuild(repeated, 3, NULL, NULL) == NULL);
+    TreeRecord forward[] = { { -1, box, "a", 0, 0 }, { 2, label, "b", 0, 0 }, { 0, box, "c", 0, 0 } };
+    assert(TreeBuild(forward, 3, NULL, NULL) == NULL);
+    TreeRecord roots[] = { { -1, box, "a", 0, 0 }, { -1, box, "b", 0, 0 } };
+    assert(TreeBuild(roots, 2, NULL, NULL) == NULL);
+    TreeRecord unnamed[] = { { -1, box, "a", 0, 0 }, { 0, label, NULL, 0, 0 } };
+    assert(TreeBuild(unnamed, 2, NULL, NULL) == NULL);
+    TreeRecord unknown[] = { { -1, box, "a", 0, 0 }, { 0, (widgetType)WIDGET_TYPE_COUNT, "b", 0, 0 } };
+    assert(TreeBuild(unknown, 2, NULL, NULL) == NULL);
+    TreeRecord missing[] = { { -1, box, "a", 0, 1 } };
+    assert(TreeBuild(missing, 1, NULL, NULL) == NULL);
+    assert(TreeBuild(NULL, 1, NULL, NULL) == NULL);
+    assert(TreeBuild(records, 0, keys, values) == NULL);
+
+    AllocatorGetStats(allocatorTree, &after);
+    assert(after.live == before.live);
+    printf("Passed!\n");
+}
+
+void testTreeDestroyDeferred() {
+    printf("Testing TreeDestroyDeferred... ");
+
+    AllocatorStats treeBefore, mapBefore, treeAfter, mapAfter;
+    TreeReclaimerFlush();
+    AllocatorGetStats(allocatorTree, &treeBefore);
+    AllocatorGetStats(allocatorHashMap, &mapBefore);
+
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "label", "Item");
+    Tree *root = TreeNew(box, "root", NULL, NULL);
+    Tree *panel = TreeNew(box, "panel", NULL, NULL);
+    TreeAddChild(root, TreeNew(label, "title", NULL, NULL));
+    TreeAddChild(root, panel);
+    TreeAddChild(root, TreeNew(label, "status", NULL, NULL));
+    char id[32];
+    for (int i = 0; i < 1000; i++) {
+        sprintf(id, "item-%d", i);
+        TreeAddChild(panel, TreeNew(button, id, NULL, attributes));
+    }
+    HashMapFree(attributes);
+
+    // Detaching only unlinks the subtree, the other children keep their order
+    assert(TreeDetachChild(root, panel) == 1);
+    assert(TreeGetNode(root, "item-0") == NULL);
+    assert(TreeGetNode(panel, "item-999") != NULL);
+    assert(TreeGetNode(root, "title") != NULL && TreeGetNode(root, "status") != NULL);
+    assert(TreeDetachChild(root, panel) == -1);
+    assert(TreeDetachChild(NULL, panel) == -1);
+
+    // The reclaimer thread releases the whole subtree
+    assert(TreeDestroyDeferred(panel) == 1);
+    assert(TreeDestroyDeferred(NULL) == -1);
+    TreeDestroyDeferred(root);
+    TreeReclaimerFlush();
+
+    AllocatorGetStats(allocatorTree, &treeAfter);
+    AllocatorGetStats(allocatorHashMap, &mapAfter);
+    assert(treeAfter.live == treeBefore.live);
+    assert(mapAfter.live == mapBefore.live);
+    printf("Passed!\n");
+}
+
+void testTreeText() {
+    printf("Testing TreeText... ");
+
+    AllocatorStats before, after;
+    AllocatorGetStats(allocatorTree, &before);
+
+    // The nodes hold slices of one block, nothing is copied
+    const char content[] = "Hello\0Save\0";
+    char *bytes = AllocatorAlloc(allocatorTree, sizeof(content));
+    memcpy(bytes, content, sizeof(content));
+    TextBlock *block = TextBlockAdopt(bytes, sizeof(content));
+    assert(block);
+
+    Tree *root = TreeNew(box, "root", NULL, NULL);
+    Tree *title = TreeNew(label, "title", NULL, NULL);
+    Tree *save = TreeNew(button, "save", NULL, NULL);
+    Tree *other = TreeNew(label, "other", NULL, NULL);
+    TreeAddChild(root, title);
+    TreeAddChild(root, save);
+    assert(TreeGetText(title, NULL) == NULL);
+    assert(TreeSetText(title, block, 0, 5) == 1);
+    assert(TreeSetText(save, block, 6, 4) == 1);
+    assert(TreeSetText(other, block, 6, 4) == 1);
+
+    size_t length;
+    assert(TreeGetText(title, &length) == bytes && length == 5);
+    assert(strcmp(TreeGetText(save, &length), "Save") == 0 && length == 4);
+
+    // The slice must be a string of the block
+    assert(TreeSetText(title, block, 0, 4) == -1);
+    assert(TreeSetText(title, block, 6, 6) == -1);
+    assert(TreeSetText(title, block, 12, 0) == -1);
+    assert(TreeSetText(NULL, block, 0, 5) == -1);
+    assert(TreeGetText(NULL, &length) == NULL);
+
+    // The block lives as long as a node uses it, clones share the slices
+    TextBlockRelease(block);
+    Tree *copy = TreeInstantiate(root, "copy");
+    assert(TreeGetText(TreeGetNode(copy, "copy-title"), NULL) == bytes);
+
+    MemoryUsage usage = { 0 }, copyUsage = { 0 };
+    TreeMemoryUsage(root, &usage);
+    TreeMemoryUsage(copy, &copyUsage);
+    assert(usage.text > 0 && usage.text + copyUsage.text <= sizeof(content) + 3 * sizeof(void *));
+
+    // Replacing a node takes the text of the new one, a NULL block removes it
+    assert(TreeUpdateNodeMove(copy, "copy-title", other) == 1);
+    assert(strcmp(TreeGetText(TreeGetNode(copy, "other"), NULL), "Save") == 0);
+    assert(TreeSetText(title, NULL, 0, 0) == 1 && TreeGetText(title, NULL) == NULL);
+
+    TreeDestroyAll(root);
+    assert(strcmp(TreeGetText(TreeGetNode(copy, "copy-save"), NULL), "Save") == 0);
+    TreeDestroyAll(copy);
+
+    AllocatorGetStats(allocatorTree, &after);
+    assert(after.live == before.live);
+    printf("Passed!\n");
+}
+
+void testTreeGeneration() {
+    printf("Testing TreeGetGeneration... ");
+
+    AllocatorStats before, after;
+    AllocatorGetStats(allocatorTree, &before);
+
+    Tree *one = TreeNew(box, "one", NULL, NULL), *two = TreeNew(box, "two", NULL, NULL);
+    Tree *panel = TreeNew(box, "panel", NULL, NULL), *item = TreeNew(label, "item", NULL, NULL);
+    TreeAddChild(one, panel);
+    TreeAddChild(panel, item);
+    TreeAddChild(two, TreeNew(label, "other", NULL, NULL));
+
+    // Each tree has its own generation, no two trees have the same one
+    unsigned long first = TreeGetGeneration(one), second = TreeGetGeneration(two);
+    assert(first && second && first != second);
+    assert(TreeGetGeneration(one) == first && TreeGetGeneration(item) == first);
+    assert(TreeGetGeneration(NULL) == 0);
+
+    // Changing a tree, however deep, leaves the other trees alone
+    assert(TreeSetAttribute(item, "text", "Item") == 1);
+    unsigned long changed = TreeGetGeneration(one);
+    assert(changed != first && TreeGetGeneration(two) == second);
+    TreeAddChild(two, TreeNew(label, "new", NULL, NULL));
+    assert(TreeGetGeneration(one) == changed && TreeGetGeneration(two) != second);
+
+    // A subtree moved to another tree changes it from then on, trees being built change nothing
+    assert(TreeDetachChild(one, panel) == 1);
+    changed = TreeGetGeneration(one);
+    second = TreeGetGeneration(two);
+    TreeAddChild(two, panel);
+    assert(TreeGetGeneration(two) != second && TreeGetGeneration(panel) == TreeGetGeneration(two));
+    second = TreeGetGeneration(two);
+    TreeSetId(item, "moved");
+    Tree *built = TreeNew(box, "built", NULL, NULL);
+    TreeAddChild(built, TreeNew(label, "child", NULL, NULL));
+    TreeDestroyAll(built);
+    assert(TreeGetGeneration(one) == changed && TreeGetGeneration(two) != second);
+
+    // The nodes changed since a generation are known until the structure changes
+    Tree *nodes[TREE_CHANGES];
+    unsigned long since = TreeGetGeneration(two);
+    assert(TreeGetChanges(two, since, nodes, TREE_CHANGES) == 0);
+    TreeSetId(item, "renamed");
+    TreeSetAttribute(panel, "title", "Panel");
+    assert(TreeGetChanges(item, since, nodes, TREE_CHANGES) == 2 && nodes[0] == panel && nodes[1] == item);
+    assert(TreeGetChanges(two, since, nodes, 1) == -1);
+    assert(TreeGetChanges(two, first - 1, nodes, TREE_CHANGES) == -1);
+    TreeAddChild(panel, TreeNew(label, "late", NULL, NULL));
+    assert(TreeGetChanges(two, since, nodes, TREE_CHANGES) == -1);
+
+    // Only the last changes are remembered
+    since = TreeGetGeneration(two);
+    for (int i = 0; i < TREE_CHANGES; i++) TreeSetId(item, i % 2 ? "odd" : "even");
+    assert(TreeGetChanges(two, since, nodes, TREE_CHANGES) == TREE_CHANGES);
+    TreeSetId(item, "last");
+    assert(TreeGetChanges(two, since, nodes, TREE_CHANGES) == -1);
+    assert(TreeGetChanges(NULL, since, nodes, TREE_CHANGES) == -1);
+
+    TreeDestroyAll(one);
+    TreeDestroyAll(two);
+    AllocatorGetStats(allocatorTree, &after);
+    assert(after.live == before.live);
+    printf("Passed!\n");
+}
+
 int main() {
     testTreeNew();
     testTreeAddChild();
     testTreeRemoveChild();
     testTreeGetNode();
     testTreeUpdateNode();
+    testTreeNewAdopt();
+    testTreeClone();
+    testTreeRowModel();
     testTreeDestroy();
     testTreeIsLeaf();
     testTreeGetParent();
+    testTreeFreezeAll();
+    testTreeMemoryUsage();
+    testTreeIterators();
+    testTreeDeepNesting();
+    testTreeBuild();
+    testTreeDestroyDeferred();
+    testTreeText();
+    testTreeGeneration();
 
     HashMap *hashmap = HashMapNew();
     HashMapPut(hashmap, "key-1", "value-1");
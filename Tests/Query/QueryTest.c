@@ -0,0 +1,265 @@
+/***************************************************************************************************
+ * @file QueryTest.c                                                                               *
+ * @brief The unit tests for the selector queries                                                  *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Query.h                                                                                    *
+ **************************************************************************************************/
+
+#include "../../Query/Query.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+static Tree *addNode(Tree *parent, widgetType type, const char *id, const char *label) {
+    HashMap *attributes = NULL;
+    if(label) {
+        attributes = HashMapNew();
+        HashMapPut(attributes, "label", label);
+    }
+    Tree *node = TreeNew(type, id, NULL, attributes);
+    HashMapFree(attributes);
+    if(parent) TreeAddChild(parent, node);
+    return node;
+}
+
+/*
+ * window#main
+ *   box#toolbar
+ *     button#open [label=Open]
+ *     button#save [label=Save]
+ *   box#content
+ *     box#form
+ *       label#name [label=Name]
+ *       button#submit [label=OK]
+ *     button#cancel [label=Cancel]
+ */
+static Tree *buildWindow() {
+    Tree *root = addNode(NULL, window, "main", NULL);
+    Tree *toolbar = addNode(root, box, "toolbar", NULL);
+    addNode(toolbar, button, "open", "Open");
+    addNode(toolbar, button, "save", "Save");
+    Tree *content = addNode(root, box, "content", NULL);
+    Tree *form = addNode(content, box, "form", NULL);
+    addNode(form, label, "name", "Name");
+    addNode(form, button, "submit", "OK");
+    addNode(content, button, "cancel", "Cancel");
+    return root;
+}
+
+/* Runs a selector and checks the ids of the results, given as one space separated string */
+static void expect(TreeIndex *index, Tree *scope, const char *text, const char *ids) {
+    Selector *selector = SelectorCompile(text);
+    assert(selector);
+
+    Tree **results;
+    int count = QuerySelectAll(index, scope, selector, &results);
+    assert(count >= 0);
+
+    char found[256] = "";
+    for(int i = 0; i < count; i++) {
+        if(i) strcat(found, " ");
+        strcat(found, TreeGetId(results[i]));
+    }
+    if(strcmp(found, ids) != 0) printf("\n%s: expected \"%s\", found \"%s\"\n", text, ids, found);
+    assert(strcmp(found, ids) == 0);
+
+    free(results);
+    SelectorFree(selector);
+}
+
+void testSelectorCompile() {
+    printf("Testing SelectorCompile... ");
+
+    const char *valid[] = {"button", "*", "#ok", "[label]", "[label=OK]", "[ label = 'O K' ]", "[label=\"a>b\"]",
+                           "button#ok[label=OK][visible]", "box button", "box>button", "  box  >  button  ",
+                           "window box > * label"};
+    for(size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        Selector *selector = SelectorCompile(valid[i]);
+        assert(selector);
+        SelectorFree(selector);
+    }
+
+    const char *invalid[] = {"", "   ", "slider", "#", "[label", "[=OK]", "[label=]", "[label='OK]", "box >",
+                             "> box", "box > > button", "button#a#b", "box,button", "label ~ button", "button.primary"};
+    for(size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) assert(SelectorCompile(invalid[i]) == NULL);
+
+    assert(SelectorCompile(NULL) == NULL);
+    SelectorFree(NULL);
+
+    printf("Passed!\n");
+}
+
+void testQuerySelectAll() {
+    printf("Testing QuerySelectAll... ");
+
+    Tree *root = buildWindow();
+    TreeIndex *index = TreeIndexNew(root);
+    assert(TreeIndexSize(index) == 9);
+
+    expect(index, NULL, "button", "open save submit cancel");
+    expect(index, NULL, "*", "main toolbar open save content form name submit cancel");
+    expect(index, NULL, "#submit", "submit");
+    expect(index, NULL, "button#name", "");
+    expect(index, NULL, "[label=OK]", "submit");
+    expect(index, NULL, "[label]", "open save name submit cancel");
+    expect(index, NULL, "box button", "open save submit cancel");
+    expect(index, NULL, "window > box > button", "open save cancel");
+    expect(index, NULL, "#content button", "submit cancel");
+    expect(index, NULL, "#content > button", "cancel");
+    expect(index, NULL, "window box button", "open save submit cancel");
+    expect(index, NULL, "box box > *", "name submit");
+    expect(index, NULL, "window > #form", "");
+
+    // Queries under a scope only return its descendants, the ancestors can be above it
+    Tree *content = TreeGetNode(root, "content");
+    expect(index, content, "button", "submit cancel");
+    expect(index, content, "window button", "submit cancel");
+    expect(index, content, "#content", "");
+    expect(index, TreeGetNode(root, "toolbar"), "#submit", "");
+
+    assert(QuerySelectFirst(index, NULL, NULL) == NULL);
+    Selector *selector = SelectorCompile("box > button");
+    assert(QuerySelectFirst(index, NULL, selector) == TreeGetNode(root, "open"));
+    assert(QuerySelectFirst(index, content, selector) == TreeGetNode(root, "submit"));
+
+    // A node outside the tree is not a valid scope
+    Tree *stranger = addNode(NULL, box, "stranger", NULL);
+    Tree **results;
+    assert(QuerySelectAll(index, stranger, selector, &results) == -1 && results == NULL);
+    assert(QuerySelectAll(NULL, NULL, selector, &results) == -1);
+    TreeDestroy(stranger);
+
+    SelectorFree(selector);
+    TreeIndexFree(index);
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+void testAttributeIndex() {
+    printf("Testing TreeIndexAddAttribute... ");
+
+    Tree *root = buildWindow();
+    TreeIndex *index = TreeIndexNew(root);
+
+    // The indexed attribute gives the same answers
+    assert(TreeIndexAddAttribute(index, "label") == 1);
+    assert(TreeIndexAddAttribute(index, "label") == 0);
+    assert(TreeIndexAddAttribute(NULL, "label") == -1);
+    expect(index, NULL, "[label=OK]", "submit");
+    expect(index, NULL, "button[label=Save]", "save");
+    expect(index, NULL, "label[label=OK]", "");
+    expect(index, NULL, "#form > [label=OK]", "submit");
+    expect(index, NULL, "[label=Missing]", "");
+
+    // Added after the index was built
+    assert(TreeIndexAddAttribute(index, "title") == 1);
+    expect(index, NULL, "[title=Main]", "");
+
+    TreeIndexFree(index);
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+void testIndexRefresh() {
+    printf("Testing index refresh... ");
+
+    Tree *root = buildWindow();
+    TreeIndex *index = TreeIndexNew(root);
+    TreeIndexAddAttribute(index, "label");
+    expect(index, NULL, "#toolbar > button", "open save");
+
+    // Changing the tree rebuilds the index on the next query
+    addNode(TreeGetNode(root, "toolbar"), button, "print", "Print");
+    assert(TreeIndexSize(index) == 10);
+    expect(index, NULL, "#toolbar > button", "open save print");
+    expect(index, NULL, "[label=Print]", "print");
+
+    TreeRemoveChild(TreeGetNode(root, "toolbar"), "open");
+    expect(index, NULL, "#toolbar > button", "save print");
+
+    Tree *replacement = addNode(NULL, button, "help", "Help");
+    TreeUpdateNode(root, "save", replacement);
+    TreeDestroy(replacement);
+    expect(index, NULL, "#toolbar > button", "help print");
+    expect(index, NULL, "[label=Help]", "help");
+    expect(index, NULL, "[label=Save]", "");
+
+    // Ids and attributes changed in place are moved in the lists, several at once too
+    Tree *submit = TreeGetNode(root, "submit");
+    TreeSetId(submit, "send");
+    TreeSetAttribute(submit, "label", "Send");
+    TreeSetAttribute(TreeGetNode(root, "cancel"), "label", NULL);
+    TreeSetAttribute(TreeGetNode(root, "name"), "label", "Send");
+    expect(index, NULL, "#send", "send");
+    expect(index, NULL, "#submit", "");
+    expect(index, NULL, "[label=Send]", "name send");
+    expect(index, NULL, "[label=Cancel]", "");
+    expect(index, NULL, "#form > button", "send");
+
+    // More changes than the tree remembers rebuild it
+    for(int i = 0; i <= TREE_CHANGES; i++) TreeSetAttribute(submit, "label", i % 2 ? "Odd" : "Even");
+    expect(index, NULL, "[label=Even]", "send");
+    expect(index, NULL, "[label=Send]", "name");
+    assert(TreeIndexSize(index) == 9);
+
+    TreeIndexFree(index);
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+void testLargeTree() {
+    printf("Testing queries on a large tree... ");
+
+    // 1000 boxes of 100 buttons, the 7th button of each box labelled "Seven"
+    Tree *root = addNode(NULL, window, "main", NULL);
+    char id[32];
+    for(int i = 0; i < 1000; i++) {
+        sprintf(id, "box%d", i);
+        Tree *row = addNode(root, box, id, NULL);
+        for(int j = 0; j < 100; j++) {
+            sprintf(id, "button%d_%d", i, j);
+            addNode(row, button, id, j == 7 ? "Seven" : "Other");
+        }
+    }
+
+    TreeIndex *index = TreeIndexNew(root);
+    TreeIndexAddAttribute(index, "label");
+    assert(TreeIndexSize(index) == 1 + 1000 + 100000);
+
+    Tree **results;
+    Selector *selector = SelectorCompile("#box500 > [label=Seven]");
+    assert(QuerySelectAll(index, NULL, selector, &results) == 1);
+    assert(strcmp(TreeGetId(results[0]), "button500_7") == 0);
+    free(results);
+    SelectorFree(selector);
+
+    selector = SelectorCompile("box button[label=Seven]");
+    assert(QuerySelectAll(index, TreeGetNode(root, "box999"), selector, &results) == 1);
+    free(results);
+    assert(QuerySelectAll(index, NULL, selector, &results) == 1000);
+    assert(strcmp(TreeGetId(results[0]), "button0_7") == 0);
+    assert(strcmp(TreeGetId(results[999]), "button999_7") == 0);
+    free(results);
+    SelectorFree(selector);
+
+    TreeIndexFree(index);
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+int main() {
+    testSelectorCompile();
+    testQuerySelectAll();
+    testAttributeIndex();
+    testIndexRefresh();
+    testLargeTree();
+
+    printf("\nAll tests passed successfully!\n");
+    return 0;
+}
@@ -0,0 +1,205 @@
+/***************************************************************************************************
+ * @file DirtySetTest.c                                                                            *
+ * @brief The unit tests for the set of nodes changed by a transaction                             *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see DirtySet.h                                                                                 *
+ **************************************************************************************************/
+
+#include "../../Renderer/DirtySet.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+static Tree *addNode(Tree *parent, widgetType type, const char *id) {
+    Tree *node = TreeNew(type, id, NULL, NULL);
+    if (parent) TreeAddChild(parent, node);
+    return node;
+}
+
+/*
+ * box#root
+ *   box#first
+ *     label#a
+ *     label#b
+ *   box#second
+ *     button#c
+ */
+static Tree *buildTree() {
+    Tree *root = addNode(NULL, box, "root");
+    Tree *first = addNode(root, box, "first");
+    addNode(first, label, "a");
+    addNode(first, label, "b");
+    addNode(addNode(root, box, "second"), button, "c");
+    return root;
+}
+
+/* Records the calls of a flush as "+id" for an added subtree and "id:name,name" for changed attributes */
+static int recordAdded(Tree *node, Tree *parent, void *userData) {
+    (void)parent;
+    char *log = userData;
+    sprintf(log + strlen(log), "%s+%s", *log ? " " : "", TreeGetId(node));
+    return 1;
+}
+
+static int recordChanged(Tree *node, const Atom *names, int count, void *userData) {
+    char *log = userData;
+    sprintf(log + strlen(log), "%s%s:", *log ? " " : "", TreeGetId(node));
+    for (int i = 0; i < count; i++) sprintf(log + strlen(log), "%s%s", i ? "," : "", AtomToString(names[i]));
+    return count;
+}
+
+static int failChanged(Tree *node, const Atom *names, int count, void *userData) {
+    (void)node;
+    (void)names;
+    (void)count;
+    (void)userData;
+    return -1;
+}
+
+static const DirtySetCallbacks recorder = { recordAdded, recordChanged };
+
+void testCoalescing() {
+    printf("Testing coalesced changes... ");
+
+    // An attribute changed three times is flushed once, next to the other attributes of its node
+    Tree *root = buildTree();
+    Tree *a = TreeGetNode(root, "a");
+    DirtySet *set = DirtySetNew();
+    assert(DirtySetMarkAttribute(set, a, AtomIntern("text")) == 1);
+    assert(DirtySetMarkAttribute(set, a, AtomIntern("text")) == 0);
+    assert(DirtySetMarkAttribute(set, a, AtomIntern("wrap")) == 1);
+    assert(DirtySetMarkAttribute(set, a, AtomIntern("text")) == 0);
+    assert(DirtySetCount(set) == 1);
+
+    char log[256] = "";
+    assert(DirtySetFlush(set, root, &recorder, log) == 2);
+    assert(strcmp(log, "a:text,wrap") == 0);
+
+    // The flush empties the set
+    log[0] = '\0';
+    assert(DirtySetCount(set) == 0);
+    assert(DirtySetFlush(set, root, &recorder, log) == 0 && log[0] == '\0');
+
+    // The changes inside an added subtree are flushed with it
+    Tree *row = addNode(NULL, box, "row");
+    Tree *cell = addNode(row, label, "cell");
+    TreeAddChild(root, row);
+    assert(DirtySetMarkAdded(set, row) == 1);
+    assert(DirtySetMarkAttribute(set, cell, AtomIntern("text")) == 1);
+    assert(DirtySetMarkAttribute(set, row, AtomIntern("spacing")) == 1);
+    assert(DirtySetFlush(set, root, &recorder, log) == 1);
+    assert(strcmp(log, "+row") == 0);
+
+    DirtySetFree(set);
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+void testAddThenRemove() {
+    printf("Testing added then removed nodes... ");
+
+    // A node added then removed is never flushed, nor its attributes
+    Tree *root = buildTree();
+    DirtySet *set = DirtySetNew();
+    Tree *extra = addNode(NULL, label, "extra");
+    TreeAddChild(TreeGetNode(root, "second"), extra);
+    assert(DirtySetMarkAdded(set, extra) == 1);
+    assert(DirtySetMarkAttribute(set, extra, AtomIntern("text")) == 1);
+    assert(DirtySetCount(set) == 1);
+    assert(DirtySetForget(set, extra) == 1);
+    assert(TreeRemoveChild(TreeGetNode(root, "second"), "extra") == 1);
+    assert(DirtySetCount(set) == 0);
+
+    // Changes of a removed node are dropped, the others are kept
+    Tree *b = TreeGetNode(root, "b");
+    assert(DirtySetMarkAttribute(set, b, AtomIntern("text")) == 1);
+    assert(DirtySetMarkAttribute(set, TreeGetNode(root, "c"), AtomIntern("label")) == 1);
+    assert(DirtySetForget(set, b) == 1);
+    assert(TreeRemoveChild(TreeGetNode(root, "first"), "b") == 1);
+    assert(DirtySetForget(set, TreeGetNode(root, "a")) == 0);
+
+    char log[256] = "";
+    assert(DirtySetFlush(set, root, &recorder, log) == 1);
+    assert(strcmp(log, "c:label") == 0);
+
+    DirtySetFree(set);
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+void testFlushOrder() {
+    printf("Testing the flush order... ");
+
+    // The nodes are flushed in tree order, whatever the order they changed in
+    Tree *root = buildTree();
+    DirtySet *set = DirtySetNew();
+    Tree *late = addNode(NULL, label, "late");
+    TreeAddChild(TreeGetNode(root, "first"), late);
+    assert(DirtySetMarkAttribute(set, TreeGetNode(root, "c"), AtomIntern("label")) == 1);
+    assert(DirtySetMarkAdded(set, late) == 1);
+    assert(DirtySetMarkAttribute(set, TreeGetNode(root, "b"), AtomIntern("text")) == 1);
+    assert(DirtySetMarkAttribute(set, root, AtomIntern("spacing")) == 1);
+    assert(DirtySetMarkAttribute(set, TreeGetNode(root, "a"), AtomIntern("wrap")) == 1);
+
+    char log[256] = "";
+    assert(DirtySetFlush(set, root, &recorder, log) == 5);
+    assert(strcmp(log, "root:spacing a:wrap b:text +late c:label") == 0);
+
+    // Enough nodes to grow the table, each flushed once and in order
+    Tree *list = addNode(NULL, box, "list");
+    char id[16];
+    for (int i = 0; i < 500; i++) {
+        sprintf(id, "row%d", i);
+        addNode(list, label, id);
+    }
+    for (int i = 499; i >= 0; i--) {
+        sprintf(id, "row%d", i);
+        assert(DirtySetMarkAttribute(set, TreeGetNode(list, id), AtomIntern("text")) == 1);
+    }
+    assert(DirtySetCount(set) == 500);
+    static char longLog[500 * 16];
+    longLog[0] = '\0';
+    assert(DirtySetFlush(set, list, &recorder, longLog) == 500);
+    assert(strncmp(longLog, "row0:text row1:text row2:text", 29) == 0);
+    assert(strcmp(longLog + strlen(longLog) - 23, "row498:text row499:text") == 0);
+
+    // The nodes of another Tree are left out, and an added root is flushed alone
+    Tree *other = addNode(NULL, box, "other");
+    assert(DirtySetMarkAttribute(set, other, AtomIntern("spacing")) == 1);
+    assert(DirtySetMarkAttribute(set, TreeGetNode(list, "row3"), AtomIntern("text")) == 1);
+    assert(DirtySetMarkAdded(set, list) == 1);
+    longLog[0] = '\0';
+    assert(DirtySetFlush(set, list, &recorder, longLog) == 1);
+    assert(strcmp(longLog, "+list") == 0);
+    TreeDestroyAll(other);
+
+    // A failing callback fails the flush, which still empties the set
+    assert(DirtySetMarkAttribute(set, TreeGetNode(list, "row7"), AtomIntern("text")) == 1);
+    const DirtySetCallbacks failing = { recordAdded, failChanged };
+    assert(DirtySetFlush(set, list, &failing, NULL) == -1);
+    assert(DirtySetCount(set) == 0);
+
+    assert(DirtySetMarkAttribute(NULL, root, AtomIntern("text")) == -1);
+    assert(DirtySetMarkAttribute(set, root, 0) == -1);
+    assert(DirtySetFlush(set, NULL, &recorder, log) == -1);
+    DirtySetFree(set);
+    DirtySetFree(NULL);
+    TreeDestroyAll(list);
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+int main() {
+    testCoalescing();
+    testAddThenRemove();
+    testFlushOrder();
+
+    printf("\nAll tests passed successfully!\n");
+    return 0;
+}
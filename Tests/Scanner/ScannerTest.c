@@ -0,0 +1,287 @@
+/***************************************************************************************************
+ * @file ScannerTest.c                                                                             *
+ * @brief The unit tests for the Scanner                                                           *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Scanner.h                                                                                  *
+ **************************************************************************************************/
+
+#include "../../Scanner/Scanner.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+static Tree *scan(const char *markup) {
+    FILE *file = fmemopen((void *)markup, strlen(markup), "r");
+    Tree *tree = performLexicalAnalysis(file);
+    fclose(file);
+    return tree;
+}
+
+void testParseAttributes() {
+    printf("Testing parseAttributes... ");
+
+    // Pairs separated by any white space, with either quote
+    char text[] = " label=\"Save\"\ttooltip = 'Saves \"it\"'\n margin='4' ";
+    HashMap *attributes = HashMapNewWithCapacity(3);
+    assert(parseAttributes(text, strlen(text), attributes) == 3);
+    assert(HashMapSize(attributes) == 3);
+    assert(strcmp(HashMapGet(attributes, "label"), "Save") == 0);
+    assert(strcmp(HashMapGet(attributes, "tooltip"), "Saves \"it\"") == 0);
+    assert(strcmp(HashMapGet(attributes, "margin"), "4") == 0);
+    HashMapFree(attributes);
+
+    char empty[] = "   ";
+    attributes = HashMapNew();
+    assert(parseAttributes(empty, strlen(empty), attributes) == 0);
+
+    // Invalid pairs, forbidden characters and repeated names
+    const char *invalid[] = { "label", "label=Save", "=\"Save\"", "label=\"Save", "label=\"<b>\"",
+                              "label='a>b'", "label=\"a\" label=\"b\"", "a=\"1\" b=\"2\" a='3'" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        char copy[64];
+        strcpy(copy, invalid[i]);
+        assert(parseAttributes(copy, strlen(copy), attributes) == -1);
+    }
+    HashMapFree(attributes);
+    printf("Passed!\n");
+}
+
+void testEscapedValues() {
+    printf("Testing escaped attribute values... ");
+
+    // The entities are decoded when the values are read, wherever the '&' falls in a long value
+    char text[] = "label=\"Tom &amp; Jerry\" tooltip='It&apos;s a rather long tooltip, &lt;past&gt; sixteen bytes' "
+                  "plain=\"a value long enough for the vector loop, without any entity\" amp='&'";
+    HashMap *attributes = HashMapNewWithCapacity(4);
+    assert(parseAttributes(text, strlen(text), attributes) == 4);
+    assert(strcmp(HashMapGet(attributes, "label"), "Tom & Jerry") == 0);
+    assert(strcmp(HashMapGet(attributes, "tooltip"), "It's a rather long tooltip, <past> sixteen bytes") == 0);
+    assert(strcmp(HashMapGet(attributes, "plain"), "a value long enough for the vector loop, without any entity") == 0);
+    assert(strcmp(HashMapGet(attributes, "amp"), "&") == 0);
+    HashMapFree(attributes);
+
+    // The id is decoded too
+    Tree *tree = scan("<box id=\"a&amp;b\"><label id='c' text=\"&#72;i\" /></box>");
+    assert(strcmp(TreeGetId(tree), "a&b") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(TreeGetNode(tree, "c")), "text"), "Hi") == 0);
+    TreeDestroyAll(tree);
+    printf("Passed!\n");
+}
+
+void testLongValues() {
+    printf("Testing long attribute values... ");
+
+    // A value far longer than any fixed buffer, and many attributes on one tag
+    enum { LENGTH = 100000, COUNT = 2000 };
+    char *markup = malloc(LENGTH + COUNT * 32 + 64);
+    char *end = markup + sprintf(markup, "<label id=\"long\" text=\"");
+    memset(end, 'x', LENGTH);
+    end += LENGTH;
+    end += sprintf(end, "\"");
+    for (int i = 0; i < COUNT; i++) end += sprintf(end, " data%d='%d'", i, i);
+    strcpy(end, " />");
+
+    Tree *tree = scan(markup);
+    const HashMap *attributes = TreeGetAttributes(tree);
+    assert(strcmp(TreeGetId(tree), "long") == 0);
+    assert(HashMapSize(attributes) == COUNT + 1);
+    assert(strlen(HashMapGet(attributes, "text")) == LENGTH);
+    assert(strcmp(HashMapGet(attributes, "data1999"), "1999") == 0);
+
+    TreeDestroyAll(tree);
+    free(markup);
+    printf("Passed!\n");
+}
+
+void testText() {
+    printf("Testing texts... ");
+
+    // The white spaces around a text are dropped, and its entities decoded
+    Tree *tree = scan("<box id='root'>\n  <label id='title'>\n    Tom &amp; Jerry\t</label>\n"
+                      "  <button id='save'>Save<!-- the label --> all</button>\n"
+                      "  <label id='empty'>  </label>\n</box>");
+    size_t length;
+    assert(TreeGetText(tree, NULL) == NULL);
+    assert(strcmp(TreeGetText(TreeGetNode(tree, "title"), &length), "Tom & Jerry") == 0 && length == 11);
+    assert(strcmp(TreeGetText(TreeGetNode(tree, "save"), NULL), "Save all") == 0);
+    assert(TreeGetText(TreeGetNode(tree, "empty"), NULL) == NULL);
+    TreeDestroyAll(tree);
+
+    // The texts around the children of an element are joined, even when a child has text too
+    tree = scan("<box id='root'>before<label id='a'>inner</label>middle<label id='b' />after</box>");
+    assert(strcmp(TreeGetText(tree, NULL), "before middle after") == 0);
+    assert(strcmp(TreeGetText(TreeGetNode(tree, "a"), NULL), "inner") == 0);
+    TreeDestroyAll(tree);
+
+    // A text split by many children is joined once, the block only holding the joined text
+    char *markup = malloc(16 * 1000 + 32), *expected = malloc(8 * 1000);
+    size_t used = sprintf(markup, "<box id='root'>"), joined = 0;
+    for (int i = 0; i < 1000; i++) {
+        used += sprintf(markup + used, "w%d<label />", i);
+        joined += sprintf(expected + joined, i ? " w%d" : "w%d", i);
+    }
+    strcpy(markup + used, "</box>");
+    tree = scan(markup);
+    assert(strcmp(TreeGetText(tree, &length), expected) == 0 && length == joined);
+    MemoryUsage split = { 0 };
+    TreeMemoryUsage(tree, &split);
+    assert(split.text <= joined + 1 + 64);
+    TreeDestroyAll(tree);
+    free(markup);
+    free(expected);
+
+    // The texts share one block, released with the last node using it
+    AllocatorStats before, after;
+    AllocatorGetStats(allocatorTree, &before);
+    tree = scan("<box id='root'><label id='a'>one</label><label id='b'>two</label></box>");
+    const char *one = TreeGetText(TreeGetNode(tree, "a"), NULL), *two = TreeGetText(TreeGetNode(tree, "b"), NULL);
+    assert(two == one + strlen("one") + 1);
+    MemoryUsage usage = { 0 };
+    TreeMemoryUsage(tree, &usage);
+    assert(usage.text >= strlen("one") + strlen("two") + 2);
+    TreeDestroyAll(tree);
+    AllocatorGetStats(allocatorTree, &after);
+    assert(after.live == before.live);
+    printf("Passed!\n");
+}
+
+void testComments() {
+    printf("Testing comments... ");
+
+    // Comments go anywhere between tags, with any character but their end in them
+    Tree *tree = scan("<!-- header -->\n<box id='root'><!-- <label id='hidden' /> - -> -- >\n-->"
+                      "<label id='shown' /><!----></box><!-- trailer -->");
+    assert(TreeGetNode(tree, "hidden") == NULL);
+    assert(TreeGetNode(tree, "shown") != NULL);
+    TreeDestroyAll(tree);
+
+    // A comment much longer than a block, its "-->" at every position around a block boundary
+    for (int shift = 0; shift < 40; shift++) {
+        size_t bodyLength = 4096 * 2 - 20 + shift;
+        char *markup = malloc(bodyLength + 128);
+        char *end = markup + sprintf(markup, "<box id='root'><!--");
+        for (size_t i = 0; i < bodyLength; i++) end[i] = (i % 61 == 60) ? '\n' : (i % 7 == 3) ? '>' : (i % 7 == 2) ? ' ' : '-';
+        end += bodyLength;
+        strcpy(end, "--><label id='after'>text</label></box>");
+
+        tree = scan(markup);
+        assert(strcmp(TreeGetText(TreeGetNode(tree, "after"), NULL), "text") == 0);
+        TreeDestroyAll(tree);
+        free(markup);
+    }
+    printf("Passed!\n");
+}
+
+void testErrors() {
+    printf("Testing invalid markups... ");
+
+    // Each error is reported with its line, and what was built before it is freed
+    static const struct { const char *markup; int line; } cases[] = {
+        { "<box id='root'>\n  <label>text</label>\n</grid>", 3 },
+        { "<box id='root'>\n  <unknown />\n</box>", 2 },
+        { "<box id='root'><label text='a' text='b' /></box>", 1 },
+        { "<box id='root'>\n<label>a &amp; b\n", 3 },
+        { "<box id='root'></box>\n<box id='second'></box>", 2 },
+        { "<box id='root'>\n<!-- never closed\n</box>", 3 },
+        { "text before any element", 1 },
+    };
+    AllocatorStats treeBefore, scannerBefore, treeAfter, scannerAfter;
+    AllocatorGetStats(allocatorTree, &treeBefore);
+    AllocatorGetStats(allocatorScanner, &scannerBefore);
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        FILE *file = fmemopen((void *)cases[i].markup, strlen(cases[i].markup), "r");
+        int line = -1;
+        assert(tryLexicalAnalysis(file, &line) == NULL);
+        assert(line == cases[i].line);
+        fclose(file);
+    }
+    AllocatorGetStats(allocatorTree, &treeAfter);
+    AllocatorGetStats(allocatorScanner, &scannerAfter);
+    assert(treeAfter.live == treeBefore.live && scannerAfter.live == scannerBefore.live);
+
+    // A valid markup is built as by performLexicalAnalysis
+    const char *markup = "<box id='root'><label id='title'>Title</label></box>";
+    FILE *file = fmemopen((void *)markup, strlen(markup), "r");
+    int line = -1;
+    Tree *tree = tryLexicalAnalysis(file, &line);
+    fclose(file);
+    assert(tree && line == 0);
+    assert(strcmp(TreeGetText(TreeGetNode(tree, "title"), NULL), "Title") == 0);
+    TreeDestroyAll(tree);
+    printf("Passed!\n");
+}
+
+// The allocator hooks of testOutOfMemory, every allocation fails once the count given by userData is spent
+static void *failingAllocate(size_t size, void *userData) {
+    int *left = (int *)userData;
+    return (*left)-- > 0 ? malloc(size) : NULL;
+}
+
+static void *failingReallocate(void *block, size_t oldSize, size_t size, void *userData) {
+    (void)oldSize;
+    int *left = (int *)userData;
+    return (*left)-- > 0 ? realloc(block, size) : NULL;
+}
+
+static void failingRelease(void *block, size_t size, void *userData) {
+    (void)size;
+    (void)userData;
+    free(block);
+}
+
+void testOutOfMemory() {
+    printf("Testing allocation failures... ");
+
+    // Each allocation fails in turn: the failure is reported, and what was built before it is freed
+    const char *markup = "<box id='root'>\n  Before <label text='a &amp; b'>Label</label>\n  after\n</box>";
+    int left = 0;
+    AllocatorHooks hooks = { failingAllocate, failingReallocate, failingRelease, &left };
+    assert(AllocatorSetHooks(&hooks) == 1);
+
+    Tree *tree = NULL;
+    int failures = 0;
+    while (!tree) {
+        left = failures;
+        FILE *file = fmemopen((void *)markup, strlen(markup), "r");
+        int line = -1;
+        tree = tryLexicalAnalysis(file, &line);
+        fclose(file);
+        if (tree) break;
+
+        assert(line == SCANNER_OUT_OF_MEMORY);
+        for (int subsystem = 0; subsystem < ALLOCATOR_SUBSYSTEM_COUNT; subsystem++) {
+            AllocatorStats stats;
+            AllocatorGetStats((allocatorSubsystem)subsystem, &stats);
+            assert(stats.live == 0);
+        }
+        failures++;
+    }
+
+    // Once enough allocations succeed the tree is built as usual (reading it may allocate too)
+    assert(failures > 5);
+    left = 1 << 30;
+    assert(strcmp(TreeGetText(tree, NULL), "Before after") == 0);
+    assert(strcmp(HashMapGet(TreeGetAttributes(TreeGetNode(tree, "label-1")), "text"), "a & b") == 0);
+    TreeDestroyAll(tree);
+    assert(AllocatorSetHooks(NULL) == 1);
+    printf("Passed!\n");
+}
+
+int main() {
+    testParseAttributes();
+    testEscapedValues();
+    testText();
+    testComments();
+    testLongValues();
+    testErrors();
+    testOutOfMemory();
+
+    printf("\nAll tests passed successfully!\n");
+    return 0;
+}
@@ -0,0 +1,218 @@
+/***************************************************************************************************
+ * @file SerializerTest.c                                                                          *
+ * @brief The unit tests for the Tree serializers                                                  *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Serializer.h                                                                               *
+ **************************************************************************************************/
+
+#include "../../Serializer/Serializer.h"
+#include "../../Scanner/Scanner.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+static Tree *buildWindow() {
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "title", "Tom & \"Jerry\"");
+    Tree *root = TreeNew(window, "main", NULL, attributes);
+    HashMapFree(attributes);
+
+    attributes = HashMapNew();
+    HashMapPut(attributes, "spacing", "4");
+    HashMapPut(attributes, "orientation", "vertical");
+    Tree *content = TreeNew(box, "content", NULL, attributes);
+    HashMapFree(attributes);
+
+    attributes = HashMapNew();
+    HashMapPut(attributes, "text", "a\tb");
+    TreeAddChild(content, TreeNew(label, "greeting", NULL, attributes));
+    HashMapFree(attributes);
+
+    TreeAddChild(content, TreeNew(button, "ok", NULL, NULL));
+    TreeAddChild(root, content);
+    return root;
+}
+
+void testMarkup() {
+    printf("Testing SerializerToMarkup... ");
+
+    Tree *root = buildWindow();
+    size_t length;
+
+    // Attributes are sorted by name after the id, the values escaped
+    char *markup = SerializerToMarkup(root, 0, &length);
+    assert(strcmp(markup, "<window id=\"main\" title=\"Tom &amp; &quot;Jerry&quot;\">"
+                          "<box id=\"content\" orientation=\"vertical\" spacing=\"4\">"
+                          "<label id=\"greeting\" text=\"a\tb\" />"
+                          "<button id=\"ok\" />"
+                          "</box></window>") == 0);
+    assert(length == strlen(markup));
+    free(markup);
+
+    markup = SerializerToMarkup(root, 2, NULL);
+    assert(strcmp(markup, "<window id=\"main\" title=\"Tom &amp; &quot;Jerry&quot;\">\n"
+                          "  <box id=\"content\" orientation=\"vertical\" spacing=\"4\">\n"
+                          "    <label id=\"greeting\" text=\"a\tb\" />\n"
+                          "    <button id=\"ok\" />\n"
+                          "  </box>\n"
+                          "</window>\n") == 0);
+    free(markup);
+
+    assert(SerializerToMarkup(NULL, 0, NULL) == NULL);
+    assert(SerializerToMarkup(root, -1, NULL) == NULL);
+
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+void testJson() {
+    printf("Testing SerializerToJson... ");
+
+    Tree *root = buildWindow();
+
+    char *json = SerializerToJson(root, 0, NULL);
+    assert(strcmp(json, "{\"type\":\"window\",\"id\":\"main\",\"attributes\":{\"title\":\"Tom & \\\"Jerry\\\"\"},\"children\":["
+                        "{\"type\":\"box\",\"id\":\"content\",\"attributes\":{\"orientation\":\"vertical\",\"spacing\":\"4\"},\"children\":["
+                        "{\"type\":\"label\",\"id\":\"greeting\",\"attributes\":{\"text\":\"a\\tb\"}},"
+                        "{\"type\":\"button\",\"id\":\"ok\",\"attributes\":{}}"
+                        "]}]}") == 0);
+    free(json);
+
+    json = SerializerToJson(root, 1, NULL);
+    assert(strcmp(json, "{\"type\":\"window\",\"id\":\"main\",\"attributes\":{\"title\":\"Tom & \\\"Jerry\\\"\"},\"children\":[\n"
+                        " {\"type\":\"box\",\"id\":\"content\",\"attributes\":{\"orientation\":\"vertical\",\"spacing\":\"4\"},\"children\":[\n"
+                        "  {\"type\":\"label\",\"id\":\"greeting\",\"attributes\":{\"text\":\"a\\tb\"}},\n"
+                        "  {\"type\":\"button\",\"id\":\"ok\",\"attributes\":{}}\n"
+                        " ]}\n"
+                        "]}\n") == 0);
+    free(json);
+
+    TreeDestroyAll(root);
+    printf("Passed!\n");
+}
+
+void testRoundTrip() {
+    printf("Testing markup round trip... ");
+
+    // What the scanner reads back is written the same way again
+    HashMap *attributes = HashMapNew();
+    HashMapPut(attributes, "spacing", "4");
+    HashMapPut(attributes, "halign", "center");
+    Tree *root = TreeNew(box, "root", NULL, attributes);
+    TreeAddChild(root, TreeNew(label, "first", NULL, attributes));
+    TreeAddChild(root, TreeNew(label, "second", NULL, NULL));
+    HashMapFree(attributes);
+
+    size_t length;
+    char *markup = SerializerToMarkup(root, 4, &length);
+    FILE *file = fmemopen(markup, length, "r");
+    Tree *parsed = performLexicalAnalysis(file);
+    fclose(file);
+
+    char *again = SerializerToMarkup(parsed, 4, NULL);
+    assert(strcmp(markup, again) == 0);
+
+    free(markup);
+    free(again);
+    TreeDestroyAll(root);
+    TreeDestroyAll(parsed);
+    printf("Passed!\n");
+}
+
+void testText() {
+    printf("Testing texts... ");
+
+    // The text follows the opening tag, escaped, and survives a round trip
+    const char *document = "<box id=\"root\">Items &amp; more<label id=\"title\">Tom &lt;3</label><button id=\"save\" /></box>";
+    FILE *file = fmemopen((void *)document, strlen(document), "r");
+    Tree *root = performLexicalAnalysis(file);
+    fclose(file);
+
+    char *markup = SerializerToMarkup(root, 0, NULL);
+    assert(strcmp(markup, "<box id=\"root\">Items &amp; more<label id=\"title\">Tom &lt;3</label><button id=\"save\" /></box>") == 0);
+    char *json = SerializerToJson(root, 0, NULL);
+    assert(strstr(json, "{\"type\":\"label\",\"id\":\"title\",\"attributes\":{},\"text\":\"Tom <3\"}") != NULL);
+
+    size_t length;
+    char *indented = SerializerToMarkup(root, 4, &length);
+    file = fmemopen(indented, length, "r");
+    Tree *parsed = performLexicalAnalysis(file);
+    fclose(file);
+    char *again = SerializerToMarkup(parsed, 4, NULL);
+    assert(strcmp(indented, again) == 0);
+
+    free(markup);
+    free(json);
+    free(indented);
+    free(again);
+    TreeDestroyAll(root);
+    TreeDestroyAll(parsed);
+    printf("Passed!\n");
+}
+
+void testDeepTree() {
+    printf("Testing deep trees... ");
+
+    // Far deeper than a fixed size prefix or the call stack would allow
+    enum { LEVELS = 100000 };
+    char id[32];
+    Tree *root = TreeNew(box, "level-0", NULL, NULL);
+    Tree *deepest = root;
+    for (int i = 1; i < LEVELS; i++) {
+        sprintf(id, "level-%d", i);
+        Tree *node = TreeNew(box, id, NULL, NULL);
+        TreeAddChild(deepest, node);
+        deepest = node;
+    }
+
+    size_t length;
+    char *markup = SerializerToMarkup(root, 0, &length);
+    assert(strncmp(markup, "<box id=\"level-0\"><box id=\"level-1\">", 36) == 0);
+    assert(strcmp(markup + length - 12, "</box></box>") == 0);
+
+    // The scanner reads it back whole
+    FILE *file = fmemopen(markup, length, "r");
+    Tree *parsed = performLexicalAnalysis(file);
+    fclose(file);
+    char *again = SerializerToMarkup(parsed, 0, NULL);
+    assert(strcmp(markup, again) == 0);
+
+    char *json = SerializerToJson(root, 0, &length);
+    assert(strncmp(json, "{\"type\":\"box\",\"id\":\"level-0\",\"attributes\":{},\"children\":[{", 58) == 0);
+    assert(strstr(json, "\"id\":\"level-99999\",\"attributes\":{}}]}]}") != NULL);
+
+    // Writing to a file descriptor gives the same document
+    FILE *output = tmpfile();
+    assert(SerializerWriteJson(root, 0, fileno(output)) == (long)length);
+    rewind(output);
+    char *read = malloc(length + 1);
+    assert(fread(read, 1, length + 1, output) == length);
+    assert(memcmp(read, json, length) == 0);
+    fclose(output);
+    assert(SerializerWriteMarkup(root, 0, -1) == -1);
+
+    free(read);
+    free(markup);
+    free(again);
+    free(json);
+    TreeDestroyAll(root);
+    TreeDestroyAll(parsed);
+    printf("Passed!\n");
+}
+
+int main() {
+    testMarkup();
+    testJson();
+    testRoundTrip();
+    testText();
+    testDeepTree();
+
+    printf("\nAll tests passed successfully!\n");
+    return 0;
+}
@@ -0,0 +1,185 @@
+/***************************************************************************************************
+ * @file Allocator.c                                                                               *
+ * @brief The implementation of the allocator hooks and of their counters                          *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Allocator.h                                                                                *
+ **************************************************************************************************/
+
+#include "Allocator.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The counters of a subsystem, updated from any thread
+ */
+struct Counters
+{
+    atomic_ulong allocations;
+    atomic_ulong frees;
+    atomic_size_t live;
+    atomic_size_t peak;
+};
+
+
+static void *defaultAllocate(size_t size, void *userData) { (void)userData; return malloc(size); }
+static void *defaultReallocate(void *block, size_t oldSize, size_t size, void *userData) { (void)oldSize; (void)userData; return realloc(block, size); }
+static void defaultRelease(void *block, size_t size, void *userData) { (void)size; (void)userData; free(block); }
+
+
+static AllocatorHooks currentHooks = { defaultAllocate, defaultReallocate, defaultRelease, NULL };
+static struct Counters counters[ALLOCATOR_SUBSYSTEM_COUNT];
+
+
+
+
+/**
+ * @brief Counts a block of a subsystem, and raises its peak if needed
+ */
+static void countAllocation(allocatorSubsystem subsystem, size_t size)
+{
+    struct Counters *counter = &counters[subsystem];
+    atomic_fetch_add_explicit(&counter->allocations, 1, memory_order_relaxed);
+    size_t live = atomic_fetch_add_explicit(&counter->live, size, memory_order_relaxed) + size;
+
+    size_t peak = atomic_load_explicit(&counter->peak, memory_order_relaxed);
+    while(live > peak && !atomic_compare_exchange_weak_explicit(&counter->peak, &peak, live, memory_order_relaxed, memory_order_relaxed));
+}
+
+
+/**
+ * @brief Counts the release of a block of a subsystem
+ */
+static void countFree(allocatorSubsystem subsystem, size_t size)
+{
+    atomic_fetch_add_explicit(&counters[subsystem].frees, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&counters[subsystem].live, size, memory_order_relaxed);
+}
+
+
+
+
+int AllocatorSetHooks(const AllocatorHooks *hooks)
+{
+    // The blocks still live would be released by hooks that did not allocate them
+    for(int subsystem = 0; subsystem < ALLOCATOR_SUBSYSTEM_COUNT; subsystem++)
+    {
+        if(atomic_load(&counters[subsystem].live)) return -1;
+    }
+
+    if(!hooks) currentHooks = (AllocatorHooks){ defaultAllocate, defaultReallocate, defaultRelease, NULL };
+    else
+    {
+        if(!hooks->allocate || !hooks->reallocate || !hooks->release) return -1;
+        currentHooks = *hooks;
+    }
+    return 1;
+}
+
+
+
+
+void *AllocatorAlloc(allocatorSubsystem subsystem, size_t size)
+{
+    void *block = currentHooks.allocate(size, currentHooks.userData);
+    if(block) countAllocation(subsystem, size);
+    return block;
+}
+
+
+
+
+void *AllocatorCalloc(allocatorSubsystem subsystem, size_t count, size_t size)
+{
+    // Check the size for an overflow
+    if(size && count > SIZE_MAX / size) return NULL;
+
+    void *block = AllocatorAlloc(subsystem, count * size);
+    if(block) memset(block, 0, count * size);
+    return block;
+}
+
+
+
+
+void *AllocatorRealloc(allocatorSubsystem subsystem, void *block, size_t oldSize, size_t size)
+{
+    if(!block) return AllocatorAlloc(subsystem, size);
+
+    void *resized = currentHooks.reallocate(block, oldSize, size, currentHooks.userData);
+    if(!resized) return NULL;
+
+    // A reallocation counts as the release of the old block and the allocation of the new one
+    countFree(subsystem, oldSize);
+    countAllocation(subsystem, size);
+    return resized;
+}
+
+
+
+
+void AllocatorFree(allocatorSubsystem subsystem, void *block, size_t size)
+{
+    if(!block) return;
+
+    currentHooks.release(block, size, currentHooks.userData);
+    countFree(subsystem, size);
+}
+
+
+
+
+char *AllocatorStrdup(allocatorSubsystem subsystem, const char *string)
+{
+    // Check the input parameter
+    if(!string) return NULL;
+
+    size_t size = strlen(string) + 1;
+    char *copy = (char *)AllocatorAlloc(subsystem, size);
+    if(copy) memcpy(copy, string, size);
+    return copy;
+}
+
+
+
+
+int AllocatorGetStats(allocatorSubsystem subsystem, AllocatorStats *stats)
+{
+    // Check the input parameters
+    if((int)subsystem < 0 || subsystem >= ALLOCATOR_SUBSYSTEM_COUNT || !stats) return -1;
+
+    stats->allocations = atomic_load_explicit(&counters[subsystem].allocations, memory_order_relaxed);
+    stats->frees = atomic_load_explicit(&counters[subsystem].frees, memory_order_relaxed);
+    stats->live = atomic_load_explicit(&counters[subsystem].live, memory_order_relaxed);
+    stats->peak = atomic_load_explicit(&counters[subsystem].peak, memory_order_relaxed);
+    return 1;
+}
+
+
+
+
+void AllocatorResetPeak(allocatorSubsystem subsystem)
+{
+    // Check the input parameter
+    if((int)subsystem < 0 || subsystem >= ALLOCATOR_SUBSYSTEM_COUNT) return;
+
+    atomic_store(&counters[subsystem].peak, atomic_load(&counters[subsystem].live));
+}
+
+
+
+
+size_t MemoryUsageTotal(const MemoryUsage *usage)
+{
+    // Check the input parameter
+    if(!usage) return 0;
+
+    return usage->nodes + usage->childLinks + usage->ids + usage->maps + usage->keys + usage->values + usage->frozen + usage->rows + usage->text;
+}
@@ -0,0 +1,161 @@
+/***************************************************************************************************
+ * @file Allocator.h                                                                               *
+ * @brief Defines the allocator hooks and the memory accounting of the data structures             *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Allocator.c                                                                                *
+ **************************************************************************************************/
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stddef.h>
+
+/**
+ * @brief The subsystems whose allocations are counted apart
+ */
+typedef enum
+{
+    allocatorHashMap,   ///< HashMap.c: maps, tables, entries, typed values and frozen snapshots
+    allocatorTree,      ///< Tree.c: nodes, child links, shared attributes and iterators
+    allocatorScanner    ///< Scanner.c: the stack of open tags
+} allocatorSubsystem;
+
+#define ALLOCATOR_SUBSYSTEM_COUNT (allocatorScanner + 1)  ///< The number of subsystems
+
+
+/**
+ * @brief The functions every counted allocation goes through
+ * 
+ * The size of a block is given back when it is reallocated or released, so the hooks need no
+ * header of their own to find it (and neither do the counters).
+ */
+typedef struct
+{
+    void *(*allocate)(size_t size, void *userData);                                 ///< Returns a block of size bytes, or NULL
+    void *(*reallocate)(void *block, size_t oldSize, size_t size, void *userData);  ///< Resizes a block, or returns NULL and leaves it
+    void (*release)(void *block, size_t size, void *userData);                     ///< Releases a block
+    void *userData;                                                                 ///< Passed unchanged to the hooks
+} AllocatorHooks;
+
+
+/**
+ * @brief The counters of a subsystem
+ */
+typedef struct
+{
+    unsigned long allocations;  ///< The number of blocks allocated (reallocations included)
+    unsigned long frees;        ///< The number of blocks released (reallocations included)
+    size_t live;                ///< The number of bytes allocated and not released
+    size_t peak;                ///< The highest number of live bytes since the start (or AllocatorResetPeak)
+} AllocatorStats;
+
+
+/**
+ * @brief The deep footprint of a data structure, by category, in bytes requested from the allocator
+ * 
+ * The attributes and snapshots shared by several nodes are counted in proportion to the share of
+ * each, so the footprints of all the sharers add up to what they really use.
+ */
+typedef struct
+{
+    size_t nodes;       ///< The Tree nodes, with the owners of their shared attributes
+    size_t childLinks;  ///< The links of the children lists
+    size_t ids;         ///< The ids of the nodes
+    size_t maps;        ///< The HashMap structures and their tables
+    size_t keys;        ///< The keys of the attributes
+    size_t values;      ///< The values of the attributes, with their parsed forms
+    size_t frozen;      ///< The frozen snapshots of the attributes
+    size_t rows;        ///< The virtual rows of the grids
+    size_t text;        ///< The text content of the nodes, in the blocks they share
+} MemoryUsage;
+
+
+/**
+ * @brief Replaces the allocator of the counted subsystems
+ * 
+ * Blocks are released by the hooks that allocated them, so the hooks can only be replaced while
+ * no counted block is live.
+ * @param hooks The new hooks (copied), or NULL to go back to the C library
+ * @return 1 on success, -1 if some blocks are still live
+ */
+int AllocatorSetHooks(const AllocatorHooks *hooks);
+
+
+/**
+ * @brief Allocates a block for a subsystem
+ * @param subsystem The subsystem it is counted in
+ * @param size The number of bytes
+ * @return The block, or NULL if the allocation fails
+ */
+void *AllocatorAlloc(allocatorSubsystem subsystem, size_t size);
+
+
+/**
+ * @brief Allocates a block filled with zeros for a subsystem
+ * @param subsystem The subsystem it is counted in
+ * @param count The number of elements
+ * @param size The size of an element
+ * @return The block, or NULL if the allocation fails or the size overflows
+ */
+void *AllocatorCalloc(allocatorSubsystem subsystem, size_t count, size_t size);
+
+
+/**
+ * @brief Resizes a block of a subsystem
+ * @param subsystem The subsystem it is counted in
+ * @param block The block, or NULL to allocate one
+ * @param oldSize The size the block was allocated with
+ * @param size The new size
+ * @return The block, or NULL if it fails (the old block is left as it was)
+ */
+void *AllocatorRealloc(allocatorSubsystem subsystem, void *block, size_t oldSize, size_t size);
+
+
+/**
+ * @brief Releases a block of a subsystem
+ * @param subsystem The subsystem it was counted in
+ * @param block The block, NULL does nothing
+ * @param size The size the block was allocated with
+ */
+void AllocatorFree(allocatorSubsystem subsystem, void *block, size_t size);
+
+
+/**
+ * @brief Copies a string into a block of a subsystem, released with a size of strlen + 1
+ * @param subsystem The subsystem it is counted in
+ * @param string The string to copy
+ * @return The copy, or NULL if the string is NULL or the allocation fails
+ */
+char *AllocatorStrdup(allocatorSubsystem subsystem, const char *string);
+
+
+/**
+ * @brief Reads the counters of a subsystem
+ * @param subsystem The subsystem
+ * @param stats Where the counters are written
+ * @return 1 on success, -1 if the parameters are not valid
+ */
+int AllocatorGetStats(allocatorSubsystem subsystem, AllocatorStats *stats);
+
+
+/**
+ * @brief Starts the peak of a subsystem over from its live bytes
+ * @param subsystem The subsystem
+ */
+void AllocatorResetPeak(allocatorSubsystem subsystem);
+
+
+/**
+ * @brief Returns the sum of the categories of a footprint
+ * @param usage The footprint
+ * @return The number of bytes
+ */
+size_t MemoryUsageTotal(const MemoryUsage *usage);
+
+#endif // ALLOCATOR_H
@@ -0,0 +1,153 @@
+/***************************************************************************************************
+ * @file Atom.c                                                                                    *
+ * @brief The implementation of the atoms                                                          *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Atom.h                                                                                     *
+ **************************************************************************************************/
+
+#include "Atom.h"
+#include "Hash.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ATOM_INITIAL_CAPACITY 256  ///< The initial number of slots of the atom table
+
+/**
+ * @brief The table of the interned strings
+ * 
+ * The strings are stored by atom in names, and found by an open addressing table of atoms
+ * whose size is a power of two, kept at most half full.
+ */
+static struct
+{
+    char **names;           ///< The interned strings, names[atom] (names[0] is unused)
+    Atom count;             ///< The number of interned strings
+    Atom *slots;            ///< The open addressing table, 0 marks an empty slot
+    unsigned int capacity;  ///< The number of slots, a power of two
+    pthread_mutex_t lock;   ///< Protects the table, atoms are interned from the scanner threads
+} atoms = { NULL, 0, NULL, 0, PTHREAD_MUTEX_INITIALIZER };
+
+
+
+
+/**
+ * @brief Returns the slot holding a string, or the empty slot where it belongs
+ */
+static unsigned int findSlot(const char *name, unsigned int hash)
+{
+    unsigned int mask = atoms.capacity - 1;
+    unsigned int slot = hash & mask;
+    while(atoms.slots[slot] && strcmp(atoms.names[atoms.slots[slot]], name) != 0) slot = (slot + 1) & mask;
+    return slot;
+}
+
+
+/**
+ * @brief Doubles the size of the atom table and the names array
+ */
+static int growTable()
+{
+    unsigned int capacity = atoms.capacity ? atoms.capacity * 2 : ATOM_INITIAL_CAPACITY;
+
+    // The names array never holds more than capacity / 2 atoms, plus the unused names[0]
+    char **names = (char **)realloc(atoms.names, (capacity / 2 + 1) * sizeof(char *));
+    if(!names) return -1;
+    atoms.names = names;
+
+    Atom *slots = (Atom *)calloc(capacity, sizeof(Atom));
+    if(!slots) return -1;
+
+    // Rehash the interned strings in the new table
+    free(atoms.slots);
+    atoms.slots = slots;
+    atoms.capacity = capacity;
+    for(Atom atom = 1; atom <= atoms.count; atom++)
+    {
+        atoms.slots[findSlot(atoms.names[atom], HashString(atoms.names[atom]))] = atom;
+    }
+
+    return 1;
+}
+
+
+
+
+Atom AtomIntern(const char *name)
+{
+    // Check the input parameter
+    if(!name) return 0;
+
+    pthread_mutex_lock(&atoms.lock);
+
+    // Keep the table at most half full
+    Atom atom = 0;
+    if((atoms.count + 1) * 2 > atoms.capacity && growTable() == -1)
+    {
+        pthread_mutex_unlock(&atoms.lock);
+        return 0;
+    }
+
+    unsigned int slot = findSlot(name, HashString(name));
+    atom = atoms.slots[slot];
+    if(!atom)
+    {
+        // Intern a copy of the string
+        char *copy = (char *)malloc(strlen(name) + 1);
+        if(copy)
+        {
+            strcpy(copy, name);
+            atom = ++atoms.count;
+            atoms.names[atom] = copy;
+            atoms.slots[slot] = atom;
+        }
+    }
+
+    pthread_mutex_unlock(&atoms.lock);
+    return atom;
+}
+
+
+
+
+Atom AtomLookup(const char *name)
+{
+    // Check the input parameter
+    if(!name) return 0;
+
+    pthread_mutex_lock(&atoms.lock);
+    Atom atom = atoms.capacity ? atoms.slots[findSlot(name, HashString(name))] : 0;
+    pthread_mutex_unlock(&atoms.lock);
+
+    return atom;
+}
+
+
+
+
+const char *AtomToString(Atom atom)
+{
+    pthread_mutex_lock(&atoms.lock);
+    const char *name = (atom && atom <= atoms.count) ? atoms.names[atom] : NULL;
+    pthread_mutex_unlock(&atoms.lock);
+
+    return name;
+}
+
+
+
+
+Atom AtomCount()
+{
+    pthread_mutex_lock(&atoms.lock);
+    Atom count = atoms.count;
+    pthread_mutex_unlock(&atoms.lock);
+
+    return count;
+}
@@ -0,0 +1,59 @@
+/***************************************************************************************************
+ * @file Atom.h                                                                                    *
+ * @brief Defines the atoms, interned strings identified by a small integer                        *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Atom.c                                                                                     *
+ **************************************************************************************************/
+
+#ifndef ATOM_H
+#define ATOM_H
+
+/**
+ * @brief An interned string, 0 is never a valid atom
+ * 
+ * Atoms are numbered from 1 in the order they are interned, so they can index arrays.
+ */
+typedef unsigned int Atom;
+
+
+/**
+ * @brief Returns the atom of a string, interning the string if needed
+ * 
+ * @param name The string to intern
+ * @return The atom of the string, or 0 if the name is NULL or an allocation fails
+ */
+Atom AtomIntern(const char *name);
+
+
+/**
+ * @brief Returns the atom of a string without interning it
+ * 
+ * @param name The string to look up
+ * @return The atom of the string, or 0 if the string was never interned
+ */
+Atom AtomLookup(const char *name);
+
+
+/**
+ * @brief Returns the string of an atom
+ * 
+ * @param atom The atom to convert
+ * @return The interned string (valid until the end of the program), or NULL if the atom is not valid
+ */
+const char *AtomToString(Atom atom);
+
+
+/**
+ * @brief Returns the number of interned atoms, the biggest valid atom
+ * 
+ * @return The number of interned atoms
+ */
+Atom AtomCount();
+
+#endif // ATOM_H
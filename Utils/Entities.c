@@ -0,0 +1,106 @@
+/***************************************************************************************************
+ * @file Entities.c                                                                                *
+ * @brief The implementation of the decoding of the markup entities                                *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Entities.h                                                                                 *
+ **************************************************************************************************/
+
+#include "Entities.h"
+#include <string.h>
+
+/**
+ * @brief The named entities of the markup, the numeric ones (&#N; and &#xH;) are decoded too
+ */
+static const struct
+{
+    const char *name;
+    size_t length;
+    char character;
+} namedEntities[] = {
+    { "&amp;", 5, '&' }, { "&lt;", 4, '<' }, { "&gt;", 4, '>' }, { "&quot;", 6, '"' }, { "&apos;", 6, '\'' }
+};
+
+
+/**
+ * @brief Reads the entity at the start of a text and writes its character in UTF-8
+ * 
+ * @return The length of the entity, or 0 if the text does not start with a known, valid entity
+ */
+static size_t readEntity(const char *text, char *bytes, size_t *count)
+{
+    for(size_t i = 0; i < sizeof(namedEntities) / sizeof(namedEntities[0]); i++)
+    {
+        if(strncmp(text, namedEntities[i].name, namedEntities[i].length) == 0)
+        {
+            bytes[0] = namedEntities[i].character;
+            *count = 1;
+            return namedEntities[i].length;
+        }
+    }
+    if(text[1] != '#') return 0;
+
+    // A code point, in decimal or in hexadecimal
+    int base = (text[2] == 'x' || text[2] == 'X') ? 16 : 10;
+    const char *digits = text + (base == 16 ? 3 : 2), *c = digits;
+    unsigned long code = 0;
+    for(;; c++)
+    {
+        int digit;
+        if(*c >= '0' && *c <= '9') digit = *c - '0';
+        else if(base == 16 && (*c | 0x20) >= 'a' && (*c | 0x20) <= 'f') digit = (*c | 0x20) - 'a' + 10;
+        else break;
+
+        code = code * base + digit;
+        if(code > 0x10FFFF) return 0;
+    }
+    if(c == digits || *c != ';' || !code || (code >= 0xD800 && code <= 0xDFFF)) return 0;
+
+    if(code < 0x80) { bytes[0] = (char)code; *count = 1; }
+    else if(code < 0x800) { bytes[0] = (char)(0xC0 | code >> 6); *count = 2; }
+    else if(code < 0x10000) { bytes[0] = (char)(0xE0 | code >> 12); *count = 3; }
+    else { bytes[0] = (char)(0xF0 | code >> 18); *count = 4; }
+    for(size_t i = 1; i < *count; i++) bytes[i] = (char)(0x80 | (code >> (6 * (*count - 1 - i)) & 0x3F));
+
+    return (size_t)(c + 1 - text);
+}
+
+
+
+
+size_t EntitiesDecode(const char *text, char *out)
+{
+    // Check the input parameter
+    if(!text) return 0;
+
+    size_t length = 0;
+    while(*text)
+    {
+        // Copy the characters up to the next '&' at once
+        size_t run = strcspn(text, "&");
+        if(out) memmove(out + length, text, run);
+        length += run;
+        text += run;
+        if(!*text) break;
+
+        char bytes[4];
+        size_t count = 1, read = readEntity(text, bytes, &count);
+        if(!read)
+        {
+            bytes[0] = '&';
+            read = 1;
+        }
+
+        if(out) memcpy(out + length, bytes, count);
+        length += count;
+        text += read;
+    }
+
+    if(out) out[length] = '\0';
+    return length;
+}
@@ -0,0 +1,32 @@
+/***************************************************************************************************
+ * @file Entities.h                                                                                *
+ * @brief Defines the decoding of the entities of the markup                                       *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Entities.c                                                                                 *
+ **************************************************************************************************/
+
+#ifndef ENTITIES_H
+#define ENTITIES_H
+
+#include <stddef.h>
+
+/**
+ * @brief Decodes the entities of a text
+ * 
+ * The five named entities of the markup (&amp; &lt; &gt; &quot; &apos;) and the numeric ones
+ * (&#N; and &#xH;, written in UTF-8) are decoded, the unknown or invalid ones are kept as they are.
+ * A decoded text is never longer than the text, so it can be decoded in place (out == text).
+ * 
+ * @param text The text to decode (NUL terminated)
+ * @param out Where the decoded text is written (NUL terminated), or NULL to measure it only
+ * @return The length of the decoded text
+ */
+size_t EntitiesDecode(const char *text, char *out);
+
+#endif // ENTITIES_H
@@ -0,0 +1,55 @@
+/***************************************************************************************************
+ * @file Enums.c                                                                                   *
+ * @brief The implementation of the enum helpers                                                   *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Enums.h                                                                                    *
+ **************************************************************************************************/
+
+#include "Enums.h"
+#include <string.h>
+
+/**
+ * @brief The tag names of the widget types, indexed by widgetType
+ */
+static const char *const widgetTypeNames[WIDGET_TYPE_COUNT] = {
+    "window",
+    "headerBar",
+    "box",
+    "grid",
+    "label",
+    "button"
+};
+
+
+
+
+widgetType WidgetTypeFromName(const char *name)
+{
+    // Check the input parameter
+    if(!name) return -1;
+
+    // Search the name in the widget type names
+    for(int type = 0; type < WIDGET_TYPE_COUNT; type++)
+    {
+        if(strcmp(widgetTypeNames[type], name) == 0) return (widgetType)type;
+    }
+
+    return -1;
+}
+
+
+
+
+const char *WidgetTypeToName(widgetType type)
+{
+    // Check the input parameter
+    if((int)type < 0 || type >= WIDGET_TYPE_COUNT) return NULL;
+
+    return widgetTypeNames[type];
+}
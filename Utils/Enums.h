@@ -24,4 +24,24 @@ typedef enum
     button
 } widgetType;
 
+#define WIDGET_TYPE_COUNT (button + 1)  ///< The number of widget types
+
+
+/**
+ * @brief Converts a tag name to its widget type
+ * 
+ * @param name The tag name as written in the markup (e.g., "headerBar")
+ * @return The matching widgetType, or -1 if the name is not a known widget
+ */
+widgetType WidgetTypeFromName(const char *name);
+
+
+/**
+ * @brief Converts a widget type to its tag name
+ * 
+ * @param type The widget type to convert
+ * @return The tag name of the widget type, or NULL if the type is not valid
+ */
+const char *WidgetTypeToName(widgetType type);
+
 #endif // ENUMS_H
\ No newline at end of file
@@ -0,0 +1,34 @@
+/***************************************************************************************************
+ * @file Hash.h                                                                                    *
+ * @brief Defines the string hash function shared by the data structures                           *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see HashMap.c                                                                                  *
+ **************************************************************************************************/
+
+#ifndef HASH_H
+#define HASH_H
+
+/**
+ * @brief Hashes a string with the 32 bits FNV-1a function
+ * 
+ * @param string The NUL terminated string to hash
+ * @return The hash of the string
+ */
+static inline unsigned int HashString(const char *string)
+{
+    unsigned int hash = 2166136261u;
+    for(const unsigned char *c = (const unsigned char *)string; *c; c++)
+    {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+#endif // HASH_H
@@ -0,0 +1,223 @@
+/***************************************************************************************************
+ * @file Trace.c                                                                                   *
+ * @brief The implementation of the tracing spans and of their export                              *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Trace.h                                                                                    *
+ **************************************************************************************************/
+
+#include "Trace.h"
+
+#ifdef TRACE_ENABLED
+
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+/**
+ * @brief A span of the ring buffer
+ * 
+ * The sequence is odd while the event is being written and 2 * (index + 1) once it is written,
+ * so the export can tell a complete event from one being overwritten.
+ */
+struct TraceEvent
+{
+    atomic_ulong sequence;
+    const char *name;
+    long long start;
+    long long duration;
+    long nodes;
+    long bytes;
+    int thread;
+};
+
+
+/**
+ * @brief The totals of a phase, while the trace is exported
+ */
+struct PhaseTotals
+{
+    const char *name;
+    long nodes;
+    long bytes;
+};
+
+#define TRACE_MAX_PHASES 64   ///< The number of phases whose totals are given, the others have none
+
+
+static struct TraceEvent events[TRACE_BUFFER_EVENTS];
+static atomic_ulong nextEvent;
+static _Thread_local int currentThread;
+
+
+
+
+/** @brief Returns the time of the monotonic clock in nanoseconds */
+static long long now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+
+/** @brief Returns the id of the calling thread, asked to the kernel once per thread */
+static int threadId(void)
+{
+    if(!currentThread) currentThread = (int)syscall(SYS_gettid);
+    return currentThread;
+}
+
+
+/** @brief Finds the totals of a phase, or adds them, NULL if there are too many phases */
+static struct PhaseTotals *phaseTotals(struct PhaseTotals *phases, int *count, const char *name)
+{
+    for(int i = 0; i < *count; i++)
+    {
+        if(phases[i].name == name) return &phases[i];
+    }
+
+    if(*count == TRACE_MAX_PHASES) return NULL;
+    phases[*count] = (struct PhaseTotals){ name, 0, 0 };
+    return &phases[(*count)++];
+}
+
+
+
+
+TraceSpan TraceBegin(const char *name)
+{
+    return (TraceSpan){ name, now() };
+}
+
+
+
+
+void TraceEnd(const TraceSpan *span, long nodes, long bytes)
+{
+    // Check the input parameter
+    if(!span) return;
+
+    long long end = now();
+
+    // Take the next slot, the writers never wait for each other
+    unsigned long index = atomic_fetch_add_explicit(&nextEvent, 1, memory_order_relaxed);
+    struct TraceEvent *event = &events[index % TRACE_BUFFER_EVENTS];
+
+    atomic_store_explicit(&event->sequence, 2 * index + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    event->name = span->name;
+    event->start = span->start;
+    event->duration = end - span->start;
+    event->nodes = nodes;
+    event->bytes = bytes;
+    event->thread = threadId();
+
+    atomic_store_explicit(&event->sequence, 2 * index + 2, memory_order_release);
+}
+
+
+
+
+int TraceExport(FILE *file)
+{
+    // Check the input parameter
+    if(!file) return -1;
+
+    unsigned long count = atomic_load_explicit(&nextEvent, memory_order_acquire);
+    unsigned long first = count > TRACE_BUFFER_EVENTS ? count - TRACE_BUFFER_EVENTS : 0;
+    int pid = (int)getpid();
+
+    struct PhaseTotals phases[TRACE_MAX_PHASES];
+    int phaseCount = 0;
+    int written = 0;
+
+    fputs("{\"traceEvents\":[", file);
+    for(unsigned long index = first; index < count; index++)
+    {
+        // Copy the event, and drop it if it was being written meanwhile
+        struct TraceEvent *slot = &events[index % TRACE_BUFFER_EVENTS];
+        if(atomic_load_explicit(&slot->sequence, memory_order_acquire) != 2 * index + 2) continue;
+
+        struct TraceEvent event;
+        event.name = slot->name;
+        event.start = slot->start;
+        event.duration = slot->duration;
+        event.nodes = slot->nodes;
+        event.bytes = slot->bytes;
+        event.thread = slot->thread;
+
+        atomic_thread_fence(memory_order_acquire);
+        if(atomic_load_explicit(&slot->sequence, memory_order_relaxed) != 2 * index + 2) continue;
+
+        fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"phase\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d,"
+                      "\"args\":{\"nodes\":%ld,\"bytes\":%ld}}",
+                written ? "," : "", event.name, event.start / 1e3, event.duration / 1e3, pid, event.thread,
+                event.nodes, event.bytes);
+        written++;
+
+        // The counters give the totals of the phase when the span ends
+        struct PhaseTotals *totals = phaseTotals(phases, &phaseCount, event.name);
+        if(!totals) continue;
+        totals->nodes += event.nodes;
+        totals->bytes += event.bytes;
+
+        double end = (event.start + event.duration) / 1e3;
+        if(event.nodes)
+            fprintf(file, ",\n{\"name\":\"nodes built\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,\"args\":{\"%s\":%ld}}",
+                    end, pid, event.thread, event.name, totals->nodes);
+        if(event.bytes)
+            fprintf(file, ",\n{\"name\":\"bytes scanned\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,\"args\":{\"%s\":%ld}}",
+                    end, pid, event.thread, event.name, totals->bytes);
+    }
+    fputs("\n],\"displayTimeUnit\":\"ms\"}\n", file);
+
+    return ferror(file) ? -1 : written;
+}
+
+
+
+
+void TraceClear(void)
+{
+    for(int i = 0; i < TRACE_BUFFER_EVENTS; i++) atomic_store_explicit(&events[i].sequence, 0, memory_order_relaxed);
+    atomic_store_explicit(&nextEvent, 0, memory_order_release);
+}
+
+
+
+
+long TraceGetCount(void)
+{
+    return (long)atomic_load_explicit(&nextEvent, memory_order_relaxed);
+}
+
+#else // TRACE_ENABLED
+
+/*
+ * The functions stay defined when the tracing is not compiled, so that the callers which do not
+ * go through the macros (a benchmark exporting its trace) link the same way.
+ */
+
+TraceSpan TraceBegin(const char *name) { return (TraceSpan){ name, 0 }; }
+void TraceEnd(const TraceSpan *span, long nodes, long bytes) { (void)span; (void)nodes; (void)bytes; }
+void TraceClear(void) { }
+long TraceGetCount(void) { return 0; }
+
+int TraceExport(FILE *file)
+{
+    // Check the input parameter
+    if(!file) return -1;
+
+    fputs("{\"traceEvents\":[]}\n", file);
+    return 0;
+}
+
+#endif // TRACE_ENABLED
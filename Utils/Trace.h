@@ -0,0 +1,96 @@
+/***************************************************************************************************
+ * @file Trace.h                                                                                   *
+ * @brief Defines the tracing spans around the phases of the Scanner and of the Tree               *
+ *                                                                                                 *
+ * @author Ayyoub EL KOURI                                                                         *
+ * @date 2026-10-18                                                                                *
+ * @version 1.0                                                                                    *
+ *                                                                                                 *
+ * @copyright Copyright (c) 2026, Ayyoub EL KOURI                                                  *
+ *                                                                                                 *
+ * @see Trace.c                                                                                    *
+ **************************************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+
+/*
+ * The spans are compiled only when TRACE_ENABLED is defined (-DTRACE_ENABLED): otherwise
+ * TRACE_BEGIN and TRACE_END expand to nothing and their arguments are not evaluated, so the
+ * phases cost exactly what they cost before.
+ *
+ * The spans that end are written to a ring buffer of TRACE_BUFFER_EVENTS events shared by all
+ * the threads, the oldest ones being overwritten once it is full. TraceExport writes the buffer
+ * in the JSON trace format read by chrome://tracing and Perfetto.
+ */
+
+#ifndef TRACE_BUFFER_EVENTS
+#define TRACE_BUFFER_EVENTS 65536   ///< The number of spans kept by the ring buffer
+#endif
+
+
+/**
+ * @brief A span that has begun and not ended yet
+ */
+typedef struct
+{
+    const char *name;   ///< The name of the phase, a string literal
+    long long start;    ///< The time it began, in nanoseconds of the monotonic clock
+} TraceSpan;
+
+
+#ifdef TRACE_ENABLED
+#define TRACE_BEGIN(span, name) TraceSpan span = TraceBegin(name)              ///< Declares a span and begins it
+#define TRACE_END(span, nodes, bytes) TraceEnd(&(span), (nodes), (bytes))      ///< Ends a span with its counters
+#else
+#define TRACE_BEGIN(span, name) ((void)0)
+#define TRACE_END(span, nodes, bytes) ((void)0)
+#endif
+
+
+/**
+ * @brief Begins a span, use TRACE_BEGIN instead so that it is compiled out when disabled
+ * @param name The name of the phase, a string literal (it is kept, not copied)
+ * @return The span
+ */
+TraceSpan TraceBegin(const char *name);
+
+
+/**
+ * @brief Ends a span and writes it to the ring buffer, use TRACE_END instead
+ * @param span The span
+ * @param nodes The number of nodes built (or visited) during the span
+ * @param bytes The number of bytes scanned during the span
+ */
+void TraceEnd(const TraceSpan *span, long nodes, long bytes);
+
+
+/**
+ * @brief Writes the spans of the ring buffer in the Chrome trace format
+ * 
+ * Every span is a complete event ("X") with its counters in its arguments, followed by the
+ * counter events ("C") "nodes built" and "bytes scanned" giving the totals of its phase so far.
+ * The spans still being written by other threads are left out.
+ * @param file The file to write, opened for writing
+ * @return The number of spans written (0 if the tracing is not compiled), or -1 if the file is NULL
+ */
+int TraceExport(FILE *file);
+
+
+/**
+ * @brief Empties the ring buffer
+ * 
+ * @warning No span may end at the same time
+ */
+void TraceClear(void);
+
+
+/**
+ * @brief Returns the number of spans ended since the start (or TraceClear), overwritten ones included
+ * @return The number of spans
+ */
+long TraceGetCount(void);
+
+#endif // TRACE_H
@@ -0,0 +1,13 @@
+#include "Scanner/Scanner.h"
+#include <stdlib.h>
+
+int main(){
+    FILE *file = fopen("../index.html", "r");
+    if (file == NULL) { printf("Error opening file\n"); exit(1); }
+
+    Tree *tree = performLexicalAnalysis(file);
+    fclose(file);
+
+    TreeDestroyAll(tree);
+    return 0;
+}